@@ -868,6 +868,7 @@ int gks_ft_load_user_font(char *font, int ignore_file_not_found)
 
   strcpy(gks_font_list_user_defined[textfont], font);
   font_face_cache_user_defined[textfont] = face;
+  gks_clear_text_extent_cache();
   return user_font_index++;
 }
 
@@ -44,6 +44,44 @@ static int id = 0;
 
 static gks_list_t *open_ws = NULL, *active_ws = NULL, *av_ws_types = NULL;
 
+/*
+ * Text extents are remembered for the most recent combinations of string, position and text attributes. Axis and
+ * tick label layouts inquire the same labels over and over again while searching for a layout.
+ */
+
+#define TEXT_EXTENT_CACHE_SIZE 256
+
+typedef struct
+{
+  char *str;
+  unsigned int hash;
+  double px, py, a, b, c, d;
+  int font, prec, path, halign, valign, encoding, bearing_x_direction;
+  double chh, chxp, chsp, chup[2], slant;
+} text_extent_key_t;
+
+typedef struct
+{
+  text_extent_key_t key;
+  double cpx, cpy, tx[4], ty[4];
+} text_extent_t;
+
+static text_extent_t text_extent_cache[TEXT_EXTENT_CACHE_SIZE];
+
+/*
+ * While a capture is active, every primitive and attribute record dispatched to the workstations is appended to the
+ * capture buffer, preceded by a copy of the state list whenever the state has changed since the last record. Any
+ * other record (workstation control, segments, color representations, ...) makes the capture incomplete.
+ */
+
+#define CAPTURE_STATE (-1)
+#define CAPTURE_HEADER_SIZE 10
+#define CAPTURE_ALIGN(n) (((n) + 7) & ~(size_t)7)
+#define CAPTURE_INITIAL_SIZE 65536
+
+static gks_capture_t *capture = NULL;
+static gks_state_list_t capture_state;
+
 static ws_descr_t ws_types[] = {
     {2, GKS_K_METERS, 1.00000, 1.00000, 65536, 65536, 4, "mf", NULL, "MO"},
     {3, GKS_K_METERS, 1.00000, 1.00000, 65536, 65536, 5, "mf", NULL, "MI"},
@@ -126,6 +164,118 @@ static double *x = NULL, *y = NULL;
 
 static int max_points = 0;
 
+static int capture_supported(int fctid)
+{
+  switch (fctid)
+    {
+    case POLYLINE:
+    case POLYMARKER:
+    case TEXT:
+    case FILLAREA:
+    case CELLARRAY:
+    case GDP:
+    case DRAW_IMAGE:
+    case SET_ASF:
+    case SET_WINDOW:
+    case SET_VIEWPORT:
+    case SELECT_XFORM:
+    case SET_CLIPPING:
+    case SET_ENCODING:
+    case SET_RESAMPLE_METHOD:
+    case SET_TEXT_SLANT:
+    case SET_SHADOW:
+    case SET_TRANSPARENCY:
+    case SET_COORD_XFORM:
+    case SET_BORDER_WIDTH:
+    case SET_BORDER_COLOR_INDEX:
+    case SELECT_CLIP_XFORM:
+    case SET_CLIP_REGION:
+      return 1;
+
+    default:
+      return fctid >= SET_PLINE_INDEX && fctid <= SET_FILL_COLOR_INDEX;
+    }
+}
+
+static void capture_append(int fctid, int dx, int dy, int dimx, const int *ia, int n_i, int len_f_arr_1,
+                           const double *f_arr_1, int len_f_arr_2, const double *f_arr_2, int len_c_arr,
+                           const char *c_arr, int n_c)
+{
+  int header[CAPTURE_HEADER_SIZE], size;
+  size_t len;
+  char *p;
+
+  len = sizeof(header) + CAPTURE_ALIGN(n_i * sizeof(int)) + (len_f_arr_1 + len_f_arr_2) * sizeof(double) +
+        CAPTURE_ALIGN((size_t)n_c);
+  if (len > (size_t)(capture->max_size - capture->nbytes))
+    {
+      /* the capture would grow too large, so give up on it */
+      gks_discard_capture(capture);
+      return;
+    }
+  if (capture->nbytes + (int)len > capture->size)
+    {
+      size = capture->size > 0 ? capture->size : CAPTURE_INITIAL_SIZE;
+      while (size < capture->nbytes + (int)len) size = size <= capture->max_size / 2 ? 2 * size : capture->max_size;
+      capture->buffer = gks_realloc(capture->buffer, size);
+      capture->size = size;
+    }
+
+  header[0] = (int)len;
+  header[1] = fctid;
+  header[2] = dx;
+  header[3] = dy;
+  header[4] = dimx;
+  header[5] = len_f_arr_1;
+  header[6] = len_f_arr_2;
+  header[7] = len_c_arr;
+  header[8] = n_i;
+  header[9] = n_c;
+
+  p = capture->buffer + capture->nbytes;
+  memcpy(p, header, sizeof(header));
+  p += sizeof(header);
+  if (n_i > 0) memcpy(p, ia, n_i * sizeof(int));
+  p += CAPTURE_ALIGN(n_i * sizeof(int));
+  if (len_f_arr_1 > 0) memcpy(p, f_arr_1, len_f_arr_1 * sizeof(double));
+  p += len_f_arr_1 * sizeof(double);
+  if (len_f_arr_2 > 0) memcpy(p, f_arr_2, len_f_arr_2 * sizeof(double));
+  p += len_f_arr_2 * sizeof(double);
+  if (n_c > 0) memcpy(p, c_arr, n_c);
+
+  capture->nbytes += (int)len;
+}
+
+static void capture_append_state(void)
+{
+  memmove(&capture_state, s, sizeof(gks_state_list_t));
+  capture_append(CAPTURE_STATE, 0, 0, 0, NULL, 0, 0, NULL, 0, NULL, 0, (char *)s, sizeof(gks_state_list_t));
+}
+
+static void capture_item(int fctid, int dx, int dy, int dimx, int *i_arr, int len_f_arr_1, double *f_arr_1,
+                         int len_f_arr_2, double *f_arr_2, int len_c_arr, char *c_arr)
+{
+  int n_i, n_c;
+
+  if (!capture->complete) return;
+
+  if (!capture_supported(fctid) || id != 0)
+    {
+      gks_discard_capture(capture);
+      return;
+    }
+
+  if (memcmp(&capture_state, s, sizeof(gks_state_list_t)) != 0)
+    {
+      capture_append_state();
+      if (!capture->complete) return;
+    }
+
+  n_i = dy > 0 ? dimx * (dy - 1) + dx : 0;
+  n_c = fctid == TEXT ? (int)strlen(c_arr) + 1 : 0;
+  capture_append(fctid, dx, dy, dimx, i_arr, n_i, len_f_arr_1, f_arr_1, len_f_arr_2, f_arr_2, len_c_arr, c_arr, n_c);
+}
+
 static void gks_ddlk(int fctid, int dx, int dy, int dimx, int *i_arr, int len_f_arr_1, double *f_arr_1, int len_f_arr_2,
                      double *f_arr_2, int len_c_arr, char *c_arr, void **ptr)
 {
@@ -133,6 +283,9 @@ static void gks_ddlk(int fctid, int dx, int dy, int dimx, int *i_arr, int len_f_
   ws_list_t *ws;
   int have_id;
 
+  if (capture != NULL)
+    capture_item(fctid, dx, dy, dimx, i_arr, len_f_arr_1, f_arr_1, len_f_arr_2, f_arr_2, len_c_arr, c_arr);
+
   switch (fctid)
     {
     case OPEN_WS:
@@ -619,6 +772,7 @@ void gks_close_gks(void)
           fontfile = 0;
         }
 
+      gks_clear_text_extent_cache();
       gks_list_free(av_ws_types);
       gks_free((void *)s);
       s = NULL;
@@ -3025,16 +3179,90 @@ void gks_inq_ws_category(int wtype, int *errind, int *wscat)
     *errind = GKS_K_ERROR;
 }
 
+void gks_clear_text_extent_cache(void)
+{
+  int i;
+
+  for (i = 0; i < TEXT_EXTENT_CACHE_SIZE; i++)
+    {
+      if (text_extent_cache[i].key.str != NULL)
+        {
+          gks_free(text_extent_cache[i].key.str);
+          text_extent_cache[i].key.str = NULL;
+        }
+    }
+}
+
+static void text_extent_key(double px, double py, char *str, text_extent_key_t *key)
+{
+  int tnr = s->cntnr;
+  unsigned int hash = 2166136261U;
+  const unsigned char *p;
+
+  for (p = (const unsigned char *)str; *p; p++) hash = (hash ^ *p) * 16777619U;
+
+  key->str = str;
+  key->px = px;
+  key->py = py;
+  key->a = s->a[tnr];
+  key->b = s->b[tnr];
+  key->c = s->c[tnr];
+  key->d = s->d[tnr];
+  key->font = s->txfont;
+  key->prec = s->txprec;
+  key->path = s->txp;
+  key->halign = s->txal[0];
+  key->valign = s->txal[1];
+  key->encoding = s->input_encoding;
+  gks_ft_inq_bearing_x_direction(&key->bearing_x_direction);
+  key->chh = s->chh;
+  key->chxp = s->chxp;
+  key->chsp = s->chsp;
+  key->chup[0] = s->chup[0];
+  key->chup[1] = s->chup[1];
+  key->slant = s->txslant;
+
+  hash ^= (unsigned int)(key->font * 31 + key->prec * 7 + key->halign * 3 + key->valign);
+  key->hash = hash;
+}
+
+static int text_extent_key_equal(const text_extent_key_t *k1, const text_extent_key_t *k2)
+{
+  return k1->hash == k2->hash && k1->px == k2->px && k1->py == k2->py && k1->a == k2->a && k1->b == k2->b &&
+         k1->c == k2->c && k1->d == k2->d && k1->font == k2->font && k1->prec == k2->prec && k1->path == k2->path &&
+         k1->halign == k2->halign && k1->valign == k2->valign && k1->encoding == k2->encoding &&
+         k1->bearing_x_direction == k2->bearing_x_direction && k1->chh == k2->chh && k1->chxp == k2->chxp &&
+         k1->chsp == k2->chsp && k1->chup[0] == k2->chup[0] && k1->chup[1] == k2->chup[1] && k1->slant == k2->slant &&
+         strcmp(k1->str, k2->str) == 0;
+}
+
 void gks_inq_text_extent(int wkid, double px, double py, char *str, int *errind, double *cpx, double *cpy, double *tx,
                          double *ty)
 {
   double bx[9], by[9];
   int i;
+  text_extent_key_t key;
+  text_extent_t *entry;
 
   if (gks_list_find(open_ws, wkid) != NULL && strlen(str) != 0)
     {
       if (strlen(str) < GKS_K_TEXT_MAX_SIZE)
         {
+          text_extent_key(px, py, str, &key);
+          entry = text_extent_cache + key.hash % TEXT_EXTENT_CACHE_SIZE;
+          if (entry->key.str != NULL && text_extent_key_equal(&entry->key, &key))
+            {
+              for (i = 0; i < 4; i++)
+                {
+                  tx[i] = entry->tx[i];
+                  ty[i] = entry->ty[i];
+                }
+              *cpx = entry->cpx;
+              *cpy = entry->cpy;
+              *errind = GKS_K_NO_ERROR;
+              return;
+            }
+
           if (s->txprec != GKS_K_TEXT_PRECISION_OUTLINE)
             {
               /* double the string length as the longest utf8 representation of any latin1 character is two bytes long
@@ -3070,6 +3298,17 @@ void gks_inq_text_extent(int wkid, double px, double py, char *str, int *errind,
               *cpy = by[8];
             }
           *errind = GKS_K_NO_ERROR;
+
+          if (entry->key.str != NULL) gks_free(entry->key.str);
+          entry->key = key;
+          entry->key.str = gks_strdup(str);
+          for (i = 0; i < 4; i++)
+            {
+              entry->tx[i] = tx[i];
+              entry->ty[i] = ty[i];
+            }
+          entry->cpx = *cpx;
+          entry->cpy = *cpy;
         }
       else
         /* string is too long */
@@ -4529,6 +4768,171 @@ void *gks_state(void)
   return (void *)s;
 }
 
+/*
+ * Take a snapshot of the complete GKS state list. GKS must be open.
+ */
+void gks_save_state(gks_state_list_t *state)
+{
+  memcpy(state, s, sizeof(gks_state_list_t));
+}
+
+/*
+ * Restore the attributes and normalization transformations of a state list taken with gks_save_state. Only the
+ * settings that differ from the current state are set, so no redundant attribute records are sent to the
+ * workstations.
+ */
+void gks_restore_state(const gks_state_list_t *state)
+{
+  int tnr, asf[13];
+
+  if (state->lindex != s->lindex) gks_set_pline_index(state->lindex);
+  if (state->ltype != s->ltype) gks_set_pline_linetype(state->ltype);
+  if (state->lwidth != s->lwidth) gks_set_pline_linewidth(state->lwidth);
+  if (state->plcoli != s->plcoli) gks_set_pline_color_index(state->plcoli);
+  if (state->mindex != s->mindex) gks_set_pmark_index(state->mindex);
+  if (state->mtype != s->mtype) gks_set_pmark_type(state->mtype);
+  if (state->mszsc != s->mszsc) gks_set_pmark_size(state->mszsc);
+  if (state->pmcoli != s->pmcoli) gks_set_pmark_color_index(state->pmcoli);
+  if (state->tindex != s->tindex) gks_set_text_index(state->tindex);
+  if (state->txfont != s->txfont || state->txprec != s->txprec) gks_set_text_fontprec(state->txfont, state->txprec);
+  if (state->chxp != s->chxp) gks_set_text_expfac(state->chxp);
+  if (state->chsp != s->chsp) gks_set_text_spacing(state->chsp);
+  if (state->txcoli != s->txcoli) gks_set_text_color_index(state->txcoli);
+  if (state->chh != s->chh) gks_set_text_height(state->chh);
+  if (state->chup[0] != s->chup[0] || state->chup[1] != s->chup[1])
+    gks_set_text_upvec(state->chup[0], state->chup[1]);
+  if (state->txp != s->txp) gks_set_text_path(state->txp);
+  if (state->txal[0] != s->txal[0] || state->txal[1] != s->txal[1]) gks_set_text_align(state->txal[0], state->txal[1]);
+  if (state->findex != s->findex) gks_set_fill_index(state->findex);
+  if (state->ints != s->ints) gks_set_fill_int_style(state->ints);
+  if (state->styli != s->styli) gks_set_fill_style_index(state->styli);
+  if (state->facoli != s->facoli) gks_set_fill_color_index(state->facoli);
+  if (memcmp(state->asf, s->asf, sizeof(asf)) != 0)
+    {
+      memcpy(asf, state->asf, sizeof(asf));
+      gks_set_asf(asf);
+    }
+
+  for (tnr = 1; tnr < MAX_TNR; tnr++)
+    {
+      if (memcmp(state->window[tnr], s->window[tnr], 4 * sizeof(double)) != 0)
+        gks_set_window(tnr, state->window[tnr][0], state->window[tnr][1], state->window[tnr][2],
+                       state->window[tnr][3]);
+      if (memcmp(state->viewport[tnr], s->viewport[tnr], 4 * sizeof(double)) != 0)
+        gks_set_viewport(tnr, state->viewport[tnr][0], state->viewport[tnr][1], state->viewport[tnr][2],
+                         state->viewport[tnr][3]);
+    }
+  if (state->cntnr != s->cntnr) gks_select_xform(state->cntnr);
+  if (state->clip != s->clip) gks_set_clipping(state->clip);
+  if (state->clip_tnr != s->clip_tnr) gks_select_clip_xform(state->clip_tnr);
+  if (state->clip_region != s->clip_region) gks_set_clip_region(state->clip_region);
+
+  if (state->input_encoding != s->input_encoding) gks_set_encoding(state->input_encoding);
+  if (state->txslant != s->txslant) gks_set_text_slant(state->txslant);
+  if (state->shoff[0] != s->shoff[0] || state->shoff[1] != s->shoff[1] || state->blur != s->blur)
+    gks_set_shadow(state->shoff[0], state->shoff[1], state->blur);
+  if (state->alpha != s->alpha) gks_set_transparency(state->alpha);
+  if (state->resample_method != s->resample_method) gks_set_resample_method(state->resample_method);
+  if (state->bwidth != s->bwidth) gks_set_border_width(state->bwidth);
+  if (state->bcoli != s->bcoli) gks_set_border_color_index(state->bcoli);
+  if (state->resize_behaviour != s->resize_behaviour) gks_set_resize_behaviour(state->resize_behaviour);
+}
+
+/*
+ * Start recording the output of all following GKS calls into the given capture. The recording is abandoned (and the
+ * capture marked incomplete) as soon as it would exceed max_size bytes or a function is called that cannot be
+ * replayed.
+ */
+void gks_begin_capture(gks_capture_t *c, int max_size)
+{
+  c->buffer = NULL;
+  c->size = c->nbytes = 0;
+  c->max_size = max_size;
+  c->complete = 0;
+
+  if (state >= GKS_K_GKOP && capture == NULL)
+    {
+      c->complete = 1;
+      capture = c;
+      capture_append_state();
+    }
+}
+
+/*
+ * Stop the active capture. Returns 1 if the capture is complete and can be replayed.
+ */
+int gks_end_capture(void)
+{
+  int complete = 0;
+
+  if (capture != NULL)
+    {
+      if (capture->complete && memcmp(&capture_state, s, sizeof(gks_state_list_t)) != 0) capture_append_state();
+      if (capture->complete && capture->nbytes < capture->size)
+        {
+          capture->buffer = gks_realloc(capture->buffer, capture->nbytes);
+          capture->size = capture->nbytes;
+        }
+      complete = capture->complete;
+      capture = NULL;
+    }
+
+  return complete;
+}
+
+/*
+ * Dispatch the records of a complete capture to the active workstations again. The capture is only replayed if the
+ * current state list equals the one at the beginning of the capture; afterwards the state list equals the one at
+ * its end. Returns 1 if the capture has been replayed.
+ */
+int gks_replay_capture(const gks_capture_t *c)
+{
+  int header[CAPTURE_HEADER_SIZE];
+  char *p, *end, *data;
+  int *ia;
+  double *f1, *f2;
+
+  if (state < GKS_K_WSAC || !c->complete || c->nbytes == 0) return 0;
+
+  memcpy(header, c->buffer, sizeof(header));
+  if (header[1] != CAPTURE_STATE || memcmp(c->buffer + sizeof(header), s, sizeof(gks_state_list_t)) != 0) return 0;
+
+  p = c->buffer;
+  end = c->buffer + c->nbytes;
+  while (p < end)
+    {
+      memcpy(header, p, sizeof(header));
+      data = p + sizeof(header);
+      ia = header[8] > 0 ? (int *)data : i_arr;
+      data += CAPTURE_ALIGN(header[8] * sizeof(int));
+      f1 = header[5] > 0 ? (double *)data : f_arr_1;
+      data += header[5] * sizeof(double);
+      f2 = header[6] > 0 ? (double *)data : f_arr_2;
+      data += header[6] * sizeof(double);
+
+      if (header[1] == CAPTURE_STATE)
+        memmove(s, data, sizeof(gks_state_list_t));
+      else
+        gks_ddlk(header[1], header[2], header[3], header[4], ia, header[5], f1, header[6], f2, header[7],
+                 header[9] > 0 ? data : c_arr, NULL);
+
+      p += header[0];
+    }
+
+  return 1;
+}
+
+/*
+ * Release the memory of a capture.
+ */
+void gks_discard_capture(gks_capture_t *c)
+{
+  gks_free(c->buffer);
+  c->buffer = NULL;
+  c->size = c->nbytes = 0;
+  c->complete = 0;
+}
+
 void gks_set_clip_region(int region)
 {
   if (state >= GKS_K_GKOP)
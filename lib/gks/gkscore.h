@@ -215,6 +215,13 @@ typedef struct
   int empty;
 } gks_display_list_t;
 
+typedef struct
+{
+  char *buffer;
+  int size, nbytes, max_size;
+  int complete;
+} gks_capture_t;
+
 typedef struct
 {
   int left, right;
@@ -258,6 +265,13 @@ DLLEXPORT void gks_resample(const unsigned char *source_image, unsigned char *ta
                             size_t source_height, size_t target_width, size_t target_height, size_t stride, int swapx,
                             int swapy, unsigned int resample_method);
 void gks_init_core(gks_state_list_t *list);
+DLLEXPORT void gks_save_state(gks_state_list_t *state);
+DLLEXPORT void gks_restore_state(const gks_state_list_t *state);
+DLLEXPORT void gks_begin_capture(gks_capture_t *capture, int max_size);
+DLLEXPORT int gks_end_capture(void);
+DLLEXPORT int gks_replay_capture(const gks_capture_t *capture);
+DLLEXPORT void gks_discard_capture(gks_capture_t *capture);
+void gks_clear_text_extent_cache(void);
 gks_list_t *gks_list_find(gks_list_t *list, int element);
 gks_list_t *gks_list_add(gks_list_t *list, int element, void *ptr);
 gks_list_t *gks_list_del(gks_list_t *list, int element);
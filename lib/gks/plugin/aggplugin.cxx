@@ -1316,9 +1316,16 @@ static void fill_polygons(int n, const double *px, const double *py, int nply, c
       p->stroke_col =
           agg::rgba(p->rgb[gkss->bcoli][0], p->rgb[gkss->bcoli][1], p->rgb[gkss->bcoli][2], p->transparency);
 
-      p->stroke.line_join(agg::round_join);
-      p->stroke.width(gkss->bwidth * p->nominal_size);
-      fill_stroke_path(p->path);
+      if (gkss->bwidth != 0)
+        {
+          p->stroke.line_join(agg::round_join);
+          p->stroke.width(gkss->bwidth * p->nominal_size);
+          fill_stroke_path(p->path);
+        }
+      else
+        {
+          fill_path(p->path);
+        }
     }
   delete[] points;
 }
@@ -2145,14 +2145,21 @@ static void fill_polygons(int n, double *px, double *py, int nply, int *ply)
       set_color(fill_color);
 
       cairo_close_path(p->cr);
-      cairo_fill_preserve(p->cr);
+      if (gkss->bwidth != 0)
+        {
+          cairo_fill_preserve(p->cr);
 
-      set_color(gkss->bcoli);
-      cairo_set_line_cap(p->cr, CAIRO_LINE_CAP_BUTT);
-      cairo_set_line_join(p->cr, CAIRO_LINE_JOIN_ROUND);
-      cairo_set_dash(p->cr, p->dashes, 0, 0);
-      set_line_width(gkss->bwidth * p->nominal_size);
-      cairo_stroke(p->cr);
+          set_color(gkss->bcoli);
+          cairo_set_line_cap(p->cr, CAIRO_LINE_CAP_BUTT);
+          cairo_set_line_join(p->cr, CAIRO_LINE_JOIN_ROUND);
+          cairo_set_dash(p->cr, p->dashes, 0, 0);
+          set_line_width(gkss->bwidth * p->nominal_size);
+          cairo_stroke(p->cr);
+        }
+      else
+        {
+          cairo_fill(p->cr);
+        }
     }
 }
 
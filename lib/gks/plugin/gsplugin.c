@@ -1898,8 +1898,8 @@ static void draw_triangles(int n, double *px, double *py, int ntri, int *tri)
 static void fill_polygons(int n, double *px, double *py, int nply, int *ply)
 {
   double x, y, xd, yd;
-  int j, k, len, fl_color = MAX_COLOR;
-  unsigned int rgba;
+  int j, k, len, ix, iy, jx = 0, jy = 0, fl_color = MAX_COLOR, first = 1;
+  unsigned int rgba, last_rgba = 0;
   char buffer[50];
   GKS_UNUSED(n);
 
@@ -1908,23 +1908,26 @@ static void fill_polygons(int n, double *px, double *py, int nply, int *ply)
     {
       len = ply[j++];
 
-      packb("np");
       for (k = 0; k < len; ++k)
         {
           WC_to_NDC(px[ply[j] - 1], py[ply[j] - 1], gkss->cntnr, x, y);
           seg_xform(&x, &y);
           NDC_to_DC(x, y, xd, yd);
+          ix = nint(xd);
+          iy = nint(yd);
           j++;
 
           if (k == 0)
             {
-              snprintf(buffer, 50, "%.2f %.2f m", xd, yd);
+              snprintf(buffer, 50, "np %d %d m", ix, iy);
             }
           else
             {
-              snprintf(buffer, 50, "%.2f %.2f l", xd, yd);
+              snprintf(buffer, 50, "%d %d rl", ix - jx, iy - jy);
             }
           packb(buffer);
+          jx = ix;
+          jy = iy;
         }
 
       rgba = (unsigned int)ply[j++];
@@ -1932,14 +1935,31 @@ static void fill_polygons(int n, double *px, double *py, int nply, int *ply)
       p->green[fl_color] = ((rgba >> 8) & 0xff) / 255.0;
       p->blue[fl_color] = ((rgba >> 16) & 0xff) / 255.0;
 
-      packb("cp gs");
-      set_color(-fl_color, p->wtype);
-      packb("fi gr");
+      if (gkss->bwidth != 0)
+        {
+          packb("cp gs");
+          set_color(-fl_color, p->wtype);
+          packb("fi gr");
 
-      snprintf(buffer, 50, "%.4g %.4g %.4g sc", p->red[gkss->bcoli], p->green[gkss->bcoli], p->blue[gkss->bcoli]);
-      packb(buffer);
-      set_linewidth(gkss->bwidth);
-      packb("sk");
+          snprintf(buffer, 50, "%.4g %.4g %.4g sc", p->red[gkss->bcoli], p->green[gkss->bcoli],
+                   p->blue[gkss->bcoli]);
+          packb(buffer);
+          set_linewidth(gkss->bwidth);
+          packb("sk");
+          /* "gr" restored the color from before the fill, and the border color is not a color index */
+          p->color = -1;
+        }
+      else
+        {
+          /*
+           * without borders the fill color stays set, so it only has to be emitted if it changes; `p->color` may
+           * still refer to the fill color of a previous call, so the first facet always sets it
+           */
+          if (first || p->color != fl_color || rgba != last_rgba) set_color(-fl_color, p->wtype);
+          packb("fi");
+        }
+      last_rgba = rgba;
+      first = 0;
     }
 }
 
@@ -1421,8 +1421,15 @@ static void fill_polygons(int n, double *px, double *py, int nply, int *ply)
 
       pgf_printf(p->stream, "\\definecolor{mycolor}{RGB}{%d,%d,%d}\n", red, green, blue);
 
-      pgf_printf(p->stream, "\\draw[color=pathstroke, fill=mycolor, line width=%fpt, opacity=%f] ",
-                 gkss->bwidth * p->nominal_size, p->transparency);
+      if (gkss->bwidth != 0)
+        {
+          pgf_printf(p->stream, "\\draw[color=pathstroke, fill=mycolor, line width=%fpt, opacity=%f] ",
+                     gkss->bwidth * p->nominal_size, p->transparency);
+        }
+      else
+        {
+          pgf_printf(p->stream, "\\fill[fill=mycolor, opacity=%f] ", p->transparency);
+        }
 
       for (k = 0; k < len; ++k)
         {
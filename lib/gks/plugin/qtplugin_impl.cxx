@@ -1407,7 +1407,11 @@ static void fill_polygons(int n, double *px, double *py, int nply, int *ply)
       fill_color.setAlpha(alpha);
 
       p->painter->setBrush(QBrush(fill_color, Qt::SolidPattern));
-      p->painter->setPen(QPen(border_color, gkss->bwidth * p->nominal_size, Qt::SolidLine, Qt::FlatCap, Qt::RoundJoin));
+      if (gkss->bwidth != 0)
+        p->painter->setPen(
+            QPen(border_color, gkss->bwidth * p->nominal_size, Qt::SolidLine, Qt::FlatCap, Qt::RoundJoin));
+      else
+        p->painter->setPen(Qt::NoPen);
       p->painter->drawPolygon(p->polygon->constData(), len);
     }
 
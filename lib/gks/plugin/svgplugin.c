@@ -1436,10 +1436,17 @@ static void fill_polygons(int n, double *px, double *py, int nply, int *ply)
 
       svg_printf(p->stream, " Z\" fill=\"#%02x%02x%02x\" fill-rule=\"evenodd\" fill-opacity=\"%g\" ", red, green, blue,
                  alpha);
-      svg_printf(p->stream,
-                 "stroke=\"#%02x%02x%02x\" stroke-opacity=\"%g\" stroke-linejoin=\"round\" stroke-width=\"%g\" />",
-                 p->rgb[gkss->bcoli][0], p->rgb[gkss->bcoli][1], p->rgb[gkss->bcoli][2], alpha,
-                 gkss->bwidth * p->nominal_size);
+      if (gkss->bwidth != 0)
+        {
+          svg_printf(p->stream,
+                     "stroke=\"#%02x%02x%02x\" stroke-opacity=\"%g\" stroke-linejoin=\"round\" stroke-width=\"%g\" />",
+                     p->rgb[gkss->bcoli][0], p->rgb[gkss->bcoli][1], p->rgb[gkss->bcoli][2], alpha,
+                     gkss->bwidth * p->nominal_size);
+        }
+      else
+        {
+          svg_printf(p->stream, "stroke=\"none\" />");
+        }
     }
 }
 
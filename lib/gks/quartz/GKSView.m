@@ -2005,7 +2005,7 @@ static void to_DC(int n, double *x, double *y)
       CGContextSetFillColor(context, color);
 
       CGContextClosePath(context);
-      CGContextDrawPath(context, kCGPathFillStroke);
+      CGContextDrawPath(context, gkss->bwidth != 0 ? kCGPathFillStroke : kCGPathFill);
     }
 
   end_context(context);
@@ -9,6 +9,7 @@
 #include "gkscore.h"
 #include "gr.h"
 #include "contour.h"
+#include "threadpool.h"
 
 #ifndef min
 #define min(a, b) ((a) < (b) ? (a) : (b))
@@ -75,6 +76,47 @@ typedef struct
   double *y;
 } polyline_t;
 
+/* the pen movements of `calc_contours` for a single level, see `draw` for the meaning of `flags` */
+typedef struct
+{
+  int n, capacity;
+  double *x, *y;
+  int *flags;
+} contour_path_t;
+
+typedef struct
+{
+  double *z;
+  int nrz, nx, ny;
+  double *cv, zmax;
+  double xmin, ymin, dx, dy;
+  contour_path_t *paths;
+} contour_levels_t;
+
+/*
+ * The traced contour lines of the previous call. Redrawing the same data with the same levels (e.g. after a change of
+ * the viewport or the line attributes) only replays the stored paths.
+ */
+static struct
+{
+  double *z;
+  int nrz, nx, ny;
+  double *cv;
+  int ncv;
+  double zmax;
+  double xmin, ymin, dx, dy;
+  contour_path_t *paths;
+} contour_cache = {NULL, 0, 0, 0, NULL, 0};
+
+typedef struct
+{
+  double *x, *y, *z;
+  int ntri, *triangles;
+  double *levels;
+  int *nlines;
+  polyline_t **lines;
+} tricont_levels_t;
+
 static int lookup_table[6][3][2] = {{{0, 1}, {0, 2}}, {{0, 1}, {1, 2}}, {{0, 2}, {1, 2}},
                                     {{0, 2}, {1, 2}}, {{0, 1}, {1, 2}}, {{0, 1}, {0, 2}}};
 
@@ -90,6 +132,18 @@ static char *xmalloc(int bytes)
   return ptr;
 }
 
+static char *xrealloc(void *ptr, int bytes)
+{
+  char *new_ptr;
+
+  if ((new_ptr = (char *)realloc(ptr, bytes)) == NULL)
+    {
+      fprintf(stderr, "out of virtual memory\n");
+      abort();
+    }
+  return new_ptr;
+}
+
 /*------------------------------------------------------------------------------
 / This gradient maintains a moving average of the magnitude of the gradient
 / vector at points along the contour line.  The idea behind this routine is that
@@ -747,8 +801,36 @@ static void draw(double x, double y, double z, int iflag)
     }
 }
 
+static void add_path_point(contour_path_t *path, double x, double y, int flag)
+{
+  if (path->n == path->capacity)
+    {
+      path->capacity = path->capacity ? 2 * path->capacity : 256;
+      path->x = (double *)xrealloc(path->x, path->capacity * sizeof(double));
+      path->y = (double *)xrealloc(path->y, path->capacity * sizeof(double));
+      path->flags = (int *)xrealloc(path->flags, path->capacity * sizeof(int));
+    }
+  path->x[path->n] = x;
+  path->y[path->n] = y;
+  path->flags[path->n] = flag;
+  path->n++;
+}
+
+static void free_paths(contour_path_t *paths, int n)
+{
+  int i;
+
+  for (i = 0; i < n; i++)
+    {
+      free(paths[i].x);
+      free(paths[i].y);
+      free(paths[i].flags);
+    }
+  free(paths);
+}
+
 static void calc_contours(double *z, int nrz, int nx, int ny, double *cv, int ncv, double zmax, int *bitmap,
-                          double xmin, double ymin, double dx, double dy)
+                          double xmin, double ymin, double dx, double dy, contour_path_t *path)
 {
   /*
       This subroutine draws a contour through equal values of an array.
@@ -780,6 +862,8 @@ static void calc_contours(double *z, int nrz, int nx, int ny, double *cv, int nc
 
       BITMAP is a work area large enough to hold NX*NY*NCV*2 bits.
 
+      PATH receives the pen movements which would be passed to DRAW.
+
       ******************************************************************
 
       DRAW is a subroutine used to draw contours.  The calling sequence
@@ -831,7 +915,7 @@ static void calc_contours(double *z, int nrz, int nx, int ny, double *cv, int nc
       XY is used to compute coordinates for the draw subroutine.
    */
 
-  static int l1[4] = {0, 0, -1, -1};
+  int l1[4] = {0, 0, -1, -1};
   static int i1[2] = {1, 0};
   static int i2[2] = {1, -1};
   static int i3[6] = {1, 0, 0, 1, 1, 0};
@@ -1064,7 +1148,7 @@ L200:
   xy[l - 1] = ij[l - 1] + xint[iedge - 1];
   xy[3 - l - 1] = ij[3 - l - 1];
   BITMAP(ij[0], ij[1], icv, l) = 1;
-  draw(xmin + (xy[0] - 1.0) * dx, ymin + (xy[1] - 1.0) * dy, cval, iflag + 10 * icv);
+  add_path_point(path, xmin + (xy[0] - 1.0) * dx, ymin + (xy[1] - 1.0) * dy, iflag + 10 * icv);
   if (iflag < 4)
     {
       goto L210;
@@ -1189,11 +1273,76 @@ L290:
 #undef BITMAP
 #undef Z
 
+/*
+ * Trace the levels `start` to `end - 1` independently of each other, each one into its own path.
+ */
+static void trace_levels(void *arg, int start, int end)
+{
+  contour_levels_t *c = (contour_levels_t *)arg;
+  int *bitmap, icv;
+
+  bitmap = (int *)xmalloc(c->nx * c->ny * 2 * sizeof(int));
+  for (icv = start; icv < end; icv++)
+    {
+      calc_contours(c->z, c->nrz, c->nx, c->ny, c->cv + icv, 1, c->zmax, bitmap, c->xmin, c->ymin, c->dx, c->dy,
+                    c->paths + icv);
+    }
+  free(bitmap);
+}
+
+static int contour_cache_matches(contour_levels_t *c, int ncv)
+{
+  return contour_cache.paths != NULL && contour_cache.nrz == c->nrz && contour_cache.nx == c->nx &&
+         contour_cache.ny == c->ny && contour_cache.ncv == ncv && contour_cache.zmax == c->zmax &&
+         contour_cache.xmin == c->xmin && contour_cache.ymin == c->ymin && contour_cache.dx == c->dx &&
+         contour_cache.dy == c->dy && memcmp(contour_cache.cv, c->cv, ncv * sizeof(double)) == 0 &&
+         memcmp(contour_cache.z, c->z, ((c->ny - 1) * c->nrz + c->nx) * sizeof(double)) == 0;
+}
+
+/*
+ * Return the traced paths of all levels. The data is compared against a private copy instead of relying on the data
+ * pointer, so that arrays which were modified in place are traced again.
+ */
+static contour_path_t *contour_paths(contour_levels_t *c, int ncv)
+{
+  int nz = (c->ny - 1) * c->nrz + c->nx;
+
+  if (contour_cache_matches(c, ncv)) return contour_cache.paths;
+
+  c->paths = (contour_path_t *)calloc(ncv, sizeof(contour_path_t));
+  if (c->paths == NULL)
+    {
+      fprintf(stderr, "out of virtual memory\n");
+      abort();
+    }
+  threadpool_parallel_for(ncv, 1, trace_levels, c);
+
+  if (contour_cache.paths != NULL) free_paths(contour_cache.paths, contour_cache.ncv);
+  contour_cache.z = (double *)xrealloc(contour_cache.z, nz * sizeof(double));
+  memcpy(contour_cache.z, c->z, nz * sizeof(double));
+  contour_cache.cv = (double *)xrealloc(contour_cache.cv, ncv * sizeof(double));
+  memcpy(contour_cache.cv, c->cv, ncv * sizeof(double));
+  contour_cache.nrz = c->nrz;
+  contour_cache.nx = c->nx;
+  contour_cache.ny = c->ny;
+  contour_cache.ncv = ncv;
+  contour_cache.zmax = c->zmax;
+  contour_cache.xmin = c->xmin;
+  contour_cache.ymin = c->ymin;
+  contour_cache.dx = c->dx;
+  contour_cache.dy = c->dy;
+  contour_cache.paths = c->paths;
+
+  return c->paths;
+}
+
 void gr_draw_contours(int nx, int ny, int nh, double *px, double *py, double *h, double *z, int major_h)
 {
   double mmin, mmax, *cv;
-  int ncv, *bitmap;
+  int ncv;
   int i, j, k, n = 0;
+  contour_levels_t levels;
+  contour_path_t *paths;
   int precision, max_precision;
   char *s, buffer[80];
   int eflag, error_ind = 0;
@@ -1331,16 +1480,31 @@ void gr_draw_contours(int nx, int ny, int nh, double *px, double *py, double *h,
       snprintf(contour_vars.lblfmt, 15, "%%.%d%c", max_precision, eflag ? 'e' : 'f');
     }
 
-  bitmap = (int *)xmalloc(nx * ny * ncv * 2 * sizeof(int));
   contour_vars.xmin = xmin;
   contour_vars.ymin = ymin;
   contour_vars.dx = dx;
   contour_vars.dy = dy;
 
-  calc_contours(contour_vars.z, nx, nx - xcnt, ny - ycnt, cv, ncv, mmax, bitmap, contour_vars.xmin, contour_vars.ymin,
-                contour_vars.dx, contour_vars.dy);
-
-  free(bitmap);
+  levels.z = contour_vars.z;
+  levels.nrz = nx;
+  levels.nx = nx - xcnt;
+  levels.ny = ny - ycnt;
+  levels.cv = cv;
+  levels.zmax = mmax;
+  levels.xmin = contour_vars.xmin;
+  levels.ymin = contour_vars.ymin;
+  levels.dx = contour_vars.dx;
+  levels.dy = contour_vars.dy;
+  paths = contour_paths(&levels, ncv);
+
+  /* emit the levels in order, labels are placed with respect to the previously drawn ones */
+  for (i = 0; i < ncv; i++)
+    {
+      for (k = 0; k < paths[i].n; k++)
+        {
+          draw(paths[i].x[k], paths[i].y[k], cv[i], paths[i].flags[k] % 10 + 10 * (i + 1));
+        }
+    }
 
   if (contour_vars.label_map != NULL) free(contour_vars.label_map);
   if (cv != h) free(cv);
@@ -1559,23 +1723,48 @@ static void march_triangles(double *x, double *y, double *z, int ntri, int *tria
   convert_segments_to_polylines(nlin, lin, nlines, lines);
 }
 
+/*
+ * The iso lines of the individual levels do not depend on each other, so they are extracted concurrently.
+ */
+static void march_levels(void *arg, int start, int end)
+{
+  tricont_levels_t *t = (tricont_levels_t *)arg;
+  int l;
+
+  for (l = start; l < end; l++)
+    {
+      t->nlines[l] = 0;
+      t->lines[l] = NULL;
+      march_triangles(t->x, t->y, t->z, t->ntri, t->triangles, t->levels[l], &t->nlines[l], &t->lines[l]);
+    }
+}
+
 void gr_draw_tricont(int npoints, double *x, double *y, double *z, int nlevels, double *levels, int *colors)
 {
   int i, l;
   int ntri, *triangles;
-  int nlines = 0;
-  polyline_t *lines = NULL;
+  tricont_levels_t t;
 
   gr_delaunay(npoints, x, y, &ntri, &triangles);
 
+  t.x = x;
+  t.y = y;
+  t.z = z;
+  t.ntri = ntri;
+  t.triangles = triangles;
+  t.levels = levels;
+  t.nlines = (int *)xmalloc(max(nlevels, 1) * sizeof(int));
+  t.lines = (polyline_t **)xmalloc(max(nlevels, 1) * sizeof(polyline_t *));
+  threadpool_parallel_for(nlevels, 1, march_levels, &t);
+
   for (l = 0; l < nlevels; l++)
     {
-      march_triangles(x, y, z, ntri, triangles, levels[l], &nlines, &lines);
-
       gr_setlinecolorind(colors[l]);
-      for (i = 0; i < nlines; i++) gr_polyline(lines[i].npoints, lines[i].x, lines[i].y);
+      for (i = 0; i < t.nlines[l]; i++) gr_polyline(t.lines[l][i].npoints, t.lines[l][i].x, t.lines[l][i].y);
 
-      free(lines);
+      free(t.lines[l]);
     }
+  free(t.nlines);
+  free(t.lines);
   free(triangles);
 }
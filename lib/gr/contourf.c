@@ -6,6 +6,7 @@
 
 #include "gr.h"
 #include "contourf.h"
+#include "threadpool.h"
 
 #ifndef NAN
 #define NAN (0.0 / 0.0)
@@ -37,6 +38,8 @@
 #define SADDLE1 (1 << 4)
 #define SADDLE2 (1 << 5)
 
+#define EDGE_ROWS_PER_CHUNK 16
+
 typedef struct
 {
   unsigned char *list;
@@ -45,6 +48,28 @@ typedef struct
   size_t _element_size;
 } _list_t;
 
+typedef struct
+{
+  const double *z;
+  long nx, ny;
+  double contour;
+  unsigned char *edges;
+} _edges_t;
+
+typedef struct
+{
+  _list_t *polylines_x, *polylines_y, *line_indices;
+} _level_lines_t;
+
+typedef struct
+{
+  const double *x, *y, *z;
+  long nx, ny;
+  double x_step, y_step;
+  const double *contours;
+  _level_lines_t *levels;
+} _levels_t;
+
 static _list_t *list_create(size_t initial_capacity, size_t element_size)
 {
   _list_t *list = (_list_t *)malloc(sizeof(_list_t));
@@ -267,6 +292,194 @@ static unsigned char check_saddle(const unsigned char edges)
   return ALL_EDGES;
 }
 
+/*
+ * Calculate the binary index of the marching squares algorithm for the rows `start` to `end - 1` of the padded z array
+ * and store it in `edges`.
+ */
+static void classify_cells(void *arg, int start, int end)
+{
+  const _edges_t *e = (const _edges_t *)arg;
+  const double *z = e->z;
+  long nx = e->nx, ny = e->ny, nx_padded = e->nx + 4, i, j;
+  double contour = e->contour;
+  unsigned char *edges = e->edges;
+
+  for (j = start; j < end; j++)
+    {
+      for (i = 0; i < nx_padded; i++)
+        {
+          unsigned char bitmask = get_bitmask(z, nx, ny, i, j, contour);
+          assert((edges[j * nx_padded + i] & ALL_EDGES) == 0 && "edge bit not cleared for previous iso value.");
+          edges[j * nx_padded + i] = 0;
+          if (bitmask == 1 || bitmask == 10 || bitmask == 14) /* bottom \ */
+            {
+              edges[j * nx_padded + i] |= EDGE_W | EDGE_S;
+            }
+          if (bitmask == 2 || bitmask == 5 || bitmask == 13) /* bottom / */
+            {
+              edges[j * nx_padded + i] |= EDGE_E | EDGE_S;
+            }
+          if (bitmask == 3 || bitmask == 12) /*         - */
+            {
+              edges[j * nx_padded + i] |= EDGE_W | EDGE_E;
+            }
+          if (bitmask == 6 || bitmask == 9) /*         | */
+            {
+              edges[j * nx_padded + i] |= EDGE_N | EDGE_S;
+            }
+          if (bitmask == 7 || bitmask == 8 || bitmask == 5) /* top     / */
+            {
+              edges[j * nx_padded + i] |= EDGE_N | EDGE_W;
+            }
+          if (bitmask == 4 || bitmask == 10 || bitmask == 11) /* top     \ */
+            {
+              edges[j * nx_padded + i] |= EDGE_N | EDGE_E;
+            }
+          if (bitmask == 5 || bitmask == 10)
+            {
+              /*
+               * Handle saddle points (ambiguous case) depending on average value of
+               * the four corner points of the cell.
+               */
+              double midpoint =
+                  (padded_array_lookup(z, nx, ny, i, j) + padded_array_lookup(z, nx, ny, i + 1, j) +
+                   padded_array_lookup(z, nx, ny, i + 1, j + 1) + padded_array_lookup(z, nx, ny, i, j + 1)) /
+                      4.0 >=
+                  contour;
+              if ((bitmask == 5 && midpoint) || (bitmask == 10 && !midpoint))
+                {
+                  edges[j * nx_padded + i] |= SADDLE1;
+                }
+              else
+                {
+                  edges[j * nx_padded + i] |= SADDLE2;
+                }
+            }
+        }
+    }
+}
+
+/*
+ * Find and follow the connected polylines of a single contour level. `edges` must be cleared and is cleared again when
+ * all lines have been followed.
+ */
+static void trace_level(const _levels_t *ls, unsigned char *edges, size_t contour_index)
+{
+  const double *x = ls->x, *y = ls->y, *z = ls->z;
+  long nx = ls->nx, ny = ls->ny, nx_padded = ls->nx + 4, ny_padded = ls->ny + 4, i, j;
+  double x_step = ls->x_step, y_step = ls->y_step, x_pos = 0, y_pos = 0;
+  double contour = ls->contours[contour_index];
+  _level_lines_t *lines = ls->levels + contour_index;
+  _edges_t e;
+
+  e.z = z;
+  e.nx = nx;
+  e.ny = ny;
+  e.edges = edges;
+  e.contour = contour;
+  threadpool_parallel_for(ny_padded, EDGE_ROWS_PER_CHUNK, classify_cells, &e);
+
+  for (j = 0; j < ny_padded; j++)
+    {
+      for (i = 0; i < nx_padded; i++)
+        {
+          if (edges[j * nx_padded + i] & ALL_EDGES) /* Start of a new polyline found */
+            {
+              long xi = i;
+              long yi = j;
+
+              size_t polyline_start_index = lines->polylines_x->size;
+              list_append(lines->line_indices, &polyline_start_index);
+
+              /*
+               * Follow polyline until start point is reached again. When adding a line segment
+               * to the polyline, remove the corresponding EDGE_* bit from the cell and the
+               * corresponding bit of the following cell in the line.
+               */
+              while (edges[yi * nx_padded + xi] & ALL_EDGES)
+                {
+                  unsigned char saddle = check_saddle(edges[yi * nx_padded + xi]);
+                  if (edges[yi * nx_padded + xi] & saddle & EDGE_N)
+                    {
+                      x_pos = padded_array_lookup_1d(x, nx, xi) +
+                              x_step * interpolate_edge(z, nx, ny, xi, xi + 1, yi, yi, contour);
+                      y_pos = padded_array_lookup_1d(y, ny, yi);
+                      edges[yi * nx_padded + xi] &= ~EDGE_N;
+                      yi--;
+                      assert(edges[yi * nx_padded + xi] | EDGE_S);
+                      edges[yi * nx_padded + xi] &= ~EDGE_S;
+                    }
+                  else if (edges[yi * nx_padded + xi] & saddle & EDGE_E)
+                    {
+                      x_pos = padded_array_lookup_1d(x, nx, xi + 1);
+                      y_pos = padded_array_lookup_1d(y, ny, yi) +
+                              y_step * interpolate_edge(z, nx, ny, xi + 1, xi + 1, yi, yi + 1, contour);
+                      edges[yi * nx_padded + xi] &= ~EDGE_E;
+                      xi++;
+                      assert(edges[yi * nx_padded + xi] | EDGE_W);
+                      edges[yi * nx_padded + xi] &= ~EDGE_W;
+                    }
+                  else if (edges[yi * nx_padded + xi] & saddle & EDGE_S)
+                    {
+                      x_pos = padded_array_lookup_1d(x, nx, xi) +
+                              x_step * interpolate_edge(z, nx, ny, xi, xi + 1, yi + 1, yi + 1, contour);
+                      y_pos = padded_array_lookup_1d(y, ny, yi + 1);
+                      edges[yi * nx_padded + xi] &= ~EDGE_S;
+                      yi++;
+                      assert(edges[yi * nx_padded + xi] | EDGE_N);
+                      edges[yi * nx_padded + xi] &= ~EDGE_N;
+                    }
+                  else if (edges[yi * nx_padded + xi] & saddle & EDGE_W)
+                    {
+                      x_pos = padded_array_lookup_1d(x, nx, xi);
+                      y_pos = padded_array_lookup_1d(y, ny, yi) +
+                              y_step * interpolate_edge(z, nx, ny, xi, xi, yi, yi + 1, contour);
+                      edges[yi * nx_padded + xi] &= ~EDGE_W;
+                      xi--;
+                      assert(edges[yi * nx_padded + xi] | EDGE_E);
+                      edges[yi * nx_padded + xi] &= ~EDGE_E;
+                    }
+
+                  if (!is_nan(x_pos) && !is_nan(y_pos))
+                    {
+                      list_append(lines->polylines_x, &x_pos);
+                      list_append(lines->polylines_y, &y_pos);
+                    }
+                }
+              assert(xi == i && yi == j && "contour line is not closed.");
+              /* Repeat first polyline point to get a closed line */
+              x_pos = *(((double *)lines->polylines_x->list) + polyline_start_index);
+              y_pos = *(((double *)lines->polylines_y->list) + polyline_start_index);
+              list_append(lines->polylines_x, &x_pos);
+              list_append(lines->polylines_y, &y_pos);
+
+              /* end each separate filled area with NAN */
+              x_pos = y_pos = NAN;
+              list_append(lines->polylines_x, &x_pos);
+              list_append(lines->polylines_y, &y_pos);
+            }
+        }
+    }
+}
+
+/*
+ * The levels do not depend on each other, so each range of levels is traced with its own edge buffer.
+ */
+static void trace_levels(void *arg, int start, int end)
+{
+  const _levels_t *ls = (const _levels_t *)arg;
+  unsigned char *edges;
+  int contour_index;
+
+  edges = calloc((ls->nx + 4) * (ls->ny + 4), sizeof(unsigned char));
+  assert(edges);
+  for (contour_index = start; contour_index < end; contour_index++)
+    {
+      trace_level(ls, edges, contour_index);
+    }
+  free(edges);
+}
+
 static void marching_squares(const double *x, const double *y, const double *z, long nx, long ny,
                              const double *contours, size_t nc, int first_color, int last_color, int draw_polylines)
 {
@@ -279,16 +492,12 @@ static void marching_squares(const double *x, const double *y, const double *z,
    */
   double x_step = 0, y_step = 0;
 
-  double x_pos = 0, y_pos = 0;
-  long i, j, fillarea_start_index, num_lines;
+  long i, j, num_lines;
   size_t contour_index, polylines_end_indices, *line_ind;
   double color_step = 0;
 
-  _list_t *polylines_x, *polylines_y, *line_indices;
-
-  long nx_padded = nx + 4;
-  long ny_padded = ny + 4;
-  unsigned char *edges;
+  _level_lines_t *lines;
+  _levels_t ls;
 
   for (j = 0; j < ny; j++)
     {
@@ -317,194 +526,64 @@ static void marching_squares(const double *x, const double *y, const double *z,
     }
 
   /* Create list structures to store the polyline's vertices and the start index of each individual polyline */
-  polylines_x = list_create(nx * ny / 4, sizeof(double));
-  polylines_y = list_create(nx * ny / 4, sizeof(double));
-  line_indices = list_create(100, sizeof(size_t));
-
-  edges = calloc(nx_padded * ny_padded, sizeof(unsigned char));
-  assert(edges);
-
+  ls.levels = (_level_lines_t *)malloc((nc > 0 ? nc : 1) * sizeof(_level_lines_t));
+  assert(ls.levels);
+  for (contour_index = 0; contour_index < nc; contour_index++)
+    {
+      ls.levels[contour_index].polylines_x = list_create(2 * (nx + ny), sizeof(double));
+      ls.levels[contour_index].polylines_y = list_create(2 * (nx + ny), sizeof(double));
+      ls.levels[contour_index].line_indices = list_create(16, sizeof(size_t));
+    }
+  ls.x = x;
+  ls.y = y;
+  ls.z = z;
+  ls.nx = nx;
+  ls.ny = ny;
+  ls.x_step = x_step;
+  ls.y_step = y_step;
+  ls.contours = contours;
+  threadpool_parallel_for((int)nc, 1, trace_levels, &ls);
+
+  /* Fill all areas of each contour in order. Filling must use Even-Odd-Rule. */
   gr_setfillintstyle(1);
   for (contour_index = 0; contour_index < nc; contour_index++)
     {
       long n;
-      double contour = contours[contour_index];
-      fillarea_start_index = polylines_x->size;
-
-      /*
-       * Calculate the binary index of the marching squares algorithm for each cell of the padded z array\
-       * and store it in `edges`.
-       */
-      for (j = 0; j < ny_padded; j++)
-        {
-          for (i = 0; i < nx_padded; i++)
-            {
-              unsigned char bitmask = get_bitmask(z, nx, ny, i, j, contour);
-              assert((edges[j * nx_padded + i] & ALL_EDGES) == 0 && "edge bit not cleared for previous iso value.");
-              edges[j * nx_padded + i] = 0;
-              if (bitmask == 1 || bitmask == 10 || bitmask == 14) /* bottom \ */
-                {
-                  edges[j * nx_padded + i] |= EDGE_W | EDGE_S;
-                }
-              if (bitmask == 2 || bitmask == 5 || bitmask == 13) /* bottom / */
-                {
-                  edges[j * nx_padded + i] |= EDGE_E | EDGE_S;
-                }
-              if (bitmask == 3 || bitmask == 12) /*         - */
-                {
-                  edges[j * nx_padded + i] |= EDGE_W | EDGE_E;
-                }
-              if (bitmask == 6 || bitmask == 9) /*         | */
-                {
-                  edges[j * nx_padded + i] |= EDGE_N | EDGE_S;
-                }
-              if (bitmask == 7 || bitmask == 8 || bitmask == 5) /* top     / */
-                {
-                  edges[j * nx_padded + i] |= EDGE_N | EDGE_W;
-                }
-              if (bitmask == 4 || bitmask == 10 || bitmask == 11) /* top     \ */
-                {
-                  edges[j * nx_padded + i] |= EDGE_N | EDGE_E;
-                }
-              if (bitmask == 5 || bitmask == 10)
-                {
-                  /*
-                   * Handle saddle points (ambiguous case) depending on average value of
-                   * the four corner points of the cell.
-                   */
-                  double midpoint =
-                      (padded_array_lookup(z, nx, ny, i, j) + padded_array_lookup(z, nx, ny, i + 1, j) +
-                       padded_array_lookup(z, nx, ny, i + 1, j + 1) + padded_array_lookup(z, nx, ny, i, j + 1)) /
-                          4.0 >=
-                      contour;
-                  if ((bitmask == 5 && midpoint) || (bitmask == 10 && !midpoint))
-                    {
-                      edges[j * nx_padded + i] |= SADDLE1;
-                    }
-                  else
-                    {
-                      edges[j * nx_padded + i] |= SADDLE2;
-                    }
-                }
-            }
-        }
 
-      /* Find and follow connected polylines */
-      for (j = 0; j < ny_padded; j++)
-        {
-          for (i = 0; i < nx_padded; i++)
-            {
-              if (edges[j * nx_padded + i] & ALL_EDGES) /* Start of a new polyline found */
-                {
-                  long xi = i;
-                  long yi = j;
-
-                  size_t polyline_start_index = polylines_x->size;
-                  list_append(line_indices, &polyline_start_index);
-
-                  /*
-                   * Follow polyline until start point is reached again. When adding a line segment
-                   * to the polyline, remove the corresponding EDGE_* bit from the cell and the
-                   * corresponding bit of the following cell in the line.
-                   */
-                  while (edges[yi * nx_padded + xi] & ALL_EDGES)
-                    {
-                      unsigned char saddle = check_saddle(edges[yi * nx_padded + xi]);
-                      if (edges[yi * nx_padded + xi] & saddle & EDGE_N)
-                        {
-                          x_pos = padded_array_lookup_1d(x, nx, xi) +
-                                  x_step * interpolate_edge(z, nx, ny, xi, xi + 1, yi, yi, contour);
-                          y_pos = padded_array_lookup_1d(y, ny, yi);
-                          edges[yi * nx_padded + xi] &= ~EDGE_N;
-                          yi--;
-                          assert(edges[yi * nx_padded + xi] | EDGE_S);
-                          edges[yi * nx_padded + xi] &= ~EDGE_S;
-                        }
-                      else if (edges[yi * nx_padded + xi] & saddle & EDGE_E)
-                        {
-                          x_pos = padded_array_lookup_1d(x, nx, xi + 1);
-                          y_pos = padded_array_lookup_1d(y, ny, yi) +
-                                  y_step * interpolate_edge(z, nx, ny, xi + 1, xi + 1, yi, yi + 1, contour);
-                          edges[yi * nx_padded + xi] &= ~EDGE_E;
-                          xi++;
-                          assert(edges[yi * nx_padded + xi] | EDGE_W);
-                          edges[yi * nx_padded + xi] &= ~EDGE_W;
-                        }
-                      else if (edges[yi * nx_padded + xi] & saddle & EDGE_S)
-                        {
-                          x_pos = padded_array_lookup_1d(x, nx, xi) +
-                                  x_step * interpolate_edge(z, nx, ny, xi, xi + 1, yi + 1, yi + 1, contour);
-                          y_pos = padded_array_lookup_1d(y, ny, yi + 1);
-                          edges[yi * nx_padded + xi] &= ~EDGE_S;
-                          yi++;
-                          assert(edges[yi * nx_padded + xi] | EDGE_N);
-                          edges[yi * nx_padded + xi] &= ~EDGE_N;
-                        }
-                      else if (edges[yi * nx_padded + xi] & saddle & EDGE_W)
-                        {
-                          x_pos = padded_array_lookup_1d(x, nx, xi);
-                          y_pos = padded_array_lookup_1d(y, ny, yi) +
-                                  y_step * interpolate_edge(z, nx, ny, xi, xi, yi, yi + 1, contour);
-                          edges[yi * nx_padded + xi] &= ~EDGE_W;
-                          xi--;
-                          assert(edges[yi * nx_padded + xi] | EDGE_E);
-                          edges[yi * nx_padded + xi] &= ~EDGE_E;
-                        }
-
-                      if (!is_nan(x_pos) && !is_nan(y_pos))
-                        {
-                          list_append(polylines_x, &x_pos);
-                          list_append(polylines_y, &y_pos);
-                        }
-                    }
-                  assert(xi == i && yi == j && "contour line is not closed.");
-                  /* Repeat first polyline point to get a closed line */
-                  x_pos = *(((double *)polylines_x->list) + polyline_start_index);
-                  y_pos = *(((double *)polylines_y->list) + polyline_start_index);
-                  list_append(polylines_x, &x_pos);
-                  list_append(polylines_y, &y_pos);
-
-                  /* end each separate filled area with NAN */
-                  x_pos = y_pos = NAN;
-                  list_append(polylines_x, &x_pos);
-                  list_append(polylines_y, &y_pos);
-                }
-            }
-        }
-      /* Fill all areas for the current contour. Filling must use Even-Odd-Rule. */
-      n = polylines_x->size - fillarea_start_index;
+      lines = ls.levels + contour_index;
+      n = lines->polylines_x->size;
       if (n > 2)
         {
           gr_setfillcolorind(first_color + (int)floor(color_step * contour_index));
-          gr_fillarea(n, (double *)list_get(polylines_x, fillarea_start_index),
-                      (double *)list_get(polylines_y, fillarea_start_index));
+          gr_fillarea(n, (double *)list_get(lines->polylines_x, 0), (double *)list_get(lines->polylines_y, 0));
         }
     }
-  free(edges);
 
-  num_lines = line_indices->size;
-  if (!draw_polylines)
+  /* Draw contour lines for all `contour` values */
+  for (contour_index = 0; contour_index < nc; contour_index++)
     {
-      num_lines = 0;
-    }
+      lines = ls.levels + contour_index;
+      num_lines = draw_polylines ? (long)lines->line_indices->size : 0;
 
-  polylines_end_indices = polylines_x->size;
-  list_append(line_indices, &(polylines_end_indices));
-  line_ind = (size_t *)line_indices->list;
+      polylines_end_indices = lines->polylines_x->size;
+      list_append(lines->line_indices, &(polylines_end_indices));
+      line_ind = (size_t *)lines->line_indices->list;
 
-  /* Draw contour lines for all `contour` values */
-  for (i = 0; i < num_lines; i++)
-    {
-      long n =
-          line_ind[i + 1] - line_ind[i] - 1; /* Remove (0, 0) points which are required for filling from polyline. */
-      if (n >= 2)
+      for (i = 0; i < num_lines; i++)
         {
-          gr_polyline(n, (double *)list_get(polylines_x, line_ind[i]), (double *)list_get(polylines_y, line_ind[i]));
+          long n = line_ind[i + 1] - line_ind[i] -
+                   1; /* Remove (0, 0) points which are required for filling from polyline. */
+          if (n >= 2)
+            {
+              gr_polyline(n, (double *)list_get(lines->polylines_x, line_ind[i]),
+                          (double *)list_get(lines->polylines_y, line_ind[i]));
+            }
         }
+      list_destroy(lines->polylines_x);
+      list_destroy(lines->polylines_y);
+      list_destroy(lines->line_indices);
     }
-  list_destroy(polylines_x);
-  list_destroy(polylines_y);
-  list_destroy(line_indices);
+  free(ls.levels);
 }
 
 void gr_draw_contourf(int nx, int ny, int nh, double *px, double *py, double *h, double *pz, int first_color,
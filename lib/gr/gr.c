@@ -71,6 +71,7 @@ typedef SSIZE_T ssize_t;
 #include "cm.h"
 #include "boundary.h"
 #include "threadpool.h"
+#include "radixsort.h"
 
 #ifndef R_OK
 #define R_OK 4
@@ -82,6 +83,15 @@ typedef SSIZE_T ssize_t;
 #define M_PI (3.141592653589793)
 #endif
 
+#define VOLUME_BLOCK_SIZE 8
+#define VOLUME_ABSORPTION_LIMIT 746 /* exp(-x) is zero in double precision beyond this optical depth */
+#define VOLUME_NOGRID_TILE_SIZE 32
+#define VOLUME_NOGRID_POINTS_PER_CHUNK 4096
+#define VOLUME_NOGRID_BATCH_POINTS 65536
+#define VOLUME_NOGRID_BATCH_ENTRIES 262144
+#define LATEX_IMAGE_CACHE_SIZE 32
+#define LATEX_IMAGE_CACHE_MAX_PIXELS (16 * 1024 * 1024)
+
 #define RAYCASTING_CEIL(x) ((x > 0) ? round(x + 0.50000001) : (floor(x + 1.00000001)))
 #define RAYCASTING_FLOOR(x) (round(x - 0.50000001))
 
@@ -191,18 +201,54 @@ typedef struct
   ssize_t max_non_null_id;
 } state_list_vector;
 
+typedef struct
+{
+  norm_xform nx;
+  linear_xform lx;
+  world_xform wx;
+  transformation_xform tx;
+  projection_xform gpx;
+  interaction_xform ix;
+  double txoff[2];
+  double vxmin, vxmax, vymin, vymax;
+  double cxl, cxr, cyf, cyb, czb, czt;
+  int arrow_style;
+  double arrow_size;
+  int scientific_format;
+  state_list *ctx;
+  state_list ctx_state;
+} capture_state;
+
+struct gr_capture_priv
+{
+  gks_capture_t gks;
+  capture_state begin, end;
+  int uses_linespec;
+  int replayable;
+};
+
 typedef struct
 {
   int a, b, c;
   double sp;
 } triangle_with_distance;
 
+typedef struct
+{
+  const double *data;
+  int nx, ny, nz;
+  int bnx, bny, bnz;
+  double *block_min, *block_max;
+  double data_min;
+} volume_blocks_t;
+
 struct ray_casting_attr
 {
   int nx, ny, nz;
   int algorithm;
   double *data, *dmin_ptr, *dmax_ptr;
   double *min_val, *max_val, *pixels;
+  const volume_blocks_t *blocks;
 };
 
 struct thread_attr
@@ -237,14 +283,26 @@ typedef struct text_node
   double baseline[2];
 } text_node_t;
 
+typedef struct
+{
+  int x_start, x_fin, y_start, y_fin;
+  double x, y, x_radius, y_radius;
+} volume_nogrid_splat_t;
+
 typedef struct
 {
   int px_width, px_height;
-  const data_point3d_t *start, *end;
-  kernel_f callback;
+  size_t num_points;
+  const data_point3d_t *dt_pts;
   const void **extra_data;
+  kernel_f callback;
   double radius;
   radius_f radius_callback;
+  double *positions;
+  size_t batch_first;
+  volume_nogrid_splat_t *splats;
+  int tiles_x, tiles_y;
+  const size_t *tile_start, *tile_points;
   double *pixels;
   const point3d_t *ray_dir_init;
   const point3d_t *ray_dir_x;
@@ -260,6 +318,71 @@ struct cpubasedvolume_2pass_priv
   double *pixels;
 };
 
+typedef struct
+{
+  size_t key_size;
+  char *key;
+  int width, height;
+  int *img_data;
+} raster_cache_t;
+
+typedef struct
+{
+  const int *color;
+  int dimx;
+  const int *col_map, *row_map;
+  int width;
+  int *img_data;
+} nonuniformcellarray_raster_t;
+
+typedef struct
+{
+  double phimin, phimax, rmin, rmax;
+  int dimphi, dimr, ncol;
+  int r_reverse, phi_wrapped_reverse;
+  const int *color;
+  int width, height;
+  int *img_data;
+} polarcellarray_raster_t;
+
+typedef struct
+{
+  double phimin, phimax, rmin, rmax;
+  const double *r_sorted, *phi_sorted;
+  int num_r, num_phi, ncol;
+  int r_reverse, phi_reverse;
+  const int *color;
+  int width, height;
+  int *img_data;
+} nonuniformpolarcellarray_raster_t;
+
+typedef struct
+{
+  int x_log, y_log;
+  double ax, bx, ay, by;
+} wc_ndc_xform_t;
+
+typedef struct
+{
+  int valid;
+  int nbins;
+  double vxmin, vxmax, vymin, vymax;
+  wc_ndc_xform_t xform;
+  int jmax, imax, lmax, iinc, lat;
+  double size, shape, ycorr;
+  double xmin, ymin, c1, c2;
+  int thread_count;
+  int **thread_cnt;
+} hexbin_layout_t;
+
+typedef struct
+{
+  const double *x, *y;
+  int start, end;
+  const hexbin_layout_t *layout;
+  int *cnt;
+} hexbin_binning_data_t;
+
 struct hexbin_2pass_priv
 {
   int *cell;
@@ -323,6 +446,7 @@ static int arrow_style = 0;
 static double arrow_size = 1;
 
 static int flag_printing = 0, flag_stream = 0, flag_graphics = 0;
+static gr_capture_t *active_capture = NULL;
 
 static text_node_t *text, *head;
 
@@ -337,6 +461,31 @@ static int first_color = DEFAULT_FIRST_COLOR, last_color = DEFAULT_LAST_COLOR;
 
 static unsigned int rgb[MAX_COLOR], used[MAX_COLOR];
 
+/*
+ * gr_inqcolorfromrgb hands out the color indices RGB_COLOR_FIRST to RGB_COLOR_END - 1. To avoid scanning them on every
+ * call, these indices are kept in hash buckets keyed on their packed RGB value and in the cells of a coarse grid over
+ * the weighted RGB space of the nearest color search. setcolorrep keeps both in sync, `first_unused` is the lowest
+ * index which has not been handed out yet.
+ */
+
+#define RGB_COLOR_FIRST 80
+#define RGB_COLOR_END 980
+#define RGB_HASH_SIZE 1024
+#define RGB_GRID_CELL 0.0275
+#define RGB_GRID_R 11 /* 0.30 / RGB_GRID_CELL */
+#define RGB_GRID_G 22 /* 0.59 / RGB_GRID_CELL */
+#define RGB_GRID_B 4  /* 0.11 / RGB_GRID_CELL */
+
+static struct
+{
+  int initialized;
+  int bucket[RGB_HASH_SIZE], next_in_bucket[RGB_COLOR_END], prev_in_bucket[RGB_COLOR_END];
+  int cell[RGB_GRID_R * RGB_GRID_G * RGB_GRID_B], next_in_cell[RGB_COLOR_END], prev_in_cell[RGB_COLOR_END];
+  int cell_of[RGB_COLOR_END];
+  double rep[RGB_COLOR_END][3];
+  int first_unused;
+} color_lookup;
+
 #define MAX_TICKS 500
 
 #define check_autoinit \
@@ -364,6 +513,15 @@ static unsigned int rgb[MAX_COLOR], used[MAX_COLOR];
 
 #define POINT_INC 2048
 
+#define HEXBIN_MIN_POINTS_PER_THREAD 100000
+#define DEPTH_SORT_MIN_KEYS_PER_THREAD 100000
+
+#define RASTER_MAX_SIZE 8192
+#define RASTER_CACHE_MAX_PIXELS (2048 * 2048)
+#define RASTER_ROWS_PER_CHUNK 16
+
+#define FACETS_PER_BATCH 8192
+
 #define RESOLUTION_X 4096
 #define BACKGROUND 0
 
@@ -968,6 +1126,32 @@ static char *xrealloc(void *ptr, int size)
   return (result);
 }
 
+/*
+ * Rasters of the cell array functions kept for redrawing the same data, see `raster_cache_lookup`. Rasters with more
+ * than RASTER_CACHE_MAX_PIXELS elements are released right after drawing, all of them when GKS or a workstation is
+ * closed.
+ */
+static raster_cache_t nonuniformcellarray_cache, polarcellarray_cache, nonuniformpolarcellarray_cache;
+
+static void raster_cache_release(raster_cache_t *cache)
+{
+  free(cache->key);
+  free(cache->img_data);
+  memset(cache, 0, sizeof(raster_cache_t));
+}
+
+static void raster_cache_trim(raster_cache_t *cache)
+{
+  if ((size_t)cache->width * cache->height > RASTER_CACHE_MAX_PIXELS) raster_cache_release(cache);
+}
+
+static void release_raster_caches(void)
+{
+  raster_cache_release(&nonuniformcellarray_cache);
+  raster_cache_release(&polarcellarray_cache);
+  raster_cache_release(&nonuniformpolarcellarray_cache);
+}
+
 static void reallocate(int npoints)
 {
   while (npoints >= maxpath) maxpath += POINT_INC;
@@ -1003,6 +1187,22 @@ minmax_t find_minmax(int n, double *values)
   return (minmax_t){min, max};
 }
 
+static int worker_thread_count(int n, int min_items_per_thread)
+{
+  int thread_count;
+
+  thread_count = threadpool_get_num_threads();
+  if (thread_count > n / min_items_per_thread)
+    {
+      thread_count = n / min_items_per_thread;
+    }
+  if (thread_count < 1)
+    {
+      thread_count = 1;
+    }
+  return thread_count;
+}
+
 static double x_lin(double x)
 {
   double result;
@@ -1476,6 +1676,93 @@ static void resetgks(void)
 #endif
 
 
+static int rgb_hash(unsigned int rgbmask)
+{
+  return (int)(((rgbmask * 2654435761UL) & 0xffffffffUL) >> 22) & (RGB_HASH_SIZE - 1);
+}
+
+static int rgb_grid_coordinate(double value, int size)
+{
+  int i = (int)(value / RGB_GRID_CELL);
+
+  return i < 0 ? 0 : (i >= size ? size - 1 : i);
+}
+
+static int rgb_grid_cell(double red, double green, double blue)
+{
+  return (rgb_grid_coordinate(0.30 * red, RGB_GRID_R) * RGB_GRID_G + rgb_grid_coordinate(0.59 * green, RGB_GRID_G)) *
+             RGB_GRID_B +
+         rgb_grid_coordinate(0.11 * blue, RGB_GRID_B);
+}
+
+static void link_color(int color, int *head, int *next, int *prev)
+{
+  prev[color] = -1;
+  next[color] = *head;
+  if (*head >= 0) prev[*head] = color;
+  *head = color;
+}
+
+static void unlink_color(int color, int *head, int *next, int *prev)
+{
+  if (prev[color] >= 0)
+    next[prev[color]] = next[color];
+  else
+    *head = next[color];
+  if (next[color] >= 0) prev[next[color]] = prev[color];
+}
+
+static void init_color_lookup(void)
+{
+  int i, color;
+  double *rep;
+
+  for (i = 0; i < RGB_HASH_SIZE; i++) color_lookup.bucket[i] = -1;
+  for (i = 0; i < RGB_GRID_R * RGB_GRID_G * RGB_GRID_B; i++) color_lookup.cell[i] = -1;
+
+  for (color = RGB_COLOR_FIRST; color < RGB_COLOR_END; color++)
+    {
+      link_color(color, color_lookup.bucket + rgb_hash(rgb[color]), color_lookup.next_in_bucket,
+                 color_lookup.prev_in_bucket);
+      rep = color_lookup.rep[color];
+      color_lookup.cell_of[color] = rgb_grid_cell(rep[0], rep[1], rep[2]);
+      link_color(color, color_lookup.cell + color_lookup.cell_of[color], color_lookup.next_in_cell,
+                 color_lookup.prev_in_cell);
+    }
+  color_lookup.first_unused = RGB_COLOR_FIRST;
+  color_lookup.initialized = 1;
+}
+
+static void update_color_lookup(int color, unsigned int rgbmask, double red, double green, double blue)
+{
+  int cell;
+
+  if (!color_lookup.initialized) return;
+
+  if (rgb_hash(rgb[color]) != rgb_hash(rgbmask))
+    {
+      unlink_color(color, color_lookup.bucket + rgb_hash(rgb[color]), color_lookup.next_in_bucket,
+                   color_lookup.prev_in_bucket);
+      link_color(color, color_lookup.bucket + rgb_hash(rgbmask), color_lookup.next_in_bucket,
+                 color_lookup.prev_in_bucket);
+    }
+
+  /* GKS rejects invalid color representations, so the nearest color search must not see them either */
+  if (red < 0 || red > 1 || green < 0 || green > 1 || blue < 0 || blue > 1) return;
+
+  color_lookup.rep[color][0] = red;
+  color_lookup.rep[color][1] = green;
+  color_lookup.rep[color][2] = blue;
+  cell = rgb_grid_cell(red, green, blue);
+  if (cell != color_lookup.cell_of[color])
+    {
+      unlink_color(color, color_lookup.cell + color_lookup.cell_of[color], color_lookup.next_in_cell,
+                   color_lookup.prev_in_cell);
+      link_color(color, color_lookup.cell + cell, color_lookup.next_in_cell, color_lookup.prev_in_cell);
+      color_lookup.cell_of[color] = cell;
+    }
+}
+
 static void initgks(void)
 {
   int state, errfil = 0, wkid = 1, errind, conid, wtype, color;
@@ -1516,7 +1803,14 @@ static void initgks(void)
       gks_inq_color_rep(wkid, color, GKS_K_VALUE_SET, &errind, &r, &g, &b);
       rgb[color] = ((nint(r * 255) & 0xff)) | ((nint(g * 255) & 0xff) << 8) | ((nint(b * 255) & 0xff) << 16);
       used[color] = 0;
+      if (color >= RGB_COLOR_FIRST && color < RGB_COLOR_END)
+        {
+          color_lookup.rep[color][0] = r;
+          color_lookup.rep[color][1] = g;
+          color_lookup.rep[color][2] = b;
+        }
     }
+  init_color_lookup();
 
   if (gks_getenv("GKS_NO_EXIT_HANDLER") == NULL)
     {
@@ -1555,6 +1849,7 @@ void gr_opengks(void)
 void gr_closegks(void)
 {
   gks_close_gks();
+  release_raster_caches();
   autoinit = 1;
 }
 
@@ -1659,6 +1954,7 @@ void gr_openws(int workstation_id, char *connection, int type)
 void gr_closews(int workstation_id)
 {
   gks_close_ws(workstation_id);
+  release_raster_caches();
 }
 
 /*!
@@ -2003,6 +2299,107 @@ void gr_cellarray(double xmin, double xmax, double ymin, double ymax, int dimx,
     }
 }
 
+/*
+ * Determine the size of an intermediate raster covering `ndc_width` x `ndc_height` of the current viewport, so that
+ * one raster element corresponds to one device pixel of the active workstation. If no workstation can be queried,
+ * the previously used fixed size is returned.
+ */
+static void device_raster_size(double ndc_width, double ndc_height, int *width, int *height)
+{
+  int n = 1, errind, ol, wkid, vp_width, vp_height;
+  double device_pixel_ratio, w, h;
+
+  *width = *height = (int)(2000 * scale_factor);
+
+  gks_inq_open_ws(n, &errind, &ol, &wkid);
+  if (errind != GKS_K_NO_ERROR || ol < 1) return;
+  gks_inq_vp_size(wkid, &errind, &vp_width, &vp_height, &device_pixel_ratio);
+  if (errind != GKS_K_NO_ERROR || vp_width <= 0 || vp_height <= 0 || vxmax <= vxmin || vymax <= vymin) return;
+
+  w = ceil(fabs(ndc_width) / (vxmax - vxmin) * vp_width * device_pixel_ratio);
+  h = ceil(fabs(ndc_height) / (vymax - vymin) * vp_height * device_pixel_ratio);
+  *width = (int)max(1, min(w, RASTER_MAX_SIZE));
+  *height = (int)max(1, min(h, RASTER_MAX_SIZE));
+}
+
+/*
+ * Check whether `cache` holds a raster of the given size which was computed from the same inputs. The inputs are
+ * given as `num_parts` memory blocks and compared byte by byte with a copy taken when the raster was computed. On a
+ * miss, the copy is replaced, a raster of the requested size is allocated and 0 is returned; the caller then has to
+ * fill `cache->img_data`.
+ */
+static int raster_cache_lookup(raster_cache_t *cache, int num_parts, const void **parts, const size_t *sizes,
+                               int width, int height)
+{
+  size_t key_size = 0, offset;
+  int i;
+
+  for (i = 0; i < num_parts; i++)
+    {
+      key_size += sizes[i];
+    }
+
+  if (cache->img_data != NULL && cache->width == width && cache->height == height && cache->key_size == key_size)
+    {
+      offset = 0;
+      for (i = 0; i < num_parts; i++)
+        {
+          if (memcmp(cache->key + offset, parts[i], sizes[i]) != 0) break;
+          offset += sizes[i];
+        }
+      if (i == num_parts) return 1;
+    }
+
+  if (cache->key_size != key_size)
+    {
+      free(cache->key);
+      cache->key = (char *)xmalloc(key_size > 0 ? key_size : 1);
+      cache->key_size = key_size;
+    }
+  offset = 0;
+  for (i = 0; i < num_parts; i++)
+    {
+      memcpy(cache->key + offset, parts[i], sizes[i]);
+      offset += sizes[i];
+    }
+  if (cache->img_data == NULL || cache->width * cache->height != width * height)
+    {
+      free(cache->img_data);
+      cache->img_data = (int *)xmalloc(width * height * sizeof(int));
+    }
+  cache->width = width;
+  cache->height = height;
+
+  return 0;
+}
+
+static void nonuniformcellarray_rows(void *arg, int start, int end)
+{
+  nonuniformcellarray_raster_t *raster = (nonuniformcellarray_raster_t *)arg;
+  int img_data_x, img_data_y, color_ind, width = raster->width;
+  const int *color_row, *col_map = raster->col_map;
+  int *img_row;
+
+  for (img_data_y = start; img_data_y < end; img_data_y++)
+    {
+      color_row = raster->color + raster->row_map[img_data_y] * raster->dimx;
+      img_row = raster->img_data + img_data_y * width;
+      for (img_data_x = 0; img_data_x < width; img_data_x++)
+        {
+          color_ind = color_row[col_map[img_data_x]];
+          if (color_ind >= 0 && color_ind < MAX_COLOR)
+            {
+              img_row[img_data_x] = (255 << 24) + rgb[color_ind];
+            }
+          else
+            {
+              /* invalid color indices in input data result in transparent pixel */
+              img_row[img_data_x] = 0;
+            }
+        }
+    }
+}
+
 /*!
  * Display a two dimensional color index array with nonuniform cell sizes.
  *
@@ -2051,9 +2448,11 @@ void gr_cellarray(double xmin, double xmax, double ymin, double ymax, int dimx,
 void gr_nonuniformcellarray(double *x, double *y, int dimx, int dimy, int scol, int srow, int ncol, int nrow,
                             int *color)
 {
-  int img_data_x, img_data_y, color_x_ind, color_y_ind, color_ind, edges_x = 1, edges_y = 1,
-                                                                   size = (int)(2000 * scale_factor), scale_options;
-  int *img_data;
+  raster_cache_t *cache = &nonuniformcellarray_cache;
+  int img_data_x, img_data_y, color_x_ind, color_y_ind, edges_x = 1, edges_y = 1, width, height, scale_options;
+  int params[6];
+  const void *parts[5];
+  size_t sizes[5];
   double x_pos, y_pos, x_size, y_size, *x_orig = x, *y_orig = y;
   double xmin, xmax, ymin, ymax;
 
@@ -2167,59 +2566,224 @@ void gr_nonuniformcellarray(double *x, double *y, int dimx, int dimy, int scol,
         }
     }
 
-  x_size = x[ncol] - x[scol];
-  y_size = y[nrow] - y[srow];
-  img_data = (int *)xmalloc(size * size * sizeof(int));
+  scale_options = lx.scale_options;
+  if (scale_options & GR_OPTION_FLIP_X)
+    {
+      double tmp = xmin;
+      xmin = xmax;
+      xmax = tmp;
+    }
+  if (scale_options & GR_OPTION_FLIP_Y)
+    {
+      double tmp = ymin;
+      ymin = ymax;
+      ymax = tmp;
+    }
+
+  device_raster_size(nx.a * (xmax - xmin), nx.c * (ymax - ymin), &width, &height);
 
-  color_y_ind = srow;
-  for (img_data_y = 0; img_data_y < size; img_data_y++)
+  params[0] = dimx;
+  params[1] = scol;
+  params[2] = srow;
+  params[3] = ncol;
+  params[4] = nrow;
+  params[5] = scale_options;
+  parts[0] = params;
+  sizes[0] = sizeof(params);
+  parts[1] = x + scol;
+  sizes[1] = (ncol - scol + 1) * sizeof(double);
+  parts[2] = y + srow;
+  sizes[2] = (nrow - srow + 1) * sizeof(double);
+  parts[3] = color + srow * dimx + scol;
+  sizes[3] = ((nrow - 1 - srow) * dimx + ncol - scol) * sizeof(int);
+  parts[4] = rgb;
+  sizes[4] = sizeof(rgb);
+
+  if (!raster_cache_lookup(cache, 5, parts, sizes, width, height))
     {
-      y_pos = y[srow] + img_data_y * y_size / size;
-      while (color_y_ind < nrow && y[color_y_ind + 1] <= y_pos)
-        {
-          color_y_ind++;
-        }
+      nonuniformcellarray_raster_t raster;
+      int *col_map, *row_map;
+
+      x_size = x[ncol] - x[scol];
+      y_size = y[nrow] - y[srow];
+
+      /* map every raster column and row to the cell it falls into */
+      col_map = (int *)xmalloc(width * sizeof(int));
       color_x_ind = scol;
-      for (img_data_x = 0; img_data_x < size; img_data_x++)
+      for (img_data_x = 0; img_data_x < width; img_data_x++)
         {
-          x_pos = x[scol] + img_data_x * x_size / size;
+          x_pos = x[scol] + img_data_x * x_size / width;
           while (color_x_ind < ncol && x[color_x_ind + 1] <= x_pos)
             {
               color_x_ind++;
             }
-          color_ind = color[color_y_ind * dimx + color_x_ind];
+          col_map[img_data_x] = color_x_ind;
+        }
+      row_map = (int *)xmalloc(height * sizeof(int));
+      color_y_ind = srow;
+      for (img_data_y = 0; img_data_y < height; img_data_y++)
+        {
+          y_pos = y[srow] + img_data_y * y_size / height;
+          while (color_y_ind < nrow && y[color_y_ind + 1] <= y_pos)
+            {
+              color_y_ind++;
+            }
+          row_map[img_data_y] = color_y_ind;
+        }
+
+      raster.color = color;
+      raster.dimx = dimx;
+      raster.col_map = col_map;
+      raster.row_map = row_map;
+      raster.width = width;
+      raster.img_data = cache->img_data;
+      threadpool_parallel_for(height, RASTER_ROWS_PER_CHUNK, nonuniformcellarray_rows, &raster);
+
+      free(row_map);
+      free(col_map);
+    }
+
+  lx.scale_options = 0;
+  gr_drawimage(xmin, xmax, ymin, ymax, width, height, cache->img_data, 0);
+  raster_cache_trim(cache);
+  lx.scale_options = scale_options;
+
+  gks_free(x);
+  gks_free(y);
+}
+
+static void polarcellarray_rows(void *arg, int start, int end)
+{
+  polarcellarray_raster_t *raster = (polarcellarray_raster_t *)arg;
+  int x, y, color_ind, r_ind, phi_ind, dimr = raster->dimr, dimphi = raster->dimphi;
+  double r, phi, px, py, rmin = raster->rmin, rmax = raster->rmax, phimin = raster->phimin, phimax = raster->phimax;
+  double center_x = raster->width / 2., center_y = raster->height / 2.;
+  int *img_row;
+
+  for (y = start; y < end; y++)
+    {
+      img_row = raster->img_data + y * raster->width;
+      py = (y - center_y) / center_y;
+      for (x = 0; x < raster->width; x++)
+        {
+          px = (x - center_x) / center_x;
+          r = sqrt(px * px + py * py);
+          phi = atan2(py, px);
+          if (phi < min(phimin, phimax))
+            {
+              phi += 2 * M_PI;
+            }
+
+          /* map phi from [phimin, phimax] to [0, 1] */
+          phi = (phi - phimin) / (phimax - phimin);
+
+          if (r * rmax < rmin || r >= 1 || phi < 0 || phi > 1)
+            {
+              img_row[x] = 0;
+              continue;
+            }
+          r = (r * rmax - rmin) / (rmax - rmin);
+          r_ind = (int)(r * dimr);
+          phi_ind = (int)(phi * dimphi) % dimphi;
+          if (raster->r_reverse)
+            {
+              r_ind = dimr - r_ind - 1;
+            }
+          if (raster->phi_wrapped_reverse)
+            {
+              phi_ind = dimphi - phi_ind - 1;
+            }
+          color_ind = raster->color[r_ind * raster->ncol + phi_ind];
           if (color_ind >= 0 && color_ind < MAX_COLOR)
             {
-              img_data[img_data_y * size + img_data_x] = (255 << 24) + rgb[color_ind];
+              img_row[x] = (255 << 24) + rgb[color_ind];
             }
           else
             {
               /* invalid color indices in input data result in transparent pixel */
-              img_data[img_data_y * size + img_data_x] = 0;
+              img_row[x] = 0;
             }
         }
     }
+}
 
-  scale_options = lx.scale_options;
-  if (scale_options & GR_OPTION_FLIP_X)
+static int find_interval(const double *edges, int n, double value)
+{
+  int start = 0, end = n, m;
+
+  while (start != end)
     {
-      double tmp = xmin;
-      xmin = xmax;
-      xmax = tmp;
+      m = (start + end) / 2;
+      if (value >= edges[m + 1])
+        {
+          start = m + 1;
+        }
+      else if (edges[m] > value)
+        {
+          end = m;
+        }
+      else
+        {
+          start = end = m;
+        }
     }
-  if (scale_options & GR_OPTION_FLIP_Y)
+  return start;
+}
+
+static void nonuniformpolarcellarray_rows(void *arg, int start, int end)
+{
+  nonuniformpolarcellarray_raster_t *raster = (nonuniformpolarcellarray_raster_t *)arg;
+  int x, y, color_ind, r_ind, phi_ind, num_r = raster->num_r, num_phi = raster->num_phi;
+  double cur_r, cur_phi, px, py, rmin = raster->rmin, rmax = raster->rmax, phimin = raster->phimin,
+                                 phimax = raster->phimax;
+  double center_x = raster->width / 2., center_y = raster->height / 2.;
+  const double *r_sorted = raster->r_sorted, *phi_sorted = raster->phi_sorted;
+  int *img_row;
+
+  for (y = start; y < end; y++)
     {
-      double tmp = ymin;
-      ymin = ymax;
-      ymax = tmp;
-    }
-  lx.scale_options = 0;
-  gr_drawimage(xmin, xmax, ymin, ymax, size, size, img_data, 0);
-  free(img_data);
-  lx.scale_options = scale_options;
+      img_row = raster->img_data + y * raster->width;
+      py = (y - center_y) / center_y * rmax;
+      for (x = 0; x < raster->width; x++)
+        {
+          px = (x - center_x) / center_x * rmax;
 
-  gks_free(x);
-  gks_free(y);
+          cur_r = sqrt(px * px + py * py);
+          if (raster->r_reverse)
+            {
+              cur_r = rmax - cur_r + rmin;
+            }
+
+          if (raster->phi_reverse)
+            {
+              cur_phi = fmod(-fmod(atan2(py, px) * 180 / M_PI + 360, 360) + phimin + 2 * 360, 360);
+            }
+          else
+            {
+              cur_phi = fmod(fmod(atan2(py, px) * 180 / M_PI + 360, 360) + 2 * 360 - phimax, 360);
+            }
+
+          if (cur_r < r_sorted[0] || cur_r >= r_sorted[num_r] || cur_phi < phi_sorted[0] ||
+              cur_phi >= phi_sorted[num_phi])
+            {
+              img_row[x] = 0;
+              continue;
+            }
+          r_ind = find_interval(r_sorted, num_r, cur_r);
+          phi_ind = find_interval(phi_sorted, num_phi, cur_phi);
+
+          color_ind = raster->color[r_ind * raster->ncol + phi_ind];
+          if (color_ind >= 0 && color_ind < MAX_COLOR)
+            {
+              img_row[x] = (255 << 24) + rgb[color_ind];
+            }
+          else
+            {
+              /* invalid color indices in input data result in transparent pixel */
+              img_row[x] = 0;
+            }
+        }
+    }
 }
 
 /*!
@@ -2287,9 +2851,13 @@ void gr_nonuniformcellarray(double *x, double *y, int dimx, int dimy, int scol,
 void gr_polarcellarray(double x_org, double y_org, double phimin, double phimax, double rmin, double rmax, int dimphi,
                        int dimr, int scol, int srow, int ncol, int nrow, int *color)
 {
-  int x, y, color_ind, r_ind, phi_ind, phi_reverse, phi_wrapped_reverse, r_reverse, size = (int)(2000 * scale_factor);
-  int *img_data;
-  double r, phi, tmp, center = size / 2.;
+  raster_cache_t *cache = &polarcellarray_cache;
+  int phi_reverse, phi_wrapped_reverse, r_reverse, width, height;
+  int iparams[7];
+  double params[4];
+  const void *parts[4];
+  size_t sizes[4];
+  double tmp;
 
   phimin = arc(phimin);
   phimax = arc(phimax);
@@ -2351,56 +2919,50 @@ void gr_polarcellarray(double x_org, double y_org, double phimin, double phimax,
       phimin += 2 * M_PI;
     }
 
-  img_data = (int *)xmalloc(size * size * sizeof(int));
-
-  for (y = 0; y < size; y++)
-    {
-      for (x = 0; x < size; x++)
-        {
-          double px = (x - center) / center;
-          double py = (y - center) / center;
-          r = sqrt(px * px + py * py);
-          phi = atan2(py, px);
-          if (phi < min(phimin, phimax))
-            {
-              phi += 2 * M_PI;
-            }
-
-          /* map phi from [phimin, phimax] to [0, 1] */
-          phi = (phi - phimin) / (phimax - phimin);
-
-          if (r * rmax < rmin || r >= 1 || phi < 0 || phi > 1)
-            {
-              img_data[y * size + x] = 0;
-              continue;
-            }
-          r = (r * rmax - rmin) / (rmax - rmin);
-          r_ind = (int)(r * dimr);
-          phi_ind = (int)(phi * dimphi) % dimphi;
-          if (r_reverse)
-            {
-              r_ind = dimr - r_ind - 1;
-            }
-          if (phi_wrapped_reverse)
-            {
-              phi_ind = dimphi - phi_ind - 1;
-            }
-          img_data[y * size + x] = color[(r_ind + srow - 1) * ncol + phi_ind + scol - 1];
-          color_ind = color[(r_ind + srow - 1) * ncol + phi_ind + scol - 1];
-          if (color_ind >= 0 && color_ind < MAX_COLOR)
-            {
-              img_data[y * size + x] = (255 << 24) + rgb[color_ind];
-            }
-          else
-            {
-              /* invalid color indices in input data result in transparent pixel */
-              img_data[y * size + x] = 0;
-            }
-        }
-    }
-
-  gr_drawimage(x_org - rmax, x_org + rmax, y_org + rmax, y_org - rmax, size, size, img_data, 0);
-  free(img_data);
+  device_raster_size(2 * nx.a * rmax, 2 * nx.c * rmax, &width, &height);
+
+  params[0] = phimin;
+  params[1] = phimax;
+  params[2] = rmin;
+  params[3] = rmax;
+  iparams[0] = dimphi;
+  iparams[1] = dimr;
+  iparams[2] = scol;
+  iparams[3] = srow;
+  iparams[4] = ncol;
+  iparams[5] = r_reverse;
+  iparams[6] = phi_wrapped_reverse;
+  parts[0] = params;
+  sizes[0] = sizeof(params);
+  parts[1] = iparams;
+  sizes[1] = sizeof(iparams);
+  parts[2] = color + (srow - 1) * ncol + scol - 1;
+  sizes[2] = ((dimr - 1) * ncol + dimphi) * sizeof(int);
+  parts[3] = rgb;
+  sizes[3] = sizeof(rgb);
+
+  if (!raster_cache_lookup(cache, 4, parts, sizes, width, height))
+    {
+      polarcellarray_raster_t raster;
+
+      raster.phimin = phimin;
+      raster.phimax = phimax;
+      raster.rmin = rmin;
+      raster.rmax = rmax;
+      raster.dimphi = dimphi;
+      raster.dimr = dimr;
+      raster.ncol = ncol;
+      raster.r_reverse = r_reverse;
+      raster.phi_wrapped_reverse = phi_wrapped_reverse;
+      raster.color = color + (srow - 1) * ncol + scol - 1;
+      raster.width = width;
+      raster.height = height;
+      raster.img_data = cache->img_data;
+      threadpool_parallel_for(height, RASTER_ROWS_PER_CHUNK, polarcellarray_rows, &raster);
+    }
+
+  gr_drawimage(x_org - rmax, x_org + rmax, y_org + rmax, y_org - rmax, width, height, cache->img_data, 0);
+  raster_cache_trim(cache);
 }
 
 /*!
@@ -2458,10 +3020,13 @@ void gr_polarcellarray(double x_org, double y_org, double phimin, double phimax,
 void gr_nonuniformpolarcellarray(double x_org, double y_org, double *phi, double *r, int dimphi, int dimr, int scol,
                                  int srow, int ncol, int nrow, int *color)
 {
-  int x, y, color_ind, r_ind, phi_ind, phi_reverse, r_reverse, start, end, edges_phi = 1, edges_r = 1,
-                                                                           size = (int)(2000 * scale_factor);
-  int *img_data;
-  double cur_r, cur_phi, tmp, phimin, phimax, rmin, rmax, center = size / 2.;
+  raster_cache_t *cache = &nonuniformpolarcellarray_cache;
+  int x, y, phi_reverse, r_reverse, edges_phi = 1, edges_r = 1, width, height;
+  int iparams[6];
+  double params[4];
+  const void *parts[6];
+  size_t sizes[6];
+  double tmp, phimin, phimax, rmin, rmax;
   double *r_sorted, *phi_sorted;
   if (dimphi < 0)
     {
@@ -2585,137 +3150,96 @@ void gr_nonuniformpolarcellarray(double x_org, double y_org, double *phi, double
             }
           else
             {
-              phi_sorted[x] = phi[ncol - x];
-            }
-        }
-      else
-        {
-          if (!edges_phi && x)
-            {
-              phi_sorted[x] = 0.5 * (phi[scol - 1 + x] + phi[scol - 2 + x]);
-            }
-          else
-            {
-              phi_sorted[x] = phi[scol - 1 + x];
-            }
-        }
-      phi_sorted[x] = phi_sorted[x] - phimax + 360;
-      if (x && phi_sorted[x] < phi_sorted[x - 1])
-        {
-          fprintf(stderr, "angles not sorted.\n");
-          gks_free(r_sorted);
-          gks_free(phi_sorted);
-          return;
-        }
-    }
-  if (!edges_phi)
-    {
-      if (phi_reverse)
-        {
-          phi_sorted[ncol - scol + 2] = phi[scol - 1] - phimax + 360;
-        }
-      else
-        {
-          phi_sorted[ncol - scol + 2] = phi[ncol] - phimax + 360;
-        }
-      ncol++;
-    }
-
-  phimin = fmod(phimin, 360);
-  phimax = fmod(phimax, 360);
-
-  img_data = (int *)gks_malloc(size * size * sizeof(int));
-
-  for (y = 0; y < size; y++)
-    {
-      for (x = 0; x < size; x++)
-        {
-          double px = (x - center) / center * rmax;
-          double py = (y - center) / center * rmax;
-
-          cur_r = sqrt(px * px + py * py);
-          if (r_reverse)
-            {
-              cur_r = rmax - cur_r + rmin;
-            }
-
-          if (phi_reverse)
-            {
-              cur_phi = fmod(-fmod(atan2(py, px) * 180 / M_PI + 360, 360) + phimin + 2 * 360, 360);
-            }
-          else
-            {
-              cur_phi = fmod(fmod(atan2(py, px) * 180 / M_PI + 360, 360) + 2 * 360 - phimax, 360);
-            }
-
-          start = 0;
-          end = nrow - srow + 1;
-          if (cur_r < r_sorted[start] || cur_r >= r_sorted[end])
-            {
-              img_data[y * size + x] = 0;
-              continue;
-            }
-
-          while (start != end)
-            {
-              int m = ((start + end) / 2);
-              if (cur_r >= r_sorted[m + 1])
-                {
-                  start = m + 1;
-                }
-              else if (r_sorted[m] > cur_r)
-                {
-                  end = m;
-                }
-              else
-                {
-                  start = end = m;
-                }
-            }
-          r_ind = start;
-
-          start = 0;
-          end = ncol - scol + 1;
-          if (cur_phi < phi_sorted[start] || cur_phi >= phi_sorted[end])
-            {
-              img_data[y * size + x] = 0;
-              continue;
-            }
-          while (start != end)
-            {
-              int m = ((start + end) / 2);
-              if (cur_phi >= phi_sorted[m + 1])
-                {
-                  start = m + 1;
-                }
-              else if (phi_sorted[m] > cur_phi)
-                {
-                  end = m;
-                }
-              else
-                {
-                  start = end = m;
-                }
+              phi_sorted[x] = phi[ncol - x];
             }
-          phi_ind = start;
-
-          color_ind = color[(r_ind + srow - 1) * ncol + phi_ind + scol - 1];
-          if (color_ind >= 0 && color_ind < MAX_COLOR)
+        }
+      else
+        {
+          if (!edges_phi && x)
             {
-              img_data[y * size + x] = (255 << 24) + rgb[color_ind];
+              phi_sorted[x] = 0.5 * (phi[scol - 1 + x] + phi[scol - 2 + x]);
             }
           else
             {
-              /* invalid color indices in input data result in transparent pixel */
-              img_data[y * size + x] = 0;
+              phi_sorted[x] = phi[scol - 1 + x];
             }
         }
+      phi_sorted[x] = phi_sorted[x] - phimax + 360;
+      if (x && phi_sorted[x] < phi_sorted[x - 1])
+        {
+          fprintf(stderr, "angles not sorted.\n");
+          gks_free(r_sorted);
+          gks_free(phi_sorted);
+          return;
+        }
+    }
+  if (!edges_phi)
+    {
+      if (phi_reverse)
+        {
+          phi_sorted[ncol - scol + 2] = phi[scol - 1] - phimax + 360;
+        }
+      else
+        {
+          phi_sorted[ncol - scol + 2] = phi[ncol] - phimax + 360;
+        }
+      ncol++;
+    }
+
+  phimin = fmod(phimin, 360);
+  phimax = fmod(phimax, 360);
+
+  device_raster_size(2 * nx.a * rmax, 2 * nx.c * rmax, &width, &height);
+
+  params[0] = phimin;
+  params[1] = phimax;
+  params[2] = rmin;
+  params[3] = rmax;
+  iparams[0] = scol;
+  iparams[1] = srow;
+  iparams[2] = ncol;
+  iparams[3] = nrow;
+  iparams[4] = r_reverse;
+  iparams[5] = phi_reverse;
+  parts[0] = params;
+  sizes[0] = sizeof(params);
+  parts[1] = iparams;
+  sizes[1] = sizeof(iparams);
+  parts[2] = r_sorted;
+  sizes[2] = (nrow - srow + 2) * sizeof(double);
+  parts[3] = phi_sorted;
+  sizes[3] = (ncol - scol + 2) * sizeof(double);
+  parts[4] = color + (srow - 1) * ncol + scol - 1;
+  sizes[4] = ((nrow - srow) * ncol + ncol - scol + 1) * sizeof(int);
+  parts[5] = rgb;
+  sizes[5] = sizeof(rgb);
+
+  if (!raster_cache_lookup(cache, 6, parts, sizes, width, height))
+    {
+      nonuniformpolarcellarray_raster_t raster;
+
+      raster.phimin = phimin;
+      raster.phimax = phimax;
+      raster.rmin = rmin;
+      raster.rmax = rmax;
+      raster.r_sorted = r_sorted;
+      raster.phi_sorted = phi_sorted;
+      raster.num_r = nrow - srow + 1;
+      raster.num_phi = ncol - scol + 1;
+      raster.ncol = ncol;
+      raster.r_reverse = r_reverse;
+      raster.phi_reverse = phi_reverse;
+      raster.color = color + (srow - 1) * ncol + scol - 1;
+      raster.width = width;
+      raster.height = height;
+      raster.img_data = cache->img_data;
+      threadpool_parallel_for(height, RASTER_ROWS_PER_CHUNK, nonuniformpolarcellarray_rows, &raster);
     }
 
   gks_free(r_sorted);
   gks_free(phi_sorted);
-  gr_drawimage(x_org - rmax, x_org + rmax, y_org + rmax, y_org - rmax, size, size, img_data, 0);
-  gks_free(img_data);
+  gr_drawimage(x_org - rmax, x_org + rmax, y_org + rmax, y_org - rmax, width, height, cache->img_data, 0);
+  raster_cache_trim(cache);
 }
 
 void gr_gdp(int n, double *x, double *y, int primid, int ldr, int *datrec)
@@ -3770,6 +4294,7 @@ static void setcolor(int workstation_id, color_t *color)
 static void setcolorrep(int index, double red, double green, double blue)
 {
   color_t color;
+  unsigned int rgbmask;
 
   color.index = index;
   color.red = red;
@@ -3777,7 +4302,11 @@ static void setcolorrep(int index, double red, double green, double blue)
   color.blue = blue;
 
   if (index >= 0 && index < MAX_COLOR)
-    rgb[index] = ((nint(red * 255) & 0xff)) | ((nint(green * 255) & 0xff) << 8) | ((nint(blue * 255) & 0xff) << 16);
+    {
+      rgbmask = ((nint(red * 255) & 0xff)) | ((nint(green * 255) & 0xff) << 8) | ((nint(blue * 255) & 0xff) << 16);
+      if (index >= RGB_COLOR_FIRST && index < RGB_COLOR_END) update_color_lookup(index, rgbmask, red, green, blue);
+      rgb[index] = rgbmask;
+    }
 
   foreach_activews((void (*)(int, void *))setcolor, (void *)&color);
 }
@@ -4192,6 +4721,156 @@ void gr_closeseg(void)
   gks_close_seg();
 }
 
+/*
+ * Take a snapshot of the GR state that is not part of the GKS state list. All members are copied bytewise, so two
+ * snapshots can be compared with memcmp.
+ */
+static void save_capture_state(capture_state *cs)
+{
+  memset(cs, 0, sizeof(capture_state));
+  memcpy(&cs->nx, &nx, sizeof(nx));
+  memcpy(&cs->lx, &lx, sizeof(lx));
+  memcpy(&cs->wx, &wx, sizeof(wx));
+  memcpy(&cs->tx, &tx, sizeof(tx));
+  memcpy(&cs->gpx, &gpx, sizeof(gpx));
+  memcpy(&cs->ix, &ix, sizeof(ix));
+  memcpy(cs->txoff, txoff, sizeof(txoff));
+  cs->vxmin = vxmin;
+  cs->vxmax = vxmax;
+  cs->vymin = vymin;
+  cs->vymax = vymax;
+  cs->cxl = cxl;
+  cs->cxr = cxr;
+  cs->cyf = cyf;
+  cs->cyb = cyb;
+  cs->czb = czb;
+  cs->czt = czt;
+  cs->arrow_style = arrow_style;
+  cs->arrow_size = arrow_size;
+  cs->scientific_format = scientific_format;
+  cs->ctx = ctx;
+  if (ctx != NULL) memcpy(&cs->ctx_state, ctx, sizeof(state_list));
+}
+
+static void restore_capture_state(const capture_state *cs)
+{
+  memcpy(&nx, &cs->nx, sizeof(nx));
+  memcpy(&lx, &cs->lx, sizeof(lx));
+  memcpy(&wx, &cs->wx, sizeof(wx));
+  memcpy(&tx, &cs->tx, sizeof(tx));
+  memcpy(&gpx, &cs->gpx, sizeof(gpx));
+  memcpy(&ix, &cs->ix, sizeof(ix));
+  memcpy(txoff, cs->txoff, sizeof(txoff));
+  vxmin = cs->vxmin;
+  vxmax = cs->vxmax;
+  vymin = cs->vymin;
+  vymax = cs->vymax;
+  cxl = cs->cxl;
+  cxr = cs->cxr;
+  cyf = cs->cyf;
+  cyb = cs->cyb;
+  czb = cs->czb;
+  czt = cs->czt;
+  arrow_style = cs->arrow_style;
+  arrow_size = cs->arrow_size;
+  scientific_format = cs->scientific_format;
+  if (ctx != NULL) memcpy(ctx, &cs->ctx_state, sizeof(state_list));
+}
+
+/*!
+ * Start capturing the output of all following GR calls.
+ *
+ * \param[in] max_size the maximum size of the captured output in bytes
+ *
+ * \returns a new capture or NULL if no capture can be started, e.g. because
+ *          another capture is active or GR calls are being recorded
+ *
+ * The capture records the primitives and attributes sent to the
+ * workstations, so it can be replayed by gr_replaycapture without
+ * repeating the coordinate transformations of the original calls. Captures
+ * that would exceed `max_size` bytes are abandoned.
+ */
+gr_capture_t *gr_begincapture(int max_size)
+{
+  gr_capture_t *capture;
+
+  check_autoinit;
+
+  if (active_capture != NULL || flag_stream || flag_graphics) return NULL;
+
+  capture = (gr_capture_t *)xcalloc(1, sizeof(gr_capture_t));
+  save_capture_state(&capture->begin);
+  gks_begin_capture(&capture->gks, max_size);
+  active_capture = capture;
+
+  return capture;
+}
+
+/*!
+ * Stop the active capture.
+ *
+ * \param[in] capture the capture returned by gr_begincapture
+ *
+ * \returns 1 if the capture can be replayed, 0 otherwise
+ */
+int gr_endcapture(gr_capture_t *capture)
+{
+  if (capture == NULL || capture != active_capture) return 0;
+
+  /* line specifications depend on the color cycle, which is not part of the captured state */
+  capture->replayable = gks_end_capture() && ctx == capture->begin.ctx && !capture->uses_linespec;
+  if (!capture->replayable) gks_discard_capture(&capture->gks);
+  save_capture_state(&capture->end);
+  active_capture = NULL;
+
+  return capture->replayable;
+}
+
+/*!
+ * Replay a capture.
+ *
+ * \param[in] capture a capture finished by gr_endcapture
+ *
+ * \returns 1 if the capture has been replayed, 0 otherwise
+ *
+ * A capture is only replayed if the current GR and GKS state equals the
+ * state at the beginning of the capture. Afterwards, the state is the same
+ * as after the captured calls.
+ */
+int gr_replaycapture(gr_capture_t *capture)
+{
+  capture_state current;
+
+  check_autoinit;
+
+  if (capture == NULL || !capture->replayable || flag_stream || flag_graphics) return 0;
+
+  save_capture_state(&current);
+  if (memcmp(&current, &capture->begin, sizeof(capture_state)) != 0) return 0;
+  if (!gks_replay_capture(&capture->gks)) return 0;
+  restore_capture_state(&capture->end);
+
+  return 1;
+}
+
+/*!
+ * Delete a capture and release its memory.
+ *
+ * \param[in] capture the capture to delete
+ */
+void gr_deletecapture(gr_capture_t *capture)
+{
+  if (capture == NULL) return;
+
+  if (capture == active_capture)
+    {
+      gks_end_capture();
+      active_capture = NULL;
+    }
+  gks_discard_capture(&capture->gks);
+  free(capture);
+}
+
 void gr_samplelocator(double *x, double *y, int *state)
 {
   int wkid = 1, errind;
@@ -4204,6 +4883,7 @@ void gr_samplelocator(double *x, double *y, int *state)
 void gr_emergencyclosegks(void)
 {
   gks_emergency_close();
+  release_raster_caches();
   autoinit = 1;
 }
 
@@ -6678,21 +7358,6 @@ void gr_polyline3d(int n, double *px, double *py, double *pz)
     }
 }
 
-static int cmp(const void *a, const void *b)
-{
-  const point_3d *pa = (const point_3d *)a;
-  const point_3d *pb = (const point_3d *)b;
-  double x, y, da, db;
-
-  x = (GR_OPTION_FLIP_X & lx.scale_options) ? lx.xmin : lx.xmax;
-  y = (GR_OPTION_FLIP_Y & lx.scale_options) ? lx.ymin : lx.ymax;
-
-  da = sqrt(pow(x - pa->x, 2) + pow(y - pa->y, 2));
-  db = sqrt(pow(x - pb->x, 2) + pow(y - pb->y, 2));
-
-  return db - da;
-}
-
 /*!
  * Draw marker symbols centered at the given 3D data points.
  *
@@ -6711,8 +7376,9 @@ void gr_polymarker3d(int n, double *px, double *py, double *pz)
   double clrt[4], wn[4], vp[4];
   int modern_projection_type;
 
-  double x, y, z;
+  double x, y, z, xref, yref, dx, dy;
   point_3d *point;
+  depth_key_t *keys;
   int m, visible;
 
   check_autoinit;
@@ -6739,8 +7405,13 @@ void gr_polymarker3d(int n, double *px, double *py, double *pz)
       lx.zmax = ix.zmax;
     }
 
+  /* markers are drawn from the farthest to the nearest one, measured from the back corner in x/y */
+  xref = (GR_OPTION_FLIP_X & lx.scale_options) ? lx.xmin : lx.xmax;
+  yref = (GR_OPTION_FLIP_Y & lx.scale_options) ? lx.ymin : lx.ymax;
+
   m = 0;
   point = (point_3d *)xmalloc(n * sizeof(point_3d));
+  keys = (depth_key_t *)xmalloc(n * sizeof(depth_key_t));
 
   for (i = 0; i < n; i++)
     {
@@ -6774,20 +7445,25 @@ void gr_polymarker3d(int n, double *px, double *py, double *pz)
           point[m].x = x;
           point[m].y = y;
           point[m].z = z;
+          dx = xref - x;
+          dy = yref - y;
+          keys[m].key = (float)-(dx * dx + dy * dy);
+          keys[m].index = m;
           m++;
         }
     }
 
-  qsort(point, m, sizeof(point_3d), cmp);
+  radixsort_depth_keys(m, keys, worker_thread_count(m, DEPTH_SORT_MIN_KEYS_PER_THREAD));
 
   if (m >= maxpath) reallocate(m);
 
   for (i = 0; i < m; i++)
     {
-      xpoint[i] = point[i].x;
-      ypoint[i] = point[i].y;
-      zpoint[i] = point[i].z;
+      xpoint[i] = point[keys[i].index].x;
+      ypoint[i] = point[keys[i].index].y;
+      zpoint[i] = point[keys[i].index].z;
     }
+  free(keys);
 
   if (m > 0)
     {
@@ -8725,6 +9401,145 @@ static void get_intensity(double *fx, double *fy, double *fz, double *light_sour
       (oddnormal[0] * negated_norm[0] + oddnormal[1] * negated_norm[1] + oddnormal[2] * negated_norm[2]) * 0.8 + 0.2;
 }
 
+typedef struct
+{
+  int tnr, clip_tnr, border_color;
+  double border_width;
+  unsigned int alpha;
+  int num_facets, num_points, len;
+  double x[4 * FACETS_PER_BATCH], y[4 * FACETS_PER_BATCH];
+  int attributes[6 * FACETS_PER_BATCH];
+} facet_batch_t;
+
+static void check_fill_polygons(int wkid, void *arg)
+{
+  int errind, conid, wtype;
+  int *supported = (int *)arg;
+
+  gks_inq_ws_conntype(wkid, &errind, &conid, &wtype);
+  switch (wtype)
+    {
+    case 61:
+    case 62:
+    case 63:
+    case 64:
+    case 101:
+    case 102:
+    case 140:
+    case 141:
+    case 142:
+    case 143:
+    case 144:
+    case 145:
+    case 146:
+    case 150:
+    case 151:
+    case 170:
+    case 171:
+    case 172:
+    case 173:
+    case 314:
+    case 320:
+    case 321:
+    case 322:
+    case 323:
+    case 381:
+    case 382:
+    case 400:
+    case 410:
+    case 411:
+    case 412:
+    case 413:
+      break;
+    default:
+      *supported = 0;
+    }
+}
+
+/*
+ * Start batching filled facets if all active workstations implement the GKS_K_GDP_FILL_POLYGONS primitive.
+ * Facets are outlined in the current polyline color and width if `outline` is set. Returns NULL if the caller has to
+ * fall back to single fill area calls.
+ */
+static facet_batch_t *begin_facets(int tnr, int outline)
+{
+  facet_batch_t *batch;
+  int errind, coli, clsw, supported = 1;
+  double alpha, width, clrt[4];
+
+#ifndef EMSCRIPTEN
+  foreach_activews(check_fill_polygons, (void *)&supported);
+#else
+  supported = 0;
+#endif
+  if (!supported) return NULL;
+
+  batch = (facet_batch_t *)xmalloc(sizeof(facet_batch_t));
+  batch->tnr = tnr;
+  gks_inq_transparency(&errind, &alpha);
+  batch->alpha = (unsigned int)nint(alpha * 255) & 0xff;
+  batch->num_facets = batch->num_points = batch->len = 0;
+
+  gks_inq_border_color_index(&errind, &batch->border_color);
+  gks_inq_border_width(&errind, &batch->border_width);
+  gks_inq_clip_xform(&errind, &batch->clip_tnr);
+
+  /* drivers clip GDPs against the clipping transformation rather than the current one */
+  gks_inq_clip(&errind, &clsw, clrt);
+  if (clsw == GKS_K_CLIP && batch->clip_tnr == 0) gks_select_clip_xform(MODERN_NDC);
+  if (outline)
+    {
+      gks_inq_pline_color_index(&errind, &coli);
+      gks_inq_pline_linewidth(&errind, &width);
+      gks_set_border_color_index(coli);
+      gks_set_border_width(width);
+    }
+  else
+    {
+      gks_set_border_width(0);
+    }
+  return batch;
+}
+
+static void flush_facets(facet_batch_t *batch)
+{
+  if (batch->num_facets == 0) return;
+
+  gks_select_xform(MODERN_NDC);
+  gks_gdp(batch->num_points, batch->x, batch->y, GKS_K_GDP_FILL_POLYGONS, batch->len, batch->attributes);
+  gks_select_xform(batch->tnr);
+
+  batch->num_facets = batch->num_points = batch->len = 0;
+}
+
+static void end_facets(facet_batch_t *batch)
+{
+  flush_facets(batch);
+  gks_set_border_color_index(batch->border_color);
+  gks_set_border_width(batch->border_width);
+  gks_select_clip_xform(batch->clip_tnr);
+  free(batch);
+}
+
+/* add a facet with up to four corners given in modern NDC */
+static void add_facet(facet_batch_t *batch, int n, const double *x, const double *y, int color)
+{
+  int i;
+
+  if (batch->num_facets == FACETS_PER_BATCH) flush_facets(batch);
+
+  batch->attributes[batch->len++] = n;
+  for (i = 0; i < n; i++)
+    {
+      batch->x[batch->num_points] = x[i];
+      batch->y[batch->num_points] = y[i];
+      batch->attributes[batch->len++] = ++batch->num_points;
+    }
+  batch->attributes[batch->len++] =
+      (int)((color >= 0 && color < MAX_COLOR ? rgb[color] : 0) | (batch->alpha << 24));
+  batch->num_facets++;
+}
+
 /*!
  * Draw a three-dimensional surface plot for the given data points.
  *
@@ -8766,7 +9581,8 @@ void gr_surface(int nx, int ny, double *px, double *py, double *pz, int option)
   int modern_projection_type;
 
   int i, ii, j, jj, k;
-  int color;
+  int color, linetype;
+  facet_batch_t *batch = NULL;
   double color_min, color_max;
 
   double *xn, *yn, *zn, *x, *y, *z;
@@ -9148,6 +9964,13 @@ void gr_surface(int nx, int ny, double *px, double *py, double *pz, int option)
 
             gks_set_fill_int_style(GKS_K_INTSTYLE_SOLID);
 
+            /* the outlines of filled meshes can only be batched if they are drawn solid */
+            gks_inq_pline_linetype(&errind, &linetype);
+            if (option != GR_OPTION_FILLED_MESH || linetype == GKS_K_LINETYPE_SOLID)
+              {
+                batch = begin_facets(tnr, option == GR_OPTION_FILLED_MESH);
+              }
+
             while (j > 0)
               {
                 for (i = 1; i < nx; i++)
@@ -9273,8 +10096,6 @@ void gr_surface(int nx, int ny, double *px, double *py, double *pz, int option)
                           color = first_color;
                         else if (color > last_color)
                           color = last_color;
-
-                        gks_set_fill_color_index(color);
                       }
 
                     else if (option == GR_OPTION_COLORED_MESH)
@@ -9286,8 +10107,6 @@ void gr_surface(int nx, int ny, double *px, double *py, double *pz, int option)
                           color = first_color;
                         else if (color > last_color)
                           color = last_color;
-
-                        gks_set_fill_color_index(color);
                       }
 
                     else if (option == GR_OPTION_SHADED_MESH)
@@ -9298,10 +10117,16 @@ void gr_surface(int nx, int ny, double *px, double *py, double *pz, int option)
                           color = first_color;
                         else if (color > last_color)
                           color = last_color;
+                      }
 
-                        gks_set_fill_color_index(color);
+                    if (batch != NULL)
+                      {
+                        add_facet(batch, 4, xn, yn, option == GR_OPTION_FILLED_MESH ? coli : color);
+                        continue;
                       }
 
+                    if (option != GR_OPTION_FILLED_MESH) gks_set_fill_color_index(color);
+
                     gks_select_xform(MODERN_NDC);
 
                     np = 4;
@@ -9319,6 +10144,8 @@ void gr_surface(int nx, int ny, double *px, double *py, double *pz, int option)
                 j--;
               }
 
+            if (batch != NULL) end_facets(batch);
+
             break;
           }
 
@@ -9434,11 +10261,12 @@ static int compar(const void *a, const void *b)
  */
 void gr_trisurface(int n, double *px, double *py, double *pz)
 {
-  int errind, tnr, coli, int_style;
+  int errind, tnr, coli, int_style, linetype;
   int modern_projection_type;
   int ntri, *triangles = NULL;
   double x[4], y[4], z[4], meanz;
   int i, j, color;
+  facet_batch_t *batch = NULL;
 
   if (n < 3)
     {
@@ -9551,6 +10379,9 @@ void gr_trisurface(int n, double *px, double *py, double *pz)
       qsort(triangles, ntri, 3 * sizeof(int), compar);
     }
 
+  gks_inq_pline_linetype(&errind, &linetype);
+  if (linetype == GKS_K_LINETYPE_SOLID) batch = begin_facets(tnr, 1);
+
   for (i = 0; i < ntri; i++)
     {
       meanz = 0.0;
@@ -9572,6 +10403,12 @@ void gr_trisurface(int n, double *px, double *py, double *pz)
       else if (color > last_color)
         color = last_color;
 
+      if (batch != NULL)
+        {
+          add_facet(batch, 3, x, y, color);
+          continue;
+        }
+
       gks_select_xform(MODERN_NDC);
 
       gks_set_fill_color_index(color);
@@ -9583,6 +10420,7 @@ void gr_trisurface(int n, double *px, double *py, double *pz)
 
       gks_select_xform(tnr);
     }
+  if (batch != NULL) end_facets(batch);
 
   /* restore fill area interior style and color index */
   gks_set_fill_int_style(int_style);
@@ -10109,38 +10947,81 @@ void gr_tricontour(int npoints, double *x, double *y, double *z, int nlevels, do
     }
 }
 
-static int binning(double x[], double y[], int *cell, int *cnt, double size, double shape, double rx[2], double ry[2],
-                   int bnd[2], int n, double ycorr)
+static void init_wc_ndc_xform(wc_ndc_xform_t *xf)
 {
-  int nc;
-  double xi, yi;
-  int i, i1, i2, iinc;
-  int j1, j2, jinc;
-  int L, lmax, lat;
-  double c1, c2, con1, con2, dist1;
-  double sx, sy, xmin, ymin, xr, yr;
-
-  xmin = rx[0];
-  ymin = ry[0] + ycorr;
-  xr = rx[1] - xmin;
-  yr = ry[1] + ycorr - ymin;
-  c1 = size / xr;
-  c2 = size * shape / (yr * sqrt(3.));
-
-  jinc = bnd[1];
-  lat = jinc + 1;
-  iinc = 2 * jinc;
-  lmax = bnd[0] * bnd[1];
-  con1 = 0.25;
-  con2 = 1. / 3.;
+  /* fold the (optional) logarithmic, flip and normalization transformations into one linear mapping of either the
+   * coordinate itself or its natural logarithm */
+  xf->x_log = (GR_OPTION_X_LOG & lx.scale_options) != 0;
+  xf->y_log = (GR_OPTION_Y_LOG & lx.scale_options) != 0;
+  if (xf->x_log)
+    {
+      xf->ax = lx.a / log(lx.basex);
+      xf->bx = lx.b;
+    }
+  else
+    {
+      xf->ax = 1;
+      xf->bx = 0;
+    }
+  if (xf->y_log)
+    {
+      xf->ay = lx.c / log(lx.basey);
+      xf->by = lx.d;
+    }
+  else
+    {
+      xf->ay = 1;
+      xf->by = 0;
+    }
+  if (GR_OPTION_FLIP_X & lx.scale_options)
+    {
+      xf->ax = -xf->ax;
+      xf->bx = lx.xmax + lx.xmin - xf->bx;
+    }
+  if (GR_OPTION_FLIP_Y & lx.scale_options)
+    {
+      xf->ay = -xf->ay;
+      xf->by = lx.ymax + lx.ymin - xf->by;
+    }
+  xf->ax *= nx.a;
+  xf->bx = nx.a * xf->bx + nx.b;
+  xf->ay *= nx.c;
+  xf->by = nx.c * xf->by + nx.d;
+}
 
-  for (i = 0; i < n; i++)
+GR_INLINE static int apply_wc_ndc_xform(const wc_ndc_xform_t *xf, double x, double y, double *xn, double *yn)
+{
+  if (xf->x_log)
+    {
+      if (!(x > 0)) return 0;
+      x = log(x);
+    }
+  if (xf->y_log)
+    {
+      if (!(y > 0)) return 0;
+      y = log(y);
+    }
+  *xn = xf->ax * x + xf->bx;
+  *yn = xf->ay * y + xf->by;
+  return 1;
+}
+
+static void binning_chunk(hexbin_binning_data_t *data)
+{
+  const hexbin_layout_t *layout = data->layout;
+  const double *x = data->x, *y = data->y;
+  int *cnt = data->cnt;
+  double xi, yi, sx, sy, dx, dy, dist1;
+  int i, i1, i2, j1, j2, L;
+  int iinc = layout->iinc, lat = layout->lat;
+  double c1 = layout->c1, c2 = layout->c2, xmin = layout->xmin, ymin = layout->ymin;
+  const double con1 = 0.25, con2 = 1. / 3.;
+
+  for (i = data->start; i < data->end; i++)
     {
       if (is_nan(x[i]) || is_nan(y[i])) continue;
-      xi = x[i];
-      yi = y[i];
-      gr_wctondc(&xi, &yi);
-      if (xi < vxmin || xi > vxmax || yi < vymin || yi > vymax)
+      if (!apply_wc_ndc_xform(&layout->xform, x[i], y[i], &xi, &yi)) continue;
+      if (!(xi >= vxmin && xi <= vxmax && yi >= vymin && yi <= vymax))
         {
           continue;
         }
@@ -10148,7 +11029,9 @@ static int binning(double x[], double y[], int *cell, int *cnt, double size, dou
       sy = c2 * (yi - ymin);
       j1 = sx + 0.5;
       i1 = sy + 0.5;
-      dist1 = pow((sx - j1), 2) + 3.0 * pow((sy - i1), 2);
+      dx = sx - j1;
+      dy = sy - i1;
+      dist1 = dx * dx + 3.0 * dy * dy;
       if (dist1 < con1)
         L = i1 * iinc + j1 + 1;
       else if (dist1 > con2)
@@ -10157,14 +11040,78 @@ static int binning(double x[], double y[], int *cell, int *cnt, double size, dou
         {
           j2 = sx;
           i2 = sy;
-          if (dist1 <= pow((sx - j2 - 0.5), 2) + 3.0 * pow((sy - i2 - 0.5), 2))
+          dx = sx - j2 - 0.5;
+          dy = sy - i2 - 0.5;
+          if (dist1 <= dx * dx + 3.0 * dy * dy)
             L = i1 * iinc + j1 + 1;
           else
             L = i2 * iinc + j2 + lat;
         }
 
-      cnt[L] = cnt[L] + 1;
+      cnt[L]++;
+    }
+}
+
+static void binning_chunks(void *arg, int start, int end)
+{
+  hexbin_binning_data_t *data = (hexbin_binning_data_t *)arg;
+  int i;
+
+  for (i = start; i < end; i++)
+    {
+      binning_chunk(data + i);
+    }
+}
+
+static int binning(double x[], double y[], int *cell, int *cnt, hexbin_layout_t *layout, int bnd[2], int n)
+{
+  int nc;
+  int i, L, lmax, thread_count;
+  hexbin_binning_data_t *data;
+
+  lmax = bnd[0] * bnd[1];
+
+  thread_count = worker_thread_count(n, HEXBIN_MIN_POINTS_PER_THREAD);
+  if (layout->thread_count < thread_count - 1)
+    {
+      layout->thread_cnt = (int **)xrealloc(layout->thread_cnt, (thread_count - 1) * sizeof(int *));
+      for (i = layout->thread_count; i < thread_count - 1; i++)
+        {
+          layout->thread_cnt[i] = (int *)xmalloc((layout->lmax + 1) * sizeof(int));
+        }
+      layout->thread_count = thread_count - 1;
+    }
+
+  data = (hexbin_binning_data_t *)xcalloc(thread_count, sizeof(hexbin_binning_data_t));
+  for (i = 0; i < thread_count; i++)
+    {
+      data[i].x = x;
+      data[i].y = y;
+      data[i].start = (int)((int64_t)i * n / thread_count);
+      data[i].end = (int)((int64_t)(i + 1) * n / thread_count);
+      data[i].layout = layout;
+      if (i == 0)
+        {
+          data[i].cnt = cnt;
+        }
+      else
+        {
+          data[i].cnt = layout->thread_cnt[i - 1];
+          memset(data[i].cnt, 0, (layout->lmax + 1) * sizeof(int));
+        }
+    }
+
+  threadpool_parallel_for(thread_count, 1, binning_chunks, data);
+  for (i = 1; i < thread_count; i++)
+    {
+      int *thread_cnt = data[i].cnt;
+
+      for (L = 1; L <= lmax; L++)
+        {
+          cnt[L] += thread_cnt[L];
+        }
     }
+  free(data);
 
   nc = 0;
   for (L = 1; L <= lmax; L++)
@@ -10180,6 +11127,70 @@ static int binning(double x[], double y[], int *cell, int *cnt, double size, dou
   return nc;
 }
 
+/*
+ * Return the hexagonal bin layout for the current viewport, window and scale settings. The layout (including the
+ * precomputed world-to-grid coefficients and the per-thread count buffers) is kept and reused as long as only the
+ * data values change between calls.
+ */
+static hexbin_layout_t *hexbin_layout(int nbins)
+{
+  static hexbin_layout_t layout = {0};
+  wc_ndc_xform_t xform;
+  double d, R, xr, yr;
+  int c1, i;
+
+  init_wc_ndc_xform(&xform);
+  if (layout.valid && layout.nbins == nbins && layout.vxmin == vxmin && layout.vxmax == vxmax &&
+      layout.vymin == vymin && layout.vymax == vymax && layout.xform.x_log == xform.x_log &&
+      layout.xform.y_log == xform.y_log && layout.xform.ax == xform.ax && layout.xform.bx == xform.bx &&
+      layout.xform.ay == xform.ay && layout.xform.by == xform.by)
+    {
+      return &layout;
+    }
+
+  for (i = 0; i < layout.thread_count; i++)
+    {
+      free(layout.thread_cnt[i]);
+    }
+  free(layout.thread_cnt);
+  layout.thread_cnt = NULL;
+  layout.thread_count = 0;
+
+  layout.nbins = nbins;
+  layout.vxmin = vxmin;
+  layout.vxmax = vxmax;
+  layout.vymin = vymin;
+  layout.vymax = vymax;
+  layout.xform = xform;
+
+  d = (vxmax - vxmin) / nbins;
+  R = 1. / sqrt(3) * d;
+
+  layout.size = nbins;
+  layout.shape = (vymax - vymin) / (vxmax - vxmin);
+
+  layout.jmax = floor(nbins + 1.5001);
+  c1 = 2 * floor((nbins * layout.shape) / sqrt(3) + 1.5001);
+  layout.imax = floor((layout.jmax * c1 - 1) / layout.jmax + 1);
+  layout.lmax = layout.jmax * layout.imax;
+
+  layout.ycorr = (vymax - vymin) - ((layout.imax - 2) * 1.5 * R + (layout.imax % 2) * R);
+  layout.ycorr = layout.ycorr / 2;
+
+  layout.xmin = vxmin;
+  layout.ymin = vymin + layout.ycorr;
+  xr = vxmax - layout.xmin;
+  yr = vymax + layout.ycorr - layout.ymin;
+  layout.c1 = layout.size / xr;
+  layout.c2 = layout.size * layout.shape / (yr * sqrt(3.));
+  layout.iinc = 2 * layout.jmax;
+  layout.lat = layout.jmax + 1;
+
+  layout.valid = 1;
+
+  return &layout;
+}
+
 static int hcell2xy(int nbins, double rx[2], double ry[2], double shape, int bnd[2], int *cell, double *x, double *y,
                     int *cnt, double ycorr)
 {
@@ -10242,42 +11253,31 @@ const hexbin_2pass_t *gr_hexbin_2pass(int n, double *x, double *y, int nbins, co
 
   if (context == NULL)
     {
-      int jmax, c1, imax, lmax;
-      double size, shape;
-      double ycorr;
+      hexbin_layout_t *layout;
       int *cell, *cnt;
       double *xcm, *ycm;
       double rx[2], ry[2];
       int bnd[2];
       int nc, cntmax;
 
-      size = nbins;
-      shape = (vymax - vymin) / (vxmax - vxmin);
-
-      jmax = floor(nbins + 1.5001);
-      c1 = 2 * floor((nbins * shape) / sqrt(3) + 1.5001);
-      imax = floor((jmax * c1 - 1) / jmax + 1);
-      lmax = jmax * imax;
+      layout = hexbin_layout(nbins);
 
-      ycorr = (vymax - vymin) - ((imax - 2) * 1.5 * R + (imax % 2) * R);
-      ycorr = ycorr / 2;
-
-      cell = (int *)xcalloc(lmax + 1, sizeof(int));
-      cnt = (int *)xcalloc(lmax + 1, sizeof(int));
-      xcm = (double *)xcalloc(lmax + 1, sizeof(double));
-      ycm = (double *)xcalloc(lmax + 1, sizeof(double));
+      cell = (int *)xcalloc(layout->lmax + 1, sizeof(int));
+      cnt = (int *)xcalloc(layout->lmax + 1, sizeof(int));
+      xcm = (double *)xcalloc(layout->lmax + 1, sizeof(double));
+      ycm = (double *)xcalloc(layout->lmax + 1, sizeof(double));
 
       rx[0] = vxmin;
       rx[1] = vxmax;
       ry[0] = vymin;
       ry[1] = vymax;
 
-      bnd[0] = imax;
-      bnd[1] = jmax;
+      bnd[0] = layout->imax;
+      bnd[1] = layout->jmax;
 
-      nc = binning(x, y, cell, cnt, size, shape, rx, ry, bnd, n, ycorr);
+      nc = binning(x, y, cell, cnt, layout, bnd, n);
 
-      cntmax = hcell2xy(nbins, rx, ry, shape, bnd, cell, xcm, ycm, cnt, ycorr);
+      cntmax = hcell2xy(nbins, rx, ry, layout->shape, bnd, cell, xcm, ycm, cnt, layout->ycorr);
 
       context_ = (hexbin_2pass_t *)xmalloc(sizeof(hexbin_2pass_t));
       context_->nc = nc;
@@ -10597,56 +11597,87 @@ void gr_inqcolor(int color, int *rgb)
   int wkid = 1, errind;
   double r, g, b;
 
-  check_autoinit;
+  check_autoinit;
+
+  gks_inq_color_rep(wkid, color, GKS_K_VALUE_SET, &errind, &r, &g, &b);
+  *rgb = ((nint(r * 255) & 0xff)) | ((nint(g * 255) & 0xff) << 8) | ((nint(b * 255) & 0xff) << 16);
+}
+
+/*
+ * Find the color index with the smallest weighted distance to the given color. Like a linear scan over all indices,
+ * the first index closer than FEPS wins and ties go to the lower index. The grid cells are visited in shells of growing
+ * Chebyshev distance around the cell of the requested color until no unvisited cell can contain a closer color.
+ */
+static int nearest_color(double red, double green, double blue)
+{
+  int qr, qg, qb, ir, ig, ib, k, kmax, color, ind = 0, exact = -1;
+  double dmin = FLT_MAX, d, dr, dg, db, bound;
+  const double *rep;
+
+  qr = rgb_grid_coordinate(0.30 * red, RGB_GRID_R);
+  qg = rgb_grid_coordinate(0.59 * green, RGB_GRID_G);
+  qb = rgb_grid_coordinate(0.11 * blue, RGB_GRID_B);
+  kmax = max(max(RGB_GRID_R, RGB_GRID_G), RGB_GRID_B);
+
+  for (k = 0; k < kmax; k++)
+    {
+      for (ir = max(qr - k, 0); ir <= min(qr + k, RGB_GRID_R - 1); ir++)
+        for (ig = max(qg - k, 0); ig <= min(qg + k, RGB_GRID_G - 1); ig++)
+          for (ib = max(qb - k, 0); ib <= min(qb + k, RGB_GRID_B - 1); ib++)
+            {
+              if (abs(ir - qr) != k && abs(ig - qg) != k && abs(ib - qb) != k) continue;
+
+              for (color = color_lookup.cell[(ir * RGB_GRID_G + ig) * RGB_GRID_B + ib]; color >= 0;
+                   color = color_lookup.next_in_cell[color])
+                {
+                  rep = color_lookup.rep[color];
+                  dr = 0.30 * (rep[0] - red);
+                  dg = 0.59 * (rep[1] - green);
+                  db = 0.11 * (rep[2] - blue);
+                  d = dr * dr + dg * dg + db * db;
+                  if (d < FEPS && (exact < 0 || color < exact)) exact = color;
+                  if (d < dmin || (d == dmin && color < ind))
+                    {
+                      ind = color;
+                      dmin = d;
+                    }
+                }
+            }
+
+      /* colors outside of the visited shells are at least k cells away along one axis */
+      bound = (k - 0.001) * RGB_GRID_CELL;
+      if (k > 0 && dmin < bound * bound) break;
+    }
 
-  gks_inq_color_rep(wkid, color, GKS_K_VALUE_SET, &errind, &r, &g, &b);
-  *rgb = ((nint(r * 255) & 0xff)) | ((nint(g * 255) & 0xff) << 8) | ((nint(b * 255) & 0xff) << 16);
+  return exact >= 0 ? exact : ind;
 }
 
 int gr_inqcolorfromrgb(double red, double green, double blue)
 {
-  int wkid = 1, color, errind, ind = 0;
+  int color, ind = -1;
   unsigned int rgbmask;
-  double r, g, b, dmin = FLT_MAX, d, dr, dg, db;
 
   check_autoinit;
 
   rgbmask = ((nint(red * 255) & 0xff)) | ((nint(green * 255) & 0xff) << 8) | ((nint(blue * 255) & 0xff) << 16);
 
-  for (color = 80; color < 980; color++)
-    if (rgb[color] == rgbmask)
-      {
-        setcolorrep(color, red, green, blue);
-        used[color] = 1;
-        return color;
-      }
+  for (color = color_lookup.bucket[rgb_hash(rgbmask)]; color >= 0; color = color_lookup.next_in_bucket[color])
+    if (rgb[color] == rgbmask && (ind < 0 || color < ind)) ind = color;
 
-  for (color = 80; color < 980; color++)
+  if (ind < 0)
     {
-      if (!used[color])
-        {
-          setcolorrep(color, red, green, blue);
-          used[color] = 1;
-          return color;
-        }
+      while (color_lookup.first_unused < RGB_COLOR_END && used[color_lookup.first_unused]) color_lookup.first_unused++;
+      if (color_lookup.first_unused < RGB_COLOR_END) ind = color_lookup.first_unused;
     }
 
-  for (color = 80; color < 980; color++)
+  if (ind >= 0)
     {
-      gks_inq_color_rep(wkid, color, GKS_K_VALUE_SET, &errind, &r, &g, &b);
-      dr = 0.30 * (r - red);
-      dg = 0.59 * (g - green);
-      db = 0.11 * (b - blue);
-      d = dr * dr + dg * dg + db * db;
-      if (d < dmin)
-        {
-          ind = color;
-          dmin = d;
-          if (d < FEPS) break;
-        }
+      setcolorrep(ind, red, green, blue);
+      used[ind] = 1;
+      return ind;
     }
 
-  return ind;
+  return nearest_color(red, green, blue);
 }
 
 void gr_hsvtorgb(double h, double s, double v, double *r, double *g, double *b)
@@ -11930,124 +12961,347 @@ void gr_endgraphics(void)
     }
 }
 
-static void latex2image(char *string, int pointSize, double *rgb, int *width, int *height, int **data)
+static char *latex_temp = NULL;
+static char *latex_preamble = NULL;
+
+/*
+ * Decoded LaTeX images, most recently used first. They are kept in memory in front of the `gr-cache-*.png` files, so
+ * repeated labels (and inquiring the extent of a label before drawing it) do not decode the PNG file again.
+ */
+static struct
 {
-  static char *temp = NULL;
-  int color;
-  char s[FILENAME_MAX], path[FILENAME_MAX], cache[33];
-  char *null, cmd[2 * FILENAME_MAX + 200];
-  static char *preamble = NULL;
-  char tex[FILENAME_MAX], dvi[FILENAME_MAX], png[FILENAME_MAX];
-  FILE *stream;
-  int math, ret;
-#ifdef _WIN32
-  wchar_t w_path[MAX_PATH];
+  char key[33];
+  int width, height;
+  int *data;
+} latex_images[LATEX_IMAGE_CACHE_SIZE];
+
+static int num_latex_images = 0;
+static int latex_image_pixels = 0;
+
+#ifndef NO_THREADS
+
+/* LaTeX labels submitted by `gr_prefetchmathtex` are compiled by detached worker threads */
+enum
+{
+  LATEX_JOB_PENDING,
+  LATEX_JOB_RUNNING,
+  LATEX_JOB_DONE
+};
+
+typedef struct
+{
+  char *string;
+  int point_size;
+  double rgb[3];
+  char key[33];
+  int state;
+} latex_job_t;
+
+typedef struct latex_batch_t_
+{
+  latex_job_t *jobs;
+  int num_jobs, next_job, num_workers;
+  struct latex_batch_t_ *next;
+} latex_batch_t;
+
+static pthread_mutex_t latex_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t latex_job_done = PTHREAD_COND_INITIALIZER;
+static latex_batch_t *latex_batches = NULL;
+
 #endif
 
-  color = ((int)(rgb[0] * 255)) + ((int)(rgb[1] * 255) << 8) + ((int)(rgb[2] * 255) << 16) + (255 << 24);
-  snprintf(s, FILENAME_MAX, "%d%x%s", pointSize, color, string);
-  md5(s, cache, FILENAME_MAX);
-  if (temp == NULL)
+static void latex_init(void)
+{
+  if (latex_temp == NULL)
     {
 #ifdef _WIN32
-      temp = (char *)gks_getenv("TEMP");
+      latex_temp = (char *)gks_getenv("TEMP");
 #else
-      temp = mkdtemp("gr-temp");
+      latex_temp = mkdtemp("gr-temp");
 #endif
-      if (temp == NULL) temp = TMPDIR;
+      if (latex_temp == NULL) latex_temp = TMPDIR;
     }
-  snprintf(path, FILENAME_MAX, "%s%sgr-cache-%s.png", temp, DIRDELIM, cache);
-
-#ifdef _WIN32
-  MultiByteToWideChar(CP_UTF8, 0, path, strlen(path) + 1, w_path, MAX_PATH);
-  if (_waccess(w_path, R_OK) != 0)
-#else
-  if (access(path, R_OK) != 0)
-#endif
+  if (latex_preamble == NULL)
     {
-      math = strstr(string, "\\(") == NULL;
-      snprintf(tex, FILENAME_MAX, "%s%s%s.tex", temp, DIRDELIM, cache);
-      snprintf(dvi, FILENAME_MAX, "%s%s%s.dvi", temp, DIRDELIM, cache);
-      snprintf(png, FILENAME_MAX, "%s%s%s.png", temp, DIRDELIM, cache);
-#ifdef _WIN32
-      null = "NUL";
-      MultiByteToWideChar(CP_UTF8, 0, tex, strlen(tex) + 1, w_path, MAX_PATH);
-      stream = _wfopen(w_path, L"w");
-#else
-      null = "/dev/null";
-      stream = fopen(tex, "w");
-#endif
-      if (preamble == NULL)
-        {
-          preamble = (char *)gks_getenv("GR_LATEX_PREAMBLE");
-        }
-      if (preamble != NULL)
+      latex_preamble = (char *)gks_getenv("GR_LATEX_PREAMBLE");
+    }
+  if (latex_preamble != NULL)
+    {
+      if (strcmp(latex_preamble, "AMS") == 0)
         {
-          if (strcmp(preamble, "AMS") == 0)
-            {
-              preamble = "\
+          latex_preamble = "\
 \\documentclass{article}\n\
 \\pagestyle{empty}\n\
 \\usepackage{amssymb}\n\
 \\usepackage{amsmath}\n\
 \\usepackage[dvips]{color}\n\
 \\begin{document}\n";
-            }
         }
-      else
-        {
-          preamble = "\
+    }
+  else
+    {
+      latex_preamble = "\
 \\documentclass{article}\n\
 \\pagestyle{empty}\n\
 \\usepackage[dvips]{color}\n\
 \\begin{document}\n";
-        }
-      fprintf(stream, "%s", preamble);
-      if (math) fprintf(stream, "\\[\n");
-      fprintf(stream, "\\color[rgb]{%.3f,%.3f,%.3f} {\n", rgb[0], rgb[1], rgb[2]);
-      fwrite(string, strlen(string), 1, stream);
-      fprintf(stream, "}\n");
-      if (math) fprintf(stream, "\\]\n");
-      fprintf(stream, "\\end{document}");
-      fclose(stream);
-
-      snprintf(cmd, 2 * FILENAME_MAX + 200, "latex -interaction=batchmode -halt-on-error -output-directory=%s %s >%s",
-               temp, tex, null);
-      ret = system(cmd);
+    }
+}
+
+static void latex_image_key(char *string, int pointSize, double *rgb, char *key)
+{
+  char s[FILENAME_MAX];
+  int color;
+
+  color = ((int)(rgb[0] * 255)) + ((int)(rgb[1] * 255) << 8) + ((int)(rgb[2] * 255) << 16) + (255 << 24);
+  snprintf(s, FILENAME_MAX, "%d%x%s", pointSize, color, string);
+  md5(s, key, FILENAME_MAX);
+}
+
+static int latex_file_readable(const char *path)
+{
+#ifdef _WIN32
+  wchar_t w_path[MAX_PATH];
+
+  MultiByteToWideChar(CP_UTF8, 0, path, strlen(path) + 1, w_path, MAX_PATH);
+  return _waccess(w_path, R_OK) == 0;
+#else
+  return access(path, R_OK) == 0;
+#endif
+}
+
+/*
+ * Run latex and dvipng for `string` and store the result as `gr-cache-<key>.png` in the temporary directory. This
+ * function may be called from several threads at once (for different keys), `latex_init` must have been called before.
+ */
+static void compile_latex(const char *string, int pointSize, const double *rgb, const char *cache)
+{
+  char path[FILENAME_MAX];
+  char *null, cmd[2 * FILENAME_MAX + 200];
+  char tex[FILENAME_MAX], dvi[FILENAME_MAX], png[FILENAME_MAX];
+  const char *temp = latex_temp;
+  FILE *stream;
+  int math, ret;
+#ifdef _WIN32
+  wchar_t w_path[MAX_PATH];
+#endif
 
+  snprintf(path, FILENAME_MAX, "%s%sgr-cache-%s.png", temp, DIRDELIM, cache);
+  math = strstr(string, "\\(") == NULL;
+  snprintf(tex, FILENAME_MAX, "%s%s%s.tex", temp, DIRDELIM, cache);
+  snprintf(dvi, FILENAME_MAX, "%s%s%s.dvi", temp, DIRDELIM, cache);
+  snprintf(png, FILENAME_MAX, "%s%s%s.png", temp, DIRDELIM, cache);
 #ifdef _WIN32
-      MultiByteToWideChar(CP_UTF8, 0, dvi, strlen(dvi) + 1, w_path, MAX_PATH);
-      if (ret == 0 && _waccess(w_path, R_OK) == 0)
+  null = "NUL";
+  MultiByteToWideChar(CP_UTF8, 0, tex, strlen(tex) + 1, w_path, MAX_PATH);
+  stream = _wfopen(w_path, L"w");
 #else
-      if (ret == 0 && access(dvi, R_OK) == 0)
+  null = "/dev/null";
+  stream = fopen(tex, "w");
 #endif
+  fprintf(stream, "%s", latex_preamble);
+  if (math) fprintf(stream, "\\[\n");
+  fprintf(stream, "\\color[rgb]{%.3f,%.3f,%.3f} {\n", rgb[0], rgb[1], rgb[2]);
+  fwrite(string, strlen(string), 1, stream);
+  fprintf(stream, "}\n");
+  if (math) fprintf(stream, "\\]\n");
+  fprintf(stream, "\\end{document}");
+  fclose(stream);
+
+  snprintf(cmd, 2 * FILENAME_MAX + 200, "latex -interaction=batchmode -halt-on-error -output-directory=%s %s >%s",
+           temp, tex, null);
+  ret = system(cmd);
+
+  if (ret == 0 && latex_file_readable(dvi))
+    {
+      snprintf(cmd, 2 * FILENAME_MAX + 200, "dvipng -bg transparent -q -T tight -x %d %s -o %s >%s",
+               pointSize * 100, dvi, png, null);
+      ret = system(cmd);
+      if (ret == 0)
         {
-          snprintf(cmd, 2 * FILENAME_MAX + 200, "dvipng -bg transparent -q -T tight -x %d %s -o %s >%s",
-                   pointSize * 100, dvi, png, null);
-          ret = system(cmd);
-          if (ret == 0)
+          rename(png, path);
+          if (remove(tex) != 0 || remove(dvi) != 0)
             {
-              rename(png, path);
-              if (remove(tex) != 0 || remove(dvi) != 0)
-                {
-                  fprintf(stderr, "error deleting temprorary files\n");
-                }
+              fprintf(stderr, "error deleting temprorary files\n");
             }
-          else
-            fprintf(stderr, "dvipng: PNG conversion failed\n");
         }
       else
-        fprintf(stderr, "latex: failed to create a dvi file\n");
+        fprintf(stderr, "dvipng: PNG conversion failed\n");
     }
+  else
+    fprintf(stderr, "latex: failed to create a dvi file\n");
+}
 
-#ifdef _WIN32
-  MultiByteToWideChar(CP_UTF8, 0, path, strlen(path) + 1, w_path, MAX_PATH);
-  if (_waccess(w_path, R_OK) == 0)
-#else
-  if (access(path, R_OK) == 0)
+#ifndef NO_THREADS
+
+static latex_job_t *find_latex_job(const char *key)
+{
+  latex_batch_t *batch;
+  int i;
+
+  for (batch = latex_batches; batch != NULL; batch = batch->next)
+    {
+      for (i = 0; i < batch->num_jobs; i++)
+        {
+          if (strcmp(batch->jobs[i].key, key) == 0) return batch->jobs + i;
+        }
+    }
+  return NULL;
+}
+
+/*
+ * Wait for a prefetched label to be compiled. A job that no worker has started yet is compiled by the calling thread
+ * instead. Returns 0 if the label has not been submitted by `gr_prefetchmathtex`.
+ */
+static int wait_for_latex_job(const char *key)
+{
+  latex_job_t *job;
+  int found = 0;
+
+  pthread_mutex_lock(&latex_lock);
+  while ((job = find_latex_job(key)) != NULL)
+    {
+      found = 1;
+      if (job->state == LATEX_JOB_PENDING)
+        {
+          job->state = LATEX_JOB_RUNNING;
+          pthread_mutex_unlock(&latex_lock);
+          compile_latex(job->string, job->point_size, job->rgb, job->key);
+          pthread_mutex_lock(&latex_lock);
+          job->state = LATEX_JOB_DONE;
+          pthread_cond_broadcast(&latex_job_done);
+          break;
+        }
+      if (job->state == LATEX_JOB_DONE) break;
+      pthread_cond_wait(&latex_job_done, &latex_lock);
+    }
+  pthread_mutex_unlock(&latex_lock);
+  return found;
+}
+
+static void *latex_worker(void *arg)
+{
+  latex_batch_t *batch = (latex_batch_t *)arg, **prev;
+  latex_job_t *job;
+  int i;
+
+  pthread_mutex_lock(&latex_lock);
+  while (batch->next_job < batch->num_jobs)
+    {
+      job = batch->jobs + batch->next_job++;
+      if (job->state != LATEX_JOB_PENDING) continue;
+      job->state = LATEX_JOB_RUNNING;
+      pthread_mutex_unlock(&latex_lock);
+      compile_latex(job->string, job->point_size, job->rgb, job->key);
+      pthread_mutex_lock(&latex_lock);
+      job->state = LATEX_JOB_DONE;
+      pthread_cond_broadcast(&latex_job_done);
+    }
+
+  if (--batch->num_workers == 0)
+    {
+      /* the last worker waits for jobs taken over by a drawing thread and releases the batch */
+      for (i = 0; i < batch->num_jobs; i++)
+        {
+          while (batch->jobs[i].state != LATEX_JOB_DONE) pthread_cond_wait(&latex_job_done, &latex_lock);
+        }
+      for (prev = &latex_batches; *prev != batch; prev = &(*prev)->next)
+        ;
+      *prev = batch->next;
+      pthread_cond_broadcast(&latex_job_done);
+      pthread_mutex_unlock(&latex_lock);
+
+      for (i = 0; i < batch->num_jobs; i++)
+        {
+          free(batch->jobs[i].string);
+        }
+      free(batch->jobs);
+      free(batch);
+    }
+  else
+    {
+      pthread_mutex_unlock(&latex_lock);
+    }
+  return NULL;
+}
+
+#endif
+
+static int find_latex_image(const char *key)
+{
+  int i;
+
+  for (i = 0; i < num_latex_images; i++)
+    {
+      if (strcmp(latex_images[i].key, key) == 0) return i;
+    }
+  return -1;
+}
+
+static void add_latex_image(const char *key, int width, int height, const int *data)
+{
+  int i = LATEX_IMAGE_CACHE_SIZE;
+
+  if (width * height > LATEX_IMAGE_CACHE_MAX_PIXELS) return;
+  while (num_latex_images == LATEX_IMAGE_CACHE_SIZE ||
+         (num_latex_images > 0 && latex_image_pixels + width * height > LATEX_IMAGE_CACHE_MAX_PIXELS))
+    {
+      i = --num_latex_images;
+      latex_image_pixels -= latex_images[i].width * latex_images[i].height;
+      free(latex_images[i].data);
+    }
+  memmove(latex_images + 1, latex_images, num_latex_images * sizeof(latex_images[0]));
+  strcpy(latex_images[0].key, key);
+  latex_images[0].width = width;
+  latex_images[0].height = height;
+  latex_images[0].data = (int *)xmalloc(width * height * sizeof(int));
+  memcpy(latex_images[0].data, data, width * height * sizeof(int));
+  latex_image_pixels += width * height;
+  num_latex_images++;
+}
+
+static void latex2image(char *string, int pointSize, double *rgb, int *width, int *height, int **data)
+{
+  char path[FILENAME_MAX], cache[33];
+  int i, compiled = 0;
+
+  latex_image_key(string, pointSize, rgb, cache);
+  i = find_latex_image(cache);
+  if (i >= 0)
+    {
+      if (i > 0)
+        {
+          char key[33];
+          int w = latex_images[i].width, h = latex_images[i].height, *image = latex_images[i].data;
+
+          strcpy(key, latex_images[i].key);
+          memmove(latex_images + 1, latex_images, i * sizeof(latex_images[0]));
+          strcpy(latex_images[0].key, key);
+          latex_images[0].width = w;
+          latex_images[0].height = h;
+          latex_images[0].data = image;
+        }
+      *width = latex_images[0].width;
+      *height = latex_images[0].height;
+      *data = (int *)xmalloc(*width * *height * sizeof(int));
+      memcpy(*data, latex_images[0].data, *width * *height * sizeof(int));
+      return;
+    }
+
+  latex_init();
+  snprintf(path, FILENAME_MAX, "%s%sgr-cache-%s.png", latex_temp, DIRDELIM, cache);
+#ifndef NO_THREADS
+  compiled = wait_for_latex_job(cache);
 #endif
+  if (!compiled && !latex_file_readable(path))
+    {
+      compile_latex(string, pointSize, rgb, cache);
+    }
+
+  if (latex_file_readable(path))
     {
       gr_readimage(path, width, height, data);
+      if (*data != NULL) add_latex_image(cache, *width, *height, *data);
     }
 }
 
@@ -12084,29 +13338,38 @@ static int *rotr90(int m, int n, int *mat)
   return trans;
 }
 
-static void mathtex(double x, double y, char *string, int inquire, double *tbx, double *tby)
+/* Determine the resolution, point size and color LaTeX labels are rendered with for the current text attributes */
+static void latex_image_params(int *pixels, double *chh, int *pointSize, double *rgb)
 {
-  int wkid = 1, errind, conid, wtype, dcunit;
-  int pointSize, pixels, color;
-  double chh, rgb[3], ux, uy;
-  int width, height, *data = NULL, w, h, *trans = NULL;
-  double rad, rw, rh, rx, ry, xx, yy, bbx[4], bby[4];
-  double x1, x2, y1, y2, midx, midy, sinf, cosf;
-  int i, j, ii, jj, angle, path, halign, valign, tnr;
+  int wkid = 1, errind, conid, wtype, dcunit, width, height, color;
+  double rw, rh;
 
   gks_inq_ws_conntype(wkid, &errind, &conid, &wtype);
   gks_inq_max_ds_size(wtype, &errind, &dcunit, &rw, &rh, &width, &height);
   if (sizex > 0)
-    pixels = sizex / rh * height;
+    *pixels = sizex / rh * height;
   else
-    pixels = 500;
-  if (wtype == 101 || wtype == 102 || wtype == 120 || wtype == 382) pixels *= 8;
+    *pixels = 500;
+  if (wtype == 101 || wtype == 102 || wtype == 120 || wtype == 382) *pixels *= 8;
 
-  gks_inq_text_height(&errind, &chh);
+  gks_inq_text_height(&errind, chh);
   gks_inq_text_color_index(&errind, &color);
   gks_inq_color_rep(wkid, color, GKS_K_VALUE_SET, &errind, &rgb[0], &rgb[1], &rgb[2]);
 
-  pointSize = chh * pixels;
+  *pointSize = *chh * *pixels;
+}
+
+static void mathtex(double x, double y, char *string, int inquire, double *tbx, double *tby)
+{
+  int errind;
+  int pointSize, pixels;
+  double chh, rgb[3], ux, uy;
+  int width, height, *data = NULL, w, h, *trans = NULL;
+  double rad, rw, rh, rx, ry, xx, yy, bbx[4], bby[4];
+  double x1, x2, y1, y2, midx, midy, sinf, cosf;
+  int i, j, ii, jj, angle, path, halign, valign, tnr;
+
+  latex_image_params(&pixels, &chh, &pointSize, rgb);
   latex2image(string, pointSize, rgb, &width, &height, &data);
 
   gks_inq_text_upvec(&errind, &ux, &uy);
@@ -12310,6 +13573,107 @@ void gr_inqmathtex(double x, double y, char *string, double *tbx, double *tby)
   free(s);
 }
 
+/*!
+ * Compile LaTeX formulas in the background so that subsequent calls of gr_mathtex or gr_inqmathtex do not have to
+ * wait for LaTeX.
+ *
+ * \param[in] n The number of formulas
+ * \param[in] strings The formulas, with or without enclosing dollar signs
+ *
+ * The formulas are compiled for the current text height, text color and workstation, so this function should be
+ * called with the same text attributes that the formulas will be drawn with. Formulas that are drawn without LaTeX,
+ * i.e. if a font with precision GKS_K_TEXT_PRECISION_OUTLINE is selected, are ignored.
+ */
+void gr_prefetchmathtex(int n, char **strings)
+{
+  int unused, prec, pixels, pointSize, i, len, num_jobs = 0;
+  double chh, rgb[3];
+  char path[FILENAME_MAX], key[33], *s;
+#ifndef NO_THREADS
+  latex_batch_t *batch;
+  pthread_attr_t attr;
+  pthread_t thread;
+  int num_threads;
+#endif
+
+  check_autoinit;
+
+  gks_inq_text_fontprec(&unused, &unused, &prec);
+  if (prec == 3 || n <= 0) return;
+
+  latex_image_params(&pixels, &chh, &pointSize, rgb);
+  latex_init();
+
+#ifndef NO_THREADS
+  batch = (latex_batch_t *)xcalloc(1, sizeof(latex_batch_t));
+  batch->jobs = (latex_job_t *)xcalloc(n, sizeof(latex_job_t));
+  pthread_mutex_lock(&latex_lock);
+  batch->next = latex_batches;
+  latex_batches = batch;
+#endif
+  for (i = 0; i < n; i++)
+    {
+      s = strdup(strings[i]);
+      len = strlen(s);
+      if (len > 1 && *s == '$' && s[len - 1] == '$')
+        {
+          memmove(s, s + 1, len - 2);
+          s[len - 2] = '\0';
+        }
+      latex_image_key(s, pointSize, rgb, key);
+      snprintf(path, FILENAME_MAX, "%s%sgr-cache-%s.png", latex_temp, DIRDELIM, key);
+#ifndef NO_THREADS
+      if (find_latex_image(key) >= 0 || latex_file_readable(path) || find_latex_job(key) != NULL)
+        {
+          free(s);
+          continue;
+        }
+      batch->jobs[num_jobs].string = s;
+      batch->jobs[num_jobs].point_size = pointSize;
+      memcpy(batch->jobs[num_jobs].rgb, rgb, sizeof(rgb));
+      strcpy(batch->jobs[num_jobs].key, key);
+      batch->jobs[num_jobs].state = LATEX_JOB_PENDING;
+      num_jobs++;
+      batch->num_jobs = num_jobs;
+#else
+      if (find_latex_image(key) < 0 && !latex_file_readable(path))
+        {
+          compile_latex(s, pointSize, rgb, key);
+          num_jobs++;
+        }
+      free(s);
+#endif
+    }
+
+#ifndef NO_THREADS
+  /* every worker runs one latex process at a time */
+  num_threads = min(threadpool_get_num_threads(), num_jobs);
+  pthread_attr_init(&attr);
+  pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+  for (i = 0; i < num_threads; i++)
+    {
+      if (pthread_create(&thread, &attr, latex_worker, batch) != 0) break;
+      batch->num_workers++;
+    }
+  pthread_attr_destroy(&attr);
+
+  if (batch->num_workers == 0)
+    {
+      /* nothing to do or no worker could be started, latex2image compiles the formulas on demand */
+      latex_batches = batch->next;
+      pthread_mutex_unlock(&latex_lock);
+      for (i = 0; i < batch->num_jobs; i++)
+        {
+          free(batch->jobs[i].string);
+        }
+      free(batch->jobs);
+      free(batch);
+      return;
+    }
+  pthread_mutex_unlock(&latex_lock);
+#endif
+}
+
 void mathtex2_3d(double x, double y, double z, const char *formula, int axis, double textScale, int inquire,
                  double *tbx, double *tby, double *tbz, double *baseline);
 
@@ -12943,9 +14307,105 @@ int gr_inqregenflags(void)
   return regeneration_flags;
 }
 
+/*
+ * Store the GKS attributes covered by gr_savestate in `s`, taken from a single snapshot of the GKS state list.
+ */
+static void save_gks_state(state_list *s)
+{
+  gks_state_list_t gkss;
+
+  gks_save_state(&gkss);
+  s->ltype = gkss.ltype;
+  s->lwidth = gkss.lwidth;
+  s->plcoli = gkss.plcoli;
+  s->mtype = gkss.mtype;
+  s->mszsc = gkss.mszsc;
+  s->pmcoli = gkss.pmcoli;
+  s->txfont = gkss.txfont;
+  s->txprec = gkss.txprec;
+  s->chxp = gkss.chxp;
+  s->chsp = gkss.chsp;
+  s->txcoli = gkss.txcoli;
+  s->chh = gkss.chh;
+  s->chup[0] = gkss.chup[0];
+  s->chup[1] = gkss.chup[1];
+  s->txp = gkss.txp;
+  s->txal[0] = gkss.txal[0];
+  s->txal[1] = gkss.txal[1];
+  s->ints = gkss.ints;
+  s->styli = gkss.styli;
+  s->facoli = gkss.facoli;
+  s->alpha = gkss.alpha;
+
+  s->tnr = gkss.cntnr;
+  memcpy(s->wn, gkss.window[WC], sizeof(s->wn));
+  memcpy(s->vp, gkss.viewport[WC], sizeof(s->vp));
+
+  s->bwidth = gkss.bwidth;
+  s->bcoli = gkss.bcoli;
+  s->clip_tnr = gkss.clip_tnr;
+  s->resize_behaviour = gkss.resize_behaviour;
+  s->clip_region = gkss.clip_region;
+}
+
+/*
+ * Apply the GKS attributes stored in `s`. Only the attributes that differ from the current GKS state are set, so
+ * restoring an unchanged state does not send anything to the workstations.
+ */
+static void restore_gks_state(const state_list *s)
+{
+  gks_state_list_t gkss;
+
+  gks_save_state(&gkss);
+  gkss.ltype = s->ltype;
+  gkss.lwidth = s->lwidth;
+  gkss.plcoli = s->plcoli;
+  gkss.mtype = s->mtype;
+  gkss.mszsc = s->mszsc;
+  gkss.pmcoli = s->pmcoli;
+  gkss.txfont = s->txfont;
+  gkss.txprec = s->txprec;
+  gkss.chxp = s->chxp;
+  gkss.chsp = s->chsp;
+  gkss.txcoli = s->txcoli;
+  gkss.chh = s->chh;
+  gkss.chup[0] = s->chup[0];
+  gkss.chup[1] = s->chup[1];
+  gkss.txp = s->txp;
+  gkss.txal[0] = s->txal[0];
+  gkss.txal[1] = s->txal[1];
+  gkss.ints = s->ints;
+  gkss.styli = s->styli;
+  gkss.facoli = s->facoli;
+  gkss.alpha = s->alpha;
+
+  gkss.cntnr = s->tnr;
+  memcpy(gkss.window[WC], s->wn, sizeof(s->wn));
+  gkss.window[MODERN_NDC][0] = -1;
+  gkss.window[MODERN_NDC][1] = 1;
+  gkss.window[MODERN_NDC][2] = -1;
+  gkss.window[MODERN_NDC][3] = 1;
+  memcpy(gkss.viewport[WC], s->vp, sizeof(s->vp));
+  memcpy(gkss.viewport[MODERN_NDC], s->vp, sizeof(s->vp));
+
+  gkss.bwidth = s->bwidth;
+  gkss.bcoli = s->bcoli;
+  gkss.clip_tnr = s->clip_tnr;
+  gkss.resize_behaviour = s->resize_behaviour;
+  gkss.clip_region = s->clip_region;
+
+  gks_restore_state(&gkss);
+
+  vxmin = s->vp[0];
+  vxmax = s->vp[1];
+  vymin = s->vp[2];
+  vymax = s->vp[3];
+
+  setscale(s->scale_options);
+}
+
 void gr_savestate(void)
 {
-  int errind;
   state_list *s = NULL;
 
   check_autoinit;
@@ -12957,36 +14417,9 @@ void gr_savestate(void)
       s = state + state_saved;
       state_saved += 1;
 
-      gks_inq_pline_linetype(&errind, &s->ltype);
-      gks_inq_pline_linewidth(&errind, &s->lwidth);
-      gks_inq_pline_color_index(&errind, &s->plcoli);
-      gks_inq_pmark_type(&errind, &s->mtype);
-      gks_inq_pmark_size(&errind, &s->mszsc);
-      gks_inq_pmark_color_index(&errind, &s->pmcoli);
-      gks_inq_text_fontprec(&errind, &s->txfont, &s->txprec);
-      gks_inq_text_expfac(&errind, &s->chxp);
-      gks_inq_text_spacing(&errind, &s->chsp);
-      gks_inq_text_color_index(&errind, &s->txcoli);
-      gks_inq_text_height(&errind, &s->chh);
-      gks_inq_text_upvec(&errind, &s->chup[0], &s->chup[1]);
-      gks_inq_text_path(&errind, &s->txp);
-      gks_inq_text_align(&errind, &s->txal[0], &s->txal[1]);
-      gks_inq_fill_int_style(&errind, &s->ints);
-      gks_inq_fill_style_index(&errind, &s->styli);
-      gks_inq_fill_color_index(&errind, &s->facoli);
-      gks_inq_transparency(&errind, &s->alpha);
-
-      gks_inq_current_xformno(&errind, &s->tnr);
-      gks_inq_xform(WC, &errind, s->wn, s->vp);
-
+      save_gks_state(s);
       s->scale_options = lx.scale_options;
 
-      gks_inq_border_width(&errind, &s->bwidth);
-      gks_inq_border_color_index(&errind, &s->bcoli);
-      gks_inq_clip_xform(&errind, &s->clip_tnr);
-      gks_inq_resize_behaviour(&s->resize_behaviour);
-      gks_inq_clip_region(&errind, &s->clip_region);
-
       s->txoff[0] = txoff[0];
       s->txoff[1] = txoff[1];
     }
@@ -13007,42 +14440,7 @@ void gr_restorestate(void)
       state_saved -= 1;
       s = state + state_saved;
 
-      gks_set_pline_linetype(s->ltype);
-      gks_set_pline_linewidth(s->lwidth);
-      gks_set_pline_color_index(s->plcoli);
-      gks_set_pmark_type(s->mtype);
-      gks_set_pmark_size(s->mszsc);
-      gks_set_pmark_color_index(s->pmcoli);
-      gks_set_text_fontprec(s->txfont, s->txprec);
-      gks_set_text_expfac(s->chxp);
-      gks_set_text_spacing(s->chsp);
-      gks_set_text_color_index(s->txcoli);
-      gks_set_text_height(s->chh);
-      gks_set_text_upvec(s->chup[0], s->chup[1]);
-      gks_set_text_path(s->txp);
-      gks_set_text_align(s->txal[0], s->txal[1]);
-      gks_set_fill_int_style(s->ints);
-      gks_set_fill_style_index(s->styli);
-      gks_set_fill_color_index(s->facoli);
-      gks_set_transparency(s->alpha);
-
-      gks_select_xform(s->tnr);
-      gks_set_window(WC, s->wn[0], s->wn[1], s->wn[2], s->wn[3]);
-      gks_set_window(MODERN_NDC, -1, 1, -1, 1);
-      gks_set_viewport(WC, s->vp[0], s->vp[1], s->vp[2], s->vp[3]);
-      gks_set_viewport(MODERN_NDC, s->vp[0], s->vp[1], s->vp[2], s->vp[3]);
-      vxmin = s->vp[0];
-      vxmax = s->vp[1];
-      vymin = s->vp[2];
-      vymax = s->vp[3];
-
-      setscale(s->scale_options);
-
-      gks_set_border_width(s->bwidth);
-      gks_set_border_color_index(s->bcoli);
-      gks_select_clip_xform(s->clip_tnr);
-      gks_set_resize_behaviour(s->resize_behaviour);
-      gks_set_clip_region(s->clip_region);
+      restore_gks_state(s);
 
       s->txoff[0] = txoff[0];
       s->txoff[1] = txoff[1];
@@ -13131,7 +14529,7 @@ void gr_selectcontext(int context)
       id = context - 1;
       if (app_context->buf[id] == NULL)
         {
-          app_context->buf[id] = (state_list *)xmalloc(sizeof(state_list));
+          app_context->buf[id] = (state_list *)xcalloc(1, sizeof(state_list));
           app_context->max_non_null_id = max(app_context->max_non_null_id, id);
           ctx = app_context->buf[id];
 
@@ -13179,42 +14577,7 @@ void gr_selectcontext(int context)
           ctx = app_context->buf[id];
         }
 
-      gks_set_pline_linetype(ctx->ltype);
-      gks_set_pline_linewidth(ctx->lwidth);
-      gks_set_pline_color_index(ctx->plcoli);
-      gks_set_pmark_type(ctx->mtype);
-      gks_set_pmark_size(ctx->mszsc);
-      gks_set_pmark_color_index(ctx->pmcoli);
-      gks_set_text_fontprec(ctx->txfont, ctx->txprec);
-      gks_set_text_expfac(ctx->chxp);
-      gks_set_text_spacing(ctx->chsp);
-      gks_set_text_color_index(ctx->txcoli);
-      gks_set_text_height(ctx->chh);
-      gks_set_text_upvec(ctx->chup[0], ctx->chup[1]);
-      gks_set_text_path(ctx->txp);
-      gks_set_text_align(ctx->txal[0], ctx->txal[1]);
-      gks_set_fill_int_style(ctx->ints);
-      gks_set_fill_style_index(ctx->styli);
-      gks_set_fill_color_index(ctx->facoli);
-      gks_set_transparency(ctx->alpha);
-
-      gks_select_xform(ctx->tnr);
-      gks_set_window(WC, ctx->wn[0], ctx->wn[1], ctx->wn[2], ctx->wn[3]);
-      gks_set_window(MODERN_NDC, -1, 1, -1, 1);
-      gks_set_viewport(WC, ctx->vp[0], ctx->vp[1], ctx->vp[2], ctx->vp[3]);
-      gks_set_viewport(MODERN_NDC, ctx->vp[0], ctx->vp[1], ctx->vp[2], ctx->vp[3]);
-      vxmin = ctx->vp[0];
-      vxmax = ctx->vp[1];
-      vymin = ctx->vp[2];
-      vymax = ctx->vp[3];
-
-      setscale(ctx->scale_options);
-
-      gks_set_border_width(ctx->bwidth);
-      gks_set_border_color_index(ctx->bcoli);
-      gks_select_clip_xform(ctx->clip_tnr);
-      gks_set_resize_behaviour(ctx->resize_behaviour);
-      gks_set_clip_region(ctx->clip_region);
+      restore_gks_state(ctx);
 
       txoff[0] = ctx->txoff[0];
       txoff[1] = ctx->txoff[1];
@@ -13228,7 +14591,6 @@ void gr_selectcontext(int context)
 
 void gr_savecontext(int context)
 {
-  int errind;
   int id;
 
   check_autoinit;
@@ -13260,40 +14622,13 @@ void gr_savecontext(int context)
       id = context - 1;
       if (app_context->buf[id] == NULL)
         {
-          app_context->buf[id] = (state_list *)xmalloc(sizeof(state_list));
+          app_context->buf[id] = (state_list *)xcalloc(1, sizeof(state_list));
           app_context->max_non_null_id = max(app_context->max_non_null_id, id);
         }
 
-      gks_inq_pline_linetype(&errind, &app_context->buf[id]->ltype);
-      gks_inq_pline_linewidth(&errind, &app_context->buf[id]->lwidth);
-      gks_inq_pline_color_index(&errind, &app_context->buf[id]->plcoli);
-      gks_inq_pmark_type(&errind, &app_context->buf[id]->mtype);
-      gks_inq_pmark_size(&errind, &app_context->buf[id]->mszsc);
-      gks_inq_pmark_color_index(&errind, &app_context->buf[id]->pmcoli);
-      gks_inq_text_fontprec(&errind, &app_context->buf[id]->txfont, &app_context->buf[id]->txprec);
-      gks_inq_text_expfac(&errind, &app_context->buf[id]->chxp);
-      gks_inq_text_spacing(&errind, &app_context->buf[id]->chsp);
-      gks_inq_text_color_index(&errind, &app_context->buf[id]->txcoli);
-      gks_inq_text_height(&errind, &app_context->buf[id]->chh);
-      gks_inq_text_upvec(&errind, &app_context->buf[id]->chup[0], &app_context->buf[id]->chup[1]);
-      gks_inq_text_path(&errind, &app_context->buf[id]->txp);
-      gks_inq_text_align(&errind, &app_context->buf[id]->txal[0], &app_context->buf[id]->txal[1]);
-      gks_inq_fill_int_style(&errind, &app_context->buf[id]->ints);
-      gks_inq_fill_style_index(&errind, &app_context->buf[id]->styli);
-      gks_inq_fill_color_index(&errind, &app_context->buf[id]->facoli);
-      gks_inq_transparency(&errind, &app_context->buf[id]->alpha);
-
-      gks_inq_current_xformno(&errind, &app_context->buf[id]->tnr);
-      gks_inq_xform(WC, &errind, app_context->buf[id]->wn, app_context->buf[id]->vp);
-
+      save_gks_state(app_context->buf[id]);
       app_context->buf[id]->scale_options = lx.scale_options;
 
-      gks_inq_border_width(&errind, &app_context->buf[id]->bwidth);
-      gks_inq_border_color_index(&errind, &app_context->buf[id]->bcoli);
-      gks_inq_clip_xform(&errind, &app_context->buf[id]->clip_tnr);
-      gks_inq_resize_behaviour(&app_context->buf[id]->resize_behaviour);
-      gks_inq_clip_region(&errind, &app_context->buf[id]->clip_region);
-
       app_context->buf[id]->txoff[0] = txoff[0];
       app_context->buf[id]->txoff[1] = txoff[1];
     }
@@ -13305,7 +14640,6 @@ void gr_savecontext(int context)
 
 void gr_destroycontext(int context)
 {
-  int errind;
   int id;
 
   check_autoinit;
@@ -13337,40 +14671,13 @@ void gr_destroycontext(int context)
       id = context - 1;
       if (app_context->buf[id] == NULL)
         {
-          app_context->buf[id] = (state_list *)xmalloc(sizeof(state_list));
+          app_context->buf[id] = (state_list *)xcalloc(1, sizeof(state_list));
           app_context->max_non_null_id = max(app_context->max_non_null_id, id);
         }
 
-      gks_inq_pline_linetype(&errind, &app_context->buf[id]->ltype);
-      gks_inq_pline_linewidth(&errind, &app_context->buf[id]->lwidth);
-      gks_inq_pline_color_index(&errind, &app_context->buf[id]->plcoli);
-      gks_inq_pmark_type(&errind, &app_context->buf[id]->mtype);
-      gks_inq_pmark_size(&errind, &app_context->buf[id]->mszsc);
-      gks_inq_pmark_color_index(&errind, &app_context->buf[id]->pmcoli);
-      gks_inq_text_fontprec(&errind, &app_context->buf[id]->txfont, &app_context->buf[id]->txprec);
-      gks_inq_text_expfac(&errind, &app_context->buf[id]->chxp);
-      gks_inq_text_spacing(&errind, &app_context->buf[id]->chsp);
-      gks_inq_text_color_index(&errind, &app_context->buf[id]->txcoli);
-      gks_inq_text_height(&errind, &app_context->buf[id]->chh);
-      gks_inq_text_upvec(&errind, &app_context->buf[id]->chup[0], &app_context->buf[id]->chup[1]);
-      gks_inq_text_path(&errind, &app_context->buf[id]->txp);
-      gks_inq_text_align(&errind, &app_context->buf[id]->txal[0], &app_context->buf[id]->txal[1]);
-      gks_inq_fill_int_style(&errind, &app_context->buf[id]->ints);
-      gks_inq_fill_style_index(&errind, &app_context->buf[id]->styli);
-      gks_inq_fill_color_index(&errind, &app_context->buf[id]->facoli);
-      gks_inq_transparency(&errind, &app_context->buf[id]->alpha);
-
-      gks_inq_current_xformno(&errind, &app_context->buf[id]->tnr);
-      gks_inq_xform(WC, &errind, app_context->buf[id]->wn, app_context->buf[id]->vp);
-
+      save_gks_state(app_context->buf[id]);
       app_context->buf[id]->scale_options = lx.scale_options;
 
-      gks_inq_border_width(&errind, &app_context->buf[id]->bwidth);
-      gks_inq_border_color_index(&errind, &app_context->buf[id]->bcoli);
-      gks_inq_clip_xform(&errind, &app_context->buf[id]->clip_tnr);
-      gks_inq_resize_behaviour(&app_context->buf[id]->resize_behaviour);
-      gks_inq_clip_region(&errind, &app_context->buf[id]->clip_region);
-
       app_context->buf[id]->txoff[0] = txoff[0];
       app_context->buf[id]->txoff[1] = txoff[1];
     }
@@ -13380,6 +14687,63 @@ void gr_destroycontext(int context)
     }
 }
 
+static state_list *saved_context(int context)
+{
+  if (app_context == NULL || context < 1 || (size_t)context > app_context->capacity) return NULL;
+  return app_context->buf[context - 1];
+}
+
+/*!
+ * Compute a hash value of the GR state saved in a context.
+ *
+ * \param[in] context The context id
+ * \return The hash value of the saved state or 0 if no state was saved under this id
+ *
+ * Contexts which hold the same state have the same hash value, so applications can use it to find out whether an
+ * equal state was saved before, e.g. to share a single context between several objects. Different states may have
+ * the same hash value, so candidates must be verified with `gr_comparecontexts`.
+ */
+unsigned int gr_hashcontext(int context)
+{
+  const unsigned char *bytes;
+  unsigned int hash = 2166136261u;
+  size_t i;
+  state_list *s;
+
+  check_autoinit;
+
+  s = saved_context(context);
+  if (s == NULL) return 0;
+
+  /* contexts are allocated zero-initialized, so the padding between the members does not affect the hash value */
+  bytes = (const unsigned char *)s;
+  for (i = 0; i < sizeof(state_list); i++)
+    {
+      hash = (hash ^ bytes[i]) * 16777619u;
+    }
+  return hash;
+}
+
+/*!
+ * Compare the GR states saved in two contexts.
+ *
+ * \param[in] context1 The first context id
+ * \param[in] context2 The second context id
+ * \return 0 if both contexts hold the same state, a non-zero value otherwise or if one of them was never saved
+ */
+int gr_comparecontexts(int context1, int context2)
+{
+  state_list *s1, *s2;
+
+  check_autoinit;
+
+  s1 = saved_context(context1);
+  s2 = saved_context(context2);
+  if (s1 == NULL || s2 == NULL) return 1;
+
+  return memcmp(s1, s2, sizeof(state_list)) != 0;
+}
+
 void gr_unselectcontext(void)
 {
   check_autoinit;
@@ -13395,6 +14759,8 @@ int gr_uselinespec(char *linespec)
   char *spec = linespec, lastspec = ' ';
   int result, linetype = 0, markertype = 0, color = -1;
 
+  if (active_capture != NULL) active_capture->uses_linespec = 1;
+
   while (*spec)
     {
       switch (*spec)
@@ -14703,7 +16069,8 @@ static void bilinear_interpolation(double c00, double c10, double c01, double c1
 
 /*!
  * Set the number of threads which can run parallel. The default value is the number of threads the cpu has.
- * The only usage right now is inside `gr_cpubasedvolume` and `gr_volume_nogrid`.
+ * The setting applies to the shared worker pool used by the volume renderers, contour and cell array rasterization,
+ * hexbin, shade, interp2 and gridit as well as to `gr_volume_nogrid`.
  *
  * \param[in] num number of threads
  */
@@ -14713,6 +16080,7 @@ void gr_setthreadnumber(int num)
 
   vt.max_threads = max(1, num);
   vt.thread_size = 10 * (1.0 / (2.0 * num));
+  threadpool_set_num_threads(vt.max_threads);
 
   if (flag_stream) gr_writestream("<setthreadnumber num=\"%i\"/>\n", num);
 }
@@ -14873,6 +16241,134 @@ static void trilinear_interpolation(double c000, double c001, double c010, doubl
   *erg = c0 * (1 - z_dist) + c1 * z_dist;
 }
 
+static volume_blocks_t volume_blocks = {NULL};
+
+static void volume_block_slabs(void *arg, int start, int end)
+{
+  volume_blocks_t *vb = (volume_blocks_t *)arg;
+  int nx = vb->nx, ny = vb->ny, nz = vb->nz;
+  int bx, by, bz, x, y, z, x_end, y_end, z_end, b;
+  double d, dmin, dmax;
+
+  for (bz = start; bz < end; bz++)
+    {
+      z_end = min(nz - 1, (bz + 1) * VOLUME_BLOCK_SIZE);
+      for (by = 0; by < vb->bny; by++)
+        {
+          y_end = min(ny - 1, (by + 1) * VOLUME_BLOCK_SIZE);
+          for (bx = 0; bx < vb->bnx; bx++)
+            {
+              x_end = min(nx - 1, (bx + 1) * VOLUME_BLOCK_SIZE);
+              dmin = DBL_MAX;
+              dmax = -DBL_MAX;
+              /* neighbouring blocks share their boundary voxels, so that every interpolation cell lies in a block */
+              for (z = bz * VOLUME_BLOCK_SIZE; z <= z_end; z++)
+                {
+                  for (y = by * VOLUME_BLOCK_SIZE; y <= y_end; y++)
+                    {
+                      for (x = bx * VOLUME_BLOCK_SIZE; x <= x_end; x++)
+                        {
+                          d = vb->data[x + (y + (long)z * ny) * nx];
+                          if (d < dmin) dmin = d;
+                          if (d > dmax) dmax = d;
+                          if (is_nan(d))
+                            {
+                              dmin = -DBL_MAX;
+                              dmax = DBL_MAX;
+                            }
+                        }
+                    }
+                }
+              b = bx + (by + bz * vb->bny) * vb->bnx;
+              vb->block_min[b] = dmin;
+              vb->block_max[b] = dmax;
+            }
+        }
+    }
+}
+
+/*
+ * Compute the coarse min/max grid of `data`. The caller may have changed the values in place since the previous
+ * call, so the grid is always rebuilt; only its storage is kept.
+ */
+static const volume_blocks_t *volume_blocks_for(const double *data, int nx, int ny, int nz)
+{
+  volume_blocks_t *vb = &volume_blocks;
+  int i, num_blocks;
+
+  vb->data = data;
+  vb->nx = nx;
+  vb->ny = ny;
+  vb->nz = nz;
+  vb->bnx = max(1, (nx - 1 + VOLUME_BLOCK_SIZE - 1) / VOLUME_BLOCK_SIZE);
+  vb->bny = max(1, (ny - 1 + VOLUME_BLOCK_SIZE - 1) / VOLUME_BLOCK_SIZE);
+  vb->bnz = max(1, (nz - 1 + VOLUME_BLOCK_SIZE - 1) / VOLUME_BLOCK_SIZE);
+  num_blocks = vb->bnx * vb->bny * vb->bnz;
+  vb->block_min = (double *)xrealloc(vb->block_min, num_blocks * sizeof(double));
+  vb->block_max = (double *)xrealloc(vb->block_max, num_blocks * sizeof(double));
+  threadpool_parallel_for(vb->bnz, 1, volume_block_slabs, vb);
+
+  vb->data_min = DBL_MAX;
+  for (i = 0; i < num_blocks; i++)
+    {
+      if (vb->block_min[i] < vb->data_min) vb->data_min = vb->block_min[i];
+    }
+  return vb;
+}
+
+/*
+ * Check whether the macro cell containing the ray segment from `ray_start` to `ray_end` can be skipped, i.e. it is
+ * completely zero for the emission and absorption models or does not exceed the current maximum `color` for MIP. In
+ * that case `lambda_exit` is set to the ray parameter at which the ray leaves the macro cell.
+ */
+static int volume_block_skippable(const volume_blocks_t *vb, const double *ray_start, const double *ray_end,
+                                  const double *ray_dir, const double *min_val_t, const double *max_val_t,
+                                  int algorithm, double color, double *lambda_exit)
+{
+  int i, b[3], nb[3];
+  double lo, hi, lambda, eps = 1e-8;
+
+  nb[0] = vb->bnx;
+  nb[1] = vb->bny;
+  nb[2] = vb->bnz;
+  for (i = 0; i < 3; i++)
+    {
+      b[i] = (int)floor((ray_start[i] + ray_end[i]) / 2 / VOLUME_BLOCK_SIZE);
+      b[i] = min(nb[i] - 1, max(0, b[i]));
+    }
+  i = b[0] + (b[1] + b[2] * vb->bny) * vb->bnx;
+  if (algorithm == 0 || algorithm == 1)
+    {
+      if (vb->block_min[i] != 0 || vb->block_max[i] != 0) return 0;
+    }
+  else if (vt.approximative_calculation == 0 || vb->block_max[i] > color)
+    {
+      /* the exact calculation fits a cubic polynomial, which may exceed the voxel values */
+      return 0;
+    }
+
+  *lambda_exit = DBL_MAX;
+  for (i = 0; i < 3; i++)
+    {
+      lo = b[i] == 0 ? min_val_t[i] : b[i] * VOLUME_BLOCK_SIZE;
+      hi = b[i] == nb[i] - 1 ? max_val_t[i] : (b[i] + 1) * VOLUME_BLOCK_SIZE;
+      if (ray_dir[i] > eps)
+        {
+          lambda = (hi - ray_start[i]) / ray_dir[i];
+        }
+      else if (ray_dir[i] < -eps)
+        {
+          lambda = (lo - ray_start[i]) / ray_dir[i];
+        }
+      else
+        {
+          continue;
+        }
+      if (lambda < *lambda_exit) *lambda_exit = lambda;
+    }
+  return *lambda_exit < DBL_MAX;
+}
+
 static void ray_casting_thread(void *arg)
 {
   int i, j, s;
@@ -14887,6 +16383,8 @@ static void ray_casting_thread(void *arg)
   double *data = rc->data, *pixels = rc->pixels;
   double *dmax_ptr = rc->dmax_ptr, *dmin_ptr = rc->dmin_ptr;
   double f_length, xaspect, yaspect, aspect_ratio;
+  const volume_blocks_t *blocks = rc->blocks;
+  double absorption_limit = VOLUME_ABSORPTION_LIMIT;
 
   double eps = 1e-8; /* precision parameter for comparisons */
   double x_spacing = 1. / nx;
@@ -14908,6 +16406,12 @@ static void ray_casting_thread(void *arg)
       max_val_t[2] = nz - 0.5;
     }
 
+  /* with non-negative data the transmittance only decreases, so absorption rays can stop once it drops below dmin */
+  if (dmin_ptr != NULL && *dmin_ptr > 0)
+    {
+      absorption_limit = min(absorption_limit, -log(*dmin_ptr));
+    }
+
   /* the direction of each ray is the same when the projection_type is set to orthographic */
   ray_dir_default[0] = (tx.focus_point_x - tx.camera_pos_x);
   ray_dir_default[1] = (tx.focus_point_y - tx.camera_pos_y);
@@ -15148,6 +16652,23 @@ static void ray_casting_thread(void *arg)
               ray_end[1] = ray_start[1] + lambda_min * ray_dir[1];
               ray_end[2] = ray_start[2] + lambda_min * ray_dir[2];
 
+              /* jump over macro cells which cannot contribute to the pixel */
+              if (volume_block_skippable(blocks, ray_start, ray_end, ray_dir, min_val_t, max_val_t, algorithm, color,
+                                         &lambda_min))
+                {
+                  ray_start[0] += lambda_min * ray_dir[0];
+                  ray_start[1] += lambda_min * ray_dir[1];
+                  ray_start[2] += lambda_min * ray_dir[2];
+                  start = NAN;
+                  if (fabs(ray_start[0] - max_val_t[0]) <= eps || fabs(ray_start[1] - max_val_t[1]) <= eps ||
+                      fabs(ray_start[2] - max_val_t[2]) <= eps || fabs(ray_start[0] - min_val_t[0]) <= eps ||
+                      fabs(ray_start[1] - min_val_t[1]) <= eps || fabs(ray_start[2] - min_val_t[2]) <= eps)
+                    {
+                      break;
+                    }
+                  continue;
+                }
+
               /* identify voxel */
               if (ray_dir[0] >= -eps)
                 {
@@ -15473,6 +16994,7 @@ static void ray_casting_thread(void *arg)
                   /* emission or absorption*/
                   color += voxel_influ;
                   if (rc->dmax_ptr != NULL && color >= *dmax_ptr) break;
+                  if (algorithm == 1 && blocks->data_min >= 0 && color > absorption_limit) break;
                 }
               else
                 {
@@ -15512,17 +17034,15 @@ static void ray_casting_thread(void *arg)
     }
 }
 
-static int system_processor_count(void)
+static void ray_casting_tiles(void *arg, int start, int end)
 {
-#ifdef _WIN32
-#ifndef _SC_NPROCESSORS_ONLN
-  SYSTEM_INFO info;
-  GetSystemInfo(&info);
-#define sysconf(a) info.dwNumberOfProcessors
-#define _SC_NPROCESSORS_ONLN
-#endif
-#endif
-  return (int)sysconf(_SC_NPROCESSORS_ONLN);
+  struct thread_attr *jobs = (struct thread_attr *)arg;
+  int i;
+
+  for (i = start; i < end; i++)
+    {
+      ray_casting_thread(jobs + i);
+    }
 }
 
 /*!
@@ -15617,11 +17137,8 @@ const cpubasedvolume_2pass_t *gr_cpubasedvolume_2pass(int nx, int ny, int nz, do
   double min_val[3], max_val[3];
   int x_start = 0, x_end = 0, y_start = 0, y_end = 0;
   struct ray_casting_attr f;
-#ifndef NO_THREADS
-  threadpool_t *tp;
-#endif
   struct thread_attr *jobs;
-  int i, j = 0, threadnum;
+  int i, j = 0;
   check_autoinit;
 
   if (context == NULL)
@@ -15680,23 +17197,9 @@ const cpubasedvolume_2pass_t *gr_cpubasedvolume_2pass(int nx, int ny, int nz, do
       f.min_val = min_val;
       f.max_val = max_val;
       f.pixels = pixels;
+      f.blocks = volume_blocks_for(data, nx, ny, nz);
       vt.ray_casting = &f;
 
-/* creates the threadpool */
-#ifndef NO_THREADS
-      tp = calloc(1, sizeof(*tp));
-      if (tp == 0)
-        {
-          fprintf(stderr, "can't allocate memory");
-          return NULL;
-        }
-      threadnum = (system_processor_count() - 1) < 256 ? system_processor_count() - 1 : 256;
-      if (vt.max_threads > 0)
-        {
-          threadnum = vt.max_threads;
-        }
-      threadpool_create(tp, threadnum, ray_casting_thread);
-#endif
       jobs = (struct thread_attr *)gks_malloc(n_x * n_y * sizeof(struct thread_attr));
 
       for (i = 0; i < n_x; i++)
@@ -15710,20 +17213,12 @@ const cpubasedvolume_2pass_t *gr_cpubasedvolume_2pass(int nx, int ny, int nz, do
               jobs[i + j * n_x].y_start = y_start;
               jobs[i + j * n_x].x_end = x_end;
               jobs[i + j * n_x].y_end = y_end;
-
-#ifndef NO_THREADS
-              threadpool_add_work(tp, jobs + i + j * n_x);
-#else
-              ray_casting_thread(jobs + i + j * n_x);
-#endif
               y_start = y_end;
             }
           x_start = x_end;
           y_start = 0;
         }
-#ifndef NO_THREADS
-      threadpool_destroy(tp);
-#endif
+      threadpool_parallel_for(n_x * n_y, 1, ray_casting_tiles, jobs);
 
       /* calculate the min and max value of all pixels */
       if (dmax_ptr && *dmax_ptr < 0)
@@ -15812,19 +17307,13 @@ static double mean(const double *a, const int len, const int *connections)
   return sum / len;
 }
 
-static int compare_depth(const void *_a, const void *_b)
-{
-  double a = *(double *)_a, b = *(double *)_b;
-  return a > b ? 1 : a < b ? -1 : 0;
-}
-
 void gr_polygonmesh3d(int num_points, const double *px, const double *py, const double *pz, int num_connections,
                       const int *connections, const int *colors)
 {
-  int i, j, k, len, maxlen = 0, len_connections;
+  int i, j, k, len, len_connections;
   double *x, *y, *z;
-  int *faces, *faceP, *attributes;
-  double cam_x, cam_y, cam_z, up_x, up_y, up_z, foc_x, foc_y, foc_z, depth;
+  int *offsets, *attributes;
+  depth_key_t *keys;
 
   x = (double *)xcalloc(num_points, sizeof(double));
   y = (double *)xcalloc(num_points, sizeof(double));
@@ -15837,57 +17326,38 @@ void gr_polygonmesh3d(int num_points, const double *px, const double *py, const
       gr_wc3towc(&x[i], &y[i], &z[i]);
     }
 
+  offsets = (int *)xcalloc(num_connections, sizeof(int));
+  keys = (depth_key_t *)xcalloc(num_connections, sizeof(depth_key_t));
+
   j = 0;
   for (i = 0; i < num_connections; i++)
     {
+      offsets[i] = j;
       len = connections[j++];
-      if (len > maxlen) maxlen = len;
+      keys[i].key = (float)mean(z, len, connections + j);
+      keys[i].index = i;
       j += len;
     }
   len_connections = j;
 
-  faces = (int *)xcalloc(num_connections, sizeof(double) + (1 + maxlen + 1) * sizeof(int));
-  gr_inqtransformationparameters(&cam_x, &cam_y, &cam_z, &up_x, &up_y, &up_z, &foc_x, &foc_y, &foc_z);
-
-  j = 0;
-  faceP = faces;
-  for (i = 0; i < num_connections; i++)
-    {
-      len = connections[j++];
-      depth = mean(z, len, connections + j);
-      memcpy(faceP, &depth, sizeof(double));
-      faceP += sizeof(double) / sizeof(int);
-      memcpy(faceP, &len, sizeof(int));
-      faceP += 1;
-      memcpy(faceP, connections + j, len * sizeof(int));
-      faceP += maxlen;
-      memcpy(faceP, &colors[i], sizeof(int));
-      faceP += 1;
-      j += len;
-    }
-  qsort(faces, num_connections, (sizeof(double) + (1 + maxlen + 1) * sizeof(int)), compare_depth);
+  radixsort_depth_keys(num_connections, keys, worker_thread_count(num_connections, DEPTH_SORT_MIN_KEYS_PER_THREAD));
 
-  attributes = (int *)xcalloc(num_connections, (1 + maxlen + 1) * sizeof(int));
+  attributes = (int *)xcalloc(len_connections + num_connections, sizeof(int));
   k = 0;
-  faceP = faces;
   for (i = 0; i < num_connections; i++)
     {
-      faceP += sizeof(double) / sizeof(int);
-      len = attributes[k++] = *faceP;
-      faceP += 1;
-      for (j = 0; j < len; j++)
-        {
-          attributes[k++] = faceP[j];
-        }
-      faceP += maxlen;
-      attributes[k++] = *faceP;
-      faceP += 1;
+      j = offsets[keys[i].index];
+      len = attributes[k++] = connections[j++];
+      memcpy(attributes + k, connections + j, len * sizeof(int));
+      k += len;
+      attributes[k++] = colors[keys[i].index];
     }
 
   gks_gdp(num_points, x, y, GKS_K_GDP_FILL_POLYGONS, k, attributes);
 
   free(attributes);
-  free(faces);
+  free(keys);
+  free(offsets);
   free(z);
   free(y);
   free(x);
@@ -16250,120 +17720,202 @@ double gr_volume_interp_tri_linear(const data_point3d_t *dt_pt, const void *extr
   return dt_pt->data * val * dirlen;
 }
 
-static void *volume_nogrid_worker(void *data)
+/*
+ * Projected positions of the last point set drawn by `gr_volume_nogrid`. They only depend on the point coordinates,
+ * the image size and the 3D transformation, so redrawing the same points with different kernel parameters skips the
+ * projection. The points themselves are not copied: they are identified by their address, their count and a hash of
+ * their coordinates.
+ */
+static struct
+{
+  const data_point3d_t *dt_pts;
+  size_t num_points;
+  uint64_t hash;
+  double *positions;
+  int px_width, px_height;
+  double viewport[4];
+  world_xform wx;
+  transformation_xform tx;
+  projection_xform gpx;
+} volume_nogrid_cache = {NULL, 0, 0, NULL};
+
+/*
+ * 64-bit FNV-1a over the 64-bit words of the point coordinates. Each step also folds the high half of the hash into the
+ * low half, so the high bits of a coordinate affect all bits of the result.
+ */
+static uint64_t volume_nogrid_hash(size_t ndt_pt, const data_point3d_t *dt_pts)
 {
-  volume_nogrid_data_struct *d = (volume_nogrid_data_struct *)data;
-  int px_width = d->px_width, px_height = d->px_height;
-  point3d_t ray_dir_init = *(d->ray_dir_init);
-  point3d_t ray_dir_x = *(d->ray_dir_x);
-  point3d_t ray_dir_y = *(d->ray_dir_y);
-  point3d_t ray_from_init = *(d->ray_from_init);
-  point3d_t ray_from_x = *(d->ray_from_x);
-  point3d_t ray_from_y = *(d->ray_from_y);
-  double *pixels = d->pixels;
-  double x_factor = d->x_factor, y_factor = d->y_factor;
-  kernel_f callback = d->callback;
-  const data_point3d_t *curr_dt_pt = d->start;
-  const void **extra_data = d->extra_data;
+  const uint64_t fnv_prime = ((uint64_t)1 << 40) | 0x1b3;
+  uint64_t hash = ((uint64_t)0xcbf29ce4 << 32) | 0x84222325, words[3];
+  size_t i;
+  int j;
 
-  /* Initialize pixel buffer */
-  int my_x, my_y;
-  for (my_y = 0; my_y < px_height; ++my_y)
+  for (i = 0; i < ndt_pt; i++)
     {
-      for (my_x = 0; my_x < px_width; ++my_x)
+      memcpy(words, &dt_pts[i].pt, sizeof(words));
+      for (j = 0; j < 3; j++)
         {
-          pixels[my_x + my_y * px_width] = -1;
+          hash = (hash ^ words[j]) * fnv_prime;
+          hash ^= hash >> 32;
         }
     }
+  return hash;
+}
 
-  while (curr_dt_pt < d->end)
-    {
-      int y_start, y_fin;
-      double x, y, radius, x_radius, y_radius;
-      point3d_t _z;
+static int volume_nogrid_cache_matches(size_t ndt_pt, const data_point3d_t *dt_pts, uint64_t hash)
+{
+  return volume_nogrid_cache.positions != NULL && volume_nogrid_cache.dt_pts == dt_pts &&
+         volume_nogrid_cache.num_points == ndt_pt && volume_nogrid_cache.hash == hash &&
+         volume_nogrid_cache.px_width == vt.picture_width && volume_nogrid_cache.px_height == vt.picture_height &&
+         volume_nogrid_cache.viewport[0] == vxmin && volume_nogrid_cache.viewport[1] == vxmax &&
+         volume_nogrid_cache.viewport[2] == vymin && volume_nogrid_cache.viewport[3] == vymax &&
+         memcmp(&volume_nogrid_cache.wx, &wx, sizeof(wx)) == 0 &&
+         memcmp(&volume_nogrid_cache.tx, &tx, sizeof(tx)) == 0 &&
+         memcmp(&volume_nogrid_cache.gpx, &gpx, sizeof(gpx)) == 0;
+}
 
-      /* Zero optimization */
-      if (curr_dt_pt->data == 0)
-        {
-          ++curr_dt_pt;
-          if (extra_data != NULL) ++extra_data;
-          continue;
-        }
+static void volume_nogrid_project(void *arg, int start, int end)
+{
+  volume_nogrid_data_struct *d = (volume_nogrid_data_struct *)arg;
+  size_t i, first, last;
+  point3d_t _z;
 
-      /* Calculate extent on image */
-      radius = d->radius;
-      if (d->radius_callback != NULL)
-        {
-          radius = d->radius_callback(curr_dt_pt, (const void *)extra_data);
-        }
+  first = (size_t)start * VOLUME_NOGRID_POINTS_PER_CHUNK;
+  last = (size_t)end * VOLUME_NOGRID_POINTS_PER_CHUNK;
+  if (last > d->num_points) last = d->num_points;
 
-      _z = curr_dt_pt->pt;
+  for (i = first; i < last; i++)
+    {
+      _z = d->dt_pts[i].pt;
       apply_world_xform(&_z.x, &_z.y, &_z.z);
+      d->positions[2 * i] = (_z.x + 1) * d->px_width / 2;
+      d->positions[2 * i + 1] = (-_z.y + 1) * d->px_height / 2;
+    }
+}
 
-      x = (_z.x + 1) * px_width / 2;
-      y = (-_z.y + 1) * px_height / 2;
+/* Calculate the extent of data point `i` on the image, an empty one if the point can be skipped */
+static void volume_nogrid_extent(const volume_nogrid_data_struct *d, size_t i, volume_nogrid_splat_t *s)
+{
+  double radius;
 
-      x_radius = radius / x_factor;
-      y_radius = radius / y_factor;
+  s->x_start = s->x_fin = s->y_start = s->y_fin = 0;
 
-      y_start = ceil(y - y_radius);
-      y_fin = ceil(y + y_radius);
-      if (y_start < 0)
-        {
-          y_start = 0;
-        }
-      if (y_fin > px_height)
-        {
-          y_fin = px_height;
-        }
+  /* Zero optimization */
+  if (d->dt_pts[i].data == 0) return;
+
+  radius = d->radius;
+  if (d->radius_callback != NULL)
+    {
+      radius = d->radius_callback(d->dt_pts + i, d->extra_data != NULL ? (const void *)(d->extra_data + i) : NULL);
+    }
+
+  s->x = d->positions[2 * i];
+  s->y = d->positions[2 * i + 1];
+  s->x_radius = radius / d->x_factor;
+  s->y_radius = radius / d->y_factor;
+
+  s->y_start = ceil(s->y - s->y_radius);
+  s->y_fin = ceil(s->y + s->y_radius);
+  s->x_start = ceil(s->x - s->x_radius);
+  s->x_fin = ceil(s->x + s->x_radius);
+  if (s->y_start < 0) s->y_start = 0;
+  if (s->y_fin > d->px_height) s->y_fin = d->px_height;
+  if (s->x_start < 0) s->x_start = 0;
+  if (s->x_fin > d->px_width) s->x_fin = d->px_width;
+  if (s->y_start >= s->y_fin || s->x_start >= s->x_fin)
+    {
+      s->x_start = s->x_fin = s->y_start = s->y_fin = 0;
+    }
+}
+
+/* Number of image tiles covered by the extent `s` */
+static size_t volume_nogrid_tile_count(const volume_nogrid_splat_t *s)
+{
+  if (s->x_fin == 0) return 0;
+  return (size_t)((s->x_fin - 1) / VOLUME_NOGRID_TILE_SIZE - s->x_start / VOLUME_NOGRID_TILE_SIZE + 1) *
+         (size_t)((s->y_fin - 1) / VOLUME_NOGRID_TILE_SIZE - s->y_start / VOLUME_NOGRID_TILE_SIZE + 1);
+}
+
+/*
+ * Add the current batch of data points to the image tiles `start` to `end - 1`. Each tile only visits the data points
+ * overlapping it, in the order of the input, so the pixel sums do not depend on the number of threads.
+ */
+static void volume_nogrid_tiles(void *arg, int start, int end)
+{
+  volume_nogrid_data_struct *d = (volume_nogrid_data_struct *)arg;
+  int px_width = d->px_width;
+  point3d_t ray_dir_init = *(d->ray_dir_init);
+  point3d_t ray_dir_x = *(d->ray_dir_x);
+  point3d_t ray_dir_y = *(d->ray_dir_y);
+  point3d_t ray_from_init = *(d->ray_from_init);
+  point3d_t ray_from_x = *(d->ray_from_x);
+  point3d_t ray_from_y = *(d->ray_from_y);
+  double *pixels = d->pixels;
+  kernel_f callback = d->callback;
+  int tile, tile_x_start, tile_x_fin, tile_y_start, tile_y_fin;
+  int my_x, my_y;
+  size_t k;
 
-      for (my_y = y_start; my_y < y_fin; ++my_y)
+  for (tile = start; tile < end; tile++)
+    {
+      tile_x_start = tile % d->tiles_x * VOLUME_NOGRID_TILE_SIZE;
+      tile_y_start = tile / d->tiles_x * VOLUME_NOGRID_TILE_SIZE;
+      tile_x_fin = min(tile_x_start + VOLUME_NOGRID_TILE_SIZE, d->px_width);
+      tile_y_fin = min(tile_y_start + VOLUME_NOGRID_TILE_SIZE, d->px_height);
+
+      for (k = d->tile_start[tile]; k < d->tile_start[tile + 1]; k++)
         {
-          double tmp = (my_y - y) / y_radius;
-          double x_len = x_radius * sqrt(1. - tmp * tmp);
+          size_t i = d->batch_first + d->tile_points[k];
+          const data_point3d_t *curr_dt_pt = d->dt_pts + i;
+          const void *extra_data = d->extra_data != NULL ? (const void *)(d->extra_data + i) : NULL;
+          const volume_nogrid_splat_t *s = d->splats + d->tile_points[k];
+          int y_start = max(s->y_start, tile_y_start);
+          int y_fin = min(s->y_fin, tile_y_fin);
 
-          int x_start = ceil(x - x_len);
-          int x_fin = ceil(x + x_len);
-          if (x_start < 0)
-            {
-              x_start = 0;
-            }
-          if (x_fin > px_width)
+          for (my_y = y_start; my_y < y_fin; ++my_y)
             {
-              x_fin = px_width;
-            }
-          for (my_x = x_start; my_x < x_fin; ++my_x)
-            {
-              /* calculate ray and value */
-              point3d_t ray_from = ray_from_init;
-              point3d_t ray_dir = ray_dir_init;
-              double val;
-              int idx;
-              pt_mad(&ray_from, my_x, &ray_from_x);
-              pt_mad(&ray_dir, my_x, &ray_dir_x);
-              pt_mad(&ray_from, my_y, &ray_from_y);
-              pt_mad(&ray_dir, my_y, &ray_dir_y);
-
-              val = callback(curr_dt_pt, (const void *)extra_data, &ray_from, &ray_dir);
-              if (val < 0)
+              double tmp = (my_y - s->y) / s->y_radius;
+              double x_len = s->x_radius * sqrt(1. - tmp * tmp);
+
+              int x_start = ceil(s->x - x_len);
+              int x_fin = ceil(s->x + x_len);
+              if (x_start < tile_x_start)
                 {
-                  continue;
+                  x_start = tile_x_start;
                 }
+              if (x_fin > tile_x_fin)
+                {
+                  x_fin = tile_x_fin;
+                }
+              for (my_x = x_start; my_x < x_fin; ++my_x)
+                {
+                  /* calculate ray and value */
+                  point3d_t ray_from = ray_from_init;
+                  point3d_t ray_dir = ray_dir_init;
+                  double val;
+                  int idx;
+                  pt_mad(&ray_from, my_x, &ray_from_x);
+                  pt_mad(&ray_dir, my_x, &ray_dir_x);
+                  pt_mad(&ray_from, my_y, &ray_from_y);
+                  pt_mad(&ray_dir, my_y, &ray_dir_y);
+
+                  val = callback(curr_dt_pt, extra_data, &ray_from, &ray_dir);
+                  if (val < 0)
+                    {
+                      continue;
+                    }
 
-              idx = my_x + my_y * px_width;
+                  idx = my_x + my_y * px_width;
 
-              if (pixels[idx] < 0)
-                {
-                  pixels[idx] = 0;
+                  if (pixels[idx] < 0)
+                    {
+                      pixels[idx] = 0;
+                    }
+                  pixels[idx] += val;
                 }
-              pixels[idx] += val;
             }
         }
-
-      ++curr_dt_pt;
-      if (extra_data != NULL) ++extra_data;
     }
-  return 0;
 }
 
 static point3d_t pt_rev_calc(double *view_inv, double *proj_inv, double x, double y, double z, double w)
@@ -16403,6 +17955,8 @@ static point3d_t pt_rev_calc(double *view_inv, double *proj_inv, double x, doubl
  * `callback` is expected to integrate along a given ray for the given data point.
  * For trilinear interpolation, you can use `gr_volume_interp_tri_linear`.
  * For interpolation using the multivariate gaussian distribution, you can use `gr_volume_interp_gauss`.
+ * The image is rendered in tiles, each of them only visiting the data points that overlap it. The projected positions
+ * of the data points are reused by subsequent calls as long as the points and the 3D transformation do not change.
  *
  * \param[in]       ndt_pt              Count of data points (`dt_pts`)
  * \param[in]       dt_pts              The data points to draw
@@ -16434,11 +17988,12 @@ void gr_volume_nogrid(unsigned long ndt_pt, const data_point3d_t *dt_pts, const
   point3d_t ray_dir_init, ray_dir_x, ray_dir_y;
   double aspect, x_factor, y_factor;
   double view_inv[16], proj_inv[16];
-  int i, x, y, thread_count;
-#ifndef NO_THREADS
-  pthread_t *threads;
-#endif
-  volume_nogrid_data_struct *data_structs;
+  int x, y, num_chunks, num_tiles, tile;
+  size_t i, batch_first, batch_last, num_entries, max_entries;
+  size_t *tile_start, *tile_fill, *tile_points;
+  uint64_t hash;
+  volume_nogrid_data_struct data;
+  volume_nogrid_splat_t *splats;
   double *pixels;
 
   point3d_t ray_dir;
@@ -16590,115 +18145,119 @@ void gr_volume_nogrid(unsigned long ndt_pt, const data_point3d_t *dt_pts, const
   x_factor = pt_length(&ray_from_x);
   y_factor = pt_length(&ray_from_y);
 
-  pixels = (double *)calloc(vt.picture_width * vt.picture_height, sizeof(double));
-
-#ifndef NO_THREADS
-  thread_count = (system_processor_count() - 1) < 256 ? system_processor_count() - 1 : 256;
-  if (vt.max_threads > 0)
-    {
-      thread_count = vt.max_threads;
-    }
-
-  if (ndt_pt < (unsigned long)thread_count)
-    {
-      thread_count = ndt_pt;
-    }
-
-  threads = (pthread_t *)calloc(thread_count, sizeof(pthread_t));
-#else
-  thread_count = 1;
-#endif
-  data_structs = (volume_nogrid_data_struct *)calloc(thread_count, sizeof(volume_nogrid_data_struct));
-
-  /* Calculate bounds and start threads */
-
-  for (i = 0; i < thread_count; ++i)
-    {
-      unsigned long start = i * ndt_pt / thread_count;
-      unsigned long end = (i + 1) * ndt_pt / thread_count;
-
-      if (i == thread_count - 1)
-        {
-          end = ndt_pt;
-        }
-
-      if (i == 0)
-        {
-          data_structs[i].pixels = pixels;
-        }
-      else
-        {
-          data_structs[i].pixels = (double *)calloc(vt.picture_width * vt.picture_height, sizeof(double));
+  pixels = (double *)xmalloc(vt.picture_width * vt.picture_height * sizeof(double));
+
+  memset(&data, 0, sizeof(data));
+  data.px_width = vt.picture_width;
+  data.px_height = vt.picture_height;
+  data.num_points = ndt_pt;
+  data.dt_pts = dt_pts;
+  data.extra_data = (const void **)extra_data;
+  data.callback = callback;
+  data.radius = radius;
+  data.radius_callback = radius_callback;
+  data.ray_dir_init = &ray_dir_init;
+  data.ray_dir_x = &ray_dir_x;
+  data.ray_dir_y = &ray_dir_y;
+  data.ray_from_init = &ray_from_init;
+  data.ray_from_x = &ray_from_x;
+  data.ray_from_y = &ray_from_y;
+  data.x_factor = x_factor;
+  data.y_factor = y_factor;
+  num_chunks = (int)((ndt_pt + VOLUME_NOGRID_POINTS_PER_CHUNK - 1) / VOLUME_NOGRID_POINTS_PER_CHUNK);
+
+  /* Project the data points onto the image unless the previous call already did */
+  hash = volume_nogrid_hash(ndt_pt, dt_pts);
+  if (!volume_nogrid_cache_matches(ndt_pt, dt_pts, hash))
+    {
+      volume_nogrid_cache.positions =
+          (double *)xrealloc(volume_nogrid_cache.positions, max(1, ndt_pt) * 2 * sizeof(double));
+      data.positions = volume_nogrid_cache.positions;
+      threadpool_parallel_for(num_chunks, 1, volume_nogrid_project, &data);
+
+      volume_nogrid_cache.dt_pts = dt_pts;
+      volume_nogrid_cache.num_points = ndt_pt;
+      volume_nogrid_cache.hash = hash;
+      volume_nogrid_cache.px_width = vt.picture_width;
+      volume_nogrid_cache.px_height = vt.picture_height;
+      volume_nogrid_cache.viewport[0] = vxmin;
+      volume_nogrid_cache.viewport[1] = vxmax;
+      volume_nogrid_cache.viewport[2] = vymin;
+      volume_nogrid_cache.viewport[3] = vymax;
+      memcpy(&volume_nogrid_cache.wx, &wx, sizeof(wx));
+      memcpy(&volume_nogrid_cache.tx, &tx, sizeof(tx));
+      memcpy(&volume_nogrid_cache.gpx, &gpx, sizeof(gpx));
+    }
+  data.positions = volume_nogrid_cache.positions;
+
+  for (i = 0; i < (size_t)vt.picture_width * vt.picture_height; i++)
+    {
+      pixels[i] = -1;
+    }
+
+  /*
+   * The data points are sorted into the image tiles they overlap in batches of bounded size, keeping their original
+   * order within each tile. Every tile owns its part of the image, so no per-thread buffers need to be reduced and
+   * the extra memory does not grow with the number of data points.
+   */
+  data.tiles_x = (vt.picture_width + VOLUME_NOGRID_TILE_SIZE - 1) / VOLUME_NOGRID_TILE_SIZE;
+  data.tiles_y = (vt.picture_height + VOLUME_NOGRID_TILE_SIZE - 1) / VOLUME_NOGRID_TILE_SIZE;
+  num_tiles = data.tiles_x * data.tiles_y;
+  max_entries = max((size_t)VOLUME_NOGRID_BATCH_ENTRIES, (size_t)num_tiles);
+  splats = (volume_nogrid_splat_t *)xmalloc(VOLUME_NOGRID_BATCH_POINTS * sizeof(volume_nogrid_splat_t));
+  tile_start = (size_t *)xmalloc((num_tiles + 1) * sizeof(size_t));
+  tile_fill = (size_t *)xmalloc(num_tiles * sizeof(size_t));
+  tile_points = (size_t *)xmalloc(max_entries * sizeof(size_t));
+  data.splats = splats;
+  data.tile_start = tile_start;
+  data.tile_points = tile_points;
+  data.pixels = pixels;
+  for (batch_first = 0; batch_first < ndt_pt; batch_first = batch_last)
+    {
+      memset(tile_start, 0, (num_tiles + 1) * sizeof(size_t));
+      num_entries = 0;
+      for (batch_last = batch_first; batch_last < ndt_pt && batch_last - batch_first < VOLUME_NOGRID_BATCH_POINTS;
+           batch_last++)
+        {
+          volume_nogrid_splat_t *s = splats + (batch_last - batch_first);
+          volume_nogrid_extent(&data, batch_last, s);
+          if (num_entries > 0 && num_entries + volume_nogrid_tile_count(s) > max_entries) break;
+          num_entries += volume_nogrid_tile_count(s);
+          for (y = s->y_start / VOLUME_NOGRID_TILE_SIZE; s->y_fin > 0 && y <= (s->y_fin - 1) / VOLUME_NOGRID_TILE_SIZE;
+               y++)
+            {
+              for (x = s->x_start / VOLUME_NOGRID_TILE_SIZE; x <= (s->x_fin - 1) / VOLUME_NOGRID_TILE_SIZE; x++)
+                {
+                  tile_start[x + y * data.tiles_x + 1]++;
+                }
+            }
         }
-
-      data_structs[i].px_width = vt.picture_width;
-      data_structs[i].px_height = vt.picture_height;
-      data_structs[i].start = dt_pts + start;
-      data_structs[i].end = dt_pts + end;
-      data_structs[i].callback = callback;
-      if (extra_data == NULL)
+      if (num_entries == 0) continue;
+      for (tile = 0; tile < num_tiles; tile++)
         {
-          data_structs[i].extra_data = NULL;
+          tile_start[tile + 1] += tile_start[tile];
         }
-      else
-        {
-          data_structs[i].extra_data = (const void **)extra_data + start;
-        }
-      data_structs[i].radius = radius;
-      data_structs[i].radius_callback = radius_callback;
-      data_structs[i].ray_dir_init = &ray_dir_init;
-      data_structs[i].ray_dir_x = &ray_dir_x;
-      data_structs[i].ray_dir_y = &ray_dir_y;
-      data_structs[i].ray_from_init = &ray_from_init;
-      data_structs[i].ray_from_x = &ray_from_x;
-      data_structs[i].ray_from_y = &ray_from_y;
-      data_structs[i].x_factor = x_factor;
-      data_structs[i].y_factor = y_factor;
-#ifndef NO_THREADS
-      pthread_create(threads + i, NULL, volume_nogrid_worker, (void *)(data_structs + i));
-#else
-      volume_nogrid_worker((void *)(data_structs + i));
-#endif
-    }
-
-
-#ifndef NO_THREADS
-  /* Wait for threads to end and reduce to one image buffer */
-  for (i = 0; i < thread_count; ++i)
-    {
-      pthread_join(threads[i], NULL);
-
-      if (i != 0)
+      memcpy(tile_fill, tile_start, num_tiles * sizeof(size_t));
+      for (i = batch_first; i < batch_last; i++)
         {
-          double *px_t = data_structs[i].pixels;
-          for (y = 0; y < vt.picture_height; ++y)
+          const volume_nogrid_splat_t *s = splats + (i - batch_first);
+          for (y = s->y_start / VOLUME_NOGRID_TILE_SIZE; s->y_fin > 0 && y <= (s->y_fin - 1) / VOLUME_NOGRID_TILE_SIZE;
+               y++)
             {
-              for (x = 0; x < vt.picture_width; ++x)
+              for (x = s->x_start / VOLUME_NOGRID_TILE_SIZE; x <= (s->x_fin - 1) / VOLUME_NOGRID_TILE_SIZE; x++)
                 {
-                  int idx = x + y * vt.picture_width;
-
-                  double v = px_t[idx];
-                  if (v >= 0)
-                    {
-                      double v2 = pixels[idx];
-                      if (v2 < 0)
-                        {
-                          pixels[idx] = v;
-                        }
-                      else
-                        {
-                          pixels[idx] = v2 + v;
-                        }
-                    }
+                  tile_points[tile_fill[x + y * data.tiles_x]++] = i - batch_first;
                 }
             }
-          free(data_structs[i].pixels);
         }
+      data.batch_first = batch_first;
+      threadpool_parallel_for(num_tiles, 1, volume_nogrid_tiles, &data);
     }
 
-  free(threads);
-#endif
-  free(data_structs);
+  free(tile_points);
+  free(tile_fill);
+  free(tile_start);
+  free(splats);
 
   /* Next Step: convert to absorption model if necessary and calculate min and max */
   {
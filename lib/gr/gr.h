@@ -165,6 +165,8 @@ typedef struct
   cpubasedvolume_2pass_priv_t *priv;
 } cpubasedvolume_2pass_t;
 
+typedef struct gr_capture_priv gr_capture_t;
+
 typedef struct hexbin_2pass_priv hexbin_2pass_priv_t;
 typedef struct
 {
@@ -283,6 +285,10 @@ DLLEXPORT void gr_copysegws(int);
 DLLEXPORT void gr_redrawsegws(void);
 DLLEXPORT void gr_setsegtran(int, double, double, double, double, double, double, double);
 DLLEXPORT void gr_closeseg(void);
+DLLEXPORT gr_capture_t *gr_begincapture(int);
+DLLEXPORT int gr_endcapture(gr_capture_t *);
+DLLEXPORT int gr_replaycapture(gr_capture_t *);
+DLLEXPORT void gr_deletecapture(gr_capture_t *);
 DLLEXPORT void gr_samplelocator(double *, double *, int *);
 DLLEXPORT void gr_emergencyclosegks(void);
 DLLEXPORT void gr_updategks(void);
@@ -356,6 +362,7 @@ DLLEXPORT int gr_drawgraphics(char *);
 DLLEXPORT int gr_startlistener(void);
 DLLEXPORT void gr_mathtex(double, double, char *);
 DLLEXPORT void gr_inqmathtex(double, double, char *, double *, double *);
+DLLEXPORT void gr_prefetchmathtex(int, char **);
 DLLEXPORT void gr_mathtex3d(double, double, double, char *, int);
 DLLEXPORT void gr_inqmathtex3d(double, double, double, char *, int, double *, double *, double *, double *);
 DLLEXPORT void gr_beginselection(int, int);
@@ -375,6 +382,8 @@ DLLEXPORT void gr_savecontext(int);
 DLLEXPORT void gr_selectcontext(int);
 DLLEXPORT void gr_destroycontext(int);
 DLLEXPORT void gr_unselectcontext(void);
+DLLEXPORT unsigned int gr_hashcontext(int);
+DLLEXPORT int gr_comparecontexts(int, int);
 DLLEXPORT int gr_uselinespec(char *);
 DLLEXPORT void gr_delaunay(int, const double *, const double *, int *, int **);
 DLLEXPORT void gr_reducepoints(int, const double *, const double *, int, double *, double *);
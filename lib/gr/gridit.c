@@ -4,6 +4,7 @@
 
 /*#include "gr.h"*/
 #include "gridit.h"
+#include "threadpool.h"
 
 #ifndef max
 #define max(a, b) ((a) > (b) ? (a) : (b))
@@ -16,6 +17,37 @@
 #define Integer static int
 #define Real static double
 
+#define IDSFFT_TRIANGLES_PER_CHUNK 64
+
+/* polynomial coefficients of the triangle (or border segment) `itpv` last used by IDPTIP */
+typedef struct
+{
+  int itpv;
+  double ap, bp, cp, dp, x0, y0;
+  double p5, p00, p01, p02, p03, p04, p05, p10, p11, p12, p13, p14;
+  double p20, p21, p22, p23, p30, p31, p32, p40, p41, p50;
+} idptip_coefficients_t;
+
+typedef struct
+{
+  double *xd, *yd, *zd, *xi, *yi, *zi, *wk;
+  int *iwk;
+  int nt, nl, nngp, nxi0, linear;
+  int jwipt, jwipl, jwngp0, jwigp0;
+  int *jig0mn, *jig1mn;
+} idsfft_interpolation_t;
+
+static char *xmalloc(int size)
+{
+  char *result = (char *)malloc(size);
+  if (!result)
+    {
+      fprintf(stderr, "out of virtual memory\n");
+      abort();
+    }
+  return result;
+}
+
 static int idcldp(int *ndp, double *xd, double *yd, int *ncp, int *ipc)
 {
   Integer j1, j2, j3, j4;
@@ -788,25 +820,20 @@ static int idpdrv(int *ndp, double *xd, double *yd, double *zd, int *ncp, int *i
 }
 
 static int idptip(double *xd, double *yd, double *zd, int *nt, int *ipt, int *nl, int *ipl, double *pdd, int *iti,
-                  double *xii, double *yii, double *zii, int *itpv)
+                  double *xii, double *yii, double *zii, idptip_coefficients_t *cf)
 {
-  Real ap = 0., bp = 0., cp = 0., dp = 0., x0 = 0., y0 = 0.;
-  Real p5 = 0., p00 = 0., p01 = 0., p02 = 0., p03 = 0., p04 = 0.;
-  Real p05 = 0., p10 = 0., p11 = 0., p12 = 0., p13 = 0., p14 = 0.;
-  Real p20 = 0., p21 = 0., p22 = 0., p23 = 0., p30 = 0., p31 = 0.;
-  Real p32 = 0., p40 = 0., p41 = 0., p50 = 0.;
-  Real a, b, c, d;
-  Integer i;
-  Real u, v, x[3], y[3], z[3], g1, h1, h2, h3, g2, p0, p1, p2, p3, p4;
-  Real aa, ab, bb, ad, bc, cc, cd, dd, ac;
-  Real pd[15], lu, lv;
-  Real zu[3], zv[3], dx, dy;
-  Integer il1, il2, it0, idp, jpd, kpd;
-  Real dlt;
-  Integer ntl;
-  Real zuu[3], zuv[3], zvv[3], act2, bdt2, adbc;
-  Integer jpdd, jipl, jipt;
-  Real csuv, thus, thsv, thuv, thxu;
+  double a, b, c, d;
+  int i;
+  double u, v, x[3], y[3], z[3], g1, h1, h2, h3, g2, p0, p1, p2, p3, p4;
+  double aa, ab, bb, ad, bc, cc, cd, dd, ac;
+  double pd[15], lu, lv;
+  double zu[3], zv[3], dx, dy;
+  int il1, il2, it0, idp, jpd, kpd;
+  double dlt;
+  int ntl;
+  double zuu[3], zuv[3], zvv[3], act2, bdt2, adbc;
+  int jpdd, jipl, jipt;
+  double csuv, thus, thsv, thuv, thxu;
 
   /* THIS SUBROUTINE PERFORMS PUNCTUAL INTERPOLATION OR EXTRAPOLA- */
   /* TION, I.E., DETERMINES THE Z VALUE AT A POINT. */
@@ -838,7 +865,7 @@ static int idptip(double *xd, double *yd, double *zd, int *nt, int *ipt, int *nl
     {
       /* CALCULATION OF ZII BY INTERPOLATION. */
       /* CHECKS IF THE NECESSARY COEFFICIENTS HAVE BEEN CALCULATED. */
-      if (it0 != *itpv)
+      if (it0 != cf->itpv)
         {
           /* LOADS COORDINATE AND PARTIAL DERIVATIVE VALUES AT THE */
           /* VERTEXES. */
@@ -864,19 +891,19 @@ static int idptip(double *xd, double *yd, double *zd, int *nt, int *ipt, int *nl
           /* DETERMINES THE COEFFICIENTS FOR THE COORDINATE SYSTEM */
           /* TRANSFORMATION FROM THE X-Y SYSTEM TO THE U-V SYSTEM */
           /* AND VICE VERSA. */
-          x0 = x[0];
-          y0 = y[0];
-          a = x[1] - x0;
-          b = x[2] - x0;
-          c = y[1] - y0;
-          d = y[2] - y0;
+          cf->x0 = x[0];
+          cf->y0 = y[0];
+          a = x[1] - cf->x0;
+          b = x[2] - cf->x0;
+          c = y[1] - cf->y0;
+          d = y[2] - cf->y0;
           ad = a * d;
           bc = b * c;
           dlt = ad - bc;
-          ap = d / dlt;
-          bp = -b / dlt;
-          cp = -c / dlt;
-          dp = a / dlt;
+          cf->ap = d / dlt;
+          cf->bp = -b / dlt;
+          cf->cp = -c / dlt;
+          cf->dp = a / dlt;
           /* CONVERTS THE PARTIAL DERIVATIVES AT THE VERTEXES OF THE */
           /* TRIANGLE FOR THE U-V COORDINATE SYSTEM. */
           aa = a * a;
@@ -899,40 +926,40 @@ static int idptip(double *xd, double *yd, double *zd, int *nt, int *ipt, int *nl
               /* L30: */
             }
           /* CALCULATES THE COEFFICIENTS OF THE POLYNOMIAL. */
-          p00 = z[0];
-          p10 = zu[0];
-          p01 = zv[0];
-          p20 = zuu[0] * .5;
-          p11 = zuv[0];
-          p02 = zvv[0] * .5;
-          h1 = z[1] - p00 - p10 - p20;
-          h2 = zu[1] - p10 - zuu[0];
+          cf->p00 = z[0];
+          cf->p10 = zu[0];
+          cf->p01 = zv[0];
+          cf->p20 = zuu[0] * .5;
+          cf->p11 = zuv[0];
+          cf->p02 = zvv[0] * .5;
+          h1 = z[1] - cf->p00 - cf->p10 - cf->p20;
+          h2 = zu[1] - cf->p10 - zuu[0];
           h3 = zuu[1] - zuu[0];
-          p30 = h1 * 10. - h2 * 4. + h3 * .5;
-          p40 = h1 * -15. + h2 * 7. - h3;
-          p50 = h1 * 6. - h2 * 3. + h3 * .5;
-          p5 = p50;
-          h1 = z[2] - p00 - p01 - p02;
-          h2 = zv[2] - p01 - zvv[0];
+          cf->p30 = h1 * 10. - h2 * 4. + h3 * .5;
+          cf->p40 = h1 * -15. + h2 * 7. - h3;
+          cf->p50 = h1 * 6. - h2 * 3. + h3 * .5;
+          cf->p5 = cf->p50;
+          h1 = z[2] - cf->p00 - cf->p01 - cf->p02;
+          h2 = zv[2] - cf->p01 - zvv[0];
           h3 = zvv[2] - zvv[0];
-          p03 = h1 * 10. - h2 * 4. + h3 * .5;
-          p04 = h1 * -15. + h2 * 7. - h3;
-          p05 = h1 * 6. - h2 * 3. + h3 * .5;
+          cf->p03 = h1 * 10. - h2 * 4. + h3 * .5;
+          cf->p04 = h1 * -15. + h2 * 7. - h3;
+          cf->p05 = h1 * 6. - h2 * 3. + h3 * .5;
           lu = sqrt(aa + cc);
           lv = sqrt(bb + dd);
           thxu = atan2(c, a);
           thuv = atan2(d, b) - thxu;
           csuv = cos(thuv);
-          p41 = lv * 5. * csuv / lu * p50;
-          p14 = lu * 5. * csuv / lv * p05;
-          h1 = zv[1] - p01 - p11 - p41;
-          h2 = zuv[1] - p11 - p41 * 4.;
-          p21 = h1 * 3. - h2;
-          p31 = h1 * -2. + h2;
-          h1 = zu[2] - p10 - p11 - p14;
-          h2 = zuv[2] - p11 - p14 * 4.;
-          p12 = h1 * 3. - h2;
-          p13 = h1 * -2. + h2;
+          cf->p41 = lv * 5. * csuv / lu * cf->p50;
+          cf->p14 = lu * 5. * csuv / lv * cf->p05;
+          h1 = zv[1] - cf->p01 - cf->p11 - cf->p41;
+          h2 = zuv[1] - cf->p11 - cf->p41 * 4.;
+          cf->p21 = h1 * 3. - h2;
+          cf->p31 = h1 * -2. + h2;
+          h1 = zu[2] - cf->p10 - cf->p11 - cf->p14;
+          h2 = zuv[2] - cf->p11 - cf->p14 * 4.;
+          cf->p12 = h1 * 3. - h2;
+          cf->p13 = h1 * -2. + h2;
           thus = atan2(d - c, b - a) - thxu;
           thsv = thuv - thus;
           aa = sin(thsv) / lu;
@@ -944,27 +971,27 @@ static int idptip(double *xd, double *yd, double *zd, int *nt, int *ipt, int *nl
           bc = bb * cc;
           g1 = aa * ac * (bc * 3. + ad * 2.);
           g2 = cc * ac * (ad * 3. + bc * 2.);
-          h1 = -aa * aa * aa * (aa * 5. * bb * p50 + (bc * 4. + ad) * p41) -
-               cc * cc * cc * (cc * 5. * dd * p05 + (ad * 4. + bc) * p14);
-          h2 = zvv[1] * .5 - p02 - p12;
-          h3 = zuu[2] * .5 - p20 - p21;
-          p22 = (g1 * h2 + g2 * h3 - h1) / (g1 + g2);
-          p32 = h2 - p22;
-          p23 = h3 - p22;
-          *itpv = it0;
+          h1 = -aa * aa * aa * (aa * 5. * bb * cf->p50 + (bc * 4. + ad) * cf->p41) -
+               cc * cc * cc * (cc * 5. * dd * cf->p05 + (ad * 4. + bc) * cf->p14);
+          h2 = zvv[1] * .5 - cf->p02 - cf->p12;
+          h3 = zuu[2] * .5 - cf->p20 - cf->p21;
+          cf->p22 = (g1 * h2 + g2 * h3 - h1) / (g1 + g2);
+          cf->p32 = h2 - cf->p22;
+          cf->p23 = h3 - cf->p22;
+          cf->itpv = it0;
         }
       /* CONVERTS XII AND YII TO U-V SYSTEM. */
-      dx = *xii - x0;
-      dy = *yii - y0;
-      u = ap * dx + bp * dy;
-      v = cp * dx + dp * dy;
+      dx = *xii - cf->x0;
+      dy = *yii - cf->y0;
+      u = cf->ap * dx + cf->bp * dy;
+      v = cf->cp * dx + cf->dp * dy;
       /* EVALUATES THE POLYNOMIAL. */
-      p0 = p00 + v * (p01 + v * (p02 + v * (p03 + v * (p04 + v * p05))));
-      p1 = p10 + v * (p11 + v * (p12 + v * (p13 + v * p14)));
-      p2 = p20 + v * (p21 + v * (p22 + v * p23));
-      p3 = p30 + v * (p31 + v * p32);
-      p4 = p40 + v * p41;
-      *zii = p0 + u * (p1 + u * (p2 + u * (p3 + u * (p4 + u * p5))));
+      p0 = cf->p00 + v * (cf->p01 + v * (cf->p02 + v * (cf->p03 + v * (cf->p04 + v * cf->p05))));
+      p1 = cf->p10 + v * (cf->p11 + v * (cf->p12 + v * (cf->p13 + v * cf->p14)));
+      p2 = cf->p20 + v * (cf->p21 + v * (cf->p22 + v * cf->p23));
+      p3 = cf->p30 + v * (cf->p31 + v * cf->p32);
+      p4 = cf->p40 + v * cf->p41;
+      *zii = p0 + u * (p1 + u * (p2 + u * (p3 + u * (p4 + u * cf->p5))));
     }
   else
     {
@@ -974,7 +1001,7 @@ static int idptip(double *xd, double *yd, double *zd, int *nt, int *ipt, int *nl
         {
           /* CALCULATION OF ZII BY EXTRAPOLATION IN THE RECTANGLE. */
           /* CHECKS IF THE NECESSARY COEFFICIENTS HAVE BEEN CALCULATED. */
-          if (it0 != *itpv)
+          if (it0 != cf->itpv)
             {
               /* LOADS COORDINATE AND PARTIAL DERIVATIVE VALUES AT THE END */
               /* POINTS OF THE BORDER LINE SEGMENT. */
@@ -1000,8 +1027,8 @@ static int idptip(double *xd, double *yd, double *zd, int *nt, int *ipt, int *nl
               /* DETERMINES THE COEFFICIENTS FOR THE COORDINATE SYSTEM */
               /* TRANSFORMATION FROM THE X-Y SYSTEM TO THE U-V SYSTEM */
               /* AND VICE VERSA. */
-              x0 = x[0];
-              y0 = y[0];
+              cf->x0 = x[0];
+              cf->y0 = y[0];
               a = y[1] - y[0];
               b = x[1] - x[0];
               c = -b;
@@ -1009,10 +1036,10 @@ static int idptip(double *xd, double *yd, double *zd, int *nt, int *ipt, int *nl
               ad = a * d;
               bc = b * c;
               dlt = ad - bc;
-              ap = d / dlt;
-              bp = -b / dlt;
-              cp = -bp;
-              dp = ap;
+              cf->ap = d / dlt;
+              cf->bp = -b / dlt;
+              cf->cp = -cf->bp;
+              cf->dp = cf->ap;
               /* CONVERTS THE PARTIAL DERIVATIVES AT THE END POINTS OF THE */
               /* BORDER LINE SEGMENT FOR THE U-V COORDINATE SYSTEM. */
               aa = a * a;
@@ -1035,43 +1062,43 @@ static int idptip(double *xd, double *yd, double *zd, int *nt, int *ipt, int *nl
                   /* L60: */
                 }
               /* CALCULATES THE COEFFICIENTS OF THE POLYNOMIAL. */
-              p00 = z[0];
-              p10 = zu[0];
-              p01 = zv[0];
-              p20 = zuu[0] * .5;
-              p11 = zuv[0];
-              p02 = zvv[0] * .5;
-              h1 = z[1] - p00 - p01 - p02;
-              h2 = zv[1] - p01 - zvv[0];
+              cf->p00 = z[0];
+              cf->p10 = zu[0];
+              cf->p01 = zv[0];
+              cf->p20 = zuu[0] * .5;
+              cf->p11 = zuv[0];
+              cf->p02 = zvv[0] * .5;
+              h1 = z[1] - cf->p00 - cf->p01 - cf->p02;
+              h2 = zv[1] - cf->p01 - zvv[0];
               h3 = zvv[1] - zvv[0];
-              p03 = h1 * 10. - h2 * 4. + h3 * .5;
-              p04 = h1 * -15. + h2 * 7. - h3;
-              p05 = h1 * 6. - h2 * 3. + h3 * .5;
-              h1 = zu[1] - p10 - p11;
-              h2 = zuv[1] - p11;
-              p12 = h1 * 3. - h2;
-              p13 = h1 * -2. + h2;
-              p21 = 0.;
-              p23 = -zuu[1] + zuu[0];
-              p22 = p23 * -1.5;
-              *itpv = it0;
+              cf->p03 = h1 * 10. - h2 * 4. + h3 * .5;
+              cf->p04 = h1 * -15. + h2 * 7. - h3;
+              cf->p05 = h1 * 6. - h2 * 3. + h3 * .5;
+              h1 = zu[1] - cf->p10 - cf->p11;
+              h2 = zuv[1] - cf->p11;
+              cf->p12 = h1 * 3. - h2;
+              cf->p13 = h1 * -2. + h2;
+              cf->p21 = 0.;
+              cf->p23 = -zuu[1] + zuu[0];
+              cf->p22 = cf->p23 * -1.5;
+              cf->itpv = it0;
             }
           /* CONVERTS XII AND YII TO U-V SYSTEM. */
-          dx = *xii - x0;
-          dy = *yii - y0;
-          u = ap * dx + bp * dy;
-          v = cp * dx + dp * dy;
+          dx = *xii - cf->x0;
+          dy = *yii - cf->y0;
+          u = cf->ap * dx + cf->bp * dy;
+          v = cf->cp * dx + cf->dp * dy;
           /* EVALUATES THE POLYNOMIAL. */
-          p0 = p00 + v * (p01 + v * (p02 + v * (p03 + v * (p04 + v * p05))));
-          p1 = p10 + v * (p11 + v * (p12 + v * p13));
-          p2 = p20 + v * (p21 + v * (p22 + v * p23));
+          p0 = cf->p00 + v * (cf->p01 + v * (cf->p02 + v * (cf->p03 + v * (cf->p04 + v * cf->p05))));
+          p1 = cf->p10 + v * (cf->p11 + v * (cf->p12 + v * cf->p13));
+          p2 = cf->p20 + v * (cf->p21 + v * (cf->p22 + v * cf->p23));
           *zii = p0 + u * (p1 + u * p2);
         }
       else
         {
           /* CALCULATION OF ZII BY EXTRAPOLATION IN THE TRIANGLE. */
           /* CHECKS IF THE NECESSARY COEFFICIENTS HAVE BEEN CALCULATED. */
-          if (it0 != *itpv)
+          if (it0 != cf->itpv)
             {
               /* LOADS COORDINATE AND PARTIAL DERIVATIVE VALUES AT THE VERTEX */
               /* OF THE TRIANGLE. */
@@ -1088,21 +1115,23 @@ static int idptip(double *xd, double *yd, double *zd, int *nt, int *ipt, int *nl
                   /* L70: */
                 }
               /* CALCULATES THE COEFFICIENTS OF THE POLYNOMIAL. */
-              p00 = z[0];
-              p10 = pd[0];
-              p01 = pd[1];
-              p20 = pd[2] * .5;
-              p11 = pd[3];
-              p02 = pd[4] * .5;
-              *itpv = it0;
+              cf->p00 = z[0];
+              cf->p10 = pd[0];
+              cf->p01 = pd[1];
+              cf->p20 = pd[2] * .5;
+              cf->p11 = pd[3];
+              cf->p02 = pd[4] * .5;
+              cf->x0 = x[0];
+              cf->y0 = y[0];
+              cf->itpv = it0;
             }
           /* CONVERTS XII AND YII TO U-V SYSTEM. */
-          u = *xii - x[0];
-          v = *yii - y[0];
+          u = *xii - cf->x0;
+          v = *yii - cf->y0;
           /* EVALUATES THE POLYNOMIAL. */
-          p0 = p00 + v * (p01 + v * p02);
-          p1 = p10 + v * p11;
-          *zii = p0 + u * (p1 + u * p20);
+          p0 = cf->p00 + v * (cf->p01 + v * cf->p02);
+          p1 = cf->p10 + v * cf->p11;
+          *zii = p0 + u * (p1 + u * cf->p20);
         }
     }
   return 0;
@@ -1736,8 +1765,8 @@ static int idlin(double *xd, double *yd, double *zd, int *nt, int *iwk, double *
 static int idlcom(double *x, double *y, double *z, int *itri, double *xd, double *yd, double *zd, int *nt, int *iwk,
                   double *wk)
 {
-  Real x1, y1, z1;
-  Integer iv, ipoint;
+  double x1, y1, z1;
+  int iv, ipoint;
 
   /* COMPUTE A Z VALUE FOR A GIVEN X,Y VALUE */
   /* IF OUTSIDE CONVEX HULL DON'T COMPUTE A VALUE */
@@ -1755,14 +1784,77 @@ static int idlcom(double *x, double *y, double *z, int *itri, double *xd, double
   return 0;
 }
 
+/*
+ * Interpolate the ZI values of the output grid points lying in the triangles and border regions `start + 1` to `end`
+ * (in the order of the sorted IWK grid point lists). Every call keeps its own IDPTIP coefficient cache.
+ */
+static void idsfft_interpolate(void *arg, int start, int end)
+{
+  idsfft_interpolation_t *ip = (idsfft_interpolation_t *)arg;
+  idptip_coefficients_t cf = {0};
+  int *iwk = ip->iwk;
+  int nt = ip->nt, nl = ip->nl, nngp = ip->nngp, nxi0 = ip->nxi0;
+  int jngp, jigp, jig0mx, jig1mx, iti, il1, il2, izi, ixi, iyi;
+
+  for (jngp = start + 1; jngp <= end; ++jngp)
+    {
+      iti = jngp;
+      if (jngp > nt)
+        {
+          il1 = (jngp - nt + 1) / 2;
+          il2 = (jngp - nt + 2) / 2;
+          if (il2 > nl)
+            {
+              il2 = 1;
+            }
+          iti = il1 * (nt + nl) + il2;
+        }
+      jig0mx = ip->jig0mn[jngp - 1] + iwk[ip->jwngp0 + jngp - 1] - 1;
+      jig1mx = ip->jig1mn[jngp - 1] + iwk[ip->jwngp0 + 2 * nngp - jngp] - 1;
+      for (jigp = ip->jig0mn[jngp - 1]; jigp <= jig0mx; ++jigp)
+        {
+          izi = iwk[ip->jwigp0 + jigp - 1];
+          iyi = (izi - 1) / nxi0 + 1;
+          ixi = izi - nxi0 * (iyi - 1);
+          if (ip->linear)
+            {
+              idlcom(&ip->xi[ixi - 1], &ip->yi[iyi - 1], &ip->zi[izi - 1], &iti, ip->xd, ip->yd, ip->zd, &nt,
+                     &iwk[ip->jwipt - 1], ip->wk);
+            }
+          else
+            {
+              idptip(ip->xd, ip->yd, ip->zd, &nt, &iwk[ip->jwipt - 1], &nl, &iwk[ip->jwipl - 1], ip->wk, &iti,
+                     &ip->xi[ixi - 1], &ip->yi[iyi - 1], &ip->zi[izi - 1], &cf);
+            }
+        }
+      for (jigp = ip->jig1mn[jngp - 1]; jigp <= jig1mx; ++jigp)
+        {
+          izi = iwk[ip->jwigp0 + jigp - 1];
+          iyi = (izi - 1) / nxi0 + 1;
+          ixi = izi - nxi0 * (iyi - 1);
+          if (ip->linear)
+            {
+              idlcom(&ip->xi[ixi - 1], &ip->yi[iyi - 1], &ip->zi[izi - 1], &iti, ip->xd, ip->yd, ip->zd, &nt,
+                     &iwk[ip->jwipt - 1], ip->wk);
+            }
+          else
+            {
+              idptip(ip->xd, ip->yd, ip->zd, &nt, &iwk[ip->jwipt - 1], &nl, &iwk[ip->jwipl - 1], ip->wk, &iti,
+                     &ip->xi[ixi - 1], &ip->yi[iyi - 1], &ip->zi[izi - 1], &cf);
+            }
+        }
+    }
+}
+
 void idsfft(int *md, int *ncp, int *ndp, double *xd, double *yd, double *zd, int *nxi, int *nyi, double *xi, double *yi,
             double *zi, int *iwk, double *wk)
 {
-  Integer nl, nt, md0, il1, il2, iti, ixi, izi, iyi, ncp0, ndp0;
-  Integer ngp0, ngp1, nxi0, nyi0, jigp, jngp, nngp, itpv;
-  Integer jwipc, jwigp, jwipl, ncppv, ndppv, jwngp, jwiwl, jwipt;
-  Integer jwiwp, nxipv, nyipv, jig0mn, jig1mn, jig0mx, jig1mx, jwigp0, jwngp0;
+  Integer nl, nt, md0, ncp0, ndp0;
+  Integer ngp0, ngp1, nxi0, nyi0, jngp, nngp;
+  Integer jwipc, jwipl, ncppv, ndppv, jwiwl, jwipt;
+  Integer jwiwp, nxipv, nyipv, jig1mn, jig0mx, jwigp0, jwngp0;
   Integer linear;
+  idsfft_interpolation_t ip;
 
   /* THIS SUBROUTINE PERFORMS SMOOTH SURFACE FITTING WHEN THE PRO- */
   /* JECTIONS OF THE DATA POINTS IN THE X-Y PLANE ARE IRREGULARLY */
@@ -1917,75 +2009,42 @@ void idsfft(int *md, int *ncp, int *ndp, double *xd, double *yd, double *zd, int
                       idpdrv(&ndp0, &xd[0], &yd[0], &zd[0], &ncp0, &iwk[jwipc - 1], &wk[0]);
                     }
                   /* INTERPOLATES THE ZI VALUES.  (FOR MD=1,2,3) */
-                  itpv = 0;
+                  /* THE GRID POINTS OF EACH TRIANGLE AND BORDER REGION ARE */
+                  /* INDEPENDENT, SO THEIR START INDICES ARE COLLECTED FIRST */
+                  /* AND THE REGIONS ARE THEN INTERPOLATED IN PARALLEL. */
+                  nngp = nt + 2 * nl;
+                  ip.jig0mn = (int *)xmalloc(2 * nngp * sizeof(int));
+                  ip.jig1mn = ip.jig0mn + nngp;
                   jig0mx = 0;
                   jig1mn = nxi0 * nyi0 + 1;
-                  nngp = nt + 2 * nl;
                   for (jngp = 1; jngp <= nngp; ++jngp)
                     {
-                      iti = jngp;
-                      if (jngp > nt)
-                        {
-                          il1 = (jngp - nt + 1) / 2;
-                          il2 = (jngp - nt + 2) / 2;
-                          if (il2 > nl)
-                            {
-                              il2 = 1;
-                            }
-                          iti = il1 * (nt + nl) + il2;
-                        }
-                      jwngp = jwngp0 + jngp;
-                      ngp0 = iwk[jwngp - 1];
-                      if (ngp0 != 0)
-                        {
-                          jig0mn = jig0mx + 1;
-                          jig0mx += ngp0;
-                          for (jigp = jig0mn; jigp <= jig0mx; ++jigp)
-                            {
-                              jwigp = jwigp0 + jigp;
-                              izi = iwk[jwigp - 1];
-                              iyi = (izi - 1) / nxi0 + 1;
-                              ixi = izi - nxi0 * (iyi - 1);
-                              if (linear)
-                                {
-                                  idlcom(&xi[ixi - 1], &yi[iyi - 1], &zi[izi - 1], &iti, &xd[0], &yd[0], &zd[0], &nt,
-                                         &iwk[jwipt - 1], &wk[0]);
-                                }
-                              else
-                                {
-                                  idptip(&xd[0], &yd[0], &zd[0], &nt, &iwk[jwipt - 1], &nl, &iwk[jwipl - 1], &wk[0],
-                                         &iti, &xi[ixi - 1], &yi[iyi - 1], &zi[izi - 1], &itpv);
-                                }
-                              /* L30: */
-                            }
-                        }
-                      jwngp = jwngp0 + 2 * nngp + 1 - jngp;
-                      ngp1 = iwk[jwngp - 1];
-                      if (ngp1 != 0)
-                        {
-                          jig1mx = jig1mn - 1;
-                          jig1mn -= ngp1;
-                          for (jigp = jig1mn; jigp <= jig1mx; ++jigp)
-                            {
-                              jwigp = jwigp0 + jigp;
-                              izi = iwk[jwigp - 1];
-                              iyi = (izi - 1) / nxi0 + 1;
-                              ixi = izi - nxi0 * (iyi - 1);
-                              if (linear)
-                                {
-                                  idlcom(&xi[ixi - 1], &yi[iyi - 1], &zi[izi - 1], &iti, &xd[0], &yd[0], &zd[0], &nt,
-                                         &iwk[jwipt - 1], &wk[0]);
-                                }
-                              else
-                                {
-                                  idptip(&xd[0], &yd[0], &zd[0], &nt, &iwk[jwipt - 1], &nl, &iwk[jwipl - 1], &wk[0],
-                                         &iti, &xi[ixi - 1], &yi[iyi - 1], &zi[izi - 1], &itpv);
-                                }
-                              /* L40: */
-                            }
-                        }
-                      /* L20: */
+                      ngp0 = iwk[jwngp0 + jngp - 1];
+                      ngp1 = iwk[jwngp0 + 2 * nngp - jngp];
+                      ip.jig0mn[jngp - 1] = jig0mx + 1;
+                      jig0mx += ngp0;
+                      jig1mn -= ngp1;
+                      ip.jig1mn[jngp - 1] = jig1mn;
                     }
+                  ip.xd = xd;
+                  ip.yd = yd;
+                  ip.zd = zd;
+                  ip.xi = xi;
+                  ip.yi = yi;
+                  ip.zi = zi;
+                  ip.wk = wk;
+                  ip.iwk = iwk;
+                  ip.nt = nt;
+                  ip.nl = nl;
+                  ip.nngp = nngp;
+                  ip.nxi0 = nxi0;
+                  ip.linear = linear;
+                  ip.jwipt = jwipt;
+                  ip.jwipl = jwipl;
+                  ip.jwngp0 = jwngp0;
+                  ip.jwigp0 = jwigp0;
+                  threadpool_parallel_for(nngp, IDSFFT_TRIANGLES_PER_CHUNK, idsfft_interpolate, &ip);
+                  free(ip.jig0mn);
                   return;
                 }
             }
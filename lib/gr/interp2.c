@@ -4,6 +4,21 @@
 #include <stdlib.h>
 
 #include "gr.h"
+#include "threadpool.h"
+
+#define INTERP2_ROWS_PER_CHUNK 4
+
+typedef struct
+{
+  int nx, ny;
+  const double *x, *y, *z;
+  int nxq;
+  const double *xq, *yq;
+  double *zq;
+  interp2_method_t method;
+  double extrapval;
+  double ***x_splines;
+} interp2_data_t;
 
 
 static char *xmalloc(int size)
@@ -201,64 +216,30 @@ static void create_splines(const double *x, const double *y, int n, double **spl
   free(alpha);
 }
 
-/*!
- * Interpolation in two dimensions using one of four different methods.
- * The input points are located on a grid, described by `nx`, `ny`, `x`, `y` and `z`.
- * The target grid ist described by `nxq`, `nyq`, `xq` and `yq` and the output
- * is written to `zq` as a field of `nxq * nyq` values.
- *
- * \verbatim embed:rst:leading-asterisk
- *
- * The available methods for interpolation are the following:
- *
- * +-----------------+---+-------------------------------------------+
- * | INTERP2_NEAREST | 0 | Nearest neighbour interpolation           |
- * +-----------------+---+-------------------------------------------+
- * | INTERP2_LINEAR  | 1 | Linear interpolation                      |
- * +-----------------+---+-------------------------------------------+
- * | INTERP_2_SPLINE | 2 | Interpolation using natural cubic splines |
- * +-----------------+---+-------------------------------------------+
- * | INTERP2_CUBIC   | 3 | Cubic interpolation                       |
- * +-----------------+---+-------------------------------------------+
- *
- * \endverbatim
- *
- * \param[in] nx The number of the input grid's x-values
- * \param[in] ny The number of the input grid's y-values
- * \param[in] x Pointer to the input grid's x-values
- * \param[in] y Pointer to the input grid's y-values
- * \param[in] z Pointer to the input grid's z-values (num. of values: nx * ny)
- * \param[in] nxq The number of the target grid's x-values
- * \param[in] nyq The number of the target grid's y-values
- * \param[in] xq Pointer to the target grid's x-values
- * \param[in] yq Pointer to the target grid's y-values
- * \param[out] zq Pointer to the target grids's z-values, used for output
- * \param[in] method Used method for interpolation
- * \param[in] extrapval The extrapolation value
+/*
+ * Interpolate the target grid rows `start` to `end - 1`. Each call uses its own scratch buffers for the spline
+ * method, so that disjoint row ranges can be processed concurrently.
  */
-void gr_interp2(int nx, int ny, const double *x, const double *y, const double *z, int nxq, int nyq, const double *xq,
-                const double *yq, double *zq, interp2_method_t method, double extrapval)
+static void interp2_rows(void *arg, int start, int end)
 {
-  int ixq, iyq, ix, iy, ind, i;
-  double ***x_splines = NULL, **spline = NULL, *a = NULL, diff;
+  const interp2_data_t *data = (const interp2_data_t *)arg;
+  int nx = data->nx, ny = data->ny, nxq = data->nxq;
+  const double *x = data->x, *y = data->y, *z = data->z, *xq = data->xq, *yq = data->yq;
+  double *zq = data->zq, extrapval = data->extrapval, ***x_splines = data->x_splines;
+  interp2_method_t method = data->method;
+  int ixq, iyq, ix, iy, ind;
+  double **spline = NULL, *a = NULL, diff;
 
   if (method == GR_INTERP2_SPLINE)
     {
-      x_splines = (double ***)xmalloc(ny * sizeof(double **));
       spline = (double **)xmalloc(ny * sizeof(double *));
       for (ind = 0; ind < ny; ind++)
         {
-          x_splines[ind] = (double **)xmalloc(ny * sizeof(double *));
-          for (i = 0; i < nx; i++)
-            {
-              x_splines[ind][i] = (double *)xmalloc(4 * sizeof(double));
-            }
           spline[ind] = (double *)xmalloc(4 * sizeof(double));
-          create_splines(x, z + ind * nx, nx, x_splines[ind]);
         }
       a = (double *)xmalloc(ny * sizeof(double));
     }
-  for (iyq = 0; iyq < nyq; iyq++)
+  for (iyq = start; iyq < end; iyq++)
     {
       for (ixq = 0; ixq < nxq; ixq++)
         {
@@ -344,6 +325,87 @@ void gr_interp2(int nx, int ny, const double *x, const double *y, const double *
             }
         }
     }
+  if (method == GR_INTERP2_SPLINE)
+    {
+      for (ind = 0; ind < ny; ind++)
+        {
+          free(spline[ind]);
+        }
+      free(spline);
+      free(a);
+    }
+}
+
+/*!
+ * Interpolation in two dimensions using one of four different methods.
+ * The input points are located on a grid, described by `nx`, `ny`, `x`, `y` and `z`.
+ * The target grid ist described by `nxq`, `nyq`, `xq` and `yq` and the output
+ * is written to `zq` as a field of `nxq * nyq` values.
+ *
+ * \verbatim embed:rst:leading-asterisk
+ *
+ * The available methods for interpolation are the following:
+ *
+ * +-----------------+---+-------------------------------------------+
+ * | INTERP2_NEAREST | 0 | Nearest neighbour interpolation           |
+ * +-----------------+---+-------------------------------------------+
+ * | INTERP2_LINEAR  | 1 | Linear interpolation                      |
+ * +-----------------+---+-------------------------------------------+
+ * | INTERP_2_SPLINE | 2 | Interpolation using natural cubic splines |
+ * +-----------------+---+-------------------------------------------+
+ * | INTERP2_CUBIC   | 3 | Cubic interpolation                       |
+ * +-----------------+---+-------------------------------------------+
+ *
+ * \endverbatim
+ *
+ * \param[in] nx The number of the input grid's x-values
+ * \param[in] ny The number of the input grid's y-values
+ * \param[in] x Pointer to the input grid's x-values
+ * \param[in] y Pointer to the input grid's y-values
+ * \param[in] z Pointer to the input grid's z-values (num. of values: nx * ny)
+ * \param[in] nxq The number of the target grid's x-values
+ * \param[in] nyq The number of the target grid's y-values
+ * \param[in] xq Pointer to the target grid's x-values
+ * \param[in] yq Pointer to the target grid's y-values
+ * \param[out] zq Pointer to the target grids's z-values, used for output
+ * \param[in] method Used method for interpolation
+ * \param[in] extrapval The extrapolation value
+ */
+void gr_interp2(int nx, int ny, const double *x, const double *y, const double *z, int nxq, int nyq, const double *xq,
+                const double *yq, double *zq, interp2_method_t method, double extrapval)
+{
+  int ind, i;
+  double ***x_splines = NULL;
+  interp2_data_t data;
+
+  if (method == GR_INTERP2_SPLINE)
+    {
+      x_splines = (double ***)xmalloc(ny * sizeof(double **));
+      for (ind = 0; ind < ny; ind++)
+        {
+          x_splines[ind] = (double **)xmalloc(nx * sizeof(double *));
+          for (i = 0; i < nx; i++)
+            {
+              x_splines[ind][i] = (double *)xmalloc(4 * sizeof(double));
+            }
+          create_splines(x, z + ind * nx, nx, x_splines[ind]);
+        }
+    }
+
+  data.nx = nx;
+  data.ny = ny;
+  data.x = x;
+  data.y = y;
+  data.z = z;
+  data.nxq = nxq;
+  data.xq = xq;
+  data.yq = yq;
+  data.zq = zq;
+  data.method = method;
+  data.extrapval = extrapval;
+  data.x_splines = x_splines;
+  threadpool_parallel_for(nyq, INTERP2_ROWS_PER_CHUNK, interp2_rows, &data);
+
   if (method == GR_INTERP2_SPLINE)
     {
       /* free allocated memory */
@@ -354,10 +416,7 @@ void gr_interp2(int nx, int ny, const double *x, const double *y, const double *
               free(x_splines[ind][i]);
             }
           free(x_splines[ind]);
-          free(spline[ind]);
         }
       free(x_splines);
-      free(spline);
-      free(a);
     }
 }
@@ -3175,8 +3175,57 @@ static void apply_axis3d(double *x3, double *y3, double *z3, double x, double y,
     }
 }
 
-static void render_character(BoxModelNode *node, double x, double y)
+/*
+ * A shipped-out formula is a list of characters and rules in canvas coordinates, i.e. before the text up vector,
+ * alignment and position are applied. For characters, `height` holds the text height and `width` is unused.
+ */
+typedef struct ShippedItem_
 {
+  int is_rect;
+  double x;
+  double y;
+  double width;
+  double height;
+  unsigned char utf8_str[5];
+} ShippedItem;
+
+typedef struct ShippedBoxModel_
+{
+  char *formula;
+  int font;
+  double font_size;
+  double width;
+  double height;
+  double depth;
+  size_t num_items;
+  size_t items_size;
+  ShippedItem *items;
+} ShippedBoxModel;
+
+static ShippedBoxModel *current_shipped_box_model = NULL;
+
+static ShippedItem *add_shipped_item(int is_rect, double x, double y, double width, double height)
+{
+  ShippedBoxModel *shipped = current_shipped_box_model;
+  ShippedItem *item;
+  if (shipped->num_items >= shipped->items_size)
+    {
+      shipped->items_size += 64;
+      shipped->items = (ShippedItem *)gks_realloc(shipped->items, sizeof(ShippedItem) * shipped->items_size);
+    }
+  item = shipped->items + shipped->num_items++;
+  item->is_rect = is_rect;
+  item->x = x;
+  item->y = y;
+  item->width = width;
+  item->height = height;
+  memset(item->utf8_str, 0, sizeof(item->utf8_str));
+  return item;
+}
+
+static void ship_character(BoxModelNode *node, double x, double y)
+{
+  ShippedItem *item;
   int window_height;
   double size_factor;
   unsigned char utf8_str[5] = {0, 0, 0, 0, 0};
@@ -3220,16 +3269,24 @@ static void render_character(BoxModelNode *node, double x, double y)
     {
       size_factor *= 1.25;
     }
-  gks_set_text_height(node->u.character.state.fontsize * size_factor);
-  gr_inqmathfont(&math_font);
-  gks_set_text_fontprec(math_font, 3);
-  gks_set_text_align(GKS_K_TEXT_HALIGN_LEFT, GKS_K_TEXT_VALIGN_BASE);
   if (node->u.character.bearing < 0)
     {
       x += node->u.character.bearing;
       x += node->u.character.advance;
     }
   y += node->u.character.shift_amount;
+  item = add_shipped_item(0, x, y, 0, node->u.character.state.fontsize * size_factor);
+  memcpy(item->utf8_str, utf8_str, sizeof(item->utf8_str));
+}
+
+static void render_character(const ShippedItem *item)
+{
+  double x = item->x;
+  double y = item->y;
+  gks_set_text_height(item->height);
+  gr_inqmathfont(&math_font);
+  gks_set_text_fontprec(math_font, 3);
+  gks_set_text_align(GKS_K_TEXT_HALIGN_LEFT, GKS_K_TEXT_VALIGN_BASE);
   apply_transformation(&x, &y);
   gks_select_xform(0);
   x = (x - window[0]) / (window[1] - window[0]);
@@ -3242,12 +3299,12 @@ static void render_character(BoxModelNode *node, double x, double y)
       apply_axis3d(&x3, &y3, &z3, x, y, transformationWC3.heightFactor);
 
       gks_select_xform(2);
-      gks_ft_text3d(x3, y3, z3, (char *)utf8_str, transformationWC3.axis, gks_state(), transformationWC3.heightFactor,
-                    transformationWC3.scaleFactors, gks_ft_gdp, gr_wc3towc);
+      gks_ft_text3d(x3, y3, z3, (char *)item->utf8_str, transformationWC3.axis, gks_state(),
+                    transformationWC3.heightFactor, transformationWC3.scaleFactors, gks_ft_gdp, gr_wc3towc);
     }
   else
     {
-      gks_text(x, y, (char *)utf8_str);
+      gks_text(x, y, (char *)item->utf8_str);
     }
 }
 
@@ -3275,21 +3332,25 @@ static double clamp(double x)
   return x;
 }
 
-static void render_rect(double x, double y, double width, double height)
+static void ship_rect(double x, double y, double width, double height)
+{
+  add_shipped_item(1, x, canvas_height - y, width, height);
+}
+
+static void render_rect(const ShippedItem *item)
 {
-  y = canvas_height - y;
   {
     int i;
     double xs[4];
     double ys[4];
-    xs[0] = x;
-    xs[1] = x + width;
-    xs[2] = x + width;
-    xs[3] = x;
-    ys[0] = y;
-    ys[1] = y;
-    ys[2] = y + height;
-    ys[3] = y + height;
+    xs[0] = item->x;
+    xs[1] = item->x + item->width;
+    xs[2] = item->x + item->width;
+    xs[3] = item->x;
+    ys[0] = item->y;
+    ys[1] = item->y;
+    ys[2] = item->y + item->height;
+    ys[3] = item->y + item->height;
     for (i = 0; i < 4; i++)
       {
         apply_transformation(xs + i, ys + i);
@@ -3410,7 +3471,7 @@ static void ship_vlist_out(Ship *this, size_t bm_node_index)
             if (rule_height > 0 && rule_depth > 0)
               {
                 this->cur_v += rule_height;
-                render_rect(this->cur_h + this->off_h, this->cur_v + this->off_v, rule_width, rule_height);
+                ship_rect(this->cur_h + this->off_h, this->cur_v + this->off_v, rule_width, rule_height);
               }
             break;
           }
@@ -3481,7 +3542,7 @@ static void ship_hlist_out(Ship *this, size_t bm_node_index)
       switch (child->type)
         {
         case BT_CHAR:
-          render_character(child, this->cur_h + this->off_h, this->cur_v + this->off_v);
+          ship_character(child, this->cur_h + this->off_h, this->cur_v + this->off_v);
           this->cur_h += child->u.character.width;
           break;
         case BT_KERN:
@@ -3535,7 +3596,7 @@ static void ship_hlist_out(Ship *this, size_t bm_node_index)
             if (rule_height > 0 && rule_width > 0)
               {
                 this->cur_v = base_line + rule_depth;
-                render_rect(this->cur_h + this->off_h, this->cur_v + this->off_v, rule_width, rule_height);
+                ship_rect(this->cur_h + this->off_h, this->cur_v + this->off_v, rule_width, rule_height);
                 this->cur_v = base_line;
               }
             this->cur_h += rule_width;
@@ -3590,18 +3651,6 @@ static void ship(double ox, double oy, size_t bm_node_index)
   ship_hlist_out(&ship, bm_node_index);
 }
 
-static void get_results(size_t bm_node_index, double *width, double *height, double *depth)
-{
-  BoxModelNode *box;
-  ship(0, 0, bm_node_index);
-  box = get_box_model_node(bm_node_index);
-  assert(box->type == BT_HLIST);
-  *width = ceil(box->u.hlist.width);
-  *height = ceil(ceil(box->u.hlist.height) + ceil(box->u.hlist.depth));
-  *depth = ceil(box->u.hlist.depth);
-}
-
-
 static void mathtex_to_box_model(const char *mathtex, double *width, double *height, double *depth)
 {
   BoxModelNode *result_node;
@@ -3637,6 +3686,71 @@ static void mathtex_to_box_model(const char *mathtex, double *width, double *hei
     }
 }
 
+/*
+ * Shipped-out layouts of recently used formulas, most recently used first. The layout only depends on the formula,
+ * the math font and the font size, so repeated formulas (e.g. tick labels) skip parsing, box model conversion and
+ * font metric lookups. The text up vector, alignment and position are applied when the layout is rendered.
+ */
+#define SHIPPED_BOX_MODEL_CACHE_SIZE 64
+
+static ShippedBoxModel *shipped_box_model_cache[SHIPPED_BOX_MODEL_CACHE_SIZE];
+static int shipped_box_model_cache_length = 0;
+
+static void free_shipped_box_model(ShippedBoxModel *shipped)
+{
+  gks_free(shipped->formula);
+  if (shipped->items)
+    {
+      gks_free(shipped->items);
+    }
+  gks_free(shipped);
+}
+
+static ShippedBoxModel *get_shipped_box_model(const char *mathtex)
+{
+  ShippedBoxModel *shipped;
+  int i;
+  for (i = 0; i < shipped_box_model_cache_length; i++)
+    {
+      shipped = shipped_box_model_cache[i];
+      if (shipped->font == math_font && shipped->font_size == font_size && strcmp(shipped->formula, mathtex) == 0)
+        {
+          memmove(shipped_box_model_cache + 1, shipped_box_model_cache, i * sizeof(ShippedBoxModel *));
+          shipped_box_model_cache[0] = shipped;
+          canvas_width = shipped->width;
+          canvas_height = shipped->height;
+          canvas_depth = shipped->depth;
+          return shipped;
+        }
+    }
+
+  mathtex_to_box_model(mathtex, NULL, NULL, NULL);
+  if (has_parser_error)
+    {
+      return NULL;
+    }
+  shipped = (ShippedBoxModel *)gks_malloc(sizeof(ShippedBoxModel));
+  shipped->formula = gks_strdup(mathtex);
+  shipped->font = math_font;
+  shipped->font_size = font_size;
+  shipped->width = canvas_width;
+  shipped->height = canvas_height;
+  shipped->depth = canvas_depth;
+  current_shipped_box_model = shipped;
+  ship(0, 0, result_box_model_node_index);
+  current_shipped_box_model = NULL;
+
+  if (shipped_box_model_cache_length == SHIPPED_BOX_MODEL_CACHE_SIZE)
+    {
+      free_shipped_box_model(shipped_box_model_cache[--shipped_box_model_cache_length]);
+    }
+  memmove(shipped_box_model_cache + 1, shipped_box_model_cache,
+          shipped_box_model_cache_length * sizeof(ShippedBoxModel *));
+  shipped_box_model_cache[0] = shipped;
+  shipped_box_model_cache_length++;
+  return shipped;
+}
+
 static void calculate_alignment_offsets(int horizontal_alignment, int vertical_alignment, double *x_offset,
                                         double *y_offset)
 {
@@ -3681,11 +3795,12 @@ static void calculate_alignment_offsets(int horizontal_alignment, int vertical_a
     }
 }
 
-static void render_box_model(double x, double y, int horizontal_alignment, int vertical_alignment)
+static void render_box_model(const ShippedBoxModel *shipped, double x, double y, int horizontal_alignment,
+                             int vertical_alignment)
 {
   int unused;
   int fillcolorind = 1;
-  double width, height, depth;
+  size_t i;
   /* TODO: use actual window height */
   int window_width = 2400;
   int window_height = 2400;
@@ -3706,7 +3821,17 @@ static void render_box_model(double x, double y, int horizontal_alignment, int v
   window[1] = (1 - x) * window_width;
   window[2] = -y * window_height;
   window[3] = (1 - y) * window_height;
-  get_results(result_box_model_node_index, &width, &height, &depth);
+  for (i = 0; i < shipped->num_items; i++)
+    {
+      if (shipped->items[i].is_rect)
+        {
+          render_rect(shipped->items + i);
+        }
+      else
+        {
+          render_character(shipped->items + i);
+        }
+    }
 }
 
 
@@ -3968,6 +4093,7 @@ void mathtex2(double x, double y, const char *formula, int inquire, double *tbx,
   /* TODO: inquire current workstation window height? */
   int window_width = 2400;
   int window_height = 2400;
+  ShippedBoxModel *shipped;
 
   double tbx_fallback[4];
   double tby_fallback[4];
@@ -4016,14 +4142,14 @@ void mathtex2(double x, double y, const char *formula, int inquire, double *tbx,
   transformation[4] = 0;
   transformation[5] = 0;
   font_size = 16.0 * previous_char_height / 0.027 * window_height / 500;
-  mathtex_to_box_model(formula, NULL, NULL, NULL);
-  if (!has_parser_error)
+  shipped = get_shipped_box_model(formula);
+  if (shipped)
     {
       double x_offset = 0;
       double y_offset = 0;
       if (!inquire)
         {
-          render_box_model(x, y, horizontal_alignment, vertical_alignment);
+          render_box_model(shipped, x, y, horizontal_alignment, vertical_alignment);
         }
       else
         {
@@ -4117,6 +4243,7 @@ void mathtex2_3d(double x, double y, double z, const char *formula, int axis, do
   /* TODO: inquire current workstation window height? */
   int window_width = 2400;
   int window_height = 2400;
+  ShippedBoxModel *shipped;
 
   double tbx_fallback[4];
   double tby_fallback[4];
@@ -4172,14 +4299,14 @@ void mathtex2_3d(double x, double y, double z, const char *formula, int axis, do
   transformation[4] = 0;
   transformation[5] = 0;
   font_size = 16.0 * previous_char_height / 0.027 * window_height / 500;
-  mathtex_to_box_model(formula, NULL, NULL, NULL);
-  if (!has_parser_error)
+  shipped = get_shipped_box_model(formula);
+  if (shipped)
     {
       double x_offset = 0;
       double y_offset = 0;
       if (!inquire)
         {
-          render_box_model(0, 0, horizontal_alignment, vertical_alignment);
+          render_box_model(shipped, 0, 0, horizontal_alignment, vertical_alignment);
         }
       else
         {
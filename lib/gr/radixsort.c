@@ -0,0 +1,192 @@
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+
+#include "radixsort.h"
+#include "threadpool.h"
+
+#define RADIX_BITS 8
+#define RADIX_SIZE (1 << RADIX_BITS)
+#define RADIX_MASK (RADIX_SIZE - 1)
+#define RADIX_PASSES (32 / RADIX_BITS)
+#define RADIX_MAX_THREADS 256
+
+typedef struct
+{
+  uint32_t key;
+  int index;
+} radix_item_t;
+
+typedef struct
+{
+  const radix_item_t *src;
+  radix_item_t *dst;
+  int start, end;
+  int shift;
+  int count[RADIX_SIZE];
+} radix_chunk_t;
+
+/*
+ * Map an IEEE 754 single precision float to an unsigned integer with the same ordering: negative values have all
+ * bits inverted, positive values get their sign bit set.
+ */
+static uint32_t float_to_sortable(float f)
+{
+  uint32_t u;
+
+  memcpy(&u, &f, sizeof(uint32_t));
+  return (u & 0x80000000u) ? ~u : (u | 0x80000000u);
+}
+
+static float sortable_to_float(uint32_t u)
+{
+  float f;
+
+  u = (u & 0x80000000u) ? (u & 0x7fffffffu) : ~u;
+  memcpy(&f, &u, sizeof(float));
+  return f;
+}
+
+static void radix_histogram(radix_chunk_t *chunk)
+{
+  int i, shift = chunk->shift;
+
+  memset(chunk->count, 0, sizeof(chunk->count));
+  for (i = chunk->start; i < chunk->end; i++)
+    {
+      chunk->count[(chunk->src[i].key >> shift) & RADIX_MASK]++;
+    }
+}
+
+static void radix_scatter(radix_chunk_t *chunk)
+{
+  int i, shift = chunk->shift;
+  radix_item_t *dst = chunk->dst;
+
+  /* `count` holds the output offset of every digit for this chunk at this point */
+  for (i = chunk->start; i < chunk->end; i++)
+    {
+      dst[chunk->count[(chunk->src[i].key >> shift) & RADIX_MASK]++] = chunk->src[i];
+    }
+}
+
+static int radix_digit_is_shared(const radix_chunk_t *chunks, int num_threads, int n)
+{
+  int t, digit, total;
+
+  for (digit = 0; digit < RADIX_SIZE; digit++)
+    {
+      total = 0;
+      for (t = 0; t < num_threads; t++)
+        {
+          total += chunks[t].count[digit];
+        }
+      if (total != 0)
+        {
+          return total == n;
+        }
+    }
+  return 0;
+}
+
+static void radix_histogram_chunks(void *arg, int start, int end)
+{
+  radix_chunk_t *chunks = (radix_chunk_t *)arg;
+  int i;
+
+  for (i = start; i < end; i++)
+    {
+      radix_histogram(chunks + i);
+    }
+}
+
+static void radix_scatter_chunks(void *arg, int start, int end)
+{
+  radix_chunk_t *chunks = (radix_chunk_t *)arg;
+  int i;
+
+  for (i = start; i < end; i++)
+    {
+      radix_scatter(chunks + i);
+    }
+}
+
+/*
+ * Stable sort of (depth, index) pairs in ascending order of `key` using a least significant digit radix sort. Each
+ * pass splits the keys into `num_threads` contiguous chunks which are counted and scattered on the shared worker
+ * pool. Returns 0 on success and -1 if the temporary buffers could not be allocated, in which case `keys` is left
+ * unchanged.
+ */
+int radixsort_depth_keys(int n, depth_key_t *keys, int num_threads)
+{
+  radix_item_t *items, *tmp, *src, *dst;
+  radix_chunk_t *chunks;
+  int i, t, pass, digit, offset;
+
+  if (n < 2) return 0;
+
+  if (num_threads < 1) num_threads = 1;
+  if (num_threads > RADIX_MAX_THREADS) num_threads = RADIX_MAX_THREADS;
+  if (num_threads > n) num_threads = n;
+
+  items = (radix_item_t *)malloc(2 * (size_t)n * sizeof(radix_item_t));
+  chunks = (radix_chunk_t *)malloc(num_threads * sizeof(radix_chunk_t));
+  if (items == NULL || chunks == NULL)
+    {
+      free(chunks);
+      free(items);
+      return -1;
+    }
+  tmp = items + n;
+
+  for (i = 0; i < n; i++)
+    {
+      items[i].key = float_to_sortable(keys[i].key);
+      items[i].index = keys[i].index;
+    }
+
+  src = items;
+  dst = tmp;
+  for (pass = 0; pass < RADIX_PASSES; pass++)
+    {
+      for (t = 0; t < num_threads; t++)
+        {
+          chunks[t].src = src;
+          chunks[t].dst = dst;
+          chunks[t].start = (int)((int64_t)t * n / num_threads);
+          chunks[t].end = (int)((int64_t)(t + 1) * n / num_threads);
+          chunks[t].shift = pass * RADIX_BITS;
+        }
+      threadpool_parallel_for(num_threads, 1, radix_histogram_chunks, chunks);
+
+      /* a digit shared by all keys does not change the order, so the scatter can be skipped */
+      if (radix_digit_is_shared(chunks, num_threads, n)) continue;
+
+      /* turn the per-chunk counts into output offsets: digit-major, chunk-minor keeps the sort stable */
+      offset = 0;
+      for (digit = 0; digit < RADIX_SIZE; digit++)
+        {
+          for (t = 0; t < num_threads; t++)
+            {
+              int count = chunks[t].count[digit];
+              chunks[t].count[digit] = offset;
+              offset += count;
+            }
+        }
+      threadpool_parallel_for(num_threads, 1, radix_scatter_chunks, chunks);
+
+      src = dst;
+      dst = (dst == items) ? tmp : items;
+    }
+
+  for (i = 0; i < n; i++)
+    {
+      keys[i].key = sortable_to_float(src[i].key);
+      keys[i].index = src[i].index;
+    }
+
+  free(chunks);
+  free(items);
+
+  return 0;
+}
@@ -0,0 +1,20 @@
+#ifndef _RADIXSORT_H_
+#define _RADIXSORT_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct
+{
+  float key;
+  int index;
+} depth_key_t;
+
+int radixsort_depth_keys(int n, depth_key_t *keys, int num_threads);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -15,6 +15,7 @@ Link:
 #include <stdio.h>
 
 #include "gr.h"
+#include "threadpool.h"
 
 #ifdef isnan
 #define is_nan(a) isnan(a)
@@ -25,6 +26,19 @@ Link:
 #define log1p(x) (log(1 + (x)))
 #endif
 
+#define SHADE_MIN_POINTS_PER_CHUNK 100000
+
+typedef struct
+{
+  int n;
+  double *x, *y;
+  int lines;
+  double *roi;
+  int w, h;
+  int num_chunks;
+  int **bins;
+} shade_data_t;
+
 static char *xcalloc(int count, int size)
 {
   char *result = (char *)calloc(count, size);
@@ -36,19 +50,17 @@ static char *xcalloc(int count, int size)
   return (result);
 }
 
-static void rasterize(int n, double *x, double *y, double *roi, int w, int h, int *bins)
+static void rasterize(int start, int end, double *x, double *y, double *roi, int w, int h, int *bins)
 {
   double xl, xr, yb, yt;
-  int i, ix, iy, num_bins = w * h;
+  int i, ix, iy;
 
   xl = roi[0];
   xr = roi[1];
   yb = roi[2];
   yt = roi[3];
 
-  for (i = 0; i < num_bins; i++) bins[i] = 0;
-
-  for (i = 0; i < n; i++)
+  for (i = start; i < end; i++)
     {
       if (x[i] >= roi[0] && x[i] <= roi[1] && y[i] >= roi[2] && y[i] <= roi[3])
         {
@@ -196,48 +208,87 @@ static void line(int x0, int y0, int x1, int y1, int w, int h, int *bins)
     }
 }
 
-void gr_shade(int n, double *x, double *y, int lines, int xform, double *roi, int w, int h, int *bins)
+/*
+ * Draw the line segments from point `i` to `i + 1` for `start <= i < end`. Segments with an end point outside of the
+ * region of interest (which includes NaN coordinates separating the polylines) are skipped.
+ */
+static void rasterize_lines(int start, int end, double *x, double *y, double *roi, int w, int h, int *bins)
 {
   double xl, xr, yb, yt;
-  int i, j, x0, y0, x1, y1, num_bins = w * h;
-
-  if (lines == 1)
-    {
-      xl = roi[0];
-      xr = roi[1];
-      yb = roi[2];
-      yt = roi[3];
+  int i, x0, y0, x1, y1;
 
-      for (i = 0; i < num_bins; i++) bins[i] = 0;
+  xl = roi[0];
+  xr = roi[1];
+  yb = roi[2];
+  yt = roi[3];
 
-      i = 0;
-      while (i < n)
+  for (i = start; i < end; i++)
+    {
+      if (x[i] >= xl && x[i] <= xr && y[i] >= yb && y[i] <= yt && x[i + 1] >= xl && x[i + 1] <= xr &&
+          y[i + 1] >= yb && y[i + 1] <= yt)
         {
-          j = i + 1;
-          while (j < n && !is_nan(x[j]) && !is_nan(y[j])) j++;
-          j--;
-
-          while (i < j)
-            {
-              if (x[i] >= xl && x[i] <= xr && y[i] >= yb && y[i] <= yt && x[i + 1] >= xl && x[i + 1] <= xr &&
-                  y[i + 1] >= yb && y[i + 1] <= yt)
-                {
-                  x0 = (int)((x[i] - xl) / (xr - xl) * (w - 1) + 0.5);
-                  y0 = (int)((y[i] - yb) / (yt - yb) * (h - 1) + 0.5);
-                  x1 = (int)((x[i + 1] - xl) / (xr - xl) * (w - 1) + 0.5);
-                  y1 = (int)((y[i + 1] - yb) / (yt - yb) * (h - 1) + 0.5);
-                  line(x0, y0, x1, y1, w, h, bins);
-                }
-              i++;
-            }
-
-          i += 2;
+          x0 = (int)((x[i] - xl) / (xr - xl) * (w - 1) + 0.5);
+          y0 = (int)((y[i] - yb) / (yt - yb) * (h - 1) + 0.5);
+          x1 = (int)((x[i + 1] - xl) / (xr - xl) * (w - 1) + 0.5);
+          y1 = (int)((y[i + 1] - yb) / (yt - yb) * (h - 1) + 0.5);
+          line(x0, y0, x1, y1, w, h, bins);
         }
     }
-  else
+}
+
+/*
+ * Every chunk of points (or line segments) is accumulated into its own set of bins, which are summed up afterwards.
+ */
+static void shade_chunks(void *arg, int start, int end)
+{
+  shade_data_t *data = (shade_data_t *)arg;
+  int c, i, n, first, last, num_bins = data->w * data->h;
+
+  n = data->lines ? data->n - 1 : data->n;
+  for (c = start; c < end; c++)
+    {
+      for (i = 0; i < num_bins; i++) data->bins[c][i] = 0;
+
+      first = (int)((int64_t)c * n / data->num_chunks);
+      last = (int)((int64_t)(c + 1) * n / data->num_chunks);
+      if (data->lines)
+        rasterize_lines(first, last, data->x, data->y, data->roi, data->w, data->h, data->bins[c]);
+      else
+        rasterize(first, last, data->x, data->y, data->roi, data->w, data->h, data->bins[c]);
+    }
+}
+
+void gr_shade(int n, double *x, double *y, int lines, int xform, double *roi, int w, int h, int *bins)
+{
+  shade_data_t data;
+  int c, i, num_bins = w * h;
+
+  data.n = n;
+  data.x = x;
+  data.y = y;
+  data.lines = lines == 1;
+  data.roi = roi;
+  data.w = w;
+  data.h = h;
+  data.num_chunks = threadpool_get_num_threads();
+  if (data.num_chunks > n / SHADE_MIN_POINTS_PER_CHUNK) data.num_chunks = n / SHADE_MIN_POINTS_PER_CHUNK;
+  if (data.num_chunks < 1) data.num_chunks = 1;
+
+  data.bins = (int **)xcalloc(data.num_chunks, sizeof(int *));
+  data.bins[0] = bins;
+  for (c = 1; c < data.num_chunks; c++)
+    {
+      data.bins[c] = (int *)xcalloc(num_bins, sizeof(int));
+    }
+
+  threadpool_parallel_for(data.num_chunks, 1, shade_chunks, &data);
+
+  for (c = 1; c < data.num_chunks; c++)
     {
-      rasterize(n, x, y, roi, w, h, bins);
+      for (i = 0; i < num_bins; i++) bins[i] += data.bins[c][i];
+      free(data.bins[c]);
     }
+  free(data.bins);
 
   shade(w, h, bins, xform);
 }
@@ -1,124 +1,363 @@
 #ifdef _MSC_VER
 #define NO_THREADS 1
 #endif
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#if !defined(VMS) && !defined(_WIN32)
+#include <unistd.h>
+#endif
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
 #ifndef NO_THREADS
-#include <assert.h>
+#include <pthread.h>
+#endif
 
 #include "threadpool.h"
 
-#ifndef max
-#define max(a, b) ((a) > (b) ? (a) : (b))
+#define THREADPOOL_MAX_THREADS 256
+
+/*
+ * GR keeps a single, lazily started pool of worker threads for the whole process. `threadpool_parallel_for` splits
+ * an index range into one contiguous slot per participating thread (the calling thread included). Every thread
+ * consumes its own slot in chunks of `grain` indices; once it runs dry it steals the upper half of the largest
+ * remaining range from another slot. Calls made while the pool is busy (nested or concurrent ones) run serially in
+ * the calling thread, in chunks of `grain` indices as well.
+ */
+
+static int requested_threads = 0;
+
+#ifndef NO_THREADS
+
+typedef struct
+{
+  pthread_mutex_t lock;
+  int next, end;
+} threadpool_slot_t;
+
+static struct
+{
+  pthread_mutex_t busy;
+  pthread_mutex_t lock;
+  pthread_cond_t work_cond;
+  pthread_cond_t done_cond;
+  pthread_t *threads;
+  threadpool_slot_t *slots;
+  int num_workers;
+  int active;
+  int stop;
+  unsigned long generation, start_generation;
+  threadpool_range_func_t func;
+  void *arg;
+  int grain;
+} pool = {PTHREAD_MUTEX_INITIALIZER, PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER, PTHREAD_COND_INITIALIZER};
+
+#ifndef _WIN32
+static int atfork_registered = 0;
+#endif
+
+static int system_processor_count(void)
+{
+#ifdef _WIN32
+#ifndef _SC_NPROCESSORS_ONLN
+  SYSTEM_INFO info;
+  GetSystemInfo(&info);
+#define sysconf(a) info.dwNumberOfProcessors
+#define _SC_NPROCESSORS_ONLN
 #endif
+#endif
+  return (int)sysconf(_SC_NPROCESSORS_ONLN);
+}
 
-typedef void *threadpool_work_t;
-threadpool_work_t next_work_item;
+#endif
 
-static void *threadpool_worker(void *arg)
+/*
+ * Set the number of threads (including the calling thread) used by `threadpool_parallel_for`. A value less than one
+ * restores the default, which is the number of online processors. The pool is resized on its next use.
+ */
+void threadpool_set_num_threads(int num)
 {
-  threadpool_t *tp = arg;
-  threadpool_work_t work;
+  requested_threads = num > THREADPOOL_MAX_THREADS ? THREADPOOL_MAX_THREADS : num;
+}
 
-  pthread_mutex_lock(&(tp->work_mutex));
-  while (1)
+int threadpool_get_num_threads(void)
+{
+#ifndef NO_THREADS
+  int num = requested_threads;
+
+  if (num < 1)
     {
-      while (next_work_item == NULL && !tp->stop) pthread_cond_wait(&(tp->wait_for_work_cond), &(tp->work_mutex));
+      num = system_processor_count();
+      if (num > THREADPOOL_MAX_THREADS) num = THREADPOOL_MAX_THREADS;
+      if (num < 1) num = 1;
+    }
+  return num;
+#else
+  return 1;
+#endif
+}
 
-      if (tp->stop) break;
+#ifndef NO_THREADS
+
+/*
+ * Take the next chunk for thread `self`, stealing from the other slots if its own one is exhausted. Returns 0 once
+ * all slots are empty.
+ */
+static int next_chunk(int self, int num_slots, int grain, int *start, int *end)
+{
+  threadpool_slot_t *own = pool.slots + self, *victim;
+  int i, v, best, best_size, size, mid;
 
-      work = next_work_item;
-      next_work_item = NULL;
-      pthread_cond_signal(&(tp->work_fetched));
-      tp->working_cnt++;
-      pthread_mutex_unlock(&(tp->work_mutex));
+  pthread_mutex_lock(&own->lock);
+  if (own->next < own->end)
+    {
+      *start = own->next;
+      *end = own->end - own->next > grain ? own->next + grain : own->end;
+      own->next = *end;
+      pthread_mutex_unlock(&own->lock);
+      return 1;
+    }
+  pthread_mutex_unlock(&own->lock);
 
-      if (work != NULL)
+  while (1)
+    {
+      best = -1;
+      best_size = 0;
+      for (i = 1; i < num_slots; i++)
         {
-          tp->worker_func(work);
+          v = (self + i) % num_slots;
+          pthread_mutex_lock(&pool.slots[v].lock);
+          size = pool.slots[v].end - pool.slots[v].next;
+          pthread_mutex_unlock(&pool.slots[v].lock);
+          if (size > best_size)
+            {
+              best = v;
+              best_size = size;
+            }
         }
+      if (best < 0) return 0;
 
-      pthread_mutex_lock(&(tp->work_mutex));
-      tp->working_cnt--;
-      if (!tp->stop && tp->working_cnt == 0 && next_work_item == NULL) pthread_cond_signal(&(tp->all_work_done_cond));
-    }
+      victim = pool.slots + best;
+      pthread_mutex_lock(&victim->lock);
+      size = victim->end - victim->next;
+      if (size <= 0)
+        {
+          /* someone else got there first, look again */
+          pthread_mutex_unlock(&victim->lock);
+          continue;
+        }
+      if (size <= grain)
+        {
+          *start = victim->next;
+          *end = victim->end;
+          victim->next = victim->end;
+          pthread_mutex_unlock(&victim->lock);
+          return 1;
+        }
+      mid = victim->next + size / 2;
+      *start = mid;
+      *end = victim->end;
+      victim->end = mid;
+      pthread_mutex_unlock(&victim->lock);
 
-  tp->thread_cnt--;
-  pthread_cond_signal(&(tp->all_work_done_cond));
-  pthread_mutex_unlock(&(tp->work_mutex));
-  return NULL;
+      /* keep the first chunk, publish the rest of the stolen range in our own slot */
+      if (*end - *start > grain)
+        {
+          pthread_mutex_lock(&own->lock);
+          own->next = *start + grain;
+          own->end = *end;
+          pthread_mutex_unlock(&own->lock);
+          *end = *start + grain;
+        }
+      return 1;
+    }
 }
 
-void threadpool_create(threadpool_t *tp, size_t num, worker_func_t worker_func)
+static void run_slots(int self, int num_slots)
 {
-  size_t i;
+  int start, end;
 
-  num = max(num, 1);
+  while (next_chunk(self, num_slots, pool.grain, &start, &end))
+    {
+      pool.func(pool.arg, start, end);
+    }
+}
 
-  tp->worker_func = worker_func;
-  tp->thread_cnt = num;
-  tp->threads = calloc(num, sizeof(pthread_t));
-  pthread_mutex_init(&(tp->work_mutex), NULL);
-  pthread_cond_init(&(tp->wait_for_work_cond), NULL);
-  pthread_cond_init(&(tp->work_fetched), NULL);
-  pthread_cond_init(&(tp->all_work_done_cond), NULL);
-  tp->working_cnt = 0;
-  tp->stop = 0;
+static void *threadpool_worker(void *arg)
+{
+  int self = (int)(size_t)arg;
+  unsigned long generation;
 
-  for (i = 0; i < num; i++)
+  pthread_mutex_lock(&pool.lock);
+  generation = pool.start_generation;
+  while (1)
     {
-      pthread_create(&tp->threads[i], NULL, threadpool_worker, tp);
+      while (pool.generation == generation && !pool.stop) pthread_cond_wait(&pool.work_cond, &pool.lock);
+      if (pool.stop) break;
+      generation = pool.generation;
+      pthread_mutex_unlock(&pool.lock);
+
+      run_slots(self, pool.num_workers + 1);
+
+      pthread_mutex_lock(&pool.lock);
+      if (--pool.active == 0) pthread_cond_signal(&pool.done_cond);
     }
+  pthread_mutex_unlock(&pool.lock);
+  return NULL;
 }
 
-void threadpool_destroy(threadpool_t *tp)
+static void stop_workers(void)
 {
-  int thread_cnt;
   int i;
 
-  if (tp == NULL) return;
-
-  threadpool_wait(tp);
+  if (pool.num_workers == 0) return;
 
-  pthread_mutex_lock(&(tp->work_mutex));
-  thread_cnt = tp->thread_cnt;
-  tp->stop = 1;
-  pthread_cond_broadcast(&(tp->wait_for_work_cond));
-  pthread_mutex_unlock(&(tp->work_mutex));
-
-  for (i = 0; i < thread_cnt; ++i)
+  pthread_mutex_lock(&pool.lock);
+  pool.stop = 1;
+  pthread_cond_broadcast(&pool.work_cond);
+  pthread_mutex_unlock(&pool.lock);
+  for (i = 0; i < pool.num_workers; i++)
+    {
+      pthread_join(pool.threads[i], NULL);
+    }
+  for (i = 0; i <= pool.num_workers; i++)
     {
-      pthread_join(tp->threads[i], NULL);
+      pthread_mutex_destroy(&pool.slots[i].lock);
     }
+  free(pool.threads);
+  free(pool.slots);
+  pool.threads = NULL;
+  pool.slots = NULL;
+  pool.num_workers = 0;
+  pool.stop = 0;
+}
 
-  pthread_mutex_destroy(&(tp->work_mutex));
-  pthread_cond_destroy(&(tp->wait_for_work_cond));
-  pthread_cond_destroy(&(tp->work_fetched));
-  pthread_cond_destroy(&(tp->all_work_done_cond));
-  free(tp->threads);
-  free(tp);
+#ifndef _WIN32
+static void reset_after_fork(void)
+{
+  /* worker threads do not survive a fork, so the child starts over with an empty pool */
+  pthread_mutex_init(&pool.busy, NULL);
+  pthread_mutex_init(&pool.lock, NULL);
+  pthread_cond_init(&pool.work_cond, NULL);
+  pthread_cond_init(&pool.done_cond, NULL);
+  pool.threads = NULL;
+  pool.slots = NULL;
+  pool.num_workers = 0;
+  pool.active = 0;
+  pool.stop = 0;
 }
+#endif
 
-void threadpool_add_work(threadpool_t *tp, void *arg)
+/*
+ * (Re)start the worker threads so that `num_threads - 1` workers are available. Must be called with `pool.busy`
+ * held. Returns the number of workers actually running.
+ */
+static int start_workers(int num_threads)
 {
-  pthread_mutex_lock(&(tp->work_mutex));
+  int i;
 
-  assert(next_work_item == NULL);
-  next_work_item = arg;
+  if (pool.num_workers == num_threads - 1) return pool.num_workers;
+  stop_workers();
 
-  pthread_cond_signal(&(tp->wait_for_work_cond));
-  /* wait until `next_work_item` is picked up by a worker thread before returning */
-  pthread_cond_wait(&(tp->work_fetched), &(tp->work_mutex));
-  pthread_mutex_unlock(&(tp->work_mutex));
+#ifndef _WIN32
+  if (!atfork_registered)
+    {
+      pthread_atfork(NULL, NULL, reset_after_fork);
+      atfork_registered = 1;
+    }
+#endif
+
+  pool.threads = (pthread_t *)calloc(num_threads - 1, sizeof(pthread_t));
+  pool.slots = (threadpool_slot_t *)calloc(num_threads, sizeof(threadpool_slot_t));
+  if (pool.threads == NULL || pool.slots == NULL)
+    {
+      free(pool.threads);
+      free(pool.slots);
+      pool.threads = NULL;
+      pool.slots = NULL;
+      return 0;
+    }
+  for (i = 0; i < num_threads; i++)
+    {
+      pthread_mutex_init(&pool.slots[i].lock, NULL);
+    }
+  pool.start_generation = pool.generation;
+  for (i = 0; i < num_threads - 1; i++)
+    {
+      if (pthread_create(pool.threads + i, NULL, threadpool_worker, (void *)(size_t)(i + 1)) != 0) break;
+      pool.num_workers++;
+    }
+  if (pool.num_workers == 0)
+    {
+      for (i = 0; i < num_threads; i++)
+        {
+          pthread_mutex_destroy(&pool.slots[i].lock);
+        }
+      free(pool.threads);
+      free(pool.slots);
+      pool.threads = NULL;
+      pool.slots = NULL;
+    }
+  return pool.num_workers;
 }
 
-void threadpool_wait(threadpool_t *tp)
+#endif
+
+/*
+ * Call `func(arg, start, end)` for disjoint ranges covering `0` to `n - 1`, at most `grain` indices at a time, using
+ * the shared worker pool. `func` may be called concurrently from different threads and in any order. Returns once
+ * all ranges have been processed.
+ */
+void threadpool_parallel_for(int n, int grain, threadpool_range_func_t func, void *arg)
 {
-  if (tp == NULL) return;
+  int start;
+#ifndef NO_THREADS
+  int i, num_threads, num_workers;
+#endif
+
+  if (n <= 0) return;
+  if (grain < 1) grain = 1;
 
-  pthread_mutex_lock(&(tp->work_mutex));
-  while ((!tp->stop && tp->working_cnt != 0) || (tp->stop && tp->thread_cnt != 0))
+#ifndef NO_THREADS
+  num_threads = threadpool_get_num_threads();
+  if (num_threads > (n + grain - 1) / grain) num_threads = (n + grain - 1) / grain;
+  if (num_threads > 1 && pthread_mutex_trylock(&pool.busy) == 0)
     {
-      pthread_cond_wait(&(tp->all_work_done_cond), &(tp->work_mutex));
+      num_workers = start_workers(threadpool_get_num_threads());
+      if (num_workers > 0)
+        {
+          for (i = 0; i <= num_workers; i++)
+            {
+              pool.slots[i].next = (int)((long long)i * n / (num_workers + 1));
+              pool.slots[i].end = (int)((long long)(i + 1) * n / (num_workers + 1));
+            }
+          pool.func = func;
+          pool.arg = arg;
+          pool.grain = grain;
+
+          pthread_mutex_lock(&pool.lock);
+          pool.active = num_workers;
+          pool.generation++;
+          pthread_cond_broadcast(&pool.work_cond);
+          pthread_mutex_unlock(&pool.lock);
+
+          run_slots(0, num_workers + 1);
+
+          pthread_mutex_lock(&pool.lock);
+          while (pool.active > 0) pthread_cond_wait(&pool.done_cond, &pool.lock);
+          pthread_mutex_unlock(&pool.lock);
+
+          pthread_mutex_unlock(&pool.busy);
+          return;
+        }
+      pthread_mutex_unlock(&pool.busy);
     }
-  pthread_mutex_unlock(&(tp->work_mutex));
-}
 #endif
+  for (start = 0; start < n; start += grain)
+    {
+      func(arg, start, n - start > grain ? start + grain : n);
+    }
+}
@@ -1,36 +1,27 @@
 #ifndef THREADPOOL_H_INCLUDED
 #define THREADPOOL_H_INCLUDED
 
-#ifdef _MSC_VER
-#define NO_THREADS 1
+/* the pool is also used by GRM, so its functions are exported from the GR library */
+#ifndef DLLEXPORT
+#ifdef _WIN32
+#define DLLEXPORT __declspec(dllexport)
+#else
+#define DLLEXPORT
+#endif
 #endif
-#ifndef NO_THREADS
 
-#include <stdbool.h>
-#include <stddef.h>
-#include <pthread.h>
-#include <stdio.h>
-#include <stdlib.h>
-#include <math.h>
+#ifdef __cplusplus
+extern "C" {
+#endif
 
-typedef void (*worker_func_t)(void *arg);
-typedef struct threadpool
-{
-  worker_func_t worker_func;
-  pthread_mutex_t work_mutex;
-  pthread_cond_t wait_for_work_cond;
-  pthread_cond_t work_fetched;
-  pthread_cond_t all_work_done_cond;
-  size_t working_cnt;
-  size_t thread_cnt;
-  pthread_t *threads;
-  int stop;
-} threadpool_t;
+typedef void (*threadpool_range_func_t)(void *arg, int start, int end);
 
-void threadpool_create(threadpool_t *tp, size_t num, worker_func_t func);
-void threadpool_destroy(threadpool_t *tp);
-void threadpool_add_work(threadpool_t *tp, void *arg);
-void threadpool_wait(threadpool_t *tp);
+DLLEXPORT void threadpool_set_num_threads(int num);
+DLLEXPORT int threadpool_get_num_threads(void);
+DLLEXPORT void threadpool_parallel_for(int n, int grain, threadpool_range_func_t func, void *arg);
 
+#ifdef __cplusplus
+}
 #endif
+
 #endif /* ifndef THREADPOOL_H_INCLUDED */
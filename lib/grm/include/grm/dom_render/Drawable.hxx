@@ -4,6 +4,7 @@
 #include <functional>
 #include "grm/dom_render/graphics_tree/Element.hxx"
 #include "grm/dom_render/context.hxx"
+#include "grm/dom_render/ManageDrawableCache.hxx"
 
 class Drawable
 {
@@ -12,7 +13,7 @@ public:
       const std::shared_ptr<GRM::Element> element, const std::shared_ptr<GRM::Context> context, int grContextId,
       int zIndex,
       std::function<void(const std::shared_ptr<GRM::Element> &, const std::shared_ptr<GRM::Context> &)> drawFunction);
-  void draw();
+  void draw(ManageDrawableCache *cache = nullptr);
   int zIndex;
   int insertionIndex; /* used to order drawables with the same zIndex in the order of insertion */
   int getGrContextId() const;
@@ -20,15 +21,15 @@ public:
 
 private:
   int grContextId;
-  const std::shared_ptr<GRM::Element> element;
-  const std::shared_ptr<GRM::Context> context;
+  std::shared_ptr<GRM::Element> element;
+  std::shared_ptr<GRM::Context> context;
   std::function<void(const std::shared_ptr<GRM::Element> &, const std::shared_ptr<GRM::Context> &)> drawFunction;
 };
 
 class CompareZIndex
 {
 public:
-  bool operator()(std::shared_ptr<Drawable> const &lhs, std::shared_ptr<Drawable> const &rhs);
+  bool operator()(const Drawable &lhs, const Drawable &rhs) const;
 };
 
 #endif // GR_DRAWABLE_HXX
@@ -0,0 +1,75 @@
+#ifndef GR_MANAGEDATAPREPARATION_HXX
+#define GR_MANAGEDATAPREPARATION_HXX
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "grm/dom_render/context.hxx"
+
+class ManageDataPreparation
+{
+  /*!
+   * ManageDataPreparation holds results which are derived from series data, like coordinate ranges or histogram bins.
+   * Before the graphics tree is processed, the results it will need are requested and computed concurrently by GR's
+   * thread pool. Workers only read views of the context data which were looked up on the render thread, they never
+   * access the tree, the context or GR state. The views stay valid since the context is not modified until all tasks
+   * are finished. While the tree is processed, `get` returns the prepared results and computes missing ones on the
+   * calling thread.
+   *
+   * A result is identified by an id and stays valid as long as the context data it was computed from is unchanged.
+   */
+
+public:
+  using Compute = std::function<std::vector<double>(const std::vector<GRM::DoubleView> &)>;
+
+  void begin();
+  void request(const std::string &id, const std::shared_ptr<GRM::Context> &context,
+               const std::vector<std::string> &keys, Compute compute);
+  void run();
+  const std::vector<double> &get(const std::string &id, const std::shared_ptr<GRM::Context> &context,
+                                 const std::vector<std::string> &keys, const Compute &compute);
+  void clear();
+
+private:
+  struct Input
+  {
+    const double *data = nullptr;
+    std::size_t size = 0;
+    unsigned long revision = 0;
+
+    bool operator==(const Input &other) const
+    {
+      return data == other.data && size == other.size && revision == other.revision;
+    }
+  };
+
+  struct Result
+  {
+    std::vector<Input> inputs;
+    std::vector<double> values;
+    bool used = false;
+  };
+
+  struct Task
+  {
+    std::string id;
+    std::vector<Input> inputs;
+    std::vector<GRM::DoubleView> views;
+    Compute compute;
+    std::vector<double> values;
+    bool done = false;
+  };
+
+  static std::vector<Input> lookupInputs(const std::shared_ptr<GRM::Context> &context,
+                                         const std::vector<std::string> &keys, std::vector<GRM::DoubleView> &views);
+  static void runTasks(void *arg, int start, int end);
+
+  std::unordered_map<std::string, Result> results;
+  std::vector<Task> tasks;
+};
+
+#endif // GR_MANAGEDATAPREPARATION_HXX
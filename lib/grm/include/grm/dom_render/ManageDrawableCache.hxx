@@ -0,0 +1,51 @@
+#ifndef GR_MANAGEDRAWABLECACHE_HXX
+#define GR_MANAGEDRAWABLECACHE_HXX
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "gr.h"
+#include "grm/dom_render/graphics_tree/Element.hxx"
+#include "grm/dom_render/context.hxx"
+
+class ManageDrawableCache
+{
+  /*!
+   * ManageDrawableCache keeps the captured GR output of drawables between renders. The output of a drawable is
+   * replayed instead of drawn again as long as the drawable, its parent, the transformations of its ancestors and the
+   * context data referenced by them are unchanged and the drawable starts from the same GR state as before.
+   */
+
+public:
+  ~ManageDrawableCache();
+  bool replay(const std::shared_ptr<GRM::Element> &element, const std::shared_ptr<GRM::Context> &context);
+  void beginCapture(const std::shared_ptr<GRM::Element> &element, const std::shared_ptr<GRM::Context> &context);
+  void endCapture(const std::shared_ptr<GRM::Element> &element, const std::shared_ptr<GRM::Context> &context);
+  void discardDetached();
+  void clear();
+
+private:
+  struct Entry
+  {
+    std::weak_ptr<GRM::Element> element;
+    gr_capture_t *capture = nullptr;
+    unsigned long revision = 0;
+    const GRM::Element *parent = nullptr;
+    unsigned long parent_revision = 0;
+    std::vector<GRM::Value> transformations;
+    const GRM::Context *context = nullptr;
+    std::vector<std::pair<std::string, unsigned long>> context_keys;
+  };
+
+  static std::vector<GRM::Value> ancestorTransformations(const std::shared_ptr<GRM::Element> &element);
+  static bool isValid(const Entry &entry, const std::shared_ptr<GRM::Element> &element,
+                      const std::shared_ptr<GRM::Context> &context);
+
+  std::unordered_map<const GRM::Element *, Entry> entries;
+  gr_capture_t *active_capture = nullptr;
+};
+
+#endif // GR_MANAGEDRAWABLECACHE_HXX
@@ -1,7 +1,10 @@
 #ifndef GR_MANAGEGRCONTEXTIDS_HXX
 #define GR_MANAGEGRCONTEXTIDS_HXX
 
+#include <map>
+#include <memory>
 #include <queue>
+#include <unordered_map>
 
 class ManageGRContextIds
 {
@@ -10,10 +13,23 @@ public:
   int getUnusedGRContextId();
   void markIdAsUnused(int id);
   void markAllIdsAsUnused();
+  int saveSharedGRContext(const std::shared_ptr<const void> &owner, int custom_color);
 
 private:
+  struct SharedContext
+  {
+    int id;
+    int custom_color;
+  };
+
   std::queue<int> available_gr_context_ids = {};
   int no_currently_allocated_gr_contexts = 0;
+  /*
+   * Owners are compared by their control block and not by their address, so an owner which is destroyed and replaced
+   * by a new object at the same address before the ids are marked as unused does not hand its context on
+   */
+  std::map<std::weak_ptr<const void>, SharedContext, std::owner_less<>> owner_to_context;
+  std::unordered_multimap<unsigned int, SharedContext> hash_to_context;
 };
 
 #endif // GR_MANAGEGRCONTEXTIDS_HXX
@@ -5,6 +5,7 @@
 #include <map>
 #include <vector>
 #include <iostream>
+#include <memory>
 #include <string>
 #include <type_traits>
 #include <variant>
@@ -16,6 +17,60 @@
 namespace GRM
 {
 
+class EXPORT DoubleBuffer
+{
+  /*!
+   * DoubleBuffer is a read-only array of doubles with shared ownership. It is used to store data in a GRM::Context
+   * without copying it, for example an array which is owned by a `grm_args_t` container. The data is released by the
+   * deleter of the underlying `std::shared_ptr` as soon as the last buffer which references it is destroyed.
+   */
+
+public:
+  DoubleBuffer() = default;
+  DoubleBuffer(std::shared_ptr<const double[]> data, std::size_t size);
+  explicit DoubleBuffer(std::vector<double> vec);
+
+  const double *data() const { return data_.get(); }
+  std::size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+  const double *begin() const { return data_.get(); }
+  const double *end() const { return data_.get() + size_; }
+  const double &operator[](std::size_t i) const { return data_[i]; }
+
+  std::vector<double> toVector() const;
+
+private:
+  std::shared_ptr<const double[]> data_;
+  std::size_t size_ = 0;
+};
+
+class EXPORT DoubleView
+{
+  /*!
+   * DoubleView is a read-only view of double data which does not own it, for example of a GRM::DoubleBuffer or of a
+   * `std::vector<double>` stored in a GRM::Context. Like the references returned by `GRM::get`, a view which is
+   * returned by `GRM::get_view` is only valid until the data of its context key is replaced, modified or deleted.
+   */
+
+public:
+  DoubleView() = default;
+  DoubleView(const double *data, std::size_t size) : data_(data), size_(size) {}
+  DoubleView(const DoubleBuffer &buffer) : data_(buffer.data()), size_(buffer.size()) {}
+  DoubleView(const std::vector<double> &vec) : data_(vec.data()), size_(vec.size()) {}
+
+  const double *data() const { return data_; }
+  std::size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+  const double *begin() const { return data_; }
+  const double *end() const { return data_ + size_; }
+  const double &operator[](std::size_t i) const { return data_[i]; }
+
+  std::vector<double> toVector() const { return std::vector<double>(begin(), end()); }
+
+private:
+  const double *data_ = nullptr;
+  std::size_t size_ = 0;
+};
 
 class EXPORT Context
 {
@@ -30,6 +85,8 @@ class EXPORT Context
    * To get data from that Context::Inner object the function `get` or `get_if` should be used
    * >>> GRM::get<...>(c["x"]);
    *
+   * Double data can also be stored as a GRM::DoubleBuffer which is shared instead of copied. `GRM::get_view` reads it
+   * without copying, `GRM::get<std::vector<double>>` converts it into a vector since it hands out a modifiable one.
    */
 
 public:
@@ -58,6 +115,7 @@ public:
     Inner &operator=(std::vector<int> vec);
     Inner &operator=(std::vector<double> vec);
     Inner &operator=(std::vector<std::string> vec);
+    Inner &operator=(DoubleBuffer buffer);
 
     explicit operator std::vector<int> &();
     explicit operator const std::vector<int> &() const;
@@ -77,6 +135,9 @@ public:
     explicit operator std::vector<std::string> *();
     explicit operator const std::vector<std::string> *() const;
 
+    explicit operator DoubleBuffer() const;
+    explicit operator DoubleView() const;
+
     void delete_key(const std::string &);
     void use_context_key(const std::string &key, const std::string &old_key = "");
     void decrement_key(const std::string &);
@@ -87,10 +148,21 @@ public:
   Inner operator[](const std::string &str);
   const Inner operator[](const std::string &str) const;
 
+  using IntLoader = std::function<std::vector<int>()>;
+  using DoubleLoader = std::function<std::vector<double>()>;
+  using StringLoader = std::function<std::vector<std::string>()>;
+
+  void setLazy(const std::string &key, IntLoader loader);
+  void setLazy(const std::string &key, DoubleLoader loader);
+  void setLazy(const std::string &key, StringLoader loader);
+
+  unsigned long revision(const std::string &key) const;
+
   /*!
    * \brief A forward iterator for the Context class.
    *
-   * This iterator can be used to iterate over all key/value pairs in the context in lexicographical order.
+   * This iterator can be used to iterate over all key/value pairs in the context in lexicographical order. Shared
+   * double data is visited as GRM::DoubleBuffer, it is not converted into a vector.
    */
   class Iterator
   {
@@ -99,10 +171,12 @@ public:
     using difference_type = std::ptrdiff_t;
     using value_type = std::variant<std::reference_wrapper<std::pair<const std::string, std::vector<int>>>,
                                     std::reference_wrapper<std::pair<const std::string, std::vector<double>>>,
-                                    std::reference_wrapper<std::pair<const std::string, std::vector<std::string>>>>;
+                                    std::reference_wrapper<std::pair<const std::string, std::vector<std::string>>>,
+                                    std::reference_wrapper<std::pair<const std::string, DoubleBuffer>>>;
     using pointer = std::variant<std::pair<const std::string, std::vector<int>> *,
                                  std::pair<const std::string, std::vector<double>> *,
-                                 std::pair<const std::string, std::vector<std::string>> *>;
+                                 std::pair<const std::string, std::vector<std::string>> *,
+                                 std::pair<const std::string, DoubleBuffer> *>;
     using reference = value_type;
 
     Iterator(Context &context, bool is_end_iterator = false);
@@ -118,19 +192,20 @@ public:
     friend bool operator!=(const Iterator &a, const Iterator &b);
 
   private:
-    std::variant<std::reference_wrapper<std::map<std::string, std::vector<double>>::iterator>,
-                 std::reference_wrapper<std::map<std::string, std::vector<int>>::iterator>,
-                 std::reference_wrapper<std::map<std::string, std::vector<std::string>>::iterator>>
-    next_iterator();
+    using TableIterator =
+        std::variant<std::reference_wrapper<std::map<std::string, std::vector<double>>::iterator>,
+                     std::reference_wrapper<std::map<std::string, std::vector<int>>::iterator>,
+                     std::reference_wrapper<std::map<std::string, std::vector<std::string>>::iterator>,
+                     std::reference_wrapper<std::map<std::string, DoubleBuffer>::iterator>>;
+
+    TableIterator next_iterator();
 
     Context &context_;
     std::map<std::string, std::vector<double>>::iterator table_double_it_;
     std::map<std::string, std::vector<int>>::iterator table_int_it_;
     std::map<std::string, std::vector<std::string>>::iterator table_string_it_;
-    std::variant<std::reference_wrapper<std::map<std::string, std::vector<double>>::iterator>,
-                 std::reference_wrapper<std::map<std::string, std::vector<int>>::iterator>,
-                 std::reference_wrapper<std::map<std::string, std::vector<std::string>>::iterator>>
-        current_it_;
+    std::map<std::string, DoubleBuffer>::iterator table_double_buffer_it_;
+    TableIterator current_it_;
   };
 
   Iterator begin();
@@ -138,10 +213,18 @@ public:
 
 private:
   friend class Inner;
+  void loadLazy(const std::string &key);
+  void loadAllLazy();
+  void convertBufferToVector(const std::string &key);
+  void touch(const std::string &key);
   std::map<std::string, std::vector<double>> tableDouble;
   std::map<std::string, std::vector<int>> tableInt;
   std::map<std::string, std::vector<std::string>> tableString;
+  std::map<std::string, DoubleBuffer> tableDoubleBuffer;
+  std::map<std::string, std::variant<IntLoader, DoubleLoader, StringLoader>> tableLazy;
   std::map<std::string, int> referenceNumberOfKeys;
+  std::map<std::string, unsigned long> keyRevisions;
+  unsigned long allKeysRevision = 0;
 };
 
 bool operator==(const Context::Iterator &a, const Context::Iterator &b);
@@ -195,6 +278,32 @@ template <class T> static const T &get(const Context::Inner &data)
   return static_cast<const T &>(data);
 }
 
+inline DoubleBuffer get_buffer(const Context::Inner &data)
+{
+  /*!
+   * The GRM::get_buffer function is used to get double data from a GRM::Context::Inner object with shared ownership,
+   * for example to store it under another key. Data that was stored as a GRM::DoubleBuffer is shared without copying
+   * it, data that was stored as a `std::vector<double>` is copied into a new buffer.
+   *
+   * \param[in] data const lvalue GRM::Context::Inner
+   * \returns GRM::DoubleBuffer owning a reference to the stored data or a copy of it
+   */
+  return static_cast<DoubleBuffer>(data);
+}
+
+inline DoubleView get_view(const Context::Inner &data)
+{
+  /*!
+   * The GRM::get_view function is used to read double data from a GRM::Context::Inner object without copying it. In
+   * contrast to `GRM::get<std::vector<double>>` it does not convert data that was stored as a GRM::DoubleBuffer into a
+   * vector. The view does not own the data, it is only valid until the data of the key is replaced or modified.
+   *
+   * \param[in] data const lvalue GRM::Context::Inner
+   * \returns GRM::DoubleView of the stored data
+   */
+  return static_cast<DoubleView>(data);
+}
+
 template <class T> static T *get_if(Context::Inner &&data)
 {
   /*!
@@ -0,0 +1,417 @@
+#ifndef GRM_GRAPHICS_TREE_INTERFACE_ATTR_HXX
+#define GRM_GRAPHICS_TREE_INTERFACE_ATTR_HXX
+
+#include <cstdint>
+#include <string>
+#include <grm/util.h>
+
+/*
+ * All attributes of `schema.xsd` and `private_schema.xsd` except for the numbered `colorrep.*` attributes, plus the
+ * attributes the renderer processes without them being part of the schema
+ */
+#define GRM_SCHEMA_ATTRIBUTES(X)        \
+  X(_axis_id)                           \
+  X(_bbox_id)                           \
+  X(_bbox_x_max)                        \
+  X(_bbox_x_min)                        \
+  X(_bbox_y_max)                        \
+  X(_bbox_y_min)                        \
+  X(_c_lim_max)                         \
+  X(_c_lim_min)                         \
+  X(_char_height_set_by_user)           \
+  X(_child_id)                          \
+  X(_default_diag_factor)               \
+  X(_delete_children)                   \
+  X(_hexbin_context_address)            \
+  X(_id)                                \
+  X(_legend_elems)                      \
+  X(_max_char_height_set_by_user)       \
+  X(_modified)                          \
+  X(_offset_set_by_user)                \
+  X(_original_adjust_x_lim)             \
+  X(_original_adjust_y_lim)             \
+  X(_original_x_lim)                    \
+  X(_original_x_max)                    \
+  X(_original_x_min)                    \
+  X(_original_y_lim)                    \
+  X(_original_y_max)                    \
+  X(_original_y_min)                    \
+  X(_overwrite_kind_dependent_defaults) \
+  X(_previous_pixel_height)             \
+  X(_previous_pixel_width)              \
+  X(_scale_factor)                      \
+  X(_space_3d_phi_org)                  \
+  X(_space_3d_theta_org)                \
+  X(_start_aspect_ratio)                \
+  X(_start_h)                           \
+  X(_start_w)                           \
+  X(_tick_size_set_by_user)             \
+  X(_update_limits)                     \
+  X(_update_required)                   \
+  X(_viewport_x_max_org)                \
+  X(_viewport_x_min_org)                \
+  X(_viewport_y_max_org)                \
+  X(_viewport_y_min_org)                \
+  X(_volume_context_address)            \
+  X(_width_set_by_user)                 \
+  X(_window_old_x_max)                  \
+  X(_window_old_x_min)                  \
+  X(_window_old_y_max)                  \
+  X(_window_old_y_min)                  \
+  X(_x_lim_max)                         \
+  X(_x_lim_min)                         \
+  X(_x_max_shift)                       \
+  X(_x_min_shift)                       \
+  X(_x_org)                             \
+  X(_x_range_max_org)                   \
+  X(_x_range_min_org)                   \
+  X(_y_lim_max)                         \
+  X(_y_lim_min)                         \
+  X(_y_max_shift)                       \
+  X(_y_min_shift)                       \
+  X(_y_org)                             \
+  X(_y_range_max_org)                   \
+  X(_y_range_min_org)                   \
+  X(_z_lim_max)                         \
+  X(_z_lim_min)                         \
+  X(_z_org)                             \
+  X(_z_range_max_org)                   \
+  X(_z_range_min_org)                   \
+  X(_zoomed)                            \
+  X(absolute_downwards)                 \
+  X(absolute_downwards_flt)             \
+  X(absolute_height)                    \
+  X(absolute_height_pxl)                \
+  X(absolute_upwards)                   \
+  X(absolute_upwards_flt)               \
+  X(absolute_width)                     \
+  X(absolute_width_pxl)                 \
+  X(accelerate)                         \
+  X(active)                             \
+  X(adjust_x_lim)                       \
+  X(adjust_y_lim)                       \
+  X(adjust_z_lim)                       \
+  X(algorithm)                          \
+  X(alpha)                              \
+  X(ambient)                            \
+  X(angle_ticks)                        \
+  X(aspect_ratio)                       \
+  X(axis_type)                          \
+  X(background_color)                   \
+  X(bar_width)                          \
+  X(bin_counts)                         \
+  X(bin_edges)                          \
+  X(bin_width)                          \
+  X(bin_widths)                         \
+  X(bins)                               \
+  X(border_color_ind)                   \
+  X(c)                                  \
+  X(c_lim_max)                          \
+  X(c_lim_min)                          \
+  X(c_range_max)                        \
+  X(c_range_min)                        \
+  X(cap_x_max)                          \
+  X(cap_x_min)                          \
+  X(char_expan)                         \
+  X(char_height)                        \
+  X(char_space)                         \
+  X(char_up_x)                          \
+  X(char_up_y)                          \
+  X(class_nr)                           \
+  X(classes)                            \
+  X(clear_ws)                           \
+  X(clip_transformation)                \
+  X(color_ind)                          \
+  X(color_ind_values)                   \
+  X(color_rgb_values)                   \
+  X(colormap)                           \
+  X(count)                              \
+  X(d_max)                              \
+  X(d_min)                              \
+  X(data)                               \
+  X(diag_factor)                        \
+  X(diffuse)                            \
+  X(disable_x_trans)                    \
+  X(disable_y_trans)                    \
+  X(downwards_cap_color)                \
+  X(draw_edges)                         \
+  X(draw_grid)                          \
+  X(e_downwards)                        \
+  X(e_upwards)                          \
+  X(edge_width)                         \
+  X(end_angle)                          \
+  X(error_bar_color)                    \
+  X(error_bar_x)                        \
+  X(error_bar_y_max)                    \
+  X(error_bar_y_min)                    \
+  X(face_alpha)                         \
+  X(fig_size_x)                         \
+  X(fig_size_y)                         \
+  X(figure_id)                          \
+  X(fill_color_ind)                     \
+  X(fill_color_rgb)                     \
+  X(fill_int_style)                     \
+  X(fill_style)                         \
+  X(fit_parents_height)                 \
+  X(fit_parents_width)                  \
+  X(font)                               \
+  X(font_precision)                     \
+  X(grplot)                             \
+  X(height)                             \
+  X(hide)                               \
+  X(indices)                            \
+  X(int_lim_high)                       \
+  X(int_lim_low)                        \
+  X(int_limits_high)                    \
+  X(int_limits_low)                     \
+  X(is_major)                           \
+  X(is_mirrored)                        \
+  X(isovalue)                           \
+  X(keep_aspect_ratio)                  \
+  X(keep_window)                        \
+  X(kind)                               \
+  X(label_pos)                          \
+  X(labels)                             \
+  X(levels)                             \
+  X(line_color_ind)                     \
+  X(line_color_rgb)                     \
+  X(line_spec)                          \
+  X(line_type)                          \
+  X(line_width)                         \
+  X(location)                           \
+  X(major_count)                        \
+  X(major_h)                            \
+  X(marginal_heatmap_kind)              \
+  X(marginal_heatmap_side_plot)         \
+  X(marker_color_ind)                   \
+  X(marker_color_indices)               \
+  X(marker_size)                        \
+  X(marker_sizes)                       \
+  X(marker_type)                        \
+  X(max_char_height)                    \
+  X(max_value)                          \
+  X(max_y_length)                       \
+  X(min_value)                          \
+  X(mirrored_axis)                      \
+  X(model)                              \
+  X(movable)                            \
+  X(name)                               \
+  X(norm)                               \
+  X(normalization)                      \
+  X(num_bins)                           \
+  X(num_col)                            \
+  X(num_row)                            \
+  X(num_tick_labels)                    \
+  X(num_ticks)                          \
+  X(offset)                             \
+  X(only_quadratic_aspect_ratio)        \
+  X(org)                                \
+  X(orientation)                        \
+  X(phi)                                \
+  X(phi_dim)                            \
+  X(phi_flip)                           \
+  X(phi_lim_max)                        \
+  X(phi_lim_min)                        \
+  X(phi_max)                            \
+  X(phi_min)                            \
+  X(plot_group)                         \
+  X(plot_id)                            \
+  X(plot_type)                          \
+  X(plot_x_max)                         \
+  X(plot_x_min)                         \
+  X(plot_y_max)                         \
+  X(plot_y_min)                         \
+  X(pos)                                \
+  X(projection_type)                    \
+  X(px)                                 \
+  X(py)                                 \
+  X(pz)                                 \
+  X(r)                                  \
+  X(r_dim)                              \
+  X(r_lim_max)                          \
+  X(r_lim_min)                          \
+  X(r_max)                              \
+  X(r_min)                              \
+  X(relative_downwards)                 \
+  X(relative_downwards_flt)             \
+  X(relative_height)                    \
+  X(relative_upwards)                   \
+  X(relative_upwards_flt)               \
+  X(relative_width)                     \
+  X(resample_method)                    \
+  X(reset_rotation)                     \
+  X(rings)                              \
+  X(scale)                              \
+  X(scientific_format)                  \
+  X(select_specific_xform)              \
+  X(series_index)                       \
+  X(set_text_color_for_background)      \
+  X(size_x)                             \
+  X(size_x_type)                        \
+  X(size_x_unit)                        \
+  X(size_y)                             \
+  X(size_y_type)                        \
+  X(size_y_unit)                        \
+  X(space)                              \
+  X(space_3d_camera_distance)           \
+  X(space_3d_fov)                       \
+  X(space_3d_phi)                       \
+  X(space_3d_theta)                     \
+  X(space_rotation)                     \
+  X(space_tilt)                         \
+  X(space_z_max)                        \
+  X(space_z_min)                        \
+  X(specs)                              \
+  X(specular)                           \
+  X(specular_power)                     \
+  X(stairs)                             \
+  X(start_angle)                        \
+  X(start_col)                          \
+  X(start_row)                          \
+  X(step_where)                         \
+  X(stop_col)                           \
+  X(stop_row)                           \
+  X(style)                              \
+  X(text)                               \
+  X(text_align_horizontal)              \
+  X(text_align_vertical)                \
+  X(text_color_ind)                     \
+  X(text_content)                       \
+  X(text_encoding)                      \
+  X(text_is_title)                      \
+  X(theta)                              \
+  X(tick)                               \
+  X(tick_label)                         \
+  X(tick_orientation)                   \
+  X(tick_size)                          \
+  X(total)                              \
+  X(transformation)                     \
+  X(transparency)                       \
+  X(u)                                  \
+  X(update_ws)                          \
+  X(upwards_cap_color)                  \
+  X(v)                                  \
+  X(value)                              \
+  X(viewport)                           \
+  X(viewport_x_max)                     \
+  X(viewport_x_min)                     \
+  X(viewport_y_max)                     \
+  X(viewport_y_min)                     \
+  X(weights)                            \
+  X(width)                              \
+  X(window_x_max)                       \
+  X(window_x_min)                       \
+  X(window_y_max)                       \
+  X(window_y_min)                       \
+  X(window_z_max)                       \
+  X(window_z_min)                       \
+  X(ws_viewport_x_max)                  \
+  X(ws_viewport_x_min)                  \
+  X(ws_viewport_y_max)                  \
+  X(ws_viewport_y_min)                  \
+  X(ws_window_x_max)                    \
+  X(ws_window_x_min)                    \
+  X(ws_window_y_max)                    \
+  X(ws_window_y_min)                    \
+  X(x)                                  \
+  X(x1)                                 \
+  X(x2)                                 \
+  X(x_bins)                             \
+  X(x_colormap)                         \
+  X(x_dim)                              \
+  X(x_flip)                             \
+  X(x_grid)                             \
+  X(x_ind)                              \
+  X(x_label)                            \
+  X(x_label_3d)                         \
+  X(x_lim_max)                          \
+  X(x_lim_min)                          \
+  X(x_log)                              \
+  X(x_major)                            \
+  X(x_max)                              \
+  X(x_min)                              \
+  X(x_org)                              \
+  X(x_org_pos)                          \
+  X(x_range_max)                        \
+  X(x_range_min)                        \
+  X(x_scale_ndc)                        \
+  X(x_scale_wc)                         \
+  X(x_shift_ndc)                        \
+  X(x_shift_wc)                         \
+  X(x_tick)                             \
+  X(x_tick_labels)                      \
+  X(xi)                                 \
+  X(y)                                  \
+  X(y1)                                 \
+  X(y2)                                 \
+  X(y_bins)                             \
+  X(y_colormap)                         \
+  X(y_dim)                              \
+  X(y_flip)                             \
+  X(y_grid)                             \
+  X(y_ind)                              \
+  X(y_label)                            \
+  X(y_label_3d)                         \
+  X(y_labels)                           \
+  X(y_lim_max)                          \
+  X(y_lim_min)                          \
+  X(y_line)                             \
+  X(y_log)                              \
+  X(y_major)                            \
+  X(y_max)                              \
+  X(y_min)                              \
+  X(y_org)                              \
+  X(y_org_pos)                          \
+  X(y_range_max)                        \
+  X(y_range_min)                        \
+  X(y_scale_ndc)                        \
+  X(y_scale_wc)                         \
+  X(y_shift_ndc)                        \
+  X(y_shift_wc)                         \
+  X(y_tick)                             \
+  X(y_tick_labels)                      \
+  X(z)                                  \
+  X(z_dims)                             \
+  X(z_flip)                             \
+  X(z_grid)                             \
+  X(z_index)                            \
+  X(z_label)                            \
+  X(z_label_3d)                         \
+  X(z_lim_max)                          \
+  X(z_lim_min)                          \
+  X(z_log)                              \
+  X(z_major)                            \
+  X(z_max)                              \
+  X(z_min)                              \
+  X(z_org)                              \
+  X(z_org_pos)                          \
+  X(z_range_max)                        \
+  X(z_range_min)                        \
+  X(z_tick)
+
+namespace GRM
+{
+/*
+ * Attribute names are interned into small integer atoms, so elements can store and look up their attributes
+ * without hashing or comparing strings. Every attribute of the graphics tree schema has a compile-time atom
+ * (e.g. `GRM::Attr::viewport_x_min`), all other attribute names get a new atom on first use. Like the graphics
+ * tree itself, the atom table is not thread-safe.
+ */
+enum class Attr : std::uint32_t
+{
+#define GRM_ATTR_ENUMERATOR(name) name,
+  GRM_SCHEMA_ATTRIBUTES(GRM_ATTR_ENUMERATOR)
+#undef GRM_ATTR_ENUMERATOR
+};
+
+/* Return the atom of `name`, creating a new one if the name has not been used before */
+EXPORT Attr internAttribute(const std::string &name);
+
+/* Look up the atom of `name` without creating it; returns `false` if no atom exists for the name */
+EXPORT bool findAttribute(const std::string &name, Attr *atom);
+
+/* Return the name of an atom; the reference stays valid for the lifetime of the program */
+EXPORT const std::string &attributeName(Attr atom);
+} // namespace GRM
+
+#endif
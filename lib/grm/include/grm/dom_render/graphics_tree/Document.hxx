@@ -1,9 +1,14 @@
 #ifndef GRM_GRAPHICS_TREE_INTERFACE_DOCUMENT_HXX
 #define GRM_GRAPHICS_TREE_INTERFACE_DOCUMENT_HXX
 
+#include <map>
 #include <memory>
 #include <string>
+#include <tuple>
+#include <unordered_map>
+#include <unordered_set>
 
+#include <grm/dom_render/graphics_tree/Attr.hxx>
 #include <grm/dom_render/graphics_tree/Node.hxx>
 #include <grm/dom_render/graphics_tree/Value.hxx>
 #include <grm/util.h>
@@ -87,10 +92,45 @@ public:
   // virtual functions
   std::string nodeName() const override;
 
+  /*
+   * `upt` is called with the stringified old value of every changed attribute, followed by `ren`. If `chk` is given,
+   * `upt` is only called (and the old value only stringified) for attributes `chk` returns `true` for.
+   */
   void setUpdateFct(void (*ren)(),
-                    void (*upt)(const std::shared_ptr<GRM::Element> &, const std::string &, const std::string &));
+                    void (*upt)(const std::shared_ptr<GRM::Element> &, const std::string &, const std::string &),
+                    bool (*chk)(const std::string &) = nullptr);
   void getUpdateFct(void (**ren)(),
-                    void (**upt)(const std::shared_ptr<GRM::Element> &, const std::string &, const std::string &));
+                    void (**upt)(const std::shared_ptr<GRM::Element> &, const std::string &, const std::string &),
+                    bool (**chk)(const std::string &) = nullptr);
+
+  /*
+   * Attribute changes between `beginUpdate` and the matching `endUpdate` call are queued instead of being passed to
+   * the update function immediately. `endUpdate` coalesces them per element and attribute, skips attributes which
+   * got their old value back and calls the render function only once. Transactions can be nested; only the
+   * outermost `endUpdate` commits.
+   */
+  void beginUpdate();
+  void endUpdate();
+
+  /*
+   * RAII helper which wraps its lifetime in `beginUpdate` / `endUpdate`. Call `commit` to end the transaction early
+   * and to see exceptions thrown by the update or render function; the destructor only logs them. Either way, updates
+   * which could not be passed on stay queued for the next transaction.
+   */
+  class EXPORT UpdateTransaction
+  {
+  public:
+    explicit UpdateTransaction(std::shared_ptr<Document> document);
+    ~UpdateTransaction();
+    UpdateTransaction(const UpdateTransaction &) = delete;
+    UpdateTransaction &operator=(const UpdateTransaction &) = delete;
+
+    void commit();
+
+  private:
+    std::shared_ptr<Document> m_document;
+    bool m_committed = false;
+  };
 
   void setContextFct(void (*del)(const std::shared_ptr<GRM::Element> &),
                      void (*upt)(const std::shared_ptr<GRM::Element> &, const std::string &, const GRM::Value &));
@@ -101,9 +141,72 @@ protected:
   Document();
 
 private:
+  friend class Node;
+  friend class Element;
+
+  /*
+   * Index of all elements owned by this document by their local name and by the values of the attributes
+   * `isIndexedAttribute` accepts. It is maintained by the element constructor and destructor, on adoption and on
+   * every change of an indexed attribute, so selector queries with a fixed tag name or a value for one of these
+   * attributes only have to look at the matching elements. The index is bound to the document instance and therefore
+   * never copied.
+   */
+  class ElementIndex
+  {
+  public:
+    ElementIndex() = default;
+    ElementIndex(const ElementIndex &) {}
+    ElementIndex &operator=(const ElementIndex &) { return *this; }
+
+    std::unordered_map<std::string, std::unordered_set<Element *>> elements;
+    std::map<std::pair<Attr, std::string>, std::unordered_set<Element *>> attribute_values;
+  };
+
+  /* Attribute changes queued by an open update transaction; like the element index, they are never copied */
+  class PendingUpdates
+  {
+  public:
+    struct Update
+    {
+      std::shared_ptr<Element> element;
+      std::string attribute;
+      Value old_value;
+    };
+
+    PendingUpdates() = default;
+    PendingUpdates(const PendingUpdates &) {}
+    PendingUpdates &operator=(const PendingUpdates &) { return *this; }
+
+    int depth = 0;
+    bool render_pending = false;
+    std::vector<Update> updates;
+    std::map<std::tuple<const Element *, std::string>, std::size_t> update_index;
+  };
+
   std::shared_ptr<Node> cloneIndividualNode() override;
 
   std::shared_ptr<Document> shared();
+
+  void registerElement(Element *element);
+
+  void unregisterElement(Element *element);
+
+  const std::unordered_set<Element *> *elementsByLocalName(const std::string &local_name) const;
+
+  /* Attributes the selector queries of the renderer look up by value, like `[name=...]` or `[_child_id=...]` */
+  static bool isIndexedAttribute(Attr attribute);
+
+  void indexAttributeValue(Element *element, Attr attribute, const Value &value);
+
+  void unindexAttributeValue(Element *element, Attr attribute, const Value &value);
+
+  const std::unordered_set<Element *> *elementsByAttributeValue(Attr attribute, const std::string &value) const;
+
+  void attributeChanged(const std::shared_ptr<Element> &element, const std::string &attribute,
+                        const Value &old_value);
+
+  ElementIndex m_element_index;
+  PendingUpdates m_pending_updates;
 };
 
 EXPORT std::shared_ptr<Document> createDocument();
@@ -4,6 +4,7 @@
 #include <unordered_map>
 #include <unordered_set>
 
+#include <grm/dom_render/graphics_tree/Attr.hxx>
 #include <grm/dom_render/graphics_tree/Node.hxx>
 #include <grm/dom_render/graphics_tree/Value.hxx>
 #include <grm/util.h>
@@ -44,6 +45,28 @@ public:
 
   bool hasAttribute(const std::string &qualifiedName) const;
 
+  // atom based variants of the attribute interface, see `GRM::Attr`
+
+  Value getAttribute(Attr attribute) const;
+
+  void setAttribute(Attr attribute, const Value &value);
+
+  void setAttribute(Attr attribute, const std::string &value);
+
+  void setAttribute(Attr attribute, const double &value);
+
+  void setAttribute(Attr attribute, const int &value);
+
+  void removeAttribute(Attr attribute);
+
+  bool hasAttribute(Attr attribute) const;
+
+  // atoms of all attributes in the order they were first set
+  std::vector<Attr> getAttributeAtoms() const;
+
+  // changes whenever an attribute is set to a different value or removed; revisions are unique across all elements
+  unsigned long revision() const;
+
   std::vector<std::shared_ptr<Element>> getElementsByTagName(const std::string &qualifiedName);
 
   std::vector<std::shared_ptr<const Element>> getElementsByTagName(const std::string &qualifiedName) const;
@@ -110,6 +133,8 @@ public:
   std::shared_ptr<Element> nextElementSibling();
   std::shared_ptr<const Element> nextElementSibling() const;
 
+  ~Element() override;
+
   // virtual functions
   std::string nodeName() const override;
 
@@ -128,8 +153,14 @@ private:
 
   std::shared_ptr<const Element> shared() const;
 
+  const Value *findAttributeValue(Attr attribute) const;
+
   std::string m_local_name;
-  std::unordered_map<std::string, Value> m_attributes;
+  /* attributes are stored as parallel arrays of atoms and values; elements only have a few dozen attributes at most,
+   * so a linear scan over the atoms beats hashing the attribute name */
+  std::vector<Attr> m_attribute_atoms;
+  std::vector<Value> m_attribute_values;
+  unsigned long m_revision;
 
   std::shared_ptr<Node> cloneIndividualNode() override;
 };
@@ -156,6 +156,22 @@ private:
   std::shared_ptr<const Document> nodeDocument() const;
   bool matchSelector(const std::shared_ptr<GRM::Selector> &selector,
                      std::map<std::tuple<const GRM::Element *, const GRM::Selector *>, bool> &match_map) const;
+  bool querySelectorsIndexed(const std::shared_ptr<GRM::Selector> &selector, bool first_only,
+                             std::vector<GRM::Element *> &found_elements,
+                             std::map<std::tuple<const GRM::Element *, const GRM::Selector *>, bool> &match_map) const;
+  void querySelectorsAll_traverse(const std::shared_ptr<GRM::Selector> &selector,
+                                  std::vector<std::shared_ptr<GRM::Element>> &found_elements,
+                                  std::map<std::tuple<const GRM::Element *, const GRM::Selector *>, bool> &match_map);
+  void
+  querySelectorsAll_traverse(const std::shared_ptr<GRM::Selector> &selector,
+                             std::vector<std::shared_ptr<const GRM::Element>> &found_elements,
+                             std::map<std::tuple<const GRM::Element *, const GRM::Selector *>, bool> &match_map) const;
+  std::shared_ptr<Element>
+  querySelectors_traverse(const std::shared_ptr<GRM::Selector> &selector,
+                          std::map<std::tuple<const GRM::Element *, const GRM::Selector *>, bool> &match_map);
+  std::shared_ptr<const Element>
+  querySelectors_traverse(const std::shared_ptr<GRM::Selector> &selector,
+                          std::map<std::tuple<const GRM::Element *, const GRM::Selector *>, bool> &match_map) const;
 
   Type m_type;
   std::weak_ptr<Document> m_owner_document;
@@ -2,6 +2,7 @@
 #define GRM_GRAPHICS_TREE_INTERFACE_VALUE_HXX
 
 #include <string>
+#include <variant>
 #include <grm/util.h>
 
 namespace GRM
@@ -48,10 +49,8 @@ public:
   bool operator!=(const Value &other) const;
 
 private:
-  Type m_type;
-  int m_int_value;
-  double m_double_value;
-  std::string m_string_value;
+  /* the alternatives are in the same order as `Type`, so `index()` is the type */
+  std::variant<std::monostate, int, double, std::string> m_value;
 };
 } // namespace GRM
 
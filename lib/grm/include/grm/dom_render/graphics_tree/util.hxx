@@ -6,6 +6,7 @@
 #include <memory>
 #include <map>
 #include <optional>
+#include <utility>
 #include <vector>
 #include <grm/util.h>
 
@@ -46,6 +47,16 @@ class EXPORT Selector
 public:
   bool matchElement(const GRM::Element &element,
                     std::map<std::tuple<const GRM::Element *, const GRM::Selector *>, bool> &match_map) const;
+  /*
+   * Local name every element matched by this selector must have, or `std::nullopt` if the selector can match
+   * elements of different names. Used to look up candidate elements in the local name index of a document.
+   */
+  virtual std::optional<std::string> requiredLocalName() const;
+  /*
+   * Attribute name and non-empty value every element matched by this selector must have, or `std::nullopt`. Used to
+   * look up candidate elements in the attribute value index of a document.
+   */
+  virtual std::optional<std::pair<std::string, std::string>> requiredAttributeValue() const;
 
 protected:
   virtual bool
@@ -171,6 +171,7 @@ private:
 
 EXPORT void updateFilter(const std::shared_ptr<GRM::Element> &element, const std::string &attr,
                          const std::string &value);
+EXPORT bool updateFilterNeeded(const std::string &attr);
 EXPORT void renderCaller();
 EXPORT void updateContextAttribute(const std::shared_ptr<GRM::Element> &element, const std::string &attr,
                                    const GRM::Value &old_value);
@@ -33,6 +33,7 @@ EXPORT void grm_finalize(void);
 EXPORT int grm_clear(void);
 EXPORT void grm_dump_graphics_tree(FILE *f);
 EXPORT char *grm_dump_graphics_tree_str(void);
+EXPORT int grm_dump_graphics_tree_binary(FILE *f);
 EXPORT unsigned int grm_max_plotid(void);
 EXPORT int grm_merge(const grm_args_t *args);
 EXPORT int grm_merge_extended(const grm_args_t *args, int hold, const char *identificator);
@@ -47,6 +48,7 @@ EXPORT int grm_switch(unsigned int id);
 #if !defined(NO_XERCES_C)
 EXPORT int grm_load_graphics_tree(FILE *file);
 #endif
+EXPORT int grm_load_graphics_tree_binary(FILE *file);
 EXPORT int grm_validate(void);
 
 #ifdef __cplusplus
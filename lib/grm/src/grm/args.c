@@ -34,6 +34,9 @@ static int argparse_static_variables_initialized = 0;
 static const char *const ARGS_VALID_FORMAT_SPECIFIERS = "niIdDcCsSaA";
 static const char *const ARGS_VALID_DATA_FORMAT_SPECIFIERS = "idcsa"; /* Each specifier is also valid in upper case */
 
+/* containers with more entries than this get a hash index for key lookups */
+#define ARGS_INDEX_MIN_COUNT 8
+
 
 /* ========================= functions ============================================================================== */
 
@@ -944,39 +947,7 @@ int args_check_format_compatibility(const arg_t *arg, const char *compatible_for
 
 void args_decrease_arg_reference_count(args_node_t *args_node)
 {
-  if (--(args_node->arg->priv->reference_count) == 0)
-    {
-      grm_args_value_iterator_t *value_it = grm_arg_value_iter(args_node->arg);
-      while (value_it->next(value_it) != NULL)
-        {
-          /* use a char pointer since chars have no memory alignment restrictions */
-          if (value_it->is_array)
-            {
-              if (argparse_format_to_delete_callback[(int)value_it->format] != NULL)
-                {
-                  char **current_value_ptr = *(char ***)value_it->value_ptr;
-                  while (*current_value_ptr != NULL)
-                    {
-                      argparse_format_to_delete_callback[(int)value_it->format](*current_value_ptr);
-                      /* cast to (char *) to allow pointer increment by bytes */
-                      current_value_ptr =
-                          (char **)((char *)current_value_ptr + argparse_format_to_size[(int)value_it->format]);
-                    }
-                }
-              free(*(char ***)value_it->value_ptr);
-            }
-          else if (argparse_format_to_delete_callback[(int)value_it->format] != NULL)
-            {
-              argparse_format_to_delete_callback[(int)value_it->format](*(char **)value_it->value_ptr);
-            }
-        }
-      args_value_iterator_delete(value_it);
-      free((char *)args_node->arg->key);
-      free((char *)args_node->arg->value_format);
-      free(args_node->arg->priv);
-      free(args_node->arg->value_ptr);
-      free(args_node->arg);
-    }
+  arg_decrease_reference_count(args_node->arg);
 }
 
 
@@ -1029,6 +1000,48 @@ grm_args_value_iterator_t *grm_arg_value_iter(const arg_t *arg)
   return args_value_iterator_new(arg);
 }
 
+void arg_increase_reference_count(arg_t *arg)
+{
+  ++(arg->priv->reference_count);
+}
+
+void arg_decrease_reference_count(arg_t *arg)
+{
+  if (--(arg->priv->reference_count) == 0)
+    {
+      grm_args_value_iterator_t *value_it = grm_arg_value_iter(arg);
+      while (value_it->next(value_it) != NULL)
+        {
+          /* use a char pointer since chars have no memory alignment restrictions */
+          if (value_it->is_array)
+            {
+              if (argparse_format_to_delete_callback[(int)value_it->format] != NULL)
+                {
+                  char **current_value_ptr = *(char ***)value_it->value_ptr;
+                  while (*current_value_ptr != NULL)
+                    {
+                      argparse_format_to_delete_callback[(int)value_it->format](*current_value_ptr);
+                      /* cast to (char *) to allow pointer increment by bytes */
+                      current_value_ptr =
+                          (char **)((char *)current_value_ptr + argparse_format_to_size[(int)value_it->format]);
+                    }
+                }
+              free(*(char ***)value_it->value_ptr);
+            }
+          else if (argparse_format_to_delete_callback[(int)value_it->format] != NULL)
+            {
+              argparse_format_to_delete_callback[(int)value_it->format](*(char **)value_it->value_ptr);
+            }
+        }
+      args_value_iterator_delete(value_it);
+      free((char *)arg->key);
+      free((char *)arg->value_format);
+      free(arg->priv);
+      free(arg->value_ptr);
+      free(arg);
+    }
+}
+
 err_t arg_increase_array(arg_t *arg, size_t increment)
 {
   size_t *current_size_ptr, new_size;
@@ -1292,11 +1305,67 @@ cleanup:
 
 /* ------------------------- argument container --------------------------------------------------------------------- */
 
+static int args_node_has_key(const args_node_t *args_node, const char *keyword, size_t key_hash)
+{
+  /* keys are often shared between containers (see `args_push_arg`), so compare the pointers first */
+  return args_node->arg->key == keyword ||
+         (args_node->key_hash == key_hash && strcmp(args_node->arg->key, keyword) == 0);
+}
+
+static void args_index_insert(grm_args_t *args, args_node_t *args_node)
+{
+  size_t i;
+
+  for (i = 0; i < args->index_capacity; ++i)
+    {
+      /* Quadratic probing that will visit every slot in the hash table if the capacity is a power of 2, see
+       * `datatype/template/set_int.h` */
+      size_t next_index = (args_node->key_hash + (i * i + i) / 2) & (args->index_capacity - 1);
+      if (args->index[next_index] == NULL)
+        {
+          args->index[next_index] = args_node;
+          return;
+        }
+    }
+}
+
+static void args_index_rebuild(grm_args_t *args)
+{
+  /* The index is rebuilt with a load factor of at most 1/2. Without an index (small containers or if no memory is
+   * available), keys are searched linearly. */
+  size_t capacity = 2 * ARGS_INDEX_MIN_COUNT;
+  args_node_t *current_node;
+
+  free(args->index);
+  args->index = NULL;
+  args->index_capacity = 0;
+  if (args->count <= ARGS_INDEX_MIN_COUNT)
+    {
+      return;
+    }
+  while (capacity < 2 * args->count)
+    {
+      capacity *= 2;
+    }
+  args->index = calloc(capacity, sizeof(args_node_t *));
+  if (args->index == NULL)
+    {
+      return;
+    }
+  args->index_capacity = capacity;
+  for (current_node = args->kwargs_head; current_node != NULL; current_node = current_node->next)
+    {
+      args_index_insert(args, current_node);
+    }
+}
+
 void args_init(grm_args_t *args)
 {
   args->kwargs_head = NULL;
   args->kwargs_tail = NULL;
   args->count = 0;
+  args->index = NULL;
+  args->index_capacity = 0;
 }
 
 void args_finalize(grm_args_t *args)
@@ -1309,7 +1378,6 @@ grm_args_t *args_flatcopy(const grm_args_t *copy_args)
   /* Clone the linked list but share the referenced values */
   grm_args_t *args = NULL;
   grm_args_iterator_t *it = NULL;
-  args_node_t *args_node;
   arg_t *copy_arg;
 
   args = grm_args_new();
@@ -1321,26 +1389,11 @@ grm_args_t *args_flatcopy(const grm_args_t *copy_args)
   it = grm_args_iter(copy_args);
   while ((copy_arg = it->next(it)) != NULL)
     {
-      ++(copy_arg->priv->reference_count);
-      args_node = malloc(sizeof(args_node_t));
-      if (args_node == NULL)
+      if (args_append_node(args, copy_arg) == NULL)
         {
-          debug_print_malloc_error();
           goto error_cleanup;
         }
-      args_node->arg = copy_arg;
-      args_node->next = NULL;
-
-      if (args->kwargs_head == NULL)
-        {
-          args->kwargs_head = args_node;
-        }
-      else
-        {
-          args->kwargs_tail->next = args_node;
-        }
-      args->kwargs_tail = args_node;
-      ++(args->count);
+      ++(copy_arg->priv->reference_count);
     }
   args_iterator_delete(it);
 
@@ -1375,7 +1428,6 @@ grm_args_t *args_copy_extended(const grm_args_t *copy_args, const char **keys_co
              **current_args_copy = NULL;
   grm_args_iterator_t *it = NULL;
   grm_args_value_iterator_t *value_it = NULL;
-  args_node_t *args_node;
   arg_t *copy_arg;
 
   args = grm_args_new();
@@ -1432,26 +1484,11 @@ grm_args_t *args_copy_extended(const grm_args_t *copy_args, const char **keys_co
         }
       else
         {
-          ++(copy_arg->priv->reference_count);
-          args_node = malloc(sizeof(args_node_t));
-          if (args_node == NULL)
+          if (args_append_node(args, copy_arg) == NULL)
             {
-              debug_print_malloc_error();
               goto error_cleanup;
             }
-          args_node->arg = copy_arg;
-          args_node->next = NULL;
-
-          if (args->kwargs_head == NULL)
-            {
-              args->kwargs_head = args_node;
-            }
-          else
-            {
-              args->kwargs_tail->next = args_node;
-            }
-          args->kwargs_tail = args_node;
-          ++(args->count);
+          ++(copy_arg->priv->reference_count);
         }
     }
   goto cleanup;
@@ -1506,31 +1543,13 @@ err_t args_push_common(grm_args_t *args, const char *key, const char *value_form
       args_decrease_arg_reference_count(args_node);
       args_node->arg = arg;
     }
-  else
+  else if (args_append_node(args, arg) == NULL)
     {
-      args_node = malloc(sizeof(args_node_t));
-      if (args_node == NULL)
-        {
-          debug_print_malloc_error();
-          free((char *)arg->key);
-          free((char *)arg->value_format);
-          free(arg->priv);
-          free(arg);
-          return ERROR_MALLOC;
-        }
-      args_node->arg = arg;
-      args_node->next = NULL;
-      if (args->kwargs_head == NULL)
-        {
-          args->kwargs_head = args_node;
-          args->kwargs_tail = args_node;
-        }
-      else
-        {
-          args->kwargs_tail->next = args_node;
-          args->kwargs_tail = args_node;
-        }
-      ++(args->count);
+      free((char *)arg->key);
+      free((char *)arg->value_format);
+      free(arg->priv);
+      free(arg);
+      return ERROR_MALLOC;
     }
 
   return ERROR_NONE;
@@ -1543,61 +1562,25 @@ err_t args_push_vl(grm_args_t *args, const char *key, const char *value_format,
 
 err_t args_push_arg(grm_args_t *args, arg_t *arg)
 {
-  args_node_t *args_node = NULL, *previous_node_by_keyword = NULL;
-  err_t error = ERROR_NONE;
-
-  ++(arg->priv->reference_count);
-  args_node = malloc(sizeof(args_node_t));
-  error_cleanup_and_set_error_if(args_node == NULL, ERROR_MALLOC);
-  args_node->arg = arg;
-  args_node->next = NULL;
+  args_node_t *args_node;
 
-  if (args->kwargs_head == NULL)
+  if ((args_node = args_find_node(args, arg->key)) != NULL)
     {
-      args->kwargs_head = args_node;
-      args->kwargs_tail = args_node;
-      ++(args->count);
+      /* increase the reference count first since `arg` could already be stored in this node */
+      ++(arg->priv->reference_count);
+      args_decrease_arg_reference_count(args_node);
+      args_node->arg = arg;
     }
-  else if (args_find_previous_node(args, arg->key, &previous_node_by_keyword))
+  else
     {
-      if (previous_node_by_keyword == NULL)
-        {
-          args_node->next = args->kwargs_head->next;
-          if (args->kwargs_head == args->kwargs_tail)
-            {
-              args->kwargs_tail = args_node;
-            }
-          args_decrease_arg_reference_count(args->kwargs_head);
-          free(args->kwargs_head);
-          args->kwargs_head = args_node;
-        }
-      else
+      if (args_append_node(args, arg) == NULL)
         {
-          args_node->next = previous_node_by_keyword->next->next;
-          args_decrease_arg_reference_count(previous_node_by_keyword->next);
-          free(previous_node_by_keyword->next);
-          previous_node_by_keyword->next = args_node;
-          if (args_node->next == NULL)
-            {
-              args->kwargs_tail = args_node;
-            }
+          return ERROR_MALLOC;
         }
-    }
-  else
-    {
-      args->kwargs_tail->next = args_node;
-      args->kwargs_tail = args_node;
-      ++(args->count);
+      ++(arg->priv->reference_count);
     }
 
   return ERROR_NONE;
-
-error_cleanup:
-  if (args_node != NULL)
-    {
-      free(args_node);
-    }
-  return error;
 }
 
 err_t args_update_many(grm_args_t *args, const grm_args_t *update_args)
@@ -1762,6 +1745,7 @@ void args_clear(grm_args_t *args, const char **exclude_keys)
     {
       args->kwargs_tail->next = NULL;
     }
+  args_index_rebuild(args);
 }
 
 err_t args_increase_array(grm_args_t *args, const char *key, size_t increment)
@@ -1824,12 +1808,65 @@ cleanup:
   return was_successful;
 }
 
+args_node_t *args_append_node(grm_args_t *args, arg_t *arg)
+{
+  /* Append a node for `arg` without checking if its key is already contained and without increasing the reference
+   * count of `arg` */
+  args_node_t *args_node;
+
+  args_node = malloc(sizeof(args_node_t));
+  if (args_node == NULL)
+    {
+      debug_print_malloc_error();
+      return NULL;
+    }
+  args_node->arg = arg;
+  args_node->next = NULL;
+  args_node->key_hash = (arg->key != NULL) ? djb2_hash(arg->key) : 0;
+  if (args->kwargs_head == NULL)
+    {
+      args->kwargs_head = args_node;
+    }
+  else
+    {
+      args->kwargs_tail->next = args_node;
+    }
+  args->kwargs_tail = args_node;
+  ++(args->count);
+
+  if (args->index != NULL && 2 * args->count <= args->index_capacity)
+    {
+      args_index_insert(args, args_node);
+    }
+  else if (args->count > ARGS_INDEX_MIN_COUNT)
+    {
+      args_index_rebuild(args);
+    }
+
+  return args_node;
+}
+
 args_node_t *args_find_node(const grm_args_t *args, const char *keyword)
 {
   args_node_t *current_node;
+  size_t key_hash, i;
+
+  if (args->index != NULL)
+    {
+      key_hash = djb2_hash(keyword);
+      for (i = 0; i < args->index_capacity; ++i)
+        {
+          current_node = args->index[(key_hash + (i * i + i) / 2) & (args->index_capacity - 1)];
+          if (current_node == NULL || args_node_has_key(current_node, keyword, key_hash))
+            {
+              return current_node;
+            }
+        }
+      return NULL;
+    }
 
   current_node = args->kwargs_head;
-  while (current_node != NULL && strcmp(current_node->arg->key, keyword) != 0)
+  while (current_node != NULL && current_node->arg->key != keyword && strcmp(current_node->arg->key, keyword) != 0)
     {
       current_node = current_node->next;
     }
@@ -2137,6 +2174,7 @@ void grm_args_remove(grm_args_t *args, const char *key)
             }
         }
       --(args->count);
+      args_index_rebuild(args);
     }
 }
 
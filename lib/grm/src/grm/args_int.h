@@ -60,6 +60,7 @@ struct _args_node_t
 {
   arg_t *arg;
   struct _args_node_t *next;
+  size_t key_hash;
 };
 
 struct _grm_args_t
@@ -67,6 +68,10 @@ struct _grm_args_t
   args_node_t *kwargs_head;
   args_node_t *kwargs_tail;
   unsigned int count;
+  /* open addressing hash table of the nodes for fast key lookups, only used for containers with many entries; the
+   * linked list above is kept to preserve the insertion order */
+  args_node_t **index;
+  size_t index_capacity;
 };
 
 /* ------------------------- argument iterator ---------------------------------------------------------------------- */
@@ -126,6 +131,8 @@ void *copy_value(char format, void *value_ptr);
 
 /* ------------------------- argument ------------------------------------------------------------------------------- */
 
+void arg_increase_reference_count(arg_t *arg);
+void arg_decrease_reference_count(arg_t *arg);
 err_t arg_increase_array(arg_t *arg, size_t increment);
 
 int arg_first_value(const arg_t *arg, const char *first_value_format, void *first_value, unsigned int *array_length);
@@ -160,10 +167,11 @@ void args_clear(grm_args_t *args, const char **exclude_keys);
 
 err_t args_increase_array(grm_args_t *args, const char *key, size_t increment) UNUSED;
 
-unsigned int args_count(const grm_args_t *args) UNUSED;
+unsigned int args_count(const grm_args_t *args);
 
 arg_t *args_at(const grm_args_t *args, const char *keyword);
 
+args_node_t *args_append_node(grm_args_t *args, arg_t *arg);
 args_node_t *args_find_node(const grm_args_t *args, const char *keyword);
 int args_find_previous_node(const grm_args_t *args, const char *keyword, args_node_t **previous_node);
 
@@ -1090,14 +1090,18 @@ err_t tobson_int_value(memwriter_t *memwriter, int value)
 
 err_t tobson_double_value(memwriter_t *memwriter, double value)
 {
-  err_t error;
-  char *bytes;
+  char bytes[sizeof(double)];
 
-  double_to_bytes(value, &bytes);
-  error = memwriter_puts_with_len(memwriter, bytes, sizeof(double));
-  free(bytes);
+  if (is_little_endian())
+    {
+      memcpy(bytes, &value, sizeof(double));
+    }
+  else
+    {
+      revmemcpy(bytes, &value, sizeof(double));
+    }
 
-  return error;
+  return memwriter_puts_with_len(memwriter, bytes, sizeof(double));
 }
 
 err_t tobson_string_value(memwriter_t *memwriter, char *value)
@@ -11,16 +11,21 @@ Drawable::Drawable(
   ;
 }
 
-void Drawable::draw()
+void Drawable::draw(ManageDrawableCache *cache)
 {
   gr_selectcontext(grContextId);
   gr_savestate();
-  bool old_state;
-  GRM::Render::getAutoUpdate(&old_state);
-  GRM::Render::setAutoUpdate(false);
-  GRM::Render::processAttributes(element);
-  drawFunction(element, context);
-  GRM::Render::setAutoUpdate(old_state);
+  if (cache == nullptr || !cache->replay(element, context))
+    {
+      bool old_state;
+      GRM::Render::getAutoUpdate(&old_state);
+      GRM::Render::setAutoUpdate(false);
+      if (cache != nullptr) cache->beginCapture(element, context);
+      GRM::Render::processAttributes(element);
+      drawFunction(element, context);
+      if (cache != nullptr) cache->endCapture(element, context);
+      GRM::Render::setAutoUpdate(old_state);
+    }
   gr_restorestate();
 }
 
@@ -34,10 +39,10 @@ int Drawable::getGrContextId() const
   return grContextId;
 }
 
-bool CompareZIndex::operator()(std::shared_ptr<Drawable> const &lhs, std::shared_ptr<Drawable> const &rhs)
+bool CompareZIndex::operator()(const Drawable &lhs, const Drawable &rhs) const
 {
-  if (lhs->zIndex != rhs->zIndex)
-    return lhs->zIndex > rhs->zIndex;
+  if (lhs.zIndex != rhs.zIndex)
+    return lhs.zIndex < rhs.zIndex;
   else
-    return lhs->insertionIndex > rhs->insertionIndex;
+    return lhs.insertionIndex < rhs.insertionIndex;
 }
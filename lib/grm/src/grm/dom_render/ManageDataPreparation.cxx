@@ -0,0 +1,173 @@
+#include <algorithm>
+
+#include "grm/dom_render/ManageDataPreparation.hxx"
+#include "grm/dom_render/NotFoundError.hxx"
+#include "threadpool.h"
+
+/* preparing less data than this is faster on the render thread alone than with additional worker threads */
+static const std::size_t MIN_PARALLEL_SIZE = 1 << 16;
+
+void ManageDataPreparation::begin()
+{
+  /* results which were not needed in the previous render are not expected to be needed again */
+  for (auto result_it = results.begin(); result_it != results.end();)
+    {
+      if (!result_it->second.used)
+        {
+          result_it = results.erase(result_it);
+        }
+      else
+        {
+          result_it->second.used = false;
+          ++result_it;
+        }
+    }
+  tasks.clear();
+}
+
+void ManageDataPreparation::request(const std::string &id, const std::shared_ptr<GRM::Context> &context,
+                                   const std::vector<std::string> &keys, Compute compute)
+{
+  std::vector<GRM::DoubleView> views;
+  std::vector<Input> inputs;
+  try
+    {
+      inputs = lookupInputs(context, keys, views);
+    }
+  catch (const NotFoundError &e)
+    {
+      /* invalid data is reported when the tree is processed */
+      return;
+    }
+
+  auto result_it = results.find(id);
+  if (result_it != results.end() && result_it->second.inputs == inputs)
+    {
+      result_it->second.used = true;
+      return;
+    }
+  if (std::any_of(tasks.begin(), tasks.end(), [&id](const Task &task) { return task.id == id; })) return;
+
+  Task task;
+  task.id = id;
+  task.inputs = std::move(inputs);
+  task.views = std::move(views);
+  task.compute = std::move(compute);
+  tasks.push_back(std::move(task));
+}
+
+void ManageDataPreparation::run()
+{
+  std::vector<Task *> pending;
+  std::size_t total_size = 0;
+
+  for (auto &task : tasks)
+    {
+      pending.push_back(&task);
+      for (const auto &input : task.inputs) total_size += input.size;
+    }
+  /* start with the largest tasks so that the threads finish at roughly the same time */
+  std::stable_sort(pending.begin(), pending.end(), [](const Task *a, const Task *b) {
+    std::size_t a_size = 0, b_size = 0;
+    for (const auto &input : a->inputs) a_size += input.size;
+    for (const auto &input : b->inputs) b_size += input.size;
+    return a_size > b_size;
+  });
+
+  if (pending.size() > 1 && total_size >= MIN_PARALLEL_SIZE)
+    {
+      /* the tasks are distributed by GR's persistent thread pool, which runs them serially without thread support */
+      threadpool_parallel_for(static_cast<int>(pending.size()), 1, runTasks, &pending);
+    }
+  else
+    {
+      runTasks(&pending, 0, static_cast<int>(pending.size()));
+    }
+
+  for (auto &task : tasks)
+    {
+      if (!task.done) continue;
+      auto &result = results[task.id];
+      result.inputs = std::move(task.inputs);
+      result.values = std::move(task.values);
+      result.used = true;
+    }
+  tasks.clear();
+}
+
+const std::vector<double> &ManageDataPreparation::get(const std::string &id,
+                                                      const std::shared_ptr<GRM::Context> &context,
+                                                      const std::vector<std::string> &keys, const Compute &compute)
+{
+  /*!
+   * Return the result with the given id, computing it on the calling thread if it was not prepared or if its data
+   * has changed since. The returned reference is valid until the next call.
+   */
+  std::vector<GRM::DoubleView> views;
+  auto inputs = lookupInputs(context, keys, views);
+
+  auto result_it = results.find(id);
+  if (result_it == results.end() || !(result_it->second.inputs == inputs))
+    {
+      auto values = compute(views);
+      auto &result = results[id];
+      result.inputs = std::move(inputs);
+      result.values = std::move(values);
+      result_it = results.find(id);
+    }
+  result_it->second.used = true;
+  return result_it->second.values;
+}
+
+void ManageDataPreparation::clear()
+{
+  results.clear();
+  tasks.clear();
+}
+
+std::vector<ManageDataPreparation::Input>
+ManageDataPreparation::lookupInputs(const std::shared_ptr<GRM::Context> &context, const std::vector<std::string> &keys,
+                                    std::vector<GRM::DoubleView> &views)
+{
+  /* empty keys stand for optional data which is not given */
+  std::vector<Input> inputs;
+
+  for (const auto &key : keys)
+    {
+      Input input;
+      if (!key.empty())
+        {
+          auto view = GRM::get_view((*context)[key]);
+          input.data = view.data();
+          input.size = view.size();
+          input.revision = context->revision(key);
+          views.push_back(view);
+        }
+      else
+        {
+          views.emplace_back();
+        }
+      inputs.push_back(input);
+    }
+  return inputs;
+}
+
+void ManageDataPreparation::runTasks(void *arg, int start, int end)
+{
+  auto &pending = *static_cast<std::vector<Task *> *>(arg);
+
+  for (int i = start; i < end; ++i)
+    {
+      auto &task = *pending[i];
+      /* no exception must leave this function since it is called by the C thread pool */
+      try
+        {
+          task.values = task.compute(task.views);
+          task.done = true;
+        }
+      catch (...)
+        {
+          /* the result is computed again by `get` on the render thread, which reports the error */
+        }
+    }
+}
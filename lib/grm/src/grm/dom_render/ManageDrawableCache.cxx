@@ -0,0 +1,137 @@
+#include "grm/dom_render/ManageDrawableCache.hxx"
+
+/* captures of a single drawable which get larger than this are abandoned to bound the memory used by the cache */
+static const int MAX_CAPTURE_SIZE = 256 * 1024 * 1024;
+
+ManageDrawableCache::~ManageDrawableCache()
+{
+  clear();
+}
+
+bool ManageDrawableCache::replay(const std::shared_ptr<GRM::Element> &element,
+                                 const std::shared_ptr<GRM::Context> &context)
+{
+  auto entry_it = entries.find(element.get());
+  if (entry_it == entries.end()) return false;
+
+  auto &entry = entry_it->second;
+  if (entry.capture == nullptr || !isValid(entry, element, context)) return false;
+  return gr_replaycapture(entry.capture);
+}
+
+void ManageDrawableCache::beginCapture(const std::shared_ptr<GRM::Element> &element,
+                                       const std::shared_ptr<GRM::Context> &context)
+{
+  /* a capture is still active if drawing the previous drawable failed */
+  gr_deletecapture(active_capture);
+  active_capture = nullptr;
+
+  /* do not try again to capture unchanged drawables whose output could not be captured before */
+  auto entry_it = entries.find(element.get());
+  if (entry_it != entries.end() && entry_it->second.capture == nullptr && isValid(entry_it->second, element, context))
+    return;
+
+  active_capture = gr_begincapture(MAX_CAPTURE_SIZE);
+}
+
+void ManageDrawableCache::endCapture(const std::shared_ptr<GRM::Element> &element,
+                                     const std::shared_ptr<GRM::Context> &context)
+{
+  if (active_capture == nullptr) return;
+
+  auto &entry = entries[element.get()];
+  gr_deletecapture(entry.capture);
+  entry.capture = active_capture;
+  active_capture = nullptr;
+  if (!gr_endcapture(entry.capture))
+    {
+      gr_deletecapture(entry.capture);
+      entry.capture = nullptr;
+    }
+
+  /* remember everything the output depends on, after drawing since drawing may touch context data */
+  auto parent = element->parentElement();
+  entry.element = element;
+  entry.revision = element->revision();
+  entry.parent = parent.get();
+  entry.parent_revision = parent ? parent->revision() : 0;
+  entry.transformations = ancestorTransformations(element);
+  entry.context = context.get();
+  entry.context_keys.clear();
+  for (const auto &referring_element : {element, parent})
+    {
+      if (!referring_element) continue;
+      for (auto attribute : referring_element->getAttributeAtoms())
+        {
+          auto value = referring_element->getAttribute(attribute);
+          if (!value.isString()) continue;
+          auto key = static_cast<std::string>(value);
+          entry.context_keys.emplace_back(key, context->revision(key));
+        }
+    }
+}
+
+void ManageDrawableCache::discardDetached()
+{
+  for (auto entry_it = entries.begin(); entry_it != entries.end();)
+    {
+      auto element = entry_it->second.element.lock();
+      if (!element || !element->isConnected())
+        {
+          gr_deletecapture(entry_it->second.capture);
+          entry_it = entries.erase(entry_it);
+        }
+      else
+        {
+          ++entry_it;
+        }
+    }
+}
+
+void ManageDrawableCache::clear()
+{
+  for (auto &entry : entries)
+    {
+      gr_deletecapture(entry.second.capture);
+    }
+  entries.clear();
+  gr_deletecapture(active_capture);
+  active_capture = nullptr;
+}
+
+std::vector<GRM::Value> ManageDrawableCache::ancestorTransformations(const std::shared_ptr<GRM::Element> &element)
+{
+  /* world coordinate transformations are inherited from the ancestors, see `applyMoveTransformation` */
+  static const GRM::Attr transformation_attributes[] = {
+      GRM::Attr::x_scale_wc, GRM::Attr::y_scale_wc,      GRM::Attr::x_shift_wc,
+      GRM::Attr::y_shift_wc, GRM::Attr::disable_x_trans, GRM::Attr::disable_y_trans,
+  };
+  std::vector<GRM::Value> transformations;
+
+  for (auto ancestor = element->parentElement(); ancestor && ancestor->localName() != "root";
+       ancestor = ancestor->parentElement())
+    {
+      for (auto attribute : transformation_attributes)
+        {
+          transformations.push_back(ancestor->getAttribute(attribute));
+        }
+    }
+  return transformations;
+}
+
+bool ManageDrawableCache::isValid(const Entry &entry, const std::shared_ptr<GRM::Element> &element,
+                                  const std::shared_ptr<GRM::Context> &context)
+{
+  if (entry.element.lock() != element || entry.revision != element->revision()) return false;
+
+  auto parent = element->parentElement();
+  if (parent.get() != entry.parent || (parent && parent->revision() != entry.parent_revision)) return false;
+
+  if (entry.context != context.get()) return false;
+  for (const auto &[key, revision] : entry.context_keys)
+    {
+      if (context->revision(key) != revision) return false;
+    }
+
+  return ancestorTransformations(element) == entry.transformations;
+}
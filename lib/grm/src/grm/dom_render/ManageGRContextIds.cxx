@@ -38,9 +38,49 @@ void ManageGRContextIds::markIdAsUnused(int id)
 
 void ManageGRContextIds::markAllIdsAsUnused()
 {
+  /* the contexts are kept and overwritten when their ids are used again */
   available_gr_context_ids = {};
   for (int id = 1; id <= no_currently_allocated_gr_contexts; ++id)
     {
       available_gr_context_ids.push(id);
     }
+  owner_to_context.clear();
+  hash_to_context.clear();
+}
+
+int ManageGRContextIds::saveSharedGRContext(const std::shared_ptr<const void> &owner, int custom_color)
+{
+  /*!
+   * Return the id of a gr context which holds the current gr state, saving the state only if no context with an equal
+   * state and custom color was saved since the ids were last marked as unused. All drawables of an owner (their parent
+   * element) start from the same gr state, so the context of the owner is reused without comparing the states again.
+   *
+   * \param[in] owner The object whose drawables share the context
+   * \param[in] custom_color The rgb value of the custom color index which is restored together with the context
+   */
+  if (auto owner_it = owner_to_context.find(owner);
+      owner_it != owner_to_context.end() && owner_it->second.custom_color == custom_color)
+    {
+      return owner_it->second.id;
+    }
+
+  int context_id = getUnusedGRContextId();
+  gr_savecontext(context_id);
+  unsigned int hash = gr_hashcontext(context_id);
+  auto [candidates_begin, candidates_end] = hash_to_context.equal_range(hash);
+  for (auto candidate_it = candidates_begin; candidate_it != candidates_end; ++candidate_it)
+    {
+      const auto &candidate = candidate_it->second;
+      if (candidate.custom_color == custom_color && gr_comparecontexts(candidate.id, context_id) == 0)
+        {
+          markIdAsUnused(context_id);
+          owner_to_context.insert_or_assign(owner, candidate);
+          return candidate.id;
+        }
+    }
+
+  SharedContext shared_context = {context_id, custom_color};
+  hash_to_context.emplace(hash, shared_context);
+  owner_to_context.insert_or_assign(owner, shared_context);
+  return context_id;
 }
@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <unordered_map>
 #include <utility>
 #include <variant>
@@ -8,6 +9,36 @@
 #include <grm/dom_render/context.hxx>
 
 
+GRM::DoubleBuffer::DoubleBuffer(std::shared_ptr<const double[]> data, std::size_t size)
+    : data_(std::move(data)), size_(size)
+{
+  /*!
+   * Create a buffer from shared data. A custom deleter of `data` can be used to release externally owned memory.
+   *
+   * \param[in] data The shared array
+   * \param[in] size The number of doubles in the array
+   */
+}
+
+GRM::DoubleBuffer::DoubleBuffer(std::vector<double> vec)
+{
+  /*!
+   * Create a buffer which takes over the ownership of a vector without copying its data
+   *
+   * \param[in] vec The vector to move into the buffer
+   */
+  auto shared_vec = std::make_shared<const std::vector<double>>(std::move(vec));
+  size_ = shared_vec->size();
+  data_ = std::shared_ptr<const double[]>(shared_vec, shared_vec->data());
+}
+
+std::vector<double> GRM::DoubleBuffer::toVector() const
+{
+  return std::vector<double>(begin(), end());
+}
+
+static unsigned long revision_counter = 0;
+
 GRM::Context::Context() = default; /*! default constructor for GRM::Context*/
 
 GRM::Context::Inner::Inner(Context &context, std::string key) : context(&context), key(std::move(key))
@@ -38,7 +69,9 @@ bool GRM::Context::Inner::intUsed()
    *
    * \returns a bool indicating the usage of GRM::Context::Inner::key by GRM::Context::tableInt
    */
-  return context->tableInt.find(key) != context->tableInt.end();
+  auto lazy_it = context->tableLazy.find(key);
+  return context->tableInt.find(key) != context->tableInt.end() ||
+         (lazy_it != context->tableLazy.end() && std::holds_alternative<IntLoader>(lazy_it->second));
 }
 
 bool GRM::Context::Inner::doubleUsed()
@@ -49,7 +82,10 @@ bool GRM::Context::Inner::doubleUsed()
    *
    * \returns a bool indicating the usage of GRM::Context::Inner::key by GRM::Context::tableDouble
    */
-  return context->tableDouble.find(key) != context->tableDouble.end();
+  auto lazy_it = context->tableLazy.find(key);
+  return context->tableDouble.find(key) != context->tableDouble.end() ||
+         context->tableDoubleBuffer.find(key) != context->tableDoubleBuffer.end() ||
+         (lazy_it != context->tableLazy.end() && std::holds_alternative<DoubleLoader>(lazy_it->second));
 }
 
 bool GRM::Context::Inner::stringUsed()
@@ -60,7 +96,9 @@ bool GRM::Context::Inner::stringUsed()
    *
    * \returns a bool indicating the usage of GRM::Context::Inner::key by GRM::Context::tableString
    */
-  return context->tableString.find(key) != context->tableString.end();
+  auto lazy_it = context->tableLazy.find(key);
+  return context->tableString.find(key) != context->tableString.end() ||
+         (lazy_it != context->tableLazy.end() && std::holds_alternative<StringLoader>(lazy_it->second));
 }
 
 
@@ -77,7 +115,40 @@ GRM::Context::Inner &GRM::Context::Inner::operator=(std::vector<double> vec)
     }
   else
     {
+      auto double_it = context->tableDouble.find(key);
+      if (double_it != context->tableDouble.end() && double_it->second == vec) return *this;
+      context->tableLazy.erase(key);
+      context->tableDoubleBuffer.erase(key);
       context->tableDouble[key] = std::move(vec);
+      context->touch(key);
+      return *this;
+    }
+}
+
+GRM::Context::Inner &GRM::Context::Inner::operator=(DoubleBuffer buffer)
+{
+  /*!
+   * Overloaded operator= for GRM::Context::Inner assigning a GRM::DoubleBuffer
+   * Stores the buffer in GRM::Context::tableDoubleBuffer with GRM::Context::Inner's key without copying its data
+   * Throws a TypeError if the GRM::Context::Inner key is already used by other GRM::Context tableTYPES
+   */
+  if (intUsed() || stringUsed())
+    {
+      throw TypeError("Wrong Type: std::vector<double> expected\n");
+    }
+  else
+    {
+      auto buffer_it = context->tableDoubleBuffer.find(key);
+      if (buffer_it != context->tableDoubleBuffer.end() && buffer_it->second.data() == buffer.data() &&
+          buffer_it->second.size() == buffer.size())
+        {
+          buffer_it->second = std::move(buffer);
+          return *this;
+        }
+      context->tableLazy.erase(key);
+      context->tableDouble.erase(key);
+      context->tableDoubleBuffer[key] = std::move(buffer);
+      context->touch(key);
       return *this;
     }
 }
@@ -95,7 +166,11 @@ GRM::Context::Inner &GRM::Context::Inner::operator=(std::vector<int> vec)
     }
   else
     {
+      auto int_it = context->tableInt.find(key);
+      if (int_it != context->tableInt.end() && int_it->second == vec) return *this;
+      context->tableLazy.erase(key);
       context->tableInt[key] = std::move(vec);
+      context->touch(key);
       return *this;
     }
 }
@@ -114,7 +189,11 @@ GRM::Context::Inner &GRM::Context::Inner::operator=(std::vector<std::string> vec
     }
   else
     {
+      auto string_it = context->tableString.find(key);
+      if (string_it != context->tableString.end() && string_it->second == vec) return *this;
+      context->tableLazy.erase(key);
       context->tableString[key] = std::move(vec);
+      context->touch(key);
       return *this;
     }
 }
@@ -128,8 +207,10 @@ GRM::Context::Inner::operator std::vector<int> &()
    *
    * Throws a NotFoundError if there is no vector found in tableInt with Inner's key
    */
+  context->loadLazy(key);
   if (context->tableInt.find(key) != context->tableInt.end())
     {
+      context->touch(key);
       return context->tableInt[key];
     }
   std::string msg = "No integer value found for given key: " + key;
@@ -144,6 +225,7 @@ GRM::Context::Inner::operator const std::vector<int> &() const
    *
    * Throws a NotFoundError if there is no vector found in tableInt with Inner's key
    */
+  context->loadLazy(key);
   if (context->tableInt.find(key) != context->tableInt.end())
     {
       return context->tableInt[key];
@@ -160,8 +242,11 @@ GRM::Context::Inner::operator std::vector<double> &()
    *
    * Throws a NotFoundError if there is no vector found in tableDouble with Inner's key
    */
+  context->convertBufferToVector(key);
+  context->loadLazy(key);
   if (context->tableDouble.find(key) != context->tableDouble.end())
     {
+      context->touch(key);
       return context->tableDouble[key];
     }
   std::string msg = "No double value found for given key: " + key;
@@ -176,6 +261,8 @@ GRM::Context::Inner::operator const std::vector<double> &() const
    *
    * Throws a NotFoundError if there is no vector found in tableDouble with Inner's key
    */
+  context->convertBufferToVector(key);
+  context->loadLazy(key);
   if (context->tableDouble.find(key) != context->tableDouble.end())
     {
       return context->tableDouble[key];
@@ -192,8 +279,10 @@ GRM::Context::Inner::operator std::vector<std::string> &()
    *
    * Throws a NotFoundError if there is no vector found in tableString with Inner's key
    */
+  context->loadLazy(key);
   if (context->tableString.find(key) != context->tableString.end())
     {
+      context->touch(key);
       return context->tableString[key];
     }
   std::string msg = "No string value found for given key: " + key;
@@ -208,6 +297,7 @@ GRM::Context::Inner::operator const std::vector<std::string> &() const
    *
    * Throws a NotFoundError if there is no vector found in tableString with Inner's key
    */
+  context->loadLazy(key);
   if (context->tableString.find(key) != context->tableString.end())
     {
       return context->tableString[key];
@@ -224,8 +314,10 @@ GRM::Context::Inner::operator std::vector<int> *()
    *
    * Throws a NotFoundError if there is no vector found in tableInt with Inner's key
    */
+  context->loadLazy(key);
   if (context->tableInt.find(key) != context->tableInt.end())
     {
+      context->touch(key);
       return &context->tableInt[key];
     }
   std::string msg = "No integer value found for given key: " + key;
@@ -240,6 +332,7 @@ GRM::Context::Inner::operator const std::vector<int> *() const
    *
    * Throws a NotFoundError if there is no vector found in tableInt with Inner's key
    */
+  context->loadLazy(key);
   if (context->tableInt.find(key) != context->tableInt.end())
     {
       return &context->tableInt[key];
@@ -257,8 +350,11 @@ GRM::Context::Inner::operator std::vector<double> *()
    *
    * Throws a NotFoundError if there is no vector found in tableDouble with Inner's key
    */
+  context->convertBufferToVector(key);
+  context->loadLazy(key);
   if (context->tableDouble.find(key) != context->tableDouble.end())
     {
+      context->touch(key);
       return &context->tableDouble[key];
     }
   std::string msg = "No double value found for given key: " + key;
@@ -273,6 +369,8 @@ GRM::Context::Inner::operator const std::vector<double> *() const
    *
    * Throws a NotFoundError if there is no vector found in tableDouble with Inner's key
    */
+  context->convertBufferToVector(key);
+  context->loadLazy(key);
   if (context->tableDouble.find(key) != context->tableDouble.end())
     {
       return &context->tableDouble[key];
@@ -289,8 +387,10 @@ GRM::Context::Inner::operator std::vector<std::string> *()
    *
    * Throws a NotFoundError if there is no vector found in tableString with Inner's key
    */
+  context->loadLazy(key);
   if (context->tableString.find(key) != context->tableString.end())
     {
+      context->touch(key);
       return &context->tableString[key];
     }
   std::string msg = "No string value found for given key: " + key;
@@ -305,6 +405,7 @@ GRM::Context::Inner::operator const std::vector<std::string> *() const
    *
    * Throws a NotFoundError if there is no vector found in tableString with Inner's key
    */
+  context->loadLazy(key);
   if (context->tableString.find(key) != context->tableString.end())
     {
       return &context->tableString[key];
@@ -313,6 +414,43 @@ GRM::Context::Inner::operator const std::vector<std::string> *() const
   throw NotFoundError(msg);
 }
 
+GRM::Context::Inner::operator DoubleBuffer() const
+{
+  /*!
+   * Overloaded operator GRM::DoubleBuffer used for getting double data of GRM::Context::Inner with shared ownership
+   * This operator is used in GRM::get_buffer
+   *
+   * Data stored as std::vector<double> is copied into a new buffer
+   * Throws a NotFoundError if there is no double data found with Inner's key
+   */
+  auto buffer_it = context->tableDoubleBuffer.find(key);
+  if (buffer_it != context->tableDoubleBuffer.end()) return buffer_it->second;
+
+  context->loadLazy(key);
+  auto double_it = context->tableDouble.find(key);
+  if (double_it != context->tableDouble.end()) return DoubleBuffer(double_it->second);
+  std::string msg = "No double value found for given key: " + key;
+  throw NotFoundError(msg);
+}
+
+GRM::Context::Inner::operator DoubleView() const
+{
+  /*!
+   * Overloaded operator GRM::DoubleView used for reading double data of GRM::Context::Inner without copying it
+   * This operator is used in GRM::get_view
+   *
+   * Throws a NotFoundError if there is no double data found with Inner's key
+   */
+  auto buffer_it = context->tableDoubleBuffer.find(key);
+  if (buffer_it != context->tableDoubleBuffer.end()) return buffer_it->second;
+
+  context->loadLazy(key);
+  auto double_it = context->tableDouble.find(key);
+  if (double_it != context->tableDouble.end()) return double_it->second;
+  std::string msg = "No double value found for given key: " + key;
+  throw NotFoundError(msg);
+}
+
 void GRM::Context::Inner::delete_key(const std::string &context_key)
 {
   bool erased = false;
@@ -331,7 +469,21 @@ void GRM::Context::Inner::delete_key(const std::string &context_key)
       context->tableInt.erase(context_key);
       erased = true;
     }
-  if (erased) context->referenceNumberOfKeys.erase(context_key);
+  if (context->tableDoubleBuffer.find(context_key) != context->tableDoubleBuffer.end())
+    {
+      context->tableDoubleBuffer.erase(context_key);
+      erased = true;
+    }
+  if (context->tableLazy.find(context_key) != context->tableLazy.end())
+    {
+      context->tableLazy.erase(context_key);
+      erased = true;
+    }
+  if (erased)
+    {
+      context->referenceNumberOfKeys.erase(context_key);
+      context->keyRevisions.erase(context_key);
+    }
 }
 
 void GRM::Context::Inner::decrement_key(const std::string &context_key)
@@ -376,6 +528,115 @@ const GRM::Context::Inner GRM::Context::operator[](const std::string &str) const
   return Inner(*this, str);
 }
 
+/*!
+ * \brief Register a vector which is only loaded when its key is accessed for the first time.
+ *
+ * This is used for large data sets which are read from a file (for example a memory-mapped binary graphics tree) and
+ * may never be needed. Any vector currently stored for the given key is replaced.
+ *
+ * \param[in] key The context key.
+ * \param[in] loader A function returning the vector. It is called at most once and released afterwards.
+ */
+void GRM::Context::setLazy(const std::string &key, IntLoader loader)
+{
+  tableDouble.erase(key);
+  tableInt.erase(key);
+  tableString.erase(key);
+  tableDoubleBuffer.erase(key);
+  tableLazy[key] = std::move(loader);
+  touch(key);
+}
+
+void GRM::Context::setLazy(const std::string &key, DoubleLoader loader)
+{
+  tableDouble.erase(key);
+  tableInt.erase(key);
+  tableString.erase(key);
+  tableDoubleBuffer.erase(key);
+  tableLazy[key] = std::move(loader);
+  touch(key);
+}
+
+void GRM::Context::setLazy(const std::string &key, StringLoader loader)
+{
+  tableDouble.erase(key);
+  tableInt.erase(key);
+  tableString.erase(key);
+  tableDoubleBuffer.erase(key);
+  tableLazy[key] = std::move(loader);
+  touch(key);
+}
+
+/*!
+ * \brief Get the revision of the data stored for a key.
+ *
+ * The revision changes whenever the data of the key is replaced, deleted or handed out for modification. It can be
+ * used to detect if data has changed since it was last read. Keys without data have the revision 0.
+ *
+ * \param[in] key The context key.
+ * \returns The current revision of the key.
+ */
+unsigned long GRM::Context::revision(const std::string &key) const
+{
+  auto revision_it = keyRevisions.find(key);
+  if (revision_it == keyRevisions.end()) return 0;
+  return std::max(revision_it->second, allKeysRevision);
+}
+
+void GRM::Context::touch(const std::string &key)
+{
+  keyRevisions[key] = ++revision_counter;
+}
+
+/*!
+ * \brief Load the vector registered with `setLazy` for the given key into the matching table.
+ */
+void GRM::Context::loadLazy(const std::string &key)
+{
+  auto lazy_it = tableLazy.find(key);
+  if (lazy_it == tableLazy.end()) return;
+
+  auto loader = std::move(lazy_it->second);
+  tableLazy.erase(lazy_it);
+  if (auto int_loader = std::get_if<IntLoader>(&loader))
+    {
+      tableInt[key] = (*int_loader)();
+    }
+  else if (auto double_loader = std::get_if<DoubleLoader>(&loader))
+    {
+      tableDouble[key] = (*double_loader)();
+    }
+  else if (auto string_loader = std::get_if<StringLoader>(&loader))
+    {
+      tableString[key] = (*string_loader)();
+    }
+}
+
+void GRM::Context::loadAllLazy()
+{
+  while (!tableLazy.empty())
+    {
+      /* `loadLazy` erases the entry, so its key must not be passed by reference */
+      std::string key = tableLazy.begin()->first;
+      loadLazy(key);
+    }
+}
+
+/*!
+ * \brief Replace the shared buffer of the given key by a copy of its data in `tableDouble`.
+ *
+ * This is only needed by callers which get a `std::vector<double>` that they may modify, readers use
+ * `GRM::get_view` instead.
+ */
+void GRM::Context::convertBufferToVector(const std::string &key)
+{
+  auto buffer_it = tableDoubleBuffer.find(key);
+  if (buffer_it == tableDoubleBuffer.end()) return;
+
+  tableDouble[key] = buffer_it->second.toVector();
+  tableDoubleBuffer.erase(buffer_it);
+}
+
 /*!
  * \brief Construct a new GRM::Context iterator.
  *
@@ -384,13 +645,15 @@ const GRM::Context::Inner GRM::Context::operator[](const std::string &str) const
  */
 GRM::Context::Iterator::Iterator(Context &context, bool is_end_iterator)
     : context_(context), table_double_it_(context.tableDouble.begin()), table_int_it_(context.tableInt.begin()),
-      table_string_it_(context.tableString.begin()), current_it_(table_double_it_)
+      table_string_it_(context.tableString.begin()), table_double_buffer_it_(context.tableDoubleBuffer.begin()),
+      current_it_(table_double_it_)
 {
   if (is_end_iterator)
     {
       table_double_it_ = context.tableDouble.end();
       table_int_it_ = context.tableInt.end();
       table_string_it_ = context.tableString.end();
+      table_double_buffer_it_ = context.tableDoubleBuffer.end();
     }
   else
     {
@@ -442,7 +705,7 @@ GRM::Context::Iterator GRM::Context::Iterator::operator++(int)
 bool GRM::operator==(const GRM::Context::Iterator &a, const GRM::Context::Iterator &b)
 {
   return a.table_double_it_ == b.table_double_it_ && a.table_int_it_ == b.table_int_it_ &&
-         a.table_string_it_ == b.table_string_it_;
+         a.table_string_it_ == b.table_string_it_ && a.table_double_buffer_it_ == b.table_double_buffer_it_;
 }
 
 /*!
@@ -466,35 +729,23 @@ bool GRM::operator!=(const GRM::Context::Iterator &a, const GRM::Context::Iterat
  *
  * \return The next internal iterator to process
  */
-std::variant<std::reference_wrapper<std::map<std::string, std::vector<double>>::iterator>,
-             std::reference_wrapper<std::map<std::string, std::vector<int>>::iterator>,
-             std::reference_wrapper<std::map<std::string, std::vector<std::string>>::iterator>>
-GRM::Context::Iterator::next_iterator()
+GRM::Context::Iterator::TableIterator GRM::Context::Iterator::next_iterator()
 {
-  auto is_it_lt = [](const auto &it_a, const auto &it_b, const auto &it_a_end, const auto &it_b_end) {
-    if (it_a != it_a_end && it_b != it_b_end)
-      {
-        return it_a->first < it_b->first;
-      }
-    else
+  TableIterator next_it = table_string_it_;
+  const std::string *next_key = nullptr;
+  auto consider = [&next_it, &next_key](auto &it, const auto &it_end) {
+    if (it != it_end && (next_key == nullptr || it->first < *next_key))
       {
-        return it_a != it_a_end && it_b == it_b_end;
+        next_it = it;
+        next_key = &it->first;
       }
   };
 
-  if (is_it_lt(table_double_it_, table_int_it_, context_.tableDouble.end(), context_.tableInt.end()) &&
-      is_it_lt(table_double_it_, table_string_it_, context_.tableDouble.end(), context_.tableString.end()))
-    {
-      return table_double_it_;
-    }
-  else if (is_it_lt(table_int_it_, table_string_it_, context_.tableInt.end(), context_.tableString.end()))
-    {
-      return table_int_it_;
-    }
-  else
-    {
-      return table_string_it_;
-    }
+  consider(table_double_it_, context_.tableDouble.end());
+  consider(table_double_buffer_it_, context_.tableDoubleBuffer.end());
+  consider(table_int_it_, context_.tableInt.end());
+  consider(table_string_it_, context_.tableString.end());
+  return next_it;
 }
 
 /*!
@@ -502,6 +753,9 @@ GRM::Context::Iterator::next_iterator()
  */
 GRM::Context::Iterator GRM::Context::begin()
 {
+  loadAllLazy();
+  /* the iterator hands out modifiable references to all vectors */
+  allKeysRevision = ++revision_counter;
   return Iterator(*this);
 }
 
@@ -510,5 +764,6 @@ GRM::Context::Iterator GRM::Context::begin()
  */
 GRM::Context::Iterator GRM::Context::end()
 {
+  loadAllLazy();
   return Iterator(*this, true);
 }
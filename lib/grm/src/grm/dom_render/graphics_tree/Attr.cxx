@@ -0,0 +1,66 @@
+#include <grm/dom_render/graphics_tree/Attr.hxx>
+#include <deque>
+#include <unordered_map>
+
+namespace
+{
+/*
+ * The table is not synchronized: like the graphics tree itself it must only be used by the thread that builds and
+ * renders the tree. Atoms for names that are not part of `GRM_SCHEMA_ATTRIBUTES` are therefore interned lazily and
+ * never during static initialization, where the order relative to the table's own construction is unspecified.
+ */
+struct AttributeTable
+{
+  AttributeTable()
+  {
+#define GRM_ATTR_NAME(name) names.emplace_back(#name);
+    GRM_SCHEMA_ATTRIBUTES(GRM_ATTR_NAME)
+#undef GRM_ATTR_NAME
+    for (std::uint32_t i = 0; i < names.size(); ++i)
+      {
+        atoms.emplace(names[i], static_cast<GRM::Attr>(i));
+      }
+  }
+
+  /* a deque never moves its elements, so references to the names stay valid */
+  std::deque<std::string> names;
+  std::unordered_map<std::string, GRM::Attr> atoms;
+};
+
+AttributeTable &attributeTable()
+{
+  static AttributeTable table;
+  return table;
+}
+} // namespace
+
+GRM::Attr GRM::internAttribute(const std::string &name)
+{
+  auto &table = attributeTable();
+  auto it = table.atoms.find(name);
+  if (it != table.atoms.end())
+    {
+      return it->second;
+    }
+  auto atom = static_cast<GRM::Attr>(table.names.size());
+  table.names.push_back(name);
+  table.atoms.emplace(name, atom);
+  return atom;
+}
+
+bool GRM::findAttribute(const std::string &name, GRM::Attr *atom)
+{
+  auto &table = attributeTable();
+  auto it = table.atoms.find(name);
+  if (it == table.atoms.end())
+    {
+      return false;
+    }
+  *atom = it->second;
+  return true;
+}
+
+const std::string &GRM::attributeName(GRM::Attr atom)
+{
+  return attributeTable().names[static_cast<std::uint32_t>(atom)];
+}
@@ -4,9 +4,12 @@
 #include <grm/dom_render/graphics_tree/Comment.hxx>
 #include <grm/dom_render/graphics_tree/HierarchyRequestError.hxx>
 #include <grm/dom_render/graphics_tree/NotSupportedError.hxx>
+#include "grm/util_int.h"
+#include "grm/logging_int.h"
 
 static void (*render)() = nullptr;
 static void (*update)(const std::shared_ptr<GRM::Element> &, const std::string &, const std::string &) = nullptr;
+static bool (*updateCheck)(const std::string &) = nullptr;
 static void (*contextUpdate)(const std::shared_ptr<GRM::Element> &, const std::string &, const GRM::Value &) = nullptr;
 static void (*contextDelete)(const std::shared_ptr<GRM::Element> &) = nullptr;
 GRM::Document::Document() : GRM::Node(GRM::Node::Type::DOCUMENT_NODE, nullptr) {}
@@ -48,6 +51,83 @@ std::shared_ptr<GRM::Document> GRM::Document::shared()
   return std::static_pointer_cast<GRM::Document>(shared_from_this());
 }
 
+void GRM::Document::registerElement(GRM::Element *element)
+{
+  m_element_index.elements[element->localName()].insert(element);
+  for (auto attribute : element->m_attribute_atoms)
+    {
+      if (isIndexedAttribute(attribute))
+        {
+          indexAttributeValue(element, attribute, *element->findAttributeValue(attribute));
+        }
+    }
+}
+
+void GRM::Document::unregisterElement(GRM::Element *element)
+{
+  auto it = m_element_index.elements.find(element->localName());
+  if (it != m_element_index.elements.end())
+    {
+      it->second.erase(element);
+      if (it->second.empty())
+        {
+          m_element_index.elements.erase(it);
+        }
+    }
+  for (auto attribute : element->m_attribute_atoms)
+    {
+      if (isIndexedAttribute(attribute))
+        {
+          unindexAttributeValue(element, attribute, *element->findAttributeValue(attribute));
+        }
+    }
+}
+
+const std::unordered_set<GRM::Element *> *GRM::Document::elementsByLocalName(const std::string &local_name) const
+{
+  auto it = m_element_index.elements.find(local_name);
+  if (it == m_element_index.elements.end())
+    {
+      return nullptr;
+    }
+  return &it->second;
+}
+
+bool GRM::Document::isIndexedAttribute(GRM::Attr attribute)
+{
+  return attribute == GRM::Attr::name || attribute == GRM::Attr::active || attribute == GRM::Attr::figure_id ||
+         attribute == GRM::Attr::_child_id || attribute == GRM::Attr::movable;
+}
+
+void GRM::Document::indexAttributeValue(GRM::Element *element, GRM::Attr attribute, const GRM::Value &value)
+{
+  m_element_index.attribute_values[{attribute, static_cast<std::string>(value)}].insert(element);
+}
+
+void GRM::Document::unindexAttributeValue(GRM::Element *element, GRM::Attr attribute, const GRM::Value &value)
+{
+  auto it = m_element_index.attribute_values.find({attribute, static_cast<std::string>(value)});
+  if (it != m_element_index.attribute_values.end())
+    {
+      it->second.erase(element);
+      if (it->second.empty())
+        {
+          m_element_index.attribute_values.erase(it);
+        }
+    }
+}
+
+const std::unordered_set<GRM::Element *> *GRM::Document::elementsByAttributeValue(GRM::Attr attribute,
+                                                                                  const std::string &value) const
+{
+  auto it = m_element_index.attribute_values.find({attribute, value});
+  if (it == m_element_index.attribute_values.end())
+    {
+      return nullptr;
+    }
+  return &it->second;
+}
+
 template <typename T, typename U>
 static std::vector<std::shared_ptr<T>> getElementsByTagName_impl(U &document, const std::string &qualifiedName)
 {
@@ -236,18 +316,138 @@ std::shared_ptr<const GRM::Element> GRM::Document::querySelectors(const std::str
   return querySelectors_impl(parseSelectors(selectors), match_map);
 }
 
-void GRM::Document::setUpdateFct(void (*ren)(), void (*upt)(const std::shared_ptr<GRM::Element> &, const std::string &,
-                                                            const std::string &))
+void GRM::Document::setUpdateFct(void (*ren)(),
+                                 void (*upt)(const std::shared_ptr<GRM::Element> &, const std::string &,
+                                             const std::string &),
+                                 bool (*chk)(const std::string &))
 {
   render = ren;
   update = upt;
+  updateCheck = chk;
 }
 
-void GRM::Document::getUpdateFct(void (**ren)(), void (**upt)(const std::shared_ptr<GRM::Element> &,
-                                                              const std::string &, const std::string &))
+void GRM::Document::getUpdateFct(void (**ren)(),
+                                 void (**upt)(const std::shared_ptr<GRM::Element> &, const std::string &,
+                                              const std::string &),
+                                 bool (**chk)(const std::string &))
 {
   *ren = render;
   *upt = update;
+  if (chk) *chk = updateCheck;
+}
+
+static void notifyUpdate(const std::shared_ptr<GRM::Element> &element, const std::string &attribute,
+                         const GRM::Value &old_value)
+{
+  if (!update || (updateCheck && !updateCheck(attribute))) return;
+  if (attribute == "viewport_x_min" || attribute == "viewport_x_max" || attribute == "viewport_y_min" ||
+      attribute == "viewport_y_max")
+    {
+      update(element, attribute, std::to_string(static_cast<double>(old_value)));
+    }
+  else
+    {
+      update(element, attribute, static_cast<std::string>(old_value));
+    }
+}
+
+void GRM::Document::attributeChanged(const std::shared_ptr<GRM::Element> &element, const std::string &attribute,
+                                     const GRM::Value &old_value)
+{
+  if (m_pending_updates.depth > 0)
+    {
+      /* only the value before the first change of a transaction is of interest */
+      auto key = std::make_tuple(static_cast<const GRM::Element *>(element.get()), attribute);
+      if (m_pending_updates.update_index.find(key) == m_pending_updates.update_index.end())
+        {
+          m_pending_updates.update_index[key] = m_pending_updates.updates.size();
+          m_pending_updates.updates.push_back({element, attribute, old_value});
+        }
+      return;
+    }
+  notifyUpdate(element, attribute, old_value);
+  if (render) render();
+}
+
+void GRM::Document::beginUpdate()
+{
+  ++m_pending_updates.depth;
+}
+
+void GRM::Document::endUpdate()
+{
+  if (m_pending_updates.depth == 0 || --m_pending_updates.depth > 0) return;
+
+  auto updates = std::move(m_pending_updates.updates);
+  m_pending_updates.updates.clear();
+  m_pending_updates.update_index.clear();
+  std::size_t next_update = 0;
+  try
+    {
+      for (; next_update < updates.size(); ++next_update)
+        {
+          const auto &pending_update = updates[next_update];
+          if (pending_update.element->getAttribute(pending_update.attribute) == pending_update.old_value) continue;
+          m_pending_updates.render_pending = true;
+          notifyUpdate(pending_update.element, pending_update.attribute, pending_update.old_value);
+        }
+      if (m_pending_updates.render_pending && render) render();
+      m_pending_updates.render_pending = false;
+    }
+  catch (...)
+    {
+      /*
+       * Queue the updates which have not been passed on yet in front of any queued by the callbacks, so that the next
+       * outermost `endUpdate` passes them on and renders instead of losing them.
+       */
+      auto queued_updates = std::move(m_pending_updates.updates);
+      m_pending_updates.updates.clear();
+      m_pending_updates.update_index.clear();
+      updates.erase(updates.begin(), updates.begin() + next_update);
+      for (auto *source : {&updates, &queued_updates})
+        {
+          for (auto &pending_update : *source)
+            {
+              auto key = std::make_tuple(static_cast<const GRM::Element *>(pending_update.element.get()),
+                                         pending_update.attribute);
+              if (m_pending_updates.update_index.find(key) != m_pending_updates.update_index.end()) continue;
+              m_pending_updates.update_index[key] = m_pending_updates.updates.size();
+              m_pending_updates.updates.push_back(std::move(pending_update));
+            }
+        }
+      throw;
+    }
+}
+
+GRM::Document::UpdateTransaction::UpdateTransaction(std::shared_ptr<GRM::Document> document)
+    : m_document(std::move(document))
+{
+  m_document->beginUpdate();
+}
+
+GRM::Document::UpdateTransaction::~UpdateTransaction()
+{
+  if (m_committed) return;
+  /* a destructor must not throw; the failed updates stay queued for the next transaction */
+  try
+    {
+      m_document->endUpdate();
+    }
+  catch (const std::exception &e)
+    {
+      logger((stderr, "Failed to commit an update transaction: %s\n", e.what()));
+    }
+  catch (...)
+    {
+      logger((stderr, "Failed to commit an update transaction\n"));
+    }
+}
+
+void GRM::Document::UpdateTransaction::commit()
+{
+  if (m_committed) return;
+  m_committed = true;
+  m_document->endUpdate();
 }
 
 void GRM::Document::setContextFct(void (*del)(const std::shared_ptr<GRM::Element> &),
@@ -2,13 +2,31 @@
 #include <grm/dom_render/graphics_tree/Document.hxx>
 #include <grm/dom_render/graphics_tree/util.hxx>
 #include <grm/dom_render/graphics_tree/HierarchyRequestError.hxx>
+#include <algorithm>
 #include <iterator>
 #include <grm/utilcpp_int.hxx>
 #include <grm/dom_render/graphics_tree/TypeError.hxx>
 
+static unsigned long revision_counter = 0;
+
 GRM::Element::Element(std::string local_name, const std::shared_ptr<GRM::Document> &owner_document)
-    : GRM::Node(GRM::Node::Type::ELEMENT_NODE, owner_document), m_local_name(std::move(local_name))
+    : GRM::Node(GRM::Node::Type::ELEMENT_NODE, owner_document), m_local_name(std::move(local_name)),
+      m_revision(++revision_counter)
 {
+  if (owner_document)
+    {
+      owner_document->registerElement(this);
+    }
+}
+
+GRM::Element::~Element()
+{
+  /* the owner document cannot be locked anymore if the element is destroyed along with its document */
+  auto owner_document = ownerDocument();
+  if (owner_document)
+    {
+      owner_document->unregisterElement(this);
+    }
 }
 
 std::string GRM::Element::nodeName() const
@@ -33,58 +51,91 @@ std::string GRM::Element::localName() const
 
 bool GRM::Element::hasAttributes() const
 {
-  return !this->m_attributes.empty();
+  return !this->m_attribute_atoms.empty();
 }
 
 std::unordered_set<std::string> GRM::Element::getAttributeNames() const
 {
   std::unordered_set<std::string> keys;
-  keys.reserve(this->m_attributes.size());
-  for (const auto &key : this->m_attributes)
+  keys.reserve(this->m_attribute_atoms.size());
+  for (auto atom : this->m_attribute_atoms)
     {
-      keys.insert(key.first);
+      keys.insert(GRM::attributeName(atom));
     }
   return keys;
 }
 
+std::vector<GRM::Attr> GRM::Element::getAttributeAtoms() const
+{
+  return this->m_attribute_atoms;
+}
+
+const GRM::Value *GRM::Element::findAttributeValue(GRM::Attr attribute) const
+{
+  auto begin = this->m_attribute_atoms.begin(), end = this->m_attribute_atoms.end();
+  auto it = std::find(begin, end, attribute);
+  if (it == end) return nullptr;
+  return &this->m_attribute_values[it - begin];
+}
+
 GRM::Value GRM::Element::getAttribute(const std::string &qualifiedName) const
 {
-  if (!this->hasAttribute(qualifiedName)) return {};
-  return this->m_attributes.at(qualifiedName);
+  GRM::Attr attribute;
+  if (!GRM::findAttribute(qualifiedName, &attribute)) return {};
+  return getAttribute(attribute);
+}
+
+GRM::Value GRM::Element::getAttribute(GRM::Attr attribute) const
+{
+  auto value = findAttributeValue(attribute);
+  if (!value) return {};
+  return *value;
 }
 
 void GRM::Element::setAttribute(const std::string &qualifiedName, const GRM::Value &value)
+{
+  setAttribute(GRM::internAttribute(qualifiedName), value);
+}
+
+void GRM::Element::setAttribute(GRM::Attr attribute, const GRM::Value &value)
 {
   GRM::Value old_value;
-  void (*render)() = nullptr;
-  void (*update)(const std::shared_ptr<GRM::Element> &, const std::string &, const std::string &) = nullptr;
   void (*contextUpdate)(const std::shared_ptr<GRM::Element> &, const std::string &, const GRM::Value &) = nullptr;
   void (*contextDelete)(const std::shared_ptr<GRM::Element> &) = nullptr;
-  ownerDocument()->getUpdateFct(&render, &update);
-  ownerDocument()->getContextFct(&contextDelete, &contextUpdate);
-
-  if (hasAttribute(qualifiedName)) old_value = this->m_attributes[qualifiedName];
+  auto owner_document = ownerDocument();
+  owner_document->getContextFct(&contextDelete, &contextUpdate);
 
-  this->m_attributes[qualifiedName] = value;
-  if (value != old_value)
+  auto stored_value = const_cast<GRM::Value *>(findAttributeValue(attribute));
+  if (stored_value)
     {
-      auto elem_p = std::static_pointer_cast<Element>(shared_from_this());
-      if (contextUpdate) contextUpdate(elem_p, qualifiedName, old_value);
-      if (qualifiedName == "kind")
-        {
-          ;
-        }
-      if (qualifiedName == "viewport_x_min" || qualifiedName == "viewport_x_max" || qualifiedName == "viewport_y_min" ||
-          qualifiedName == "viewport_y_max")
+      if (*stored_value == value) return;
+      old_value = std::move(*stored_value);
+      *stored_value = value;
+      m_revision = ++revision_counter;
+      if (GRM::Document::isIndexedAttribute(attribute))
         {
-          if (update) update(elem_p, qualifiedName, std::to_string(static_cast<double>(old_value)));
+          owner_document->unindexAttributeValue(this, attribute, old_value);
+          owner_document->indexAttributeValue(this, attribute, value);
         }
-      else
+    }
+  else
+    {
+      if (this->m_attribute_atoms.empty())
         {
-          if (update) update(elem_p, qualifiedName, static_cast<std::string>(old_value));
+          this->m_attribute_atoms.reserve(8);
+          this->m_attribute_values.reserve(8);
         }
-      if (render) render();
+      this->m_attribute_atoms.push_back(attribute);
+      this->m_attribute_values.push_back(value);
+      m_revision = ++revision_counter;
+      if (GRM::Document::isIndexedAttribute(attribute)) owner_document->indexAttributeValue(this, attribute, value);
+      if (value == old_value) return;
     }
+
+  const auto &qualifiedName = GRM::attributeName(attribute);
+  auto elem_p = std::static_pointer_cast<Element>(shared_from_this());
+  if (contextUpdate) contextUpdate(elem_p, qualifiedName, old_value);
+  owner_document->attributeChanged(elem_p, qualifiedName, old_value);
 }
 
 void GRM::Element::setAttribute(const std::string &qualifiedName, const std::string &value)
@@ -102,9 +153,45 @@ void GRM::Element::setAttribute(const std::string &qualifiedName, const int &val
   setAttribute(qualifiedName, GRM::Value(value));
 }
 
+void GRM::Element::setAttribute(GRM::Attr attribute, const std::string &value)
+{
+  setAttribute(attribute, GRM::Value(value));
+}
+
+void GRM::Element::setAttribute(GRM::Attr attribute, const double &value)
+{
+  setAttribute(attribute, GRM::Value(value));
+}
+
+void GRM::Element::setAttribute(GRM::Attr attribute, const int &value)
+{
+  setAttribute(attribute, GRM::Value(value));
+}
+
 void GRM::Element::removeAttribute(const std::string &qualifiedName)
 {
-  this->m_attributes.erase(qualifiedName);
+  GRM::Attr attribute;
+  if (GRM::findAttribute(qualifiedName, &attribute)) removeAttribute(attribute);
+}
+
+void GRM::Element::removeAttribute(GRM::Attr attribute)
+{
+  auto it = std::find(this->m_attribute_atoms.begin(), this->m_attribute_atoms.end(), attribute);
+  if (it == this->m_attribute_atoms.end()) return;
+  auto index = it - this->m_attribute_atoms.begin();
+  auto owner_document = ownerDocument();
+  if (owner_document && GRM::Document::isIndexedAttribute(attribute))
+    {
+      owner_document->unindexAttributeValue(this, attribute, this->m_attribute_values[index]);
+    }
+  this->m_attribute_atoms.erase(it);
+  this->m_attribute_values.erase(this->m_attribute_values.begin() + index);
+  m_revision = ++revision_counter;
+}
+
+unsigned long GRM::Element::revision() const
+{
+  return m_revision;
 }
 
 bool GRM::Element::toggleAttribute(const std::string &qualifiedName)
@@ -143,7 +230,13 @@ bool GRM::Element::toggleAttribute(const std::string &qualifiedName, bool force)
 
 bool GRM::Element::hasAttribute(const std::string &qualifiedName) const
 {
-  return this->m_attributes.find(qualifiedName) != GRM::Element::m_attributes.end();
+  GRM::Attr attribute;
+  return GRM::findAttribute(qualifiedName, &attribute) && hasAttribute(attribute);
+}
+
+bool GRM::Element::hasAttribute(GRM::Attr attribute) const
+{
+  return findAttributeValue(attribute) != nullptr;
 }
 
 template <typename T>
@@ -340,17 +433,14 @@ bool GRM::Element::isEqualNode(const std::shared_ptr<const GRM::Node> &otherNode
     {
       return false;
     }
-  if (other_node_as_element->m_attributes.size() != m_attributes.size())
+  if (other_node_as_element->m_attribute_atoms.size() != m_attribute_atoms.size())
     {
       return false;
     }
-  for (const auto &attribute_entry : other_node_as_element->m_attributes)
+  for (std::size_t i = 0; i < other_node_as_element->m_attribute_atoms.size(); ++i)
     {
-      if (m_attributes.find(attribute_entry.first) == m_attributes.end())
-        {
-          return false;
-        }
-      if (m_attributes.at(attribute_entry.first) != attribute_entry.second)
+      auto value = findAttributeValue(other_node_as_element->m_attribute_atoms[i]);
+      if (!value || *value != other_node_as_element->m_attribute_values[i])
         {
           return false;
         }
@@ -8,6 +8,7 @@
 #include <algorithm>
 #include <map>
 #include <tuple>
+#include <unordered_map>
 
 GRM::Node::Node(Type type, const std::shared_ptr<GRM::Document> &owner_document)
     : m_type(type), m_owner_document(owner_document)
@@ -377,6 +378,22 @@ void GRM::Node::replaceChildren_impl(const std::vector<std::shared_ptr<GRM::Node
 void GRM::Node::set_owner_document_recursive(const std::shared_ptr<GRM::Node> &node,
                                              const std::shared_ptr<GRM::Document> &document)
 {
+  if (node->m_type == Type::ELEMENT_NODE)
+    {
+      auto element = static_cast<GRM::Element *>(node.get());
+      auto old_document = node->m_owner_document.lock();
+      if (old_document != document)
+        {
+          if (old_document)
+            {
+              old_document->unregisterElement(element);
+            }
+          if (document)
+            {
+              document->registerElement(element);
+            }
+        }
+    }
   node->m_owner_document = document;
   for (const auto &child_node : node->m_child_nodes)
     {
@@ -626,9 +643,194 @@ bool GRM::Node::matchSelector(const std::shared_ptr<GRM::Selector> &selector,
   return selector->matchElement(*element, match_map);
 }
 
+/*!
+ * Find the elements matching `selector` in the subtree of this node (including the node itself) by looking up the
+ * local name or the attribute value required by the selector in the element index of the node document, instead of
+ * visiting every node of the subtree. If both are indexed, the smaller set of candidates is checked. The found
+ * elements are stored in tree order; if `first_only` is set, only the first one is kept. Returns `false` without
+ * touching `found_elements` if the selector requires neither a specific local name nor an indexed attribute value.
+ */
+bool GRM::Node::querySelectorsIndexed(
+    const std::shared_ptr<GRM::Selector> &selector, bool first_only, std::vector<GRM::Element *> &found_elements,
+    std::map<std::tuple<const GRM::Element *, const GRM::Selector *>, bool> &match_map) const
+{
+  auto local_name = selector->requiredLocalName();
+  auto attribute_value = selector->requiredAttributeValue();
+  GRM::Attr attribute{};
+  if (attribute_value &&
+      (!GRM::findAttribute(attribute_value->first, &attribute) || !GRM::Document::isIndexedAttribute(attribute)))
+    {
+      attribute_value.reset();
+    }
+  if (!local_name && !attribute_value)
+    {
+      return false;
+    }
+  auto document = nodeDocument();
+  if (!document)
+    {
+      return false;
+    }
+  const std::unordered_set<GRM::Element *> *candidates = nullptr;
+  if (local_name)
+    {
+      candidates = document->elementsByLocalName(*local_name);
+      if (!candidates)
+        {
+          return true;
+        }
+    }
+  if (attribute_value)
+    {
+      auto attribute_candidates = document->elementsByAttributeValue(attribute, attribute_value->second);
+      if (!attribute_candidates)
+        {
+          return true;
+        }
+      if (!candidates || attribute_candidates->size() < candidates->size())
+        {
+          candidates = attribute_candidates;
+        }
+    }
+  if (m_type != Type::DOCUMENT_NODE)
+    {
+      /* checking a candidate walks up to this node, so the index only pays off if the subtree is larger than the
+       * number of candidates; count the subtree nodes up to that limit */
+      std::size_t subtree_size = 0;
+      std::vector<const GRM::Node *> pending_nodes{this};
+      while (!pending_nodes.empty() && subtree_size < candidates->size())
+        {
+          auto node = pending_nodes.back();
+          pending_nodes.pop_back();
+          ++subtree_size;
+          for (const auto &child_node : node->m_child_nodes)
+            {
+              pending_nodes.push_back(child_node.get());
+            }
+        }
+      if (subtree_size < candidates->size())
+        {
+          return false;
+        }
+    }
+
+  std::vector<std::pair<std::vector<std::size_t>, GRM::Element *>> matches;
+  std::unordered_map<const GRM::Node *, std::unordered_map<const GRM::Node *, std::size_t>> child_positions;
+  std::vector<const GRM::Node *> ancestors;
+  for (auto candidate : *candidates)
+    {
+      /* collect the path from this node to the candidate, leaving out candidates outside of the subtree */
+      ancestors.clear();
+      const GRM::Node *node = candidate;
+      while (node && node != this)
+        {
+          ancestors.push_back(node);
+          node = node->m_parent_node.lock().get();
+        }
+      if (!node || !candidate->matchSelector(selector, match_map))
+        {
+          continue;
+        }
+      std::vector<std::size_t> path;
+      path.reserve(ancestors.size());
+      for (auto it = ancestors.rbegin(); it != ancestors.rend(); ++it)
+        {
+          auto parent = (*it)->m_parent_node.lock().get();
+          auto &positions = child_positions[parent];
+          if (positions.empty())
+            {
+              std::size_t position = 0;
+              for (const auto &child_node : parent->m_child_nodes)
+                {
+                  positions[child_node.get()] = position++;
+                }
+            }
+          path.push_back(positions[*it]);
+        }
+      matches.emplace_back(std::move(path), candidate);
+    }
+
+  /* lexicographic order of the child position paths is the tree order (pre-order) */
+  if (first_only && !matches.empty())
+    {
+      found_elements.push_back(std::min_element(matches.begin(), matches.end())->second);
+      return true;
+    }
+  std::sort(matches.begin(), matches.end());
+  for (const auto &match : matches)
+    {
+      found_elements.push_back(match.second);
+    }
+  return true;
+}
+
 void GRM::Node::querySelectorsAll_impl(
     const std::shared_ptr<GRM::Selector> &selector, std::vector<std::shared_ptr<GRM::Element>> &found_elements,
     std::map<std::tuple<const GRM::Element *, const GRM::Selector *>, bool> &match_map)
+{
+  std::vector<GRM::Element *> indexed_elements;
+  if (!querySelectorsIndexed(selector, false, indexed_elements, match_map))
+    {
+      querySelectorsAll_traverse(selector, found_elements, match_map);
+      return;
+    }
+  for (auto element : indexed_elements)
+    {
+      found_elements.push_back(std::static_pointer_cast<GRM::Element>(element->shared_from_this()));
+    }
+}
+
+void GRM::Node::querySelectorsAll_impl(
+    const std::shared_ptr<GRM::Selector> &selector, std::vector<std::shared_ptr<const GRM::Element>> &found_elements,
+    std::map<std::tuple<const GRM::Element *, const GRM::Selector *>, bool> &match_map) const
+{
+  std::vector<GRM::Element *> indexed_elements;
+  if (!querySelectorsIndexed(selector, false, indexed_elements, match_map))
+    {
+      querySelectorsAll_traverse(selector, found_elements, match_map);
+      return;
+    }
+  for (auto element : indexed_elements)
+    {
+      found_elements.push_back(std::static_pointer_cast<const GRM::Element>(element->shared_from_this()));
+    }
+}
+
+std::shared_ptr<GRM::Element>
+GRM::Node::querySelectors_impl(const std::shared_ptr<GRM::Selector> &selector,
+                               std::map<std::tuple<const GRM::Element *, const GRM::Selector *>, bool> &match_map)
+{
+  std::vector<GRM::Element *> indexed_elements;
+  if (!querySelectorsIndexed(selector, true, indexed_elements, match_map))
+    {
+      return querySelectors_traverse(selector, match_map);
+    }
+  if (indexed_elements.empty())
+    {
+      return nullptr;
+    }
+  return std::static_pointer_cast<GRM::Element>(indexed_elements.front()->shared_from_this());
+}
+
+std::shared_ptr<const GRM::Element>
+GRM::Node::querySelectors_impl(const std::shared_ptr<GRM::Selector> &selector,
+                               std::map<std::tuple<const GRM::Element *, const GRM::Selector *>, bool> &match_map) const
+{
+  std::vector<GRM::Element *> indexed_elements;
+  if (!querySelectorsIndexed(selector, true, indexed_elements, match_map))
+    {
+      return querySelectors_traverse(selector, match_map);
+    }
+  if (indexed_elements.empty())
+    {
+      return nullptr;
+    }
+  return std::static_pointer_cast<const GRM::Element>(indexed_elements.front()->shared_from_this());
+}
+
+void GRM::Node::querySelectorsAll_traverse(
+    const std::shared_ptr<GRM::Selector> &selector, std::vector<std::shared_ptr<GRM::Element>> &found_elements,
+    std::map<std::tuple<const GRM::Element *, const GRM::Selector *>, bool> &match_map)
 {
   if (matchSelector(selector, match_map))
     {
@@ -636,11 +838,11 @@ void GRM::Node::querySelectorsAll_impl(
     }
   for (auto &child_node : m_child_nodes)
     {
-      child_node->querySelectorsAll_impl(selector, found_elements, match_map);
+      child_node->querySelectorsAll_traverse(selector, found_elements, match_map);
     }
 }
 
-void GRM::Node::querySelectorsAll_impl(
+void GRM::Node::querySelectorsAll_traverse(
     const std::shared_ptr<GRM::Selector> &selector, std::vector<std::shared_ptr<const GRM::Element>> &found_elements,
     std::map<std::tuple<const GRM::Element *, const GRM::Selector *>, bool> &match_map) const
 {
@@ -650,13 +852,13 @@ void GRM::Node::querySelectorsAll_impl(
     }
   for (auto &child_node : m_child_nodes)
     {
-      child_node->querySelectorsAll_impl(selector, found_elements, match_map);
+      child_node->querySelectorsAll_traverse(selector, found_elements, match_map);
     }
 }
 
 std::shared_ptr<GRM::Element>
-GRM::Node::querySelectors_impl(const std::shared_ptr<GRM::Selector> &selector,
-                               std::map<std::tuple<const GRM::Element *, const GRM::Selector *>, bool> &match_map)
+GRM::Node::querySelectors_traverse(const std::shared_ptr<GRM::Selector> &selector,
+                                   std::map<std::tuple<const GRM::Element *, const GRM::Selector *>, bool> &match_map)
 {
   if (matchSelector(selector, match_map))
     {
@@ -664,7 +866,7 @@ GRM::Node::querySelectors_impl(const std::shared_ptr<GRM::Selector> &selector,
     }
   for (auto &child_node : m_child_nodes)
     {
-      auto result = child_node->querySelectors_impl(selector, match_map);
+      auto result = child_node->querySelectors_traverse(selector, match_map);
       if (result)
         {
           return result;
@@ -673,9 +875,9 @@ GRM::Node::querySelectors_impl(const std::shared_ptr<GRM::Selector> &selector,
   return nullptr;
 }
 
-std::shared_ptr<const GRM::Element>
-GRM::Node::querySelectors_impl(const std::shared_ptr<GRM::Selector> &selector,
-                               std::map<std::tuple<const GRM::Element *, const GRM::Selector *>, bool> &match_map) const
+std::shared_ptr<const GRM::Element> GRM::Node::querySelectors_traverse(
+    const std::shared_ptr<GRM::Selector> &selector,
+    std::map<std::tuple<const GRM::Element *, const GRM::Selector *>, bool> &match_map) const
 {
   if (matchSelector(selector, match_map))
     {
@@ -683,7 +885,7 @@ GRM::Node::querySelectors_impl(const std::shared_ptr<GRM::Selector> &selector,
     }
   for (auto &child_node : m_child_nodes)
     {
-      auto result = child_node->querySelectors_impl(selector, match_map);
+      auto result = child_node->querySelectors_traverse(selector, match_map);
       if (result)
         {
           return result;
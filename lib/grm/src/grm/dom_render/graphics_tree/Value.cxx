@@ -2,20 +2,17 @@
 #include <stdexcept>
 #include <limits>
 
-GRM::Value::Value() : m_type(Type::UNDEFINED), m_int_value(0), m_double_value(0), m_string_value() {}
+GRM::Value::Value() : m_value() {}
 
-GRM::Value::Value(int value) : m_type(Type::INT), m_int_value(value), m_double_value(0), m_string_value() {}
+GRM::Value::Value(int value) : m_value(std::in_place_type<int>, value) {}
 
-GRM::Value::Value(double value) : m_type(Type::DOUBLE), m_int_value(0), m_double_value(value), m_string_value() {}
+GRM::Value::Value(double value) : m_value(std::in_place_type<double>, value) {}
 
-GRM::Value::Value(std::string value)
-    : m_type(Type::STRING), m_int_value(0), m_double_value(0), m_string_value(std::move(value))
-{
-}
+GRM::Value::Value(std::string value) : m_value(std::in_place_type<std::string>, std::move(value)) {}
 
 bool GRM::Value::isType(Type type) const
 {
-  return m_type == type;
+  return this->type() == type;
 }
 
 bool GRM::Value::isUndefined() const
@@ -40,42 +37,28 @@ bool GRM::Value::isString() const
 
 GRM::Value::Type GRM::Value::type() const
 {
-  return m_type;
+  return static_cast<Type>(m_value.index());
 }
 
 bool GRM::Value::operator==(const GRM::Value &other) const
 {
-  if (m_type != other.m_type)
-    {
-      return false;
-    }
-  switch (m_type)
-    {
-    case Type::UNDEFINED:
-      return true;
-    case Type::INT:
-      return m_int_value == other.m_int_value;
-    case Type::DOUBLE:
-      return m_double_value == other.m_double_value;
-    case Type::STRING:
-      return m_string_value == other.m_string_value;
-    }
-  return false;
+  return m_value == other.m_value;
 }
 
 GRM::Value::operator int() const
 {
-  switch (m_type)
+  switch (type())
     {
     case Type::INT:
-      return m_int_value;
+      return std::get<int>(m_value);
     case Type::DOUBLE:
-      return static_cast<int>(m_double_value);
+      return static_cast<int>(std::get<double>(m_value));
     case Type::STRING:
       {
+        const auto &string_value = std::get<std::string>(m_value);
         char *end = nullptr;
-        long result = std::strtol(m_string_value.c_str(), &end, 10);
-        if (end != m_string_value.c_str() + m_string_value.size())
+        long result = std::strtol(string_value.c_str(), &end, 10);
+        if (end != string_value.c_str() + string_value.size())
           {
             return 0;
           }
@@ -92,21 +75,22 @@ GRM::Value::operator int() const
 
 GRM::Value::operator double() const
 {
-  switch (m_type)
+  switch (type())
     {
     case Type::INT:
-      if (static_cast<int>(static_cast<double>(m_int_value)) != m_int_value)
+      if (static_cast<int>(static_cast<double>(std::get<int>(m_value))) != std::get<int>(m_value))
         {
           return 0;
         }
-      return m_int_value;
+      return std::get<int>(m_value);
     case Type::DOUBLE:
-      return m_double_value;
+      return std::get<double>(m_value);
     case Type::STRING:
       {
+        const auto &string_value = std::get<std::string>(m_value);
         char *end = nullptr;
-        double result = std::strtod(m_string_value.c_str(), &end);
-        if (end == m_string_value.c_str() + m_string_value.size())
+        double result = std::strtod(string_value.c_str(), &end);
+        if (end == string_value.c_str() + string_value.size())
           {
             return result;
           }
@@ -119,14 +103,14 @@ GRM::Value::operator double() const
 
 GRM::Value::operator std::string() const
 {
-  switch (m_type)
+  switch (type())
     {
     case Type::INT:
-      return std::to_string(m_int_value);
+      return std::to_string(std::get<int>(m_value));
     case Type::DOUBLE:
-      return std::to_string(m_double_value);
+      return std::to_string(std::get<double>(m_value));
     case Type::STRING:
-      return m_string_value;
+      return std::get<std::string>(m_value);
     default:
       return "";
     }
@@ -6,6 +6,8 @@
 #include <sstream>
 #include <algorithm>
 #include <cmath>
+#include <mutex>
+#include <unordered_map>
 #include "grm/base64_int.h"
 #include "grm/bson_int.h"
 #include "grm/memwriter_int.h"
@@ -311,6 +313,16 @@ bool GRM::Selector::matchElement(
   return result;
 }
 
+std::optional<std::string> GRM::Selector::requiredLocalName() const
+{
+  return std::nullopt;
+}
+
+std::optional<std::pair<std::string, std::string>> GRM::Selector::requiredAttributeValue() const
+{
+  return std::nullopt;
+}
+
 /*!
  * Normalize a given vector of doubles so all values sum up to 1.0
  *
@@ -403,6 +415,32 @@ public:
   {
   }
 
+  std::optional<std::string> requiredLocalName() const override
+  {
+    for (const auto &parsed_selector : m_part_selectors)
+      {
+        auto local_name = parsed_selector->requiredLocalName();
+        if (local_name)
+          {
+            return local_name;
+          }
+      }
+    return std::nullopt;
+  }
+
+  std::optional<std::pair<std::string, std::string>> requiredAttributeValue() const override
+  {
+    for (const auto &parsed_selector : m_part_selectors)
+      {
+        auto attribute_value = parsed_selector->requiredAttributeValue();
+        if (attribute_value)
+          {
+            return attribute_value;
+          }
+      }
+    return std::nullopt;
+  }
+
 protected:
   bool doMatchElement(const GRM::Element &element,
                       std::map<std::tuple<const GRM::Element *, const GRM::Selector *>, bool> &match_map) const override
@@ -432,6 +470,23 @@ public:
   {
   }
 
+  std::optional<std::string> requiredLocalName() const override
+  {
+    if (m_part_selectors.empty())
+      {
+        return std::nullopt;
+      }
+    auto local_name = m_part_selectors.front()->requiredLocalName();
+    for (const auto &parsed_selector : m_part_selectors)
+      {
+        if (parsed_selector->requiredLocalName() != local_name)
+          {
+            return std::nullopt;
+          }
+      }
+    return local_name;
+  }
+
 protected:
   bool doMatchElement(const GRM::Element &element,
                       std::map<std::tuple<const GRM::Element *, const GRM::Selector *>, bool> &match_map) const override
@@ -462,6 +517,16 @@ public:
   {
   }
 
+  std::optional<std::string> requiredLocalName() const override
+  {
+    return m_local_selector->requiredLocalName();
+  }
+
+  std::optional<std::pair<std::string, std::string>> requiredAttributeValue() const override
+  {
+    return m_local_selector->requiredAttributeValue();
+  }
+
 protected:
   bool doMatchElement(const GRM::Element &element,
                       std::map<std::tuple<const GRM::Element *, const GRM::Selector *>, bool> &match_map) const override
@@ -489,6 +554,16 @@ public:
   {
   }
 
+  std::optional<std::string> requiredLocalName() const override
+  {
+    return m_local_selector->requiredLocalName();
+  }
+
+  std::optional<std::pair<std::string, std::string>> requiredAttributeValue() const override
+  {
+    return m_local_selector->requiredAttributeValue();
+  }
+
 protected:
   bool doMatchElement(const GRM::Element &element,
                       std::map<std::tuple<const GRM::Element *, const GRM::Selector *>, bool> &match_map) const override
@@ -515,6 +590,16 @@ public:
   {
   }
 
+  std::optional<std::string> requiredLocalName() const override
+  {
+    return m_local_selector->requiredLocalName();
+  }
+
+  std::optional<std::pair<std::string, std::string>> requiredAttributeValue() const override
+  {
+    return m_local_selector->requiredAttributeValue();
+  }
+
 protected:
   bool doMatchElement(const GRM::Element &element,
                       std::map<std::tuple<const GRM::Element *, const GRM::Selector *>, bool> &match_map) const override
@@ -714,6 +799,15 @@ class TagSelector : public Selector
 public:
   explicit TagSelector(const std::string &tag_name) : m_local_name(GRM::tolower(tag_name)) {}
 
+  std::optional<std::string> requiredLocalName() const override
+  {
+    if (m_local_name.empty() || m_local_name == "*")
+      {
+        return std::nullopt;
+      }
+    return m_local_name;
+  }
+
 protected:
   bool doMatchElement(const GRM::Element &element,
                       std::map<std::tuple<const GRM::Element *, const GRM::Selector *>, bool> &match_map) const override
@@ -747,6 +841,16 @@ public:
   {
   }
 
+  std::optional<std::pair<std::string, std::string>> requiredAttributeValue() const override
+  {
+    /* elements without the attribute match an empty value, so they cannot be found by value */
+    if (m_attribute_name.empty() || m_attribute_value.empty())
+      {
+        return std::nullopt;
+      }
+    return std::make_pair(m_attribute_name, m_attribute_value);
+  }
+
 protected:
   bool doMatchElement(const GRM::Element &element,
                       std::map<std::tuple<const GRM::Element *, const GRM::Selector *>, bool> &match_map) const override
@@ -938,7 +1042,7 @@ private:
 };
 } // namespace GRM
 
-std::shared_ptr<GRM::Selector> GRM::parseSelectors(const std::string &selectors)
+static std::shared_ptr<GRM::Selector> parseSelectorsUncached(const std::string &selectors)
 {
   auto individual_selectors = GRM::split(selectors, ",");
   for (auto &selector : individual_selectors)
@@ -1005,8 +1109,8 @@ std::shared_ptr<GRM::Selector> GRM::parseSelectors(const std::string &selectors)
                     // this is just whitespace around another symbol
                     continue;
                   }
-                auto ancestor_selector = parseSelectors(selector.substr(0, selector.rend() - it - 1));
-                auto local_selector = parseSelectors(selector.substr(selector.rend() - it));
+                auto ancestor_selector = GRM::parseSelectors(selector.substr(0, selector.rend() - it - 1));
+                auto local_selector = GRM::parseSelectors(selector.substr(selector.rend() - it));
                 parsed_individual_selectors.push_back(
                     std::make_shared<GRM::AncestorAndLocalSelector>(ancestor_selector, local_selector));
                 conditional_selector_found = true;
@@ -1014,8 +1118,8 @@ std::shared_ptr<GRM::Selector> GRM::parseSelectors(const std::string &selectors)
               }
             case '>':
               {
-                auto parent_selector = parseSelectors(selector.substr(0, selector.rend() - it - 1));
-                auto local_selector = parseSelectors(selector.substr(selector.rend() - it));
+                auto parent_selector = GRM::parseSelectors(selector.substr(0, selector.rend() - it - 1));
+                auto local_selector = GRM::parseSelectors(selector.substr(selector.rend() - it));
                 parsed_individual_selectors.push_back(
                     std::make_shared<GRM::ParentAndLocalSelector>(parent_selector, local_selector));
                 conditional_selector_found = true;
@@ -1023,8 +1127,8 @@ std::shared_ptr<GRM::Selector> GRM::parseSelectors(const std::string &selectors)
               }
             case '~':
               {
-                auto sibling_selector = parseSelectors(selector.substr(0, selector.rend() - it - 1));
-                auto local_selector = parseSelectors(selector.substr(selector.rend() - it));
+                auto sibling_selector = GRM::parseSelectors(selector.substr(0, selector.rend() - it - 1));
+                auto local_selector = GRM::parseSelectors(selector.substr(selector.rend() - it));
                 parsed_individual_selectors.push_back(
                     std::make_shared<GRM::PreviousSiblingAndLocalSelector>(sibling_selector, local_selector));
                 conditional_selector_found = true;
@@ -1393,3 +1497,32 @@ std::shared_ptr<GRM::Selector> GRM::parseSelectors(const std::string &selectors)
     }
   return std::make_shared<GRM::OrCombinedSelector>(parsed_individual_selectors);
 }
+
+/*!
+ * Parse a selector string. Parsed selectors are immutable, so they are cached by their string and shared between
+ * queries; the render loop issues the same handful of selector strings over and over again.
+ */
+std::shared_ptr<GRM::Selector> GRM::parseSelectors(const std::string &selectors)
+{
+  static const std::size_t max_cached_selectors = 1024;
+  static std::mutex cache_mutex;
+  static std::unordered_map<std::string, std::shared_ptr<GRM::Selector>> cache;
+
+  {
+    std::lock_guard<std::mutex> lock(cache_mutex);
+    auto it = cache.find(selectors);
+    if (it != cache.end())
+      {
+        return it->second;
+      }
+  }
+  /* parse without holding the lock since combinators parse their operands recursively */
+  auto selector = parseSelectorsUncached(selectors);
+  std::lock_guard<std::mutex> lock(cache_mutex);
+  if (cache.size() >= max_cached_selectors)
+    {
+      cache.clear();
+    }
+  cache.emplace(selectors, selector);
+  return selector;
+}
@@ -38,6 +38,8 @@
 #include "grm/dom_render/Drawable.hxx"
 #include "grm/dom_render/ManageGRContextIds.hxx"
 #include "grm/dom_render/ManageCustomColorIndex.hxx"
+#include "grm/dom_render/ManageDataPreparation.hxx"
+#include "grm/dom_render/ManageDrawableCache.hxx"
 extern "C" {
 #include "grm/datatype/string_map_int.h"
 }
@@ -58,12 +60,14 @@ extern "C" {
 std::shared_ptr<GRM::Element> global_root;
 std::shared_ptr<GRM::Element> active_figure;
 std::shared_ptr<GRM::Render> global_render;
-std::priority_queue<std::shared_ptr<Drawable>, std::vector<std::shared_ptr<Drawable>>, CompareZIndex> z_queue;
+/* the drawables are sorted when the queue is rendered, the vector is cleared but keeps its capacity between renders */
+std::vector<Drawable> z_queue;
 bool z_queue_is_being_rendered = false;
-std::map<std::shared_ptr<GRM::Element>, int> parent_to_context;
 ManageGRContextIds gr_context_id_manager;
 ManageZIndex z_index_manager;
 ManageCustomColorIndex custom_color_index_manager;
+ManageDataPreparation data_preparation;
+ManageDrawableCache drawable_cache;
 
 //! This vector is used for storing element types which children get processed. Other types' children will be ignored
 static std::set<std::string> parent_types = {
@@ -137,6 +141,13 @@ static std::set<std::string> drawable_types = {
     "tick",          "titles_3d",
 };
 
+//! Drawables whose output only depends on their own attributes, their parent's attributes, inherited world
+//! transformations and context data, so it can be replayed from the drawable cache while none of these change
+static std::set<std::string> cacheable_drawable_types = {
+    "cellarray",      "draw_image", "fill_area",  "nonuniform_polarcellarray", "nonuniformcellarray",
+    "polarcellarray", "polyline",   "polymarker",
+};
+
 static std::set<std::string> drawable_kinds = {
     "contour", "contourf", "hexbin", "isosurface", "quiver", "shade", "surface", "tricontour", "trisurface", "volume",
 };
@@ -467,24 +478,26 @@ static double getMaxViewport(const std::shared_ptr<GRM::Element> &element, bool
   if (plot_element == nullptr) return 1;
   if (x)
     {
-      max_vp = (aspect_ratio_ws < 1) ? static_cast<double>(plot_element->getAttribute("_viewport_x_max_org")) : 1;
+      max_vp = (aspect_ratio_ws < 1) ? static_cast<double>(plot_element->getAttribute(GRM::Attr::_viewport_x_max_org))
+                                     : 1;
       if (!str_equals_any(element->localName(), "legend", "side_region", "text_region", "side_plot_region") &&
-          element->hasAttribute("_bbox_x_max"))
+          element->hasAttribute(GRM::Attr::_bbox_x_max))
         {
-          max_vp -= abs(static_cast<double>(element->getAttribute("_viewport_x_max_org")) -
-                        static_cast<double>(element->getAttribute("_bbox_x_max")) / max_width_height);
+          max_vp -= abs(static_cast<double>(element->getAttribute(GRM::Attr::_viewport_x_max_org)) -
+                        static_cast<double>(element->getAttribute(GRM::Attr::_bbox_x_max)) / max_width_height);
         }
     }
   else
     {
-      max_vp = (aspect_ratio_ws > 1) ? static_cast<double>(plot_element->getAttribute("_viewport_y_max_org")) : 1;
+      max_vp = (aspect_ratio_ws > 1) ? static_cast<double>(plot_element->getAttribute(GRM::Attr::_viewport_y_max_org))
+                                     : 1;
       if (!str_equals_any(element->localName(), "legend", "marginal_heatmap_plot", "plot", "side_region",
                           "side_plot_region", "text_region") &&
-          element->hasAttribute("_bbox_y_max")) // TODO: Exclude plot leads to problem with different aspect ration -
-                                                // need to fix bboxes to fix this issue here
+          element->hasAttribute(GRM::Attr::_bbox_y_max)) // TODO: Exclude plot leads to problem with different aspect
+                                                         // ration - need to fix bboxes to fix this issue here
         {
-          max_vp -= abs(static_cast<double>(element->getAttribute("_viewport_y_max_org")) -
-                        static_cast<double>(element->getAttribute("_bbox_y_max")) / max_width_height);
+          max_vp -= abs(static_cast<double>(element->getAttribute(GRM::Attr::_viewport_y_max_org)) -
+                        static_cast<double>(element->getAttribute(GRM::Attr::_bbox_y_max)) / max_width_height);
         }
     }
   return max_vp;
@@ -501,19 +514,19 @@ static double getMinViewport(const std::shared_ptr<GRM::Element> &element, bool
   if (x)
     {
       if (!str_equals_any(element->localName(), "legend", "side_region", "text_region", "side_plot_region") &&
-          element->hasAttribute("_bbox_x_min"))
+          element->hasAttribute(GRM::Attr::_bbox_x_min))
         {
-          min_vp += abs(static_cast<double>(element->getAttribute("_viewport_x_min_org")) -
-                        static_cast<double>(element->getAttribute("_bbox_x_min")) / max_width_height);
+          min_vp += abs(static_cast<double>(element->getAttribute(GRM::Attr::_viewport_x_min_org)) -
+                        static_cast<double>(element->getAttribute(GRM::Attr::_bbox_x_min)) / max_width_height);
         }
     }
   else
     {
       if (!str_equals_any(element->localName(), "legend", "side_region", "text_region", "side_plot_region") &&
-          element->hasAttribute("_bbox_y_min"))
+          element->hasAttribute(GRM::Attr::_bbox_y_min))
         {
-          min_vp += abs(static_cast<double>(element->getAttribute("_viewport_y_min_org")) -
-                        static_cast<double>(element->getAttribute("_bbox_y_min")) / max_width_height);
+          min_vp += abs(static_cast<double>(element->getAttribute(GRM::Attr::_viewport_y_min_org)) -
+                        static_cast<double>(element->getAttribute(GRM::Attr::_bbox_y_min)) / max_width_height);
         }
     }
   return min_vp;
@@ -721,8 +734,8 @@ static void sidePlotMargin(const std::shared_ptr<GRM::Element> side_region, doub
                            bool aspect_ratio_scale, double aspect_ratio_ws, double start_aspect_ratio_ws)
 {
   if (side_region->querySelectors("side_plot_region") ||
-      (side_region->hasAttribute("marginal_heatmap_side_plot") &&
-       static_cast<int>(side_region->getAttribute("marginal_heatmap_side_plot"))))
+      (side_region->hasAttribute(GRM::Attr::marginal_heatmap_side_plot) &&
+       static_cast<int>(side_region->getAttribute(GRM::Attr::marginal_heatmap_side_plot))))
     {
       *margin += inc;
       if (aspect_ratio_scale)
@@ -775,20 +788,20 @@ static void calculateCentralRegionMarginOrDiagFactor(const std::shared_ptr<GRM::
   auto render = grm_get_render();
   getPlotParent(plot_parent);
 
-  kind = static_cast<std::string>(plot_parent->getAttribute("kind"));
-  keep_aspect_ratio = static_cast<int>(plot_parent->getAttribute("keep_aspect_ratio"));
-  only_quadratic_aspect_ratio = static_cast<int>(plot_parent->getAttribute("only_quadratic_aspect_ratio"));
+  kind = static_cast<std::string>(plot_parent->getAttribute(GRM::Attr::kind));
+  keep_aspect_ratio = static_cast<int>(plot_parent->getAttribute(GRM::Attr::keep_aspect_ratio));
+  only_quadratic_aspect_ratio = static_cast<int>(plot_parent->getAttribute(GRM::Attr::only_quadratic_aspect_ratio));
 
   left_side_region = plot_parent->querySelectors("side_region[location=\"left\"]");
   right_side_region = plot_parent->querySelectors("side_region[location=\"right\"]");
   bottom_side_region = plot_parent->querySelectors("side_region[location=\"bottom\"]");
   top_side_region = plot_parent->querySelectors("side_region[location=\"top\"]");
-  if (left_side_region && left_side_region->hasAttribute("text_content")) left_text_margin = true;
-  if (right_side_region && right_side_region->hasAttribute("text_content")) right_text_margin = true;
-  if (bottom_side_region && bottom_side_region->hasAttribute("text_content")) bottom_text_margin = true;
-  if (top_side_region && top_side_region->hasAttribute("text_content")) top_text_margin = true;
-  if (top_side_region && top_side_region->hasAttribute("text_is_title"))
-    top_text_is_title = top_text_margin && static_cast<int>(top_side_region->getAttribute("text_is_title"));
+  if (left_side_region && left_side_region->hasAttribute(GRM::Attr::text_content)) left_text_margin = true;
+  if (right_side_region && right_side_region->hasAttribute(GRM::Attr::text_content)) right_text_margin = true;
+  if (bottom_side_region && bottom_side_region->hasAttribute(GRM::Attr::text_content)) bottom_text_margin = true;
+  if (top_side_region && top_side_region->hasAttribute(GRM::Attr::text_content)) top_text_margin = true;
+  if (top_side_region && top_side_region->hasAttribute(GRM::Attr::text_is_title))
+    top_text_is_title = top_text_margin && static_cast<int>(top_side_region->getAttribute(GRM::Attr::text_is_title));
 
   for (const auto &series : element->children())
     {
@@ -801,7 +814,7 @@ static void calculateCentralRegionMarginOrDiagFactor(const std::shared_ptr<GRM::
 
   GRM::Render::getFigureSize(nullptr, nullptr, &metric_width, &metric_height);
   aspect_ratio_ws = metric_width / metric_height;
-  start_aspect_ratio_ws = static_cast<double>(plot_parent->getAttribute("_start_aspect_ratio"));
+  start_aspect_ratio_ws = static_cast<double>(plot_parent->getAttribute(GRM::Attr::_start_aspect_ratio));
 
   if (keep_aspect_ratio && (!only_quadratic_aspect_ratio || (only_quadratic_aspect_ratio && !uniform_data)) &&
       !diag_factor && kind != "imshow")
@@ -960,20 +973,20 @@ static void calculateCentralRegionMarginOrDiagFactor(const std::shared_ptr<GRM::
     {
       double w, h;
       int location = PLOT_DEFAULT_LOCATION;
-      if (element->hasAttribute("location"))
+      if (element->hasAttribute(GRM::Attr::location))
         {
-          if (element->getAttribute("location").isInt())
+          if (element->getAttribute(GRM::Attr::location).isInt())
             {
-              location = static_cast<int>(element->getAttribute("location"));
+              location = static_cast<int>(element->getAttribute(GRM::Attr::location));
             }
-          else if (element->getAttribute("location").isString())
+          else if (element->getAttribute(GRM::Attr::location).isString())
             {
-              location = locationStringToInt(static_cast<std::string>(element->getAttribute("location")));
+              location = locationStringToInt(static_cast<std::string>(element->getAttribute(GRM::Attr::location)));
             }
         }
       else
         {
-          element->setAttribute("location", location);
+          element->setAttribute(GRM::Attr::location, location);
         }
 
       if (location == 11 || location == 12 || location == 13)
@@ -1021,21 +1034,21 @@ static void setViewportForSideRegionElements(const std::shared_ptr<GRM::Element>
   central_region = plot_parent->querySelectors("central_region");
   if (element->localName() != "side_region") side_region = element->parentElement();
 
-  viewport[0] = static_cast<double>(central_region->getAttribute("_viewport_x_min_org"));
-  viewport[1] = static_cast<double>(central_region->getAttribute("_viewport_x_max_org"));
-  viewport[2] = static_cast<double>(central_region->getAttribute("_viewport_y_min_org"));
-  viewport[3] = static_cast<double>(central_region->getAttribute("_viewport_y_max_org"));
-  keep_aspect_ratio = static_cast<int>(plot_parent->getAttribute("keep_aspect_ratio"));
-  only_quadratic_aspect_ratio = static_cast<int>(plot_parent->getAttribute("only_quadratic_aspect_ratio"));
-  start_aspect_ratio_ws = static_cast<double>(plot_parent->getAttribute("_start_aspect_ratio"));
-  location = static_cast<std::string>(side_region->getAttribute("location"));
+  viewport[0] = static_cast<double>(central_region->getAttribute(GRM::Attr::_viewport_x_min_org));
+  viewport[1] = static_cast<double>(central_region->getAttribute(GRM::Attr::_viewport_x_max_org));
+  viewport[2] = static_cast<double>(central_region->getAttribute(GRM::Attr::_viewport_y_min_org));
+  viewport[3] = static_cast<double>(central_region->getAttribute(GRM::Attr::_viewport_y_max_org));
+  keep_aspect_ratio = static_cast<int>(plot_parent->getAttribute(GRM::Attr::keep_aspect_ratio));
+  only_quadratic_aspect_ratio = static_cast<int>(plot_parent->getAttribute(GRM::Attr::only_quadratic_aspect_ratio));
+  start_aspect_ratio_ws = static_cast<double>(plot_parent->getAttribute(GRM::Attr::_start_aspect_ratio));
+  location = static_cast<std::string>(side_region->getAttribute(GRM::Attr::location));
 
   GRM::Render::getFigureSize(nullptr, nullptr, &metric_width, &metric_height);
   auto aspect_ratio_ws = metric_width / metric_height;
   double diag_factor = std::sqrt((viewport[1] - viewport[0]) * (viewport[1] - viewport[0]) +
                                  (viewport[3] - viewport[2]) * (viewport[3] - viewport[2]));
-  if (!element->hasAttribute("_default_diag_factor"))
-    element->setAttribute("_default_diag_factor",
+  if (!element->hasAttribute(GRM::Attr::_default_diag_factor))
+    element->setAttribute(GRM::Attr::_default_diag_factor,
                           ((DEFAULT_ASPECT_RATIO_FOR_SCALING) *
                            (start_aspect_ratio_ws <= 1 ? start_aspect_ratio_ws : (1.0 / start_aspect_ratio_ws))) /
                               diag_factor);
@@ -1043,8 +1056,8 @@ static void setViewportForSideRegionElements(const std::shared_ptr<GRM::Element>
   // special case for keep_aspect_ratio with uniform data which can lead to smaller plots
   if ((keep_aspect_ratio && uniform_data && only_quadratic_aspect_ratio) || !keep_aspect_ratio)
     {
-      if (!element->hasAttribute("_offset_set_by_user")) offset *= DEFAULT_ASPECT_RATIO_FOR_SCALING;
-      if (!element->hasAttribute("_width_set_by_user")) width *= DEFAULT_ASPECT_RATIO_FOR_SCALING;
+      if (!element->hasAttribute(GRM::Attr::_offset_set_by_user)) offset *= DEFAULT_ASPECT_RATIO_FOR_SCALING;
+      if (!element->hasAttribute(GRM::Attr::_width_set_by_user)) width *= DEFAULT_ASPECT_RATIO_FOR_SCALING;
       if (aspect_ratio_ws <= 1)
         {
           offset_rel = offset * aspect_ratio_ws;
@@ -1058,7 +1071,7 @@ static void setViewportForSideRegionElements(const std::shared_ptr<GRM::Element>
     }
   else
     {
-      auto default_diag_factor = static_cast<double>(element->getAttribute("_default_diag_factor"));
+      auto default_diag_factor = static_cast<double>(element->getAttribute(GRM::Attr::_default_diag_factor));
       offset_rel = offset * diag_factor * default_diag_factor;
       width_rel = width * diag_factor * default_diag_factor;
     }
@@ -1068,40 +1081,40 @@ static void setViewportForSideRegionElements(const std::shared_ptr<GRM::Element>
       max_vp = getMaxViewport(element, true);
       global_render->setViewport(element, viewport[1] + offset_rel,
                                  grm_min(viewport[1] + offset_rel + width_rel, max_vp), viewport[2], viewport[3]);
-      element->setAttribute("_viewport_x_min_org", viewport[1] + offset_rel);
-      element->setAttribute("_viewport_x_max_org", grm_min(viewport[1] + offset_rel + width_rel, max_vp));
-      element->setAttribute("_viewport_y_min_org", viewport[2]);
-      element->setAttribute("_viewport_y_max_org", viewport[3]);
+      element->setAttribute(GRM::Attr::_viewport_x_min_org, viewport[1] + offset_rel);
+      element->setAttribute(GRM::Attr::_viewport_x_max_org, grm_min(viewport[1] + offset_rel + width_rel, max_vp));
+      element->setAttribute(GRM::Attr::_viewport_y_min_org, viewport[2]);
+      element->setAttribute(GRM::Attr::_viewport_y_max_org, viewport[3]);
     }
   else if (location == "left")
     {
       min_vp = getMinViewport(element, true);
       global_render->setViewport(element, grm_max(viewport[0] - (offset_rel + width_rel), min_vp), viewport[0],
                                  viewport[2], viewport[3]);
-      element->setAttribute("_viewport_x_min_org", grm_max(viewport[0] - (offset_rel + width_rel), min_vp));
-      element->setAttribute("_viewport_x_max_org", viewport[0]);
-      element->setAttribute("_viewport_y_min_org", viewport[2]);
-      element->setAttribute("_viewport_y_max_org", viewport[3]);
+      element->setAttribute(GRM::Attr::_viewport_x_min_org, grm_max(viewport[0] - (offset_rel + width_rel), min_vp));
+      element->setAttribute(GRM::Attr::_viewport_x_max_org, viewport[0]);
+      element->setAttribute(GRM::Attr::_viewport_y_min_org, viewport[2]);
+      element->setAttribute(GRM::Attr::_viewport_y_max_org, viewport[3]);
     }
   else if (location == "top")
     {
       max_vp = getMaxViewport(element, false);
       global_render->setViewport(element, viewport[0], viewport[1], viewport[3] + offset_rel,
                                  grm_min(viewport[3] + offset_rel + width_rel, max_vp));
-      element->setAttribute("_viewport_x_min_org", viewport[0]);
-      element->setAttribute("_viewport_x_max_org", viewport[1]);
-      element->setAttribute("_viewport_y_min_org", viewport[3] + offset_rel);
-      element->setAttribute("_viewport_y_max_org", grm_min(viewport[3] + offset_rel + width_rel, max_vp));
+      element->setAttribute(GRM::Attr::_viewport_x_min_org, viewport[0]);
+      element->setAttribute(GRM::Attr::_viewport_x_max_org, viewport[1]);
+      element->setAttribute(GRM::Attr::_viewport_y_min_org, viewport[3] + offset_rel);
+      element->setAttribute(GRM::Attr::_viewport_y_max_org, grm_min(viewport[3] + offset_rel + width_rel, max_vp));
     }
   else if (location == "bottom")
     {
       min_vp = getMinViewport(element, false);
       global_render->setViewport(element, viewport[0], viewport[1],
                                  grm_max(viewport[2] - (offset_rel + width_rel), min_vp), viewport[2]);
-      element->setAttribute("_viewport_x_min_org", viewport[0]);
-      element->setAttribute("_viewport_x_max_org", viewport[1]);
-      element->setAttribute("_viewport_y_min_org", grm_max(viewport[2] - (offset_rel + width_rel), min_vp));
-      element->setAttribute("_viewport_y_max_org", viewport[2]);
+      element->setAttribute(GRM::Attr::_viewport_x_min_org, viewport[0]);
+      element->setAttribute(GRM::Attr::_viewport_x_max_org, viewport[1]);
+      element->setAttribute(GRM::Attr::_viewport_y_min_org, grm_max(viewport[2] - (offset_rel + width_rel), min_vp));
+      element->setAttribute(GRM::Attr::_viewport_y_max_org, viewport[2]);
     }
 }
 
@@ -1114,18 +1127,18 @@ static void calculateViewport(const std::shared_ptr<GRM::Element> &element)
       std::shared_ptr<GRM::Element> plot_parent = element;
       getPlotParent(plot_parent);
 
-      vp[0] = static_cast<double>(element->parentElement()->getAttribute("viewport_x_min"));
-      vp[1] = static_cast<double>(element->parentElement()->getAttribute("viewport_x_max"));
-      vp[2] = static_cast<double>(element->parentElement()->getAttribute("viewport_y_min"));
-      vp[3] = static_cast<double>(element->parentElement()->getAttribute("viewport_y_max"));
+      vp[0] = static_cast<double>(element->parentElement()->getAttribute(GRM::Attr::viewport_x_min));
+      vp[1] = static_cast<double>(element->parentElement()->getAttribute(GRM::Attr::viewport_x_max));
+      vp[2] = static_cast<double>(element->parentElement()->getAttribute(GRM::Attr::viewport_y_min));
+      vp[3] = static_cast<double>(element->parentElement()->getAttribute(GRM::Attr::viewport_y_max));
 
       calculateCentralRegionMarginOrDiagFactor(element, &vp[0], &vp[1], &vp[2], &vp[3], false);
 
       render->setViewport(element, vp[0], vp[1], vp[2], vp[3]);
-      element->setAttribute("_viewport_x_min_org", vp[0]);
-      element->setAttribute("_viewport_x_max_org", vp[1]);
-      element->setAttribute("_viewport_y_min_org", vp[2]);
-      element->setAttribute("_viewport_y_max_org", vp[3]);
+      element->setAttribute(GRM::Attr::_viewport_x_min_org, vp[0]);
+      element->setAttribute(GRM::Attr::_viewport_x_max_org, vp[1]);
+      element->setAttribute(GRM::Attr::_viewport_y_min_org, vp[2]);
+      element->setAttribute(GRM::Attr::_viewport_y_max_org, vp[3]);
     }
   else if (element->localName() == "plot")
     {
@@ -1137,19 +1150,19 @@ static void calculateViewport(const std::shared_ptr<GRM::Element> &element)
       /* when grids are being used for layouting the subplot information is stored in the parent of the plot */
       if (element->parentElement()->localName() == "layout_grid_element")
         {
-          vp[0] = static_cast<double>(element->parentElement()->getAttribute("plot_x_min"));
-          vp[1] = static_cast<double>(element->parentElement()->getAttribute("plot_x_max"));
-          vp[2] = static_cast<double>(element->parentElement()->getAttribute("plot_y_min"));
-          vp[3] = static_cast<double>(element->parentElement()->getAttribute("plot_y_max"));
+          vp[0] = static_cast<double>(element->parentElement()->getAttribute(GRM::Attr::plot_x_min));
+          vp[1] = static_cast<double>(element->parentElement()->getAttribute(GRM::Attr::plot_x_max));
+          vp[2] = static_cast<double>(element->parentElement()->getAttribute(GRM::Attr::plot_y_min));
+          vp[3] = static_cast<double>(element->parentElement()->getAttribute(GRM::Attr::plot_y_max));
         }
       else
         {
-          vp[0] = static_cast<double>(element->getAttribute("plot_x_min"));
-          vp[1] = static_cast<double>(element->getAttribute("plot_x_max"));
-          vp[2] = static_cast<double>(element->getAttribute("plot_y_min"));
-          vp[3] = static_cast<double>(element->getAttribute("plot_y_max"));
+          vp[0] = static_cast<double>(element->getAttribute(GRM::Attr::plot_x_min));
+          vp[1] = static_cast<double>(element->getAttribute(GRM::Attr::plot_x_max));
+          vp[2] = static_cast<double>(element->getAttribute(GRM::Attr::plot_y_min));
+          vp[3] = static_cast<double>(element->getAttribute(GRM::Attr::plot_y_max));
         }
-      kind = static_cast<std::string>(element->getAttribute("kind"));
+      kind = static_cast<std::string>(element->getAttribute(GRM::Attr::kind));
 
       GRM::Render::getFigureSize(nullptr, nullptr, &metric_width, &metric_height);
       aspect_ratio_ws = metric_width / metric_height;
@@ -1163,13 +1176,14 @@ static void calculateViewport(const std::shared_ptr<GRM::Element> &element)
           vp[0] *= aspect_ratio_ws;
           vp[1] *= aspect_ratio_ws;
         }
-      if (!element->hasAttribute("_start_aspect_ratio")) element->setAttribute("_start_aspect_ratio", aspect_ratio_ws);
+      if (!element->hasAttribute(GRM::Attr::_start_aspect_ratio))
+        element->setAttribute(GRM::Attr::_start_aspect_ratio, aspect_ratio_ws);
 
       render->setViewport(element, vp[0], vp[1], vp[2], vp[3]);
-      element->setAttribute("_viewport_x_min_org", vp[0]);
-      element->setAttribute("_viewport_x_max_org", vp[1]);
-      element->setAttribute("_viewport_y_min_org", vp[2]);
-      element->setAttribute("_viewport_y_max_org", vp[3]);
+      element->setAttribute(GRM::Attr::_viewport_x_min_org, vp[0]);
+      element->setAttribute(GRM::Attr::_viewport_x_max_org, vp[1]);
+      element->setAttribute(GRM::Attr::_viewport_y_min_org, vp[2]);
+      element->setAttribute(GRM::Attr::_viewport_y_max_org, vp[3]);
     }
   else if (element->localName() == "side_region")
     {
@@ -1184,20 +1198,21 @@ static void calculateViewport(const std::shared_ptr<GRM::Element> &element)
       auto plot_parent = element;
       getPlotParent(plot_parent);
 
-      if (element->hasAttribute("location")) location = static_cast<std::string>(element->getAttribute("location"));
+      if (element->hasAttribute(GRM::Attr::location))
+        location = static_cast<std::string>(element->getAttribute(GRM::Attr::location));
 
       // is set cause processElement is run for every Element even when only attributes gets processed; so the
       // calculateViewport call from the plot element which causes the calculation of the central_region viewport is
       // also processed
-      plot_viewport[0] = static_cast<double>(plot_parent->getAttribute("plot_x_min"));
-      plot_viewport[1] = static_cast<double>(plot_parent->getAttribute("plot_x_max"));
+      plot_viewport[0] = static_cast<double>(plot_parent->getAttribute(GRM::Attr::plot_x_min));
+      plot_viewport[1] = static_cast<double>(plot_parent->getAttribute(GRM::Attr::plot_x_max));
       plot_viewport[2] =
-          static_cast<double>(plot_parent->getAttribute("plot_y_min")) / (DEFAULT_ASPECT_RATIO_FOR_SCALING);
+          static_cast<double>(plot_parent->getAttribute(GRM::Attr::plot_y_min)) / (DEFAULT_ASPECT_RATIO_FOR_SCALING);
       plot_viewport[3] =
-          static_cast<double>(plot_parent->getAttribute("plot_y_max")) / (DEFAULT_ASPECT_RATIO_FOR_SCALING);
-      keep_aspect_ratio = static_cast<int>(plot_parent->getAttribute("keep_aspect_ratio"));
-      only_quadratic_aspect_ratio = static_cast<int>(plot_parent->getAttribute("only_quadratic_aspect_ratio"));
-      kind = static_cast<std::string>(plot_parent->getAttribute("kind"));
+          static_cast<double>(plot_parent->getAttribute(GRM::Attr::plot_y_max)) / (DEFAULT_ASPECT_RATIO_FOR_SCALING);
+      keep_aspect_ratio = static_cast<int>(plot_parent->getAttribute(GRM::Attr::keep_aspect_ratio));
+      only_quadratic_aspect_ratio = static_cast<int>(plot_parent->getAttribute(GRM::Attr::only_quadratic_aspect_ratio));
+      kind = static_cast<std::string>(plot_parent->getAttribute(GRM::Attr::kind));
 
       if (keep_aspect_ratio && only_quadratic_aspect_ratio)
         {
@@ -1218,43 +1233,43 @@ static void calculateViewport(const std::shared_ptr<GRM::Element> &element)
             }
         }
 
-      if (element->hasAttribute("offset") && !element->hasAttribute("marginal_heatmap_side_plot"))
-        offset = static_cast<double>(element->getAttribute("offset"));
-      if (element->hasAttribute("width") && !element->hasAttribute("marginal_heatmap_side_plot"))
-        width = static_cast<double>(element->getAttribute("width"));
+      if (element->hasAttribute(GRM::Attr::offset) && !element->hasAttribute(GRM::Attr::marginal_heatmap_side_plot))
+        offset = static_cast<double>(element->getAttribute(GRM::Attr::offset));
+      if (element->hasAttribute(GRM::Attr::width) && !element->hasAttribute(GRM::Attr::marginal_heatmap_side_plot))
+        width = static_cast<double>(element->getAttribute(GRM::Attr::width));
 
       // side_region only has a text_region child - no offset or width is needed
       if (element->querySelectors("side_plot_region") == nullptr &&
-          !element->hasAttribute("marginal_heatmap_side_plot"))
+          !element->hasAttribute(GRM::Attr::marginal_heatmap_side_plot))
         {
           offset = 0.0;
           width = 0.0;
         }
 
-      if (!element->hasAttribute("_offset_set_by_user")) element->setAttribute("offset", offset);
-      if (!element->hasAttribute("_width_set_by_user")) element->setAttribute("width", width);
+      if (!element->hasAttribute(GRM::Attr::_offset_set_by_user)) element->setAttribute(GRM::Attr::offset, offset);
+      if (!element->hasAttribute(GRM::Attr::_width_set_by_user)) element->setAttribute(GRM::Attr::width, width);
 
       // apply text width to the side_region
       if (kind != "imshow")
         {
-          if (location == "top" && element->hasAttribute("text_content") &&
-              !element->hasAttribute("marginal_heatmap_side_plot"))
+          if (location == "top" && element->hasAttribute(GRM::Attr::text_content) &&
+              !element->hasAttribute(GRM::Attr::marginal_heatmap_side_plot))
             {
-              width += (0.025 + ((element->hasAttribute("text_is_title") &&
-                                  static_cast<int>(element->getAttribute("text_is_title")))
+              width += (0.025 + ((element->hasAttribute(GRM::Attr::text_is_title) &&
+                                  static_cast<int>(element->getAttribute(GRM::Attr::text_is_title)))
                                      ? 0.075
                                      : 0.05)) *
                        (plot_viewport[3] - plot_viewport[2]);
             }
-          if (location == "left" && element->hasAttribute("text_content"))
+          if (location == "left" && element->hasAttribute(GRM::Attr::text_content))
             {
               width += (0.075 + 0.05) * (plot_viewport[1] - plot_viewport[0]);
             }
-          if (location == "bottom" && element->hasAttribute("text_content"))
+          if (location == "bottom" && element->hasAttribute(GRM::Attr::text_content))
             {
               width += (0.075 + 0.05) * (plot_viewport[3] - plot_viewport[2]);
             }
-          if (location == "right" && element->hasAttribute("text_content"))
+          if (location == "right" && element->hasAttribute(GRM::Attr::text_content))
             {
               width += (0.075 + 0.05) * (plot_viewport[1] - plot_viewport[0]);
             }
@@ -1270,32 +1285,33 @@ static void calculateViewport(const std::shared_ptr<GRM::Element> &element)
       auto plot_parent = element;
       getPlotParent(plot_parent);
 
-      plot_viewport[0] = static_cast<double>(plot_parent->getAttribute("plot_x_min"));
-      plot_viewport[1] = static_cast<double>(plot_parent->getAttribute("plot_x_max"));
+      plot_viewport[0] = static_cast<double>(plot_parent->getAttribute(GRM::Attr::plot_x_min));
+      plot_viewport[1] = static_cast<double>(plot_parent->getAttribute(GRM::Attr::plot_x_max));
       plot_viewport[2] =
-          static_cast<double>(plot_parent->getAttribute("plot_y_min")) / (DEFAULT_ASPECT_RATIO_FOR_SCALING);
+          static_cast<double>(plot_parent->getAttribute(GRM::Attr::plot_y_min)) / (DEFAULT_ASPECT_RATIO_FOR_SCALING);
       plot_viewport[3] =
-          static_cast<double>(plot_parent->getAttribute("plot_y_max")) / (DEFAULT_ASPECT_RATIO_FOR_SCALING);
-      location = static_cast<std::string>(element->parentElement()->getAttribute("location"));
-      kind = static_cast<std::string>(plot_parent->getAttribute("kind"));
+          static_cast<double>(plot_parent->getAttribute(GRM::Attr::plot_y_max)) / (DEFAULT_ASPECT_RATIO_FOR_SCALING);
+      location = static_cast<std::string>(element->parentElement()->getAttribute(GRM::Attr::location));
+      kind = static_cast<std::string>(plot_parent->getAttribute(GRM::Attr::kind));
 
       // apply text width to the side_region
       if (kind != "imshow")
         {
           if (location == "top")
             {
-              if (!element->parentElement()->hasAttribute("marginal_heatmap_side_plot"))
+              if (!element->parentElement()->hasAttribute(GRM::Attr::marginal_heatmap_side_plot))
                 {
-                  width += (0.025 + ((element->parentElement()->hasAttribute("text_is_title") &&
-                                      static_cast<int>(element->parentElement()->getAttribute("text_is_title")))
+                  width += (0.025 + ((element->parentElement()->hasAttribute(GRM::Attr::text_is_title) &&
+                                      static_cast<int>(
+                                          element->parentElement()->getAttribute(GRM::Attr::text_is_title)))
                                          ? 0.075
                                          : 0.05)) *
                            (plot_viewport[3] - plot_viewport[2]);
                 }
-              if (element->parentElement()->hasAttribute("offset"))
-                offset = static_cast<double>(element->parentElement()->getAttribute("offset"));
-              if (element->parentElement()->hasAttribute("width"))
-                offset += static_cast<double>(element->parentElement()->getAttribute("width"));
+              if (element->parentElement()->hasAttribute(GRM::Attr::offset))
+                offset = static_cast<double>(element->parentElement()->getAttribute(GRM::Attr::offset));
+              if (element->parentElement()->hasAttribute(GRM::Attr::width))
+                offset += static_cast<double>(element->parentElement()->getAttribute(GRM::Attr::width));
             }
           if (location == "left")
             {
@@ -1322,16 +1338,16 @@ static void calculateViewport(const std::shared_ptr<GRM::Element> &element)
       auto plot_parent = element;
       getPlotParent(plot_parent);
 
-      plot_viewport[0] = static_cast<double>(plot_parent->getAttribute("plot_x_min"));
-      plot_viewport[1] = static_cast<double>(plot_parent->getAttribute("plot_x_max"));
+      plot_viewport[0] = static_cast<double>(plot_parent->getAttribute(GRM::Attr::plot_x_min));
+      plot_viewport[1] = static_cast<double>(plot_parent->getAttribute(GRM::Attr::plot_x_max));
       plot_viewport[2] =
-          static_cast<double>(plot_parent->getAttribute("plot_y_min")) / (DEFAULT_ASPECT_RATIO_FOR_SCALING);
+          static_cast<double>(plot_parent->getAttribute(GRM::Attr::plot_y_min)) / (DEFAULT_ASPECT_RATIO_FOR_SCALING);
       plot_viewport[3] =
-          static_cast<double>(plot_parent->getAttribute("plot_y_max")) / (DEFAULT_ASPECT_RATIO_FOR_SCALING);
-      location = static_cast<std::string>(element->parentElement()->getAttribute("location"));
-      keep_aspect_ratio = static_cast<int>(plot_parent->getAttribute("keep_aspect_ratio"));
-      only_quadratic_aspect_ratio = static_cast<int>(plot_parent->getAttribute("only_quadratic_aspect_ratio"));
-      kind = static_cast<std::string>(plot_parent->getAttribute("kind"));
+          static_cast<double>(plot_parent->getAttribute(GRM::Attr::plot_y_max)) / (DEFAULT_ASPECT_RATIO_FOR_SCALING);
+      location = static_cast<std::string>(element->parentElement()->getAttribute(GRM::Attr::location));
+      keep_aspect_ratio = static_cast<int>(plot_parent->getAttribute(GRM::Attr::keep_aspect_ratio));
+      only_quadratic_aspect_ratio = static_cast<int>(plot_parent->getAttribute(GRM::Attr::only_quadratic_aspect_ratio));
+      kind = static_cast<std::string>(plot_parent->getAttribute(GRM::Attr::kind));
 
       if (keep_aspect_ratio && only_quadratic_aspect_ratio)
         {
@@ -1352,36 +1368,36 @@ static void calculateViewport(const std::shared_ptr<GRM::Element> &element)
             }
         }
 
-      if (element->parentElement()->hasAttribute("offset"))
-        offset = static_cast<double>(element->parentElement()->getAttribute("offset"));
-      if (element->parentElement()->hasAttribute("width"))
-        width = static_cast<double>(element->parentElement()->getAttribute("width"));
+      if (element->parentElement()->hasAttribute(GRM::Attr::offset))
+        offset = static_cast<double>(element->parentElement()->getAttribute(GRM::Attr::offset));
+      if (element->parentElement()->hasAttribute(GRM::Attr::width))
+        width = static_cast<double>(element->parentElement()->getAttribute(GRM::Attr::width));
 
       setViewportForSideRegionElements(element, offset, width, false);
     }
   else if (element->localName() == "colorbar") // TODO: adjust this calculation when texts are included in side_region
     {
-      auto vp_x_min = static_cast<double>(element->parentElement()->getAttribute("viewport_x_min"));
-      auto vp_x_max = static_cast<double>(element->parentElement()->getAttribute("viewport_x_max"));
-      auto vp_y_min = static_cast<double>(element->parentElement()->getAttribute("viewport_y_min"));
-      auto vp_y_max = static_cast<double>(element->parentElement()->getAttribute("viewport_y_max"));
+      auto vp_x_min = static_cast<double>(element->parentElement()->getAttribute(GRM::Attr::viewport_x_min));
+      auto vp_x_max = static_cast<double>(element->parentElement()->getAttribute(GRM::Attr::viewport_x_max));
+      auto vp_y_min = static_cast<double>(element->parentElement()->getAttribute(GRM::Attr::viewport_y_min));
+      auto vp_y_max = static_cast<double>(element->parentElement()->getAttribute(GRM::Attr::viewport_y_max));
       render->setViewport(element, vp_x_min, vp_x_max, vp_y_min, vp_y_max);
-      element->setAttribute("_viewport_x_min_org", vp_x_min);
-      element->setAttribute("_viewport_x_max_org", vp_x_max);
-      element->setAttribute("_viewport_y_min_org", vp_y_min);
-      element->setAttribute("_viewport_y_max_org", vp_y_max);
+      element->setAttribute(GRM::Attr::_viewport_x_min_org, vp_x_min);
+      element->setAttribute(GRM::Attr::_viewport_x_max_org, vp_x_max);
+      element->setAttribute(GRM::Attr::_viewport_y_min_org, vp_y_min);
+      element->setAttribute(GRM::Attr::_viewport_y_max_org, vp_y_max);
     }
   else if (element->localName() == "marginal_heatmap_plot")
     {
-      auto vp_x_min = static_cast<double>(element->parentElement()->getAttribute("viewport_x_min"));
-      auto vp_x_max = static_cast<double>(element->parentElement()->getAttribute("viewport_x_max"));
-      auto vp_y_min = static_cast<double>(element->parentElement()->getAttribute("viewport_y_min"));
-      auto vp_y_max = static_cast<double>(element->parentElement()->getAttribute("viewport_y_max"));
+      auto vp_x_min = static_cast<double>(element->parentElement()->getAttribute(GRM::Attr::viewport_x_min));
+      auto vp_x_max = static_cast<double>(element->parentElement()->getAttribute(GRM::Attr::viewport_x_max));
+      auto vp_y_min = static_cast<double>(element->parentElement()->getAttribute(GRM::Attr::viewport_y_min));
+      auto vp_y_max = static_cast<double>(element->parentElement()->getAttribute(GRM::Attr::viewport_y_max));
       render->setViewport(element, vp_x_min, vp_x_max, vp_y_min, vp_y_max);
-      element->setAttribute("_viewport_x_min_org", vp_x_min);
-      element->setAttribute("_viewport_x_max_org", vp_x_max);
-      element->setAttribute("_viewport_y_min_org", vp_y_min);
-      element->setAttribute("_viewport_y_max_org", vp_y_max);
+      element->setAttribute(GRM::Attr::_viewport_x_min_org, vp_x_min);
+      element->setAttribute(GRM::Attr::_viewport_x_max_org, vp_x_max);
+      element->setAttribute(GRM::Attr::_viewport_y_min_org, vp_y_min);
+      element->setAttribute(GRM::Attr::_viewport_y_max_org, vp_y_max);
     }
   else if (element->localName() == "legend")
     {
@@ -1391,7 +1407,7 @@ static void calculateViewport(const std::shared_ptr<GRM::Element> &element)
       double vp_x_min, vp_x_max, vp_y_min, vp_y_max;
       double scale_factor = 1.0, start_aspect_ratio_ws;
       const std::shared_ptr<GRM::Context> &context = render->getContext();
-      std::string kind, labels_key = static_cast<std::string>(element->getAttribute("labels"));
+      std::string kind, labels_key = static_cast<std::string>(element->getAttribute(GRM::Attr::labels));
       auto labels = GRM::get<std::vector<std::string>>((*context)[labels_key]);
       std::shared_ptr<GRM::Element> central_region;
       bool keep_aspect_ratio = false;
@@ -1405,29 +1421,30 @@ static void calculateViewport(const std::shared_ptr<GRM::Element> &element)
             }
         }
 
-      viewport[0] = static_cast<double>(central_region->getAttribute("_viewport_x_min_org"));
-      viewport[1] = static_cast<double>(central_region->getAttribute("_viewport_x_max_org"));
-      viewport[2] = static_cast<double>(central_region->getAttribute("_viewport_y_min_org"));
-      viewport[3] = static_cast<double>(central_region->getAttribute("_viewport_y_max_org"));
+      viewport[0] = static_cast<double>(central_region->getAttribute(GRM::Attr::_viewport_x_min_org));
+      viewport[1] = static_cast<double>(central_region->getAttribute(GRM::Attr::_viewport_x_max_org));
+      viewport[2] = static_cast<double>(central_region->getAttribute(GRM::Attr::_viewport_y_min_org));
+      viewport[3] = static_cast<double>(central_region->getAttribute(GRM::Attr::_viewport_y_max_org));
 
-      if (element->hasAttribute("location"))
+      if (element->hasAttribute(GRM::Attr::location))
         {
-          if (element->getAttribute("location").isInt())
+          if (element->getAttribute(GRM::Attr::location).isInt())
             {
-              location = static_cast<int>(element->getAttribute("location"));
+              location = static_cast<int>(element->getAttribute(GRM::Attr::location));
             }
-          else if (element->getAttribute("location").isString())
+          else if (element->getAttribute(GRM::Attr::location).isString())
             {
-              location = locationStringToInt(static_cast<std::string>(element->getAttribute("location")));
+              location = locationStringToInt(static_cast<std::string>(element->getAttribute(GRM::Attr::location)));
             }
         }
       else
         {
-          element->setAttribute("location", location);
+          element->setAttribute(GRM::Attr::location, location);
         }
-      keep_aspect_ratio = static_cast<int>(element->parentElement()->getAttribute("keep_aspect_ratio"));
-      start_aspect_ratio_ws = static_cast<double>(element->parentElement()->getAttribute("_start_aspect_ratio"));
-      kind = static_cast<std::string>(element->parentElement()->getAttribute("kind"));
+      keep_aspect_ratio = static_cast<int>(element->parentElement()->getAttribute(GRM::Attr::keep_aspect_ratio));
+      start_aspect_ratio_ws =
+          static_cast<double>(element->parentElement()->getAttribute(GRM::Attr::_start_aspect_ratio));
+      kind = static_cast<std::string>(element->parentElement()->getAttribute(GRM::Attr::kind));
 
       if (!keep_aspect_ratio)
         {
@@ -1442,36 +1459,36 @@ static void calculateViewport(const std::shared_ptr<GRM::Element> &element)
         {
           double diag_factor = std::sqrt((viewport[1] - viewport[0]) * (viewport[1] - viewport[0]) +
                                          (viewport[3] - viewport[2]) * (viewport[3] - viewport[2]));
-          if (!element->hasAttribute("_default_diag_factor"))
+          if (!element->hasAttribute(GRM::Attr::_default_diag_factor))
             element->setAttribute(
                 "_default_diag_factor",
                 ((DEFAULT_ASPECT_RATIO_FOR_SCALING) *
                  (start_aspect_ratio_ws <= 1 ? start_aspect_ratio_ws : (1.0 / start_aspect_ratio_ws))) /
                     diag_factor);
-          auto default_diag_factor = static_cast<double>(element->getAttribute("_default_diag_factor"));
+          auto default_diag_factor = static_cast<double>(element->getAttribute(GRM::Attr::_default_diag_factor));
 
           scale_factor = diag_factor * default_diag_factor;
         }
-      element->setAttribute("_scale_factor", scale_factor);
+      element->setAttribute(GRM::Attr::_scale_factor, scale_factor);
 
       if (kind != "pie")
         {
           legendSize(labels, &w, &h);
-          if (element->hasAttribute("_start_w"))
+          if (element->hasAttribute(GRM::Attr::_start_w))
             {
-              w = static_cast<double>(element->getAttribute("_start_w"));
+              w = static_cast<double>(element->getAttribute(GRM::Attr::_start_w));
             }
           else
             {
-              element->setAttribute("_start_w", w);
+              element->setAttribute(GRM::Attr::_start_w, w);
             }
-          if (element->hasAttribute("_start_h"))
+          if (element->hasAttribute(GRM::Attr::_start_h))
             {
-              h = static_cast<double>(element->getAttribute("_start_h"));
+              h = static_cast<double>(element->getAttribute(GRM::Attr::_start_h));
             }
           else
             {
-              element->setAttribute("_start_h", h);
+              element->setAttribute(GRM::Attr::_start_h, h);
             }
 
           if (int_equals_any(location, 3, 11, 12, 13))
@@ -1530,21 +1547,21 @@ static void calculateViewport(const std::shared_ptr<GRM::Element> &element)
             }
           w += num_labels * 0.03 + (num_labels - 1) * 0.02;
 
-          if (element->hasAttribute("_start_w"))
+          if (element->hasAttribute(GRM::Attr::_start_w))
             {
-              w = static_cast<double>(element->getAttribute("_start_w"));
+              w = static_cast<double>(element->getAttribute(GRM::Attr::_start_w));
             }
           else
             {
-              element->setAttribute("_start_w", w);
+              element->setAttribute(GRM::Attr::_start_w, w);
             }
-          if (element->hasAttribute("_start_h"))
+          if (element->hasAttribute(GRM::Attr::_start_h))
             {
-              h = static_cast<double>(element->getAttribute("_start_h"));
+              h = static_cast<double>(element->getAttribute(GRM::Attr::_start_h));
             }
           else
             {
-              element->setAttribute("_start_h", h);
+              element->setAttribute(GRM::Attr::_start_h, h);
             }
 
           px = 0.5 * (viewport[0] + viewport[1] - w * scale_factor);
@@ -1557,10 +1574,10 @@ static void calculateViewport(const std::shared_ptr<GRM::Element> &element)
         }
 
       render->setViewport(element, vp_x_min, vp_x_max, vp_y_min, vp_y_max);
-      element->setAttribute("_viewport_x_min_org", vp_x_min);
-      element->setAttribute("_viewport_x_max_org", vp_x_max);
-      element->setAttribute("_viewport_y_min_org", vp_y_min);
-      element->setAttribute("_viewport_y_max_org", vp_y_max);
+      element->setAttribute(GRM::Attr::_viewport_x_min_org, vp_x_min);
+      element->setAttribute(GRM::Attr::_viewport_x_max_org, vp_x_max);
+      element->setAttribute(GRM::Attr::_viewport_y_min_org, vp_y_min);
+      element->setAttribute(GRM::Attr::_viewport_y_max_org, vp_y_max);
     }
   GRM::Render::processViewport(element);
 }
@@ -1572,8 +1589,8 @@ static void applyMoveTransformation(const std::shared_ptr<GRM::Element> &element
   double x_scale = 1, y_scale = 1;
   bool disable_x_trans = false, disable_y_trans = false, any_xform = false; // only for wc
   std::shared_ptr<GRM::Element> parent_element = element->parentElement();
-  std::string post_fix = "_wc";
-  std::vector<std::string> ndc_transformation_elems = {
+  bool ndc_transformation = false;
+  static const std::vector<std::string> ndc_transformation_elems = {
       "figure",
       "plot",
       "colorbar",
@@ -1591,80 +1608,85 @@ static void applyMoveTransformation(const std::shared_ptr<GRM::Element> &element
 
   if (std::find(ndc_transformation_elems.begin(), ndc_transformation_elems.end(), element->localName()) !=
       ndc_transformation_elems.end())
-    post_fix = "_ndc";
+    ndc_transformation = true;
+
+  auto x_scale_attr = ndc_transformation ? GRM::Attr::x_scale_ndc : GRM::Attr::x_scale_wc;
+  auto y_scale_attr = ndc_transformation ? GRM::Attr::y_scale_ndc : GRM::Attr::y_scale_wc;
+  auto x_shift_attr = ndc_transformation ? GRM::Attr::x_shift_ndc : GRM::Attr::x_shift_wc;
+  auto y_shift_attr = ndc_transformation ? GRM::Attr::y_shift_ndc : GRM::Attr::y_shift_wc;
 
-  if (element->hasAttribute("x_scale" + post_fix))
+  if (element->hasAttribute(x_scale_attr))
     {
-      x_scale = static_cast<double>(element->getAttribute("x_scale" + post_fix));
+      x_scale = static_cast<double>(element->getAttribute(x_scale_attr));
       any_xform = true;
     }
-  if (element->hasAttribute("y_scale" + post_fix))
+  if (element->hasAttribute(y_scale_attr))
     {
-      y_scale = static_cast<double>(element->getAttribute("y_scale" + post_fix));
+      y_scale = static_cast<double>(element->getAttribute(y_scale_attr));
       any_xform = true;
     }
-  if (element->hasAttribute("x_shift" + post_fix))
+  if (element->hasAttribute(x_shift_attr))
     {
-      x_shift = static_cast<double>(element->getAttribute("x_shift" + post_fix));
+      x_shift = static_cast<double>(element->getAttribute(x_shift_attr));
       any_xform = true;
     }
-  if (element->hasAttribute("y_shift" + post_fix))
+  if (element->hasAttribute(y_shift_attr))
     {
-      y_shift = static_cast<double>(element->getAttribute("y_shift" + post_fix));
+      y_shift = static_cast<double>(element->getAttribute(y_shift_attr));
       any_xform = true;
     }
-  if (element->hasAttribute("disable_x_trans"))
-    disable_x_trans = static_cast<int>(element->getAttribute("disable_x_trans"));
-  if (element->hasAttribute("disable_y_trans"))
-    disable_y_trans = static_cast<int>(element->getAttribute("disable_y_trans"));
+  if (element->hasAttribute(GRM::Attr::disable_x_trans))
+    disable_x_trans = static_cast<int>(element->getAttribute(GRM::Attr::disable_x_trans));
+  if (element->hasAttribute(GRM::Attr::disable_y_trans))
+    disable_y_trans = static_cast<int>(element->getAttribute(GRM::Attr::disable_y_trans));
 
   // get parent transformation when an element doesn't have an own in wc case
-  if (!any_xform && post_fix == "_wc")
+  if (!any_xform && !ndc_transformation)
     {
       while (parent_element->localName() != "root" && !any_xform)
         {
-          if (parent_element->hasAttribute("x_scale" + post_fix))
+          if (parent_element->hasAttribute(x_scale_attr))
             {
-              x_scale = static_cast<double>(parent_element->getAttribute("x_scale" + post_fix));
+              x_scale = static_cast<double>(parent_element->getAttribute(x_scale_attr));
               any_xform = true;
             }
-          if (parent_element->hasAttribute("y_scale" + post_fix))
+          if (parent_element->hasAttribute(y_scale_attr))
             {
-              y_scale = static_cast<double>(parent_element->getAttribute("y_scale" + post_fix));
+              y_scale = static_cast<double>(parent_element->getAttribute(y_scale_attr));
               any_xform = true;
             }
-          if (parent_element->hasAttribute("x_shift" + post_fix))
+          if (parent_element->hasAttribute(x_shift_attr))
             {
-              x_shift = static_cast<double>(parent_element->getAttribute("x_shift" + post_fix));
+              x_shift = static_cast<double>(parent_element->getAttribute(x_shift_attr));
               any_xform = true;
             }
-          if (parent_element->hasAttribute("y_shift" + post_fix))
+          if (parent_element->hasAttribute(y_shift_attr))
             {
-              y_shift = static_cast<double>(parent_element->getAttribute("y_shift" + post_fix));
+              y_shift = static_cast<double>(parent_element->getAttribute(y_shift_attr));
               any_xform = true;
             }
-          if (parent_element->hasAttribute("disable_x_trans"))
-            disable_x_trans = static_cast<int>(parent_element->getAttribute("disable_x_trans"));
-          if (parent_element->hasAttribute("disable_y_trans"))
-            disable_y_trans = static_cast<int>(parent_element->getAttribute("disable_y_trans"));
+          if (parent_element->hasAttribute(GRM::Attr::disable_x_trans))
+            disable_x_trans = static_cast<int>(parent_element->getAttribute(GRM::Attr::disable_x_trans));
+          if (parent_element->hasAttribute(GRM::Attr::disable_y_trans))
+            disable_y_trans = static_cast<int>(parent_element->getAttribute(GRM::Attr::disable_y_trans));
 
           parent_element = parent_element->parentElement();
         }
     }
 
-  if (post_fix == "_ndc")
+  if (ndc_transformation)
     {
       // elements in ndc space gets transformed in ndc space which is equal to changing their viewport
       double diff;
       double vp_border_x_min = 0.0, vp_border_x_max, vp_border_y_min = 0.0, vp_border_y_max;
       bool private_shift = false;
 
-      if (element->hasAttribute("viewport_x_min"))
+      if (element->hasAttribute(GRM::Attr::viewport_x_min))
         {
-          vp_org[0] = static_cast<double>(element->getAttribute("_viewport_x_min_org"));
-          vp_org[1] = static_cast<double>(element->getAttribute("_viewport_x_max_org"));
-          vp_org[2] = static_cast<double>(element->getAttribute("_viewport_y_min_org"));
-          vp_org[3] = static_cast<double>(element->getAttribute("_viewport_y_max_org"));
+          vp_org[0] = static_cast<double>(element->getAttribute(GRM::Attr::_viewport_x_min_org));
+          vp_org[1] = static_cast<double>(element->getAttribute(GRM::Attr::_viewport_x_max_org));
+          vp_org[2] = static_cast<double>(element->getAttribute(GRM::Attr::_viewport_y_min_org));
+          vp_org[3] = static_cast<double>(element->getAttribute(GRM::Attr::_viewport_y_max_org));
         }
       else
         {
@@ -1672,24 +1694,24 @@ static void applyMoveTransformation(const std::shared_ptr<GRM::Element> &element
         }
 
       // apply viewport changes defined by the user via setAttribute first
-      if (element->hasAttribute("_x_min_shift"))
+      if (element->hasAttribute(GRM::Attr::_x_min_shift))
         {
-          vp_org[0] += static_cast<double>(element->getAttribute("_x_min_shift"));
+          vp_org[0] += static_cast<double>(element->getAttribute(GRM::Attr::_x_min_shift));
           private_shift = true;
         }
-      if (element->hasAttribute("_x_max_shift"))
+      if (element->hasAttribute(GRM::Attr::_x_max_shift))
         {
-          vp_org[1] += static_cast<double>(element->getAttribute("_x_max_shift"));
+          vp_org[1] += static_cast<double>(element->getAttribute(GRM::Attr::_x_max_shift));
           private_shift = true;
         }
-      if (element->hasAttribute("_y_min_shift"))
+      if (element->hasAttribute(GRM::Attr::_y_min_shift))
         {
-          vp_org[2] += static_cast<double>(element->getAttribute("_y_min_shift"));
+          vp_org[2] += static_cast<double>(element->getAttribute(GRM::Attr::_y_min_shift));
           private_shift = true;
         }
-      if (element->hasAttribute("_y_max_shift"))
+      if (element->hasAttribute(GRM::Attr::_y_max_shift))
         {
-          vp_org[3] += static_cast<double>(element->getAttribute("_y_max_shift"));
+          vp_org[3] += static_cast<double>(element->getAttribute(GRM::Attr::_y_max_shift));
           private_shift = true;
         }
 
@@ -1866,24 +1888,12 @@ PushDrawableToZQueue::PushDrawableToZQueue(
 void PushDrawableToZQueue::operator()(const std::shared_ptr<GRM::Element> &element,
                                       const std::shared_ptr<GRM::Context> &context)
 {
-  int context_id;
-  auto parent = element->parentElement();
-
-  if (auto search = parent_to_context.find(parent); search != parent_to_context.end())
-    {
-      context_id = search->second;
-    }
-  else
-    {
-      context_id = gr_context_id_manager.getUnusedGRContextId();
-      gr_savecontext(context_id);
-      parent_to_context[parent] = context_id;
-    }
-  auto drawable =
-      std::shared_ptr<Drawable>(new Drawable(element, context, context_id, z_index_manager.getZIndex(), drawFunction));
-  drawable->insertionIndex = (int)z_queue.size();
+  int custom_color;
+  gr_inqcolor(PLOT_CUSTOM_COLOR_INDEX, &custom_color);
+  auto context_id = gr_context_id_manager.saveSharedGRContext(element->parentElement(), custom_color);
+  z_queue.emplace_back(element, context, context_id, z_index_manager.getZIndex(), drawFunction);
+  z_queue.back().insertionIndex = (int)z_queue.size() - 1;
   custom_color_index_manager.savecontext(context_id);
-  z_queue.push(drawable);
 }
 
 static double autoTick(double amin, double amax)
@@ -2328,8 +2338,8 @@ static std::shared_ptr<GRM::Element> getSubplotElement(const std::shared_ptr<GRM
 
   while (ancestor->localName() != "figure")
     {
-      bool ancestor_is_subplot_group =
-          (ancestor->hasAttribute("plot_group") && static_cast<int>(ancestor->getAttribute("plot_group")));
+      bool ancestor_is_subplot_group = (ancestor->hasAttribute(GRM::Attr::plot_group) &&
+                                        static_cast<int>(ancestor->getAttribute(GRM::Attr::plot_group)));
       if (ancestor->localName() == "layout_grid_element" || ancestor_is_subplot_group)
         {
           return ancestor;
@@ -2490,7 +2500,7 @@ static void getAxesInformation(const std::shared_ptr<GRM::Element> &element, con
   std::shared_ptr<GRM::Element> central_region, central_region_parent;
 
   auto subplot_element = getSubplotElement(element);
-  auto kind = static_cast<std::string>(subplot_element->getAttribute("kind"));
+  auto kind = static_cast<std::string>(subplot_element->getAttribute(GRM::Attr::kind));
 
   central_region_parent = subplot_element;
   if (kind == "marginal_heatmap") central_region_parent = subplot_element->children()[0];
@@ -2503,11 +2513,11 @@ static void getAxesInformation(const std::shared_ptr<GRM::Element> &element, con
         }
     }
 
-  auto scale = static_cast<int>(subplot_element->getAttribute("scale"));
-  auto xmin = static_cast<double>(central_region->getAttribute("window_x_min"));
-  auto xmax = static_cast<double>(central_region->getAttribute("window_x_max"));
-  auto ymin = static_cast<double>(central_region->getAttribute("window_y_min"));
-  auto ymax = static_cast<double>(central_region->getAttribute("window_y_max"));
+  auto scale = static_cast<int>(subplot_element->getAttribute(GRM::Attr::scale));
+  auto xmin = static_cast<double>(central_region->getAttribute(GRM::Attr::window_x_min));
+  auto xmax = static_cast<double>(central_region->getAttribute(GRM::Attr::window_x_max));
+  auto ymin = static_cast<double>(central_region->getAttribute(GRM::Attr::window_y_min));
+  auto ymax = static_cast<double>(central_region->getAttribute(GRM::Attr::window_y_max));
 
   getMajorCount(element, kind, major_count);
 
@@ -2517,9 +2527,9 @@ static void getAxesInformation(const std::shared_ptr<GRM::Element> &element, con
     }
   else
     {
-      if (element->hasAttribute("x_major"))
+      if (element->hasAttribute(GRM::Attr::x_major))
         {
-          x_major = static_cast<int>(element->getAttribute("x_major"));
+          x_major = static_cast<int>(element->getAttribute(GRM::Attr::x_major));
         }
       else
         {
@@ -2530,10 +2540,10 @@ static void getAxesInformation(const std::shared_ptr<GRM::Element> &element, con
               auto barplots = central_region->querySelectorsAll("series_barplot");
               for (const auto &barplot : barplots)
                 {
-                  if (!barplot->hasAttribute("style") ||
-                      static_cast<std::string>(barplot->getAttribute("style")) == "default")
+                  if (!barplot->hasAttribute(GRM::Attr::style) ||
+                      static_cast<std::string>(barplot->getAttribute(GRM::Attr::style)) == "default")
                     {
-                      auto y_key = static_cast<std::string>(barplot->getAttribute("y"));
+                      auto y_key = static_cast<std::string>(barplot->getAttribute(GRM::Attr::y));
                       std::vector<double> y_vec = GRM::get<std::vector<double>>((*context)[y_key]);
                       if (size(y_vec) > 20)
                         {
@@ -2549,19 +2559,20 @@ static void getAxesInformation(const std::shared_ptr<GRM::Element> &element, con
               x_major = major_count;
             }
         }
-      element->setAttribute("x_major", x_major);
+      element->setAttribute(GRM::Attr::x_major, x_major);
     }
 
   if (scale & GR_OPTION_X_LOG &&
-      !(element->hasAttribute("x_tick") && static_cast<std::string>(element->getAttribute("name")) == "colorbar"))
+      !(element->hasAttribute(GRM::Attr::x_tick) &&
+        static_cast<std::string>(element->getAttribute(GRM::Attr::name)) == "colorbar"))
     {
       x_tick = 1;
     }
   else
     {
-      if (element->hasAttribute("x_tick"))
+      if (element->hasAttribute(GRM::Attr::x_tick))
         {
-          x_tick = static_cast<double>(element->getAttribute("x_tick"));
+          x_tick = static_cast<double>(element->getAttribute(GRM::Attr::x_tick));
         }
       else
         {
@@ -2584,8 +2595,9 @@ static void getAxesInformation(const std::shared_ptr<GRM::Element> &element, con
     }
 
   if (scale & GR_OPTION_FLIP_X &&
-      !(element->hasAttribute("x_org") && (static_cast<std::string>(element->getAttribute("name")) == "colorbar" ||
-                                           element->localName() == "grid" || element->localName() == "grid3d")))
+      !(element->hasAttribute(GRM::Attr::x_org) &&
+        (static_cast<std::string>(element->getAttribute(GRM::Attr::name)) == "colorbar" ||
+         element->localName() == "grid" || element->localName() == "grid3d")))
     {
       x_org_low = xmax;
       x_org_high = xmin;
@@ -2601,9 +2613,9 @@ static void getAxesInformation(const std::shared_ptr<GRM::Element> &element, con
     }
   else
     {
-      if (element->hasAttribute("x_org"))
+      if (element->hasAttribute(GRM::Attr::x_org))
         {
-          x_org = static_cast<double>(element->getAttribute("x_org"));
+          x_org = static_cast<double>(element->getAttribute(GRM::Attr::x_org));
         }
       else
         {
@@ -2627,28 +2639,29 @@ static void getAxesInformation(const std::shared_ptr<GRM::Element> &element, con
     }
   else
     {
-      if (element->hasAttribute("y_major"))
+      if (element->hasAttribute(GRM::Attr::y_major))
         {
-          y_major = static_cast<int>(element->getAttribute("y_major"));
+          y_major = static_cast<int>(element->getAttribute(GRM::Attr::y_major));
         }
       else
         {
           y_major = major_count;
-          element->setAttribute("y_major", y_major);
+          element->setAttribute(GRM::Attr::y_major, y_major);
         }
     }
 
   if (scale & GR_OPTION_Y_LOG &&
-      !((element->localName() == "axes_3d" || static_cast<std::string>(element->getAttribute("name")) == "colorbar") &&
-        element->hasAttribute("y_tick")))
+      !((element->localName() == "axes_3d" ||
+         static_cast<std::string>(element->getAttribute(GRM::Attr::name)) == "colorbar") &&
+        element->hasAttribute(GRM::Attr::y_tick)))
     {
       y_tick = 1;
     }
   else
     {
-      if (element->hasAttribute("y_tick"))
+      if (element->hasAttribute(GRM::Attr::y_tick))
         {
-          y_tick = static_cast<double>(element->getAttribute("y_tick"));
+          y_tick = static_cast<double>(element->getAttribute(GRM::Attr::y_tick));
         }
       else
         {
@@ -2664,8 +2677,9 @@ static void getAxesInformation(const std::shared_ptr<GRM::Element> &element, con
     }
 
   if (scale & GR_OPTION_FLIP_Y &&
-      !(element->hasAttribute("y_org") && (static_cast<std::string>(element->getAttribute("name")) == "colorbar" ||
-                                           element->localName() == "grid" || element->localName() == "grid3d")))
+      !(element->hasAttribute(GRM::Attr::y_org) &&
+        (static_cast<std::string>(element->getAttribute(GRM::Attr::name)) == "colorbar" ||
+         element->localName() == "grid" || element->localName() == "grid3d")))
     {
       y_org_low = ymax;
       y_org_high = ymin;
@@ -2681,9 +2695,9 @@ static void getAxesInformation(const std::shared_ptr<GRM::Element> &element, con
     }
   else
     {
-      if (element->hasAttribute("y_org"))
+      if (element->hasAttribute(GRM::Attr::y_org))
         {
-          y_org = static_cast<double>(element->getAttribute("y_org"));
+          y_org = static_cast<double>(element->getAttribute(GRM::Attr::y_org));
         }
       else
         {
@@ -2816,7 +2830,9 @@ void GRM::Render::getFigureSize(int *pixel_width, int *pixel_height, double *met
   double tmp_size_d[2], metric_size[2];
   int i;
   std::string size_unit, size_type;
-  std::array<std::string, 2> vars = {"x", "y"};
+  std::array<GRM::Attr, 2> size_attrs = {GRM::Attr::size_x, GRM::Attr::size_y};
+  std::array<GRM::Attr, 2> size_unit_attrs = {GRM::Attr::size_x_unit, GRM::Attr::size_y_unit};
+  std::array<GRM::Attr, 2> size_type_attrs = {GRM::Attr::size_x_type, GRM::Attr::size_y_type};
   std::array<double, 2> default_size = {PLOT_DEFAULT_WIDTH, PLOT_DEFAULT_HEIGHT};
   std::shared_ptr<GRM::Element> figure = active_figure;
 
@@ -2834,28 +2850,28 @@ void GRM::Render::getFigureSize(int *pixel_width, int *pixel_height, double *met
   dpi[1] = dpm[1] * 0.0254;
 
   /* TODO: Overwork this calculation */
-  if (figure->hasAttribute("fig_size_x") && figure->hasAttribute("fig_size_y"))
+  if (figure->hasAttribute(GRM::Attr::fig_size_x) && figure->hasAttribute(GRM::Attr::fig_size_y))
     {
-      tmp_size_d[0] = static_cast<double>(figure->getAttribute("fig_size_x"));
-      tmp_size_d[1] = static_cast<double>(figure->getAttribute("fig_size_y"));
+      tmp_size_d[0] = static_cast<double>(figure->getAttribute(GRM::Attr::fig_size_x));
+      tmp_size_d[1] = static_cast<double>(figure->getAttribute(GRM::Attr::fig_size_y));
       for (i = 0; i < 2; ++i)
         {
           pixel_size[i] = (int)grm_round(tmp_size_d[i] * dpi[i]);
           metric_size[i] = tmp_size_d[i] / 0.0254;
         }
     }
-  else if (figure->hasAttribute("size_x") && figure->hasAttribute("size_y"))
+  else if (figure->hasAttribute(GRM::Attr::size_x) && figure->hasAttribute(GRM::Attr::size_y))
     {
       for (i = 0; i < 2; ++i)
         {
-          size_unit = static_cast<std::string>(figure->getAttribute("size_" + vars[i] + "_unit"));
-          size_type = static_cast<std::string>(figure->getAttribute("size_" + vars[i] + "_type"));
+          size_unit = static_cast<std::string>(figure->getAttribute(size_unit_attrs[i]));
+          size_type = static_cast<std::string>(figure->getAttribute(size_type_attrs[i]));
           if (size_unit.empty()) size_unit = "px";
           tmp_size_d[i] = default_size[i];
 
           if (size_type == "double" || size_type == "int")
             {
-              tmp_size_d[i] = static_cast<double>(figure->getAttribute("size_" + vars[i]));
+              tmp_size_d[i] = static_cast<double>(figure->getAttribute(size_attrs[i]));
               auto meters_per_unit_iter = symbol_to_meters_per_unit.find(size_unit);
               if (meters_per_unit_iter != symbol_to_meters_per_unit.end())
                 {
@@ -3002,7 +3018,7 @@ static bool getLimitsForColorbar(const std::shared_ptr<GRM::Element> &element, d
   return limits_found;
 }
 
-static double findMaxStep(unsigned int n, std::vector<double> x)
+static double findMaxStep(unsigned int n, const GRM::DoubleView &x)
 {
   double max_step = 0.0;
   unsigned int i;
@@ -3019,15 +3035,15 @@ static double findMaxStep(unsigned int n, std::vector<double> x)
 }
 
 static void extendErrorBars(const std::shared_ptr<GRM::Element> &element, const std::shared_ptr<GRM::Context> &context,
-                            std::vector<double> x, std::vector<double> y)
+                            GRM::DoubleBuffer x, GRM::DoubleBuffer y)
 {
   auto id = static_cast<int>(global_root->getAttribute("_id"));
   auto str = std::to_string(id);
   global_root->setAttribute("_id", ++id);
 
-  (*context)["x" + str] = x;
+  (*context)["x" + str] = std::move(x);
   element->setAttribute("x", "x" + str);
-  (*context)["y" + str] = y;
+  (*context)["y" + str] = std::move(y);
   element->setAttribute("y", "y" + str);
 }
 
@@ -4763,41 +4779,44 @@ static void processAxis(const std::shared_ptr<GRM::Element> &element, const std:
   del_values del = del_values::update_without_default;
   int scientific_format = SCIENTIFIC_FORMAT_OPTION, scale = 0;
 
-  del = del_values(static_cast<int>(element->getAttribute("_delete_children")));
+  del = del_values(static_cast<int>(element->getAttribute(GRM::Attr::_delete_children)));
   clearOldChildren(&del, element);
   getAxesInformation(element, x_org_pos, y_org_pos, x_org, y_org, x_major, y_major, x_tick, y_tick);
   getPlotParent(plot_parent);
 
-  window[0] = static_cast<double>(element->parentElement()->parentElement()->getAttribute("window_x_min"));
-  window[1] = static_cast<double>(element->parentElement()->parentElement()->getAttribute("window_x_max"));
-  window[2] = static_cast<double>(element->parentElement()->parentElement()->getAttribute("window_y_min"));
-  window[3] = static_cast<double>(element->parentElement()->parentElement()->getAttribute("window_y_max"));
-  if (element->hasAttribute("_window_old_x_min"))
-    old_window[0] = static_cast<double>(element->getAttribute("_window_old_x_min"));
-  if (element->hasAttribute("_window_old_x_max"))
-    old_window[1] = static_cast<double>(element->getAttribute("_window_old_x_max"));
-  if (element->hasAttribute("_window_old_y_min"))
-    old_window[2] = static_cast<double>(element->getAttribute("_window_old_y_min"));
-  if (element->hasAttribute("_window_old_y_max"))
-    old_window[3] = static_cast<double>(element->getAttribute("_window_old_y_max"));
-  element->setAttribute("_window_old_x_min", window[0]);
-  element->setAttribute("_window_old_x_max", window[1]);
-  element->setAttribute("_window_old_y_min", window[2]);
-  element->setAttribute("_window_old_y_max", window[3]);
-
-  kind = static_cast<std::string>(plot_parent->getAttribute("kind"));
-  if (element->hasAttribute("mirrored_axis")) mirrored_axis = static_cast<int>(element->getAttribute("mirrored_axis"));
-  axis_type = static_cast<std::string>(element->getAttribute("axis_type"));
-  if (element->hasAttribute("scientific_format")) // TODO: maybe need to be changed if Du Kim's MR gets merged
-    scientific_format = static_cast<int>(element->getAttribute("scientific_format"));
-  if (plot_parent->hasAttribute("font")) processFont(plot_parent);
-  if (plot_parent->hasAttribute("x_flip")) x_flip = static_cast<int>(plot_parent->getAttribute("x_flip"));
-  if (plot_parent->hasAttribute("y_flip")) y_flip = static_cast<int>(plot_parent->getAttribute("y_flip"));
-
-  if (element->hasAttribute("scale"))
+  window[0] = static_cast<double>(element->parentElement()->parentElement()->getAttribute(GRM::Attr::window_x_min));
+  window[1] = static_cast<double>(element->parentElement()->parentElement()->getAttribute(GRM::Attr::window_x_max));
+  window[2] = static_cast<double>(element->parentElement()->parentElement()->getAttribute(GRM::Attr::window_y_min));
+  window[3] = static_cast<double>(element->parentElement()->parentElement()->getAttribute(GRM::Attr::window_y_max));
+  if (element->hasAttribute(GRM::Attr::_window_old_x_min))
+    old_window[0] = static_cast<double>(element->getAttribute(GRM::Attr::_window_old_x_min));
+  if (element->hasAttribute(GRM::Attr::_window_old_x_max))
+    old_window[1] = static_cast<double>(element->getAttribute(GRM::Attr::_window_old_x_max));
+  if (element->hasAttribute(GRM::Attr::_window_old_y_min))
+    old_window[2] = static_cast<double>(element->getAttribute(GRM::Attr::_window_old_y_min));
+  if (element->hasAttribute(GRM::Attr::_window_old_y_max))
+    old_window[3] = static_cast<double>(element->getAttribute(GRM::Attr::_window_old_y_max));
+  element->setAttribute(GRM::Attr::_window_old_x_min, window[0]);
+  element->setAttribute(GRM::Attr::_window_old_x_max, window[1]);
+  element->setAttribute(GRM::Attr::_window_old_y_min, window[2]);
+  element->setAttribute(GRM::Attr::_window_old_y_max, window[3]);
+
+  kind = static_cast<std::string>(plot_parent->getAttribute(GRM::Attr::kind));
+  if (element->hasAttribute(GRM::Attr::mirrored_axis))
+    mirrored_axis = static_cast<int>(element->getAttribute(GRM::Attr::mirrored_axis));
+  axis_type = static_cast<std::string>(element->getAttribute(GRM::Attr::axis_type));
+  if (element->hasAttribute(GRM::Attr::scientific_format)) // TODO: maybe need to be changed if Du Kim's MR gets merged
+    scientific_format = static_cast<int>(element->getAttribute(GRM::Attr::scientific_format));
+  if (plot_parent->hasAttribute(GRM::Attr::font)) processFont(plot_parent);
+  if (plot_parent->hasAttribute(GRM::Attr::x_flip))
+    x_flip = static_cast<int>(plot_parent->getAttribute(GRM::Attr::x_flip));
+  if (plot_parent->hasAttribute(GRM::Attr::y_flip))
+    y_flip = static_cast<int>(plot_parent->getAttribute(GRM::Attr::y_flip));
+
+  if (element->hasAttribute(GRM::Attr::scale))
     {
       global_render->processScale(element);
-      scale = static_cast<int>(element->getAttribute("scale"));
+      scale = static_cast<int>(element->getAttribute(GRM::Attr::scale));
     }
 
   if (axis_type == "x")
@@ -4824,14 +4843,17 @@ static void processAxis(const std::shared_ptr<GRM::Element> &element, const std:
       (axis_type == "y" && ((std::isnan(old_window[2]) || old_window[2] == window[2]) &&
                             (std::isnan(old_window[3]) || old_window[3] == window[3]))))
     {
-      if (element->hasAttribute("min_value")) min_val = static_cast<double>(element->getAttribute("min_value"));
-      if (element->hasAttribute("max_value")) max_val = static_cast<double>(element->getAttribute("max_value"));
-      if (element->hasAttribute("org")) org = static_cast<double>(element->getAttribute("org"));
-      if (element->hasAttribute("pos")) pos = static_cast<double>(element->getAttribute("pos"));
-      if (element->hasAttribute("tick")) tick = static_cast<double>(element->getAttribute("tick"));
-      if (element->hasAttribute("major_count")) major_count = static_cast<int>(element->getAttribute("major_count"));
-      if (element->hasAttribute("tick_orientation"))
-        tick_orientation = static_cast<int>(element->getAttribute("tick_orientation"));
+      if (element->hasAttribute(GRM::Attr::min_value))
+        min_val = static_cast<double>(element->getAttribute(GRM::Attr::min_value));
+      if (element->hasAttribute(GRM::Attr::max_value))
+        max_val = static_cast<double>(element->getAttribute(GRM::Attr::max_value));
+      if (element->hasAttribute(GRM::Attr::org)) org = static_cast<double>(element->getAttribute(GRM::Attr::org));
+      if (element->hasAttribute(GRM::Attr::pos)) pos = static_cast<double>(element->getAttribute(GRM::Attr::pos));
+      if (element->hasAttribute(GRM::Attr::tick)) tick = static_cast<double>(element->getAttribute(GRM::Attr::tick));
+      if (element->hasAttribute(GRM::Attr::major_count))
+        major_count = static_cast<int>(element->getAttribute(GRM::Attr::major_count));
+      if (element->hasAttribute(GRM::Attr::tick_orientation))
+        tick_orientation = static_cast<int>(element->getAttribute(GRM::Attr::tick_orientation));
     }
 
   // special cases for x- and y-flip
@@ -4871,7 +4893,7 @@ static void processAxis(const std::shared_ptr<GRM::Element> &element, const std:
                                         axis.label_position, axis_elem);
   if (del != del_values::update_without_default)
     {
-      if (!axis_elem->hasAttribute("draw_grid")) axis_elem->setAttribute("draw_grid", true);
+      if (!axis_elem->hasAttribute(GRM::Attr::draw_grid)) axis_elem->setAttribute(GRM::Attr::draw_grid, true);
       if (kind == "barplot")
         {
           bool only_barplot = true;
@@ -4888,13 +4910,14 @@ static void processAxis(const std::shared_ptr<GRM::Element> &element, const std:
 
           if (only_barplot)
             {
-              if (barplot != nullptr) orientation = static_cast<std::string>(barplot->getAttribute("orientation"));
-              if (axis_type == "x" && orientation == "horizontal") axis_elem->setAttribute("draw_grid", false);
-              if (axis_type == "y" && orientation == "vertical") axis_elem->setAttribute("draw_grid", false);
+              if (barplot != nullptr)
+                orientation = static_cast<std::string>(barplot->getAttribute(GRM::Attr::orientation));
+              if (axis_type == "x" && orientation == "horizontal") axis_elem->setAttribute(GRM::Attr::draw_grid, false);
+              if (axis_type == "y" && orientation == "vertical") axis_elem->setAttribute(GRM::Attr::draw_grid, false);
             }
         }
-      if (kind == "shade") axis_elem->setAttribute("draw_grid", false);
-      axis_elem->setAttribute("mirrored_axis", mirrored_axis);
+      if (kind == "shade") axis_elem->setAttribute(GRM::Attr::draw_grid, false);
+      axis_elem->setAttribute(GRM::Attr::mirrored_axis, mirrored_axis);
     }
   // create tick_group elements
   if (!element->querySelectors("tick_group") ||
@@ -4905,9 +4928,9 @@ static void processAxis(const std::shared_ptr<GRM::Element> &element, const std:
     {
       for (const auto &child : element->children())
         {
-          if (child->localName() != "polyline" && child->hasAttribute("_child_id")) child->remove();
+          if (child->localName() != "polyline" && child->hasAttribute(GRM::Attr::_child_id)) child->remove();
         }
-      element->setAttribute("scientific_format", scientific_format);
+      element->setAttribute(GRM::Attr::scientific_format, scientific_format);
       axisArgumentsConvertedIntoTickGroups(axis.ticks, axis.tick_labels, axis_elem, del_values::recreate_own_children);
     }
   // polyline for axis-line
@@ -4926,7 +4949,7 @@ static void processAxis(const std::shared_ptr<GRM::Element> &element, const std:
   if (del != del_values::update_without_default && del != del_values::update_with_default)
     {
       line = global_render->createPolyline(line_x_min, line_x_max, line_y_min, line_y_max);
-      line->setAttribute("_child_id", 0);
+      line->setAttribute(GRM::Attr::_child_id, 0);
       axis_elem->append(line);
     }
   else
@@ -4938,8 +4961,8 @@ static void processAxis(const std::shared_ptr<GRM::Element> &element, const std:
   if (line != nullptr && del != del_values::update_without_default)
     {
       int z_index = axis_type == "x" ? 0 : -2;
-      line->setAttribute("name", axis_type + "-axis-line");
-      line->setAttribute("z_index", element->parentElement()->localName() == "colorbar" ? 2 : z_index);
+      line->setAttribute(GRM::Attr::name, axis_type + "-axis-line");
+      line->setAttribute(GRM::Attr::z_index, element->parentElement()->localName() == "colorbar" ? 2 : z_index);
     }
   if (axis_type == "x")
     {
@@ -4956,7 +4979,7 @@ static void processAxis(const std::shared_ptr<GRM::Element> &element, const std:
       if (del != del_values::update_without_default && del != del_values::update_with_default)
         {
           line = global_render->createPolyline(line_x_min, line_x_max, line_y_min, line_y_max);
-          line->setAttribute("_child_id", 1);
+          line->setAttribute(GRM::Attr::_child_id, 1);
           axis_elem->append(line);
         }
       else
@@ -4967,8 +4990,8 @@ static void processAxis(const std::shared_ptr<GRM::Element> &element, const std:
         }
       if (line != nullptr && del != del_values::update_without_default)
         {
-          line->setAttribute("name", axis_type + "-axis-line mirrored");
-          line->setAttribute("z_index", axis_type == "x" ? -1 : -3);
+          line->setAttribute(GRM::Attr::name, axis_type + "-axis-line mirrored");
+          line->setAttribute(GRM::Attr::z_index, axis_type == "x" ? -1 : -3);
         }
     }
 
@@ -4978,15 +5001,15 @@ static void processAxis(const std::shared_ptr<GRM::Element> &element, const std:
 
 void GRM::Render::processWindow(const std::shared_ptr<GRM::Element> &element)
 {
-  auto xmin = static_cast<double>(element->getAttribute("window_x_min"));
-  auto xmax = static_cast<double>(element->getAttribute("window_x_max"));
-  auto ymin = static_cast<double>(element->getAttribute("window_y_min"));
-  auto ymax = static_cast<double>(element->getAttribute("window_y_max"));
+  auto xmin = static_cast<double>(element->getAttribute(GRM::Attr::window_x_min));
+  auto xmax = static_cast<double>(element->getAttribute(GRM::Attr::window_x_max));
+  auto ymin = static_cast<double>(element->getAttribute(GRM::Attr::window_y_min));
+  auto ymax = static_cast<double>(element->getAttribute(GRM::Attr::window_y_max));
   if (element->localName() == "central_region")
     {
       std::shared_ptr<GRM::Element> plot_element = element;
       getPlotParent(plot_element);
-      auto kind = static_cast<std::string>(plot_element->getAttribute("kind"));
+      auto kind = static_cast<std::string>(plot_element->getAttribute(GRM::Attr::kind));
 
       if (str_equals_any(kind, "polar", "polar_histogram", "polar_heatmap", "nonuniformpolar_heatmap"))
         {
@@ -5001,19 +5024,19 @@ void GRM::Render::processWindow(const std::shared_ptr<GRM::Element> &element)
         }
       if (str_equals_any(kind, "wireframe", "surface", "plot3", "scatter3", "trisurface", "volume", "isosurface"))
         {
-          auto zmin = static_cast<double>(element->getAttribute("window_z_min"));
-          auto zmax = static_cast<double>(element->getAttribute("window_z_max"));
+          auto zmin = static_cast<double>(element->getAttribute(GRM::Attr::window_z_min));
+          auto zmax = static_cast<double>(element->getAttribute(GRM::Attr::window_z_max));
 
           gr_setwindow3d(xmin, xmax, ymin, ymax, zmin, zmax);
         }
-      if (element->hasAttribute("_zoomed") && static_cast<int>(element->getAttribute("_zoomed")))
+      if (element->hasAttribute(GRM::Attr::_zoomed) && static_cast<int>(element->getAttribute(GRM::Attr::_zoomed)))
         {
           for (const auto axis : element->querySelectorsAll("axis"))
             {
               clearAxisAttributes(axis);
               processAxis(axis, global_render->context);
             }
-          element->setAttribute("_zoomed", false);
+          element->setAttribute(GRM::Attr::_zoomed, false);
         }
     }
   else
@@ -5058,10 +5081,10 @@ void GRM::Render::processViewport(const std::shared_ptr<GRM::Element> &element)
    */
   double viewport[4];
 
-  viewport[0] = static_cast<double>(element->getAttribute("viewport_x_min"));
-  viewport[1] = static_cast<double>(element->getAttribute("viewport_x_max"));
-  viewport[2] = static_cast<double>(element->getAttribute("viewport_y_min"));
-  viewport[3] = static_cast<double>(element->getAttribute("viewport_y_max"));
+  viewport[0] = static_cast<double>(element->getAttribute(GRM::Attr::viewport_x_min));
+  viewport[1] = static_cast<double>(element->getAttribute(GRM::Attr::viewport_x_max));
+  viewport[2] = static_cast<double>(element->getAttribute(GRM::Attr::viewport_y_min));
+  viewport[3] = static_cast<double>(element->getAttribute(GRM::Attr::viewport_y_max));
 
   // TODO: Change this workaround when all elements with viewports really have a valid viewport
   if (viewport[1] - viewport[0] > 0.0 && viewport[3] - viewport[2] > 0.0)
@@ -5245,52 +5268,51 @@ void GRM::Render::processAttributes(const std::shared_ptr<GRM::Element> &element
    */
 
   // Map used for processing all kinds of attributes
-  static std::map<std::string, std::function<void(const std::shared_ptr<GRM::Element> &)>> attrStringToFunc{
-      {std::string("alpha"), processAlpha},
-      {std::string("background_color"), processBackgroundColor},
-      {std::string("border_color_ind"), processBorderColorInd},
-      {std::string("marginal_heatmap_side_plot"), processMarginalHeatmapSidePlot},
-      {std::string("char_expan"), processCharExpan},
-      {std::string("char_space"), processCharSpace},
-      {std::string("char_up_x"), processCharUp}, // the x element can be used cause both must be set
-      {std::string("clip_transformation"), processClipTransformation},
-      {std::string("colormap"), processColormap},
-      {std::string("fill_color_ind"), processFillColorInd},
-      {std::string("fill_int_style"), processFillIntStyle},
-      {std::string("fill_style"), processFillStyle},
-      {std::string("font"), processFont},
-      {std::string("line_color_ind"), processLineColorInd},
-      {std::string("line_spec"), processLineSpec},
-      {std::string("line_type"), processLineType},
-      {std::string("line_width"), processLineWidth},
-      {std::string("marginal_heatmap_kind"), processMarginalHeatmapKind},
-      {std::string("marker_color_ind"), processMarkerColorInd},
-      {std::string("marker_size"), processMarkerSize},
-      {std::string("marker_type"), processMarkerType},
-      {std::string("projection_type"), processProjectionType},
-      {std::string("max_char_height"), processRelativeCharHeight},
-      {std::string("resample_method"), processResampleMethod},
-      {std::string("reset_rotation"), processResetRotation},
-      {std::string("select_specific_xform"), processSelectSpecificXform},
-      {std::string("space"), processSpace},
-      {std::string("space_3d_fov"), processSpace3d},          // the fov element can be used cause both must be set
-      {std::string("text_align_vertical"), processTextAlign}, // the alignment in both directions is set
-      {std::string("text_color_ind"), processTextColorInd},
-      {std::string("text_encoding"), processTextEncoding},
-      {std::string("viewport"), processViewport},
-      {std::string("ws_viewport_x_min"),
-       processWSViewport},                               // the xmin element can be used here cause all 4 are required
-      {std::string("ws_window_x_min"), processWSWindow}, // the xmin element can be used here cause all 4 are required
-      {std::string("x_flip"), processFlip},              // y_flip is also set
-      {std::string("z_index"), processZIndex},
+  static std::map<GRM::Attr, std::function<void(const std::shared_ptr<GRM::Element> &)>> attrToFunc{
+      {GRM::Attr::alpha, processAlpha},
+      {GRM::Attr::background_color, processBackgroundColor},
+      {GRM::Attr::border_color_ind, processBorderColorInd},
+      {GRM::Attr::marginal_heatmap_side_plot, processMarginalHeatmapSidePlot},
+      {GRM::Attr::char_expan, processCharExpan},
+      {GRM::Attr::char_space, processCharSpace},
+      {GRM::Attr::char_up_x, processCharUp}, // the x element can be used cause both must be set
+      {GRM::Attr::clip_transformation, processClipTransformation},
+      {GRM::Attr::colormap, processColormap},
+      {GRM::Attr::fill_color_ind, processFillColorInd},
+      {GRM::Attr::fill_int_style, processFillIntStyle},
+      {GRM::Attr::fill_style, processFillStyle},
+      {GRM::Attr::font, processFont},
+      {GRM::Attr::line_color_ind, processLineColorInd},
+      {GRM::Attr::line_spec, processLineSpec},
+      {GRM::Attr::line_type, processLineType},
+      {GRM::Attr::line_width, processLineWidth},
+      {GRM::Attr::marginal_heatmap_kind, processMarginalHeatmapKind},
+      {GRM::Attr::marker_color_ind, processMarkerColorInd},
+      {GRM::Attr::marker_size, processMarkerSize},
+      {GRM::Attr::marker_type, processMarkerType},
+      {GRM::Attr::projection_type, processProjectionType},
+      {GRM::Attr::max_char_height, processRelativeCharHeight},
+      {GRM::Attr::resample_method, processResampleMethod},
+      {GRM::Attr::reset_rotation, processResetRotation},
+      {GRM::Attr::select_specific_xform, processSelectSpecificXform},
+      {GRM::Attr::space, processSpace},
+      {GRM::Attr::space_3d_fov, processSpace3d},          // the fov element can be used cause both must be set
+      {GRM::Attr::text_align_vertical, processTextAlign}, // the alignment in both directions is set
+      {GRM::Attr::text_color_ind, processTextColorInd},
+      {GRM::Attr::text_encoding, processTextEncoding},
+      {GRM::Attr::viewport, processViewport},
+      {GRM::Attr::ws_viewport_x_min, processWSViewport}, // the xmin element can be used here cause all 4 are required
+      {GRM::Attr::ws_window_x_min, processWSWindow},     // the xmin element can be used here cause all 4 are required
+      {GRM::Attr::x_flip, processFlip},                  // y_flip is also set
+      {GRM::Attr::z_index, processZIndex},
   };
 
-  static std::map<std::string, std::function<void(const std::shared_ptr<GRM::Element> &)>> attrStringToFuncPost{
+  static std::map<GRM::Attr, std::function<void(const std::shared_ptr<GRM::Element> &)>> attrToFuncPost{
       /* This map contains functions for attributes that should be called after some attributes have been processed
        * already. These functions can contain e.g. inquire function calls for colors.
        * */
-      {std::string("transparency"), processTransparency},
-      {std::string("set_text_color_for_background"), processTextColorForBackground},
+      {GRM::Attr::transparency, processTransparency},
+      {GRM::Attr::set_text_color_for_background, processTextColorForBackground},
   };
 
   static std::map<std::string, std::function<void(const std::shared_ptr<GRM::Element> &, const std::string attribute)>>
@@ -5300,33 +5322,37 @@ void GRM::Render::processAttributes(const std::shared_ptr<GRM::Element> &element
           {std::string("colorrep"), processColorRep},
       };
 
-  for (const auto &attribute : element->getAttributeNames())
+  auto attributes = element->getAttributeAtoms();
+  for (auto attribute : attributes)
     {
-      auto start = 0U;
-      auto end = attribute.find('.');
+      auto func = attrToFunc.find(attribute);
+      if (func != attrToFunc.end())
+        {
+          func->second(element);
+          continue;
+        }
+      const auto &attribute_name = GRM::attributeName(attribute);
+      auto end = attribute_name.find('.');
       if (end != std::string::npos)
         {
           /* element can hold more than one attribute of this kind */
-          auto attributeKind = attribute.substr(start, end);
+          auto attributeKind = attribute_name.substr(0, end);
           if (multiAttrStringToFunc.find(attributeKind) != multiAttrStringToFunc.end())
             {
-              multiAttrStringToFunc[attributeKind](element, attribute);
+              multiAttrStringToFunc[attributeKind](element, attribute_name);
             }
         }
-      else if (attrStringToFunc.find(attribute) != attrStringToFunc.end())
-        {
-          attrStringToFunc[attribute](element);
-        }
     }
 
-  for (auto &attribute : element->getAttributeNames())
+  for (auto attribute : attributes)
     /*
      * Post process attribute run
      */
     {
-      if (attrStringToFuncPost.find(attribute) != attrStringToFuncPost.end())
+      auto func = attrToFuncPost.find(attribute);
+      if (func != attrToFuncPost.end())
         {
-          attrStringToFuncPost[attribute](element);
+          func->second(element);
         }
     }
 }
@@ -6096,7 +6122,7 @@ static void processBarplot(const std::shared_ptr<GRM::Element> &element, const s
                 }
               bar_centers.push_back((x1 + x2) / 2.0);
             }
-          extendErrorBars(child, context, bar_centers, y_vec);
+          extendErrorBars(child, context, GRM::DoubleBuffer(bar_centers), GRM::DoubleBuffer(y_vec));
         }
     }
 }
@@ -6453,7 +6479,7 @@ static void processErrorBars(const std::shared_ptr<GRM::Element> &element, const
   int scale_options, color_upwards_cap, color_downwards_cap, color_error_bar;
   double marker_size, x_min, x_max, y_min, y_max, tick, a, b, e_upwards, e_downwards, x_value;
   double line_x[2], line_y[2];
-  std::vector<double> x_vec, y_vec;
+  GRM::DoubleView x_vec, y_vec;
   unsigned int x_length;
   std::string x_key, y_key;
   std::shared_ptr<GRM::Element> series;
@@ -6475,8 +6501,8 @@ static void processErrorBars(const std::shared_ptr<GRM::Element> &element, const
   if (!element->hasAttribute("y")) throw NotFoundError("Error-bars are missing required attribute y-data.\n");
   y_key = static_cast<std::string>(element->getAttribute("y"));
 
-  x_vec = GRM::get<std::vector<double>>((*context)[x_key]);
-  y_vec = GRM::get<std::vector<double>>((*context)[y_key]);
+  x_vec = GRM::get_view((*context)[x_key]);
+  y_vec = GRM::get_view((*context)[y_key]);
   x_length = x_vec.size();
   kind = static_cast<std::string>(series->parentElement()->getAttribute("kind"));
   if (element->parentElement()->hasAttribute("orientation"))
@@ -7605,18 +7631,19 @@ static void processGridLine(const std::shared_ptr<GRM::Element> &element, const
   getPlotParent(plot_parent);
 
   auto coordinate_system = plot_parent->querySelectors("coordinate_system");
-  bool hide =
-      (coordinate_system->hasAttribute("hide")) ? static_cast<int>(coordinate_system->getAttribute("hide")) : false;
-  auto coordinate_system_type = static_cast<std::string>(coordinate_system->getAttribute("plot_type"));
-  auto axis_type = static_cast<std::string>(axis_elem->getAttribute("axis_type"));
-  auto min_val = static_cast<double>(axis_elem->getAttribute("min_value"));
-  auto max_val = static_cast<double>(axis_elem->getAttribute("max_value"));
-  auto org = static_cast<double>(axis_elem->getAttribute("org"));
-  auto pos = static_cast<double>(axis_elem->getAttribute("pos"));
-  auto tick = static_cast<double>(axis_elem->getAttribute("tick"));
-  auto major_count = static_cast<int>(axis_elem->getAttribute("major_count"));
-  auto value = static_cast<double>(element->getAttribute("value"));
-  auto is_major = static_cast<int>(element->getAttribute("is_major"));
+  bool hide = (coordinate_system->hasAttribute(GRM::Attr::hide))
+                  ? static_cast<int>(coordinate_system->getAttribute(GRM::Attr::hide))
+                  : false;
+  auto coordinate_system_type = static_cast<std::string>(coordinate_system->getAttribute(GRM::Attr::plot_type));
+  auto axis_type = static_cast<std::string>(axis_elem->getAttribute(GRM::Attr::axis_type));
+  auto min_val = static_cast<double>(axis_elem->getAttribute(GRM::Attr::min_value));
+  auto max_val = static_cast<double>(axis_elem->getAttribute(GRM::Attr::max_value));
+  auto org = static_cast<double>(axis_elem->getAttribute(GRM::Attr::org));
+  auto pos = static_cast<double>(axis_elem->getAttribute(GRM::Attr::pos));
+  auto tick = static_cast<double>(axis_elem->getAttribute(GRM::Attr::tick));
+  auto major_count = static_cast<int>(axis_elem->getAttribute(GRM::Attr::major_count));
+  auto value = static_cast<double>(element->getAttribute(GRM::Attr::value));
+  auto is_major = static_cast<int>(element->getAttribute(GRM::Attr::is_major));
 
   tick_t g = {value, is_major};
   axis_t grid = {min_val, max_val, tick, org, pos, major_count, 1, &g, 0.0, 0, nullptr, NAN, false};
@@ -8023,36 +8050,57 @@ static void processHexbin(const std::shared_ptr<GRM::Element> &element, const st
     }
 }
 
-static void histBins(const std::shared_ptr<GRM::Element> &element, const std::shared_ptr<GRM::Context> &context)
+static std::string histBinsComputation(const std::shared_ptr<GRM::Element> &element,
+                                       const std::shared_ptr<GRM::Context> &context, std::vector<std::string> &keys,
+                                       ManageDataPreparation::Compute &compute)
 {
-  double *tmp_bins;
-  std::vector<double> x, weights;
-  unsigned int num_bins = 0, num_weights;
+  /*!
+   * Determine the data and the function for binning the data of a hist series
+   *
+   * \param[in] element The series_hist GRM::Element
+   * \param[in] context The GRM::Context that contains the actual data
+   * \param[out] keys The context keys of the data and the weights
+   * \param[out] compute The function computing the bins from the data
+   * \returns The id of the bins in the data preparation
+   */
+  std::string weights_key;
+  unsigned int num_bins = 0, num_weights = 0;
 
   if (!element->hasAttribute("x")) throw NotFoundError("Hist series is missing required attribute x-data.\n");
   auto key = static_cast<std::string>(element->getAttribute("x"));
-  x = GRM::get<std::vector<double>>((*context)[key]);
-  auto current_point_count = (int)x.size();
+  auto current_point_count = (int)GRM::get_view((*context)[key]).size();
 
   if (element->hasAttribute("num_bins")) num_bins = static_cast<int>(element->getAttribute("num_bins"));
   if (element->hasAttribute("weights"))
     {
-      auto weights_key = static_cast<std::string>(element->getAttribute("weights"));
-      weights = GRM::get<std::vector<double>>((*context)[weights_key]);
-      num_weights = weights.size();
+      weights_key = static_cast<std::string>(element->getAttribute("weights"));
+      num_weights = GRM::get_view((*context)[weights_key]).size();
     }
-  if (!weights.empty() && current_point_count != num_weights)
+  if (num_weights != 0 && current_point_count != num_weights)
     throw std::length_error("For hist series the size of data and weights must be the same.\n");
   if (num_bins <= 1)
     {
       num_bins = (int)(3.3 * log10(current_point_count) + 0.5) + 1;
     }
-  auto bins = std::vector<double>(num_bins);
-  double *x_p = &(x[0]);
-  double *weights_p = (weights.empty()) ? nullptr : &(weights[0]);
-  tmp_bins = &(bins[0]);
-  bin_data(current_point_count, x_p, num_bins, tmp_bins, weights_p);
-  std::vector<double> tmp(tmp_bins, tmp_bins + num_bins);
+
+  keys = {key, weights_key};
+  compute = [num_bins](const std::vector<GRM::DoubleView> &data) {
+    auto bins = std::vector<double>(num_bins);
+    double *x_p = const_cast<double *>(data[0].data());
+    double *weights_p = (data[1].empty()) ? nullptr : const_cast<double *>(data[1].data());
+    bin_data(data[0].size(), x_p, num_bins, &(bins[0]), weights_p);
+    return bins;
+  };
+  return "hist_bins:" + key + ":" + weights_key + ":" + std::to_string(num_bins);
+}
+
+static void histBins(const std::shared_ptr<GRM::Element> &element, const std::shared_ptr<GRM::Context> &context)
+{
+  std::vector<std::string> keys;
+  ManageDataPreparation::Compute compute;
+
+  auto bins_id = histBinsComputation(element, context, keys, compute);
+  std::vector<double> tmp = data_preparation.get(bins_id, context, keys, compute);
 
   auto id = static_cast<int>(global_root->getAttribute("_id"));
   auto str = std::to_string(id);
@@ -8239,7 +8287,7 @@ static void processHist(const std::shared_ptr<GRM::Element> &element, const std:
         {
           std::vector<double> bar_centers(num_bins);
           linspace(x_min + 0.5 * bar_width, x_max - 0.5 * bar_width, (int)num_bins, bar_centers);
-          extendErrorBars(child, context, bar_centers, bins_vec);
+          extendErrorBars(child, context, GRM::DoubleBuffer(bar_centers), GRM::DoubleBuffer(bins_vec));
         }
     }
 }
@@ -8517,8 +8565,8 @@ static void processPolyline(const std::shared_ptr<GRM::Element> &element, const
       auto x = static_cast<std::string>(element->getAttribute("x"));
       auto y = static_cast<std::string>(element->getAttribute("y"));
 
-      std::vector<double> x_vec = GRM::get<std::vector<double>>((*context)[x]);
-      std::vector<double> y_vec = GRM::get<std::vector<double>>((*context)[y]);
+      auto x_vec = GRM::get_view((*context)[x]);
+      auto y_vec = GRM::get_view((*context)[y]);
 
       auto n = std::min<int>((int)x_vec.size(), (int)y_vec.size());
       auto group = element->parentElement();
@@ -8531,7 +8579,7 @@ static void processPolyline(const std::shared_ptr<GRM::Element> &element, const
           lineHelper(element, context, "polyline");
         }
       else if (redraw_ws)
-        gr_polyline(n, (double *)&(x_vec[0]), (double *)&(y_vec[0]));
+        gr_polyline(n, (double *)x_vec.data(), (double *)y_vec.data());
     }
   else if (element->getAttribute("x1").isDouble() && element->getAttribute("x2").isDouble() &&
            element->getAttribute("y1").isDouble() && element->getAttribute("y2").isDouble())
@@ -8600,8 +8648,8 @@ static void processPolymarker(const std::shared_ptr<GRM::Element> &element,
       auto x = static_cast<std::string>(element->getAttribute("x"));
       auto y = static_cast<std::string>(element->getAttribute("y"));
 
-      std::vector<double> x_vec = GRM::get<std::vector<double>>((*context)[x]);
-      std::vector<double> y_vec = GRM::get<std::vector<double>>((*context)[y]);
+      auto x_vec = GRM::get_view((*context)[x]);
+      auto y_vec = GRM::get_view((*context)[y]);
 
       auto n = std::min<int>((int)x_vec.size(), (int)y_vec.size());
       auto group = element->parentElement();
@@ -8615,7 +8663,7 @@ static void processPolymarker(const std::shared_ptr<GRM::Element> &element,
         }
       else
         {
-          if (redraw_ws) gr_polymarker(n, (double *)&(x_vec[0]), (double *)&(y_vec[0]));
+          if (redraw_ws) gr_polymarker(n, (double *)x_vec.data(), (double *)y_vec.data());
         }
     }
   else if (element->getAttribute("x").isDouble() && element->getAttribute("y").isDouble())
@@ -10557,7 +10605,7 @@ static void processScatter(const std::shared_ptr<GRM::Element> &element, const s
   int i, c_index = -1;
   std::vector<int> marker_color_inds_vec;
   std::vector<double> marker_sizes_vec;
-  std::vector<double> x_vec, y_vec, z_vec, c_vec;
+  GRM::DoubleView x_vec, y_vec, z_vec, c_vec;
   del_values del = del_values::update_without_default;
   int child_id = 0;
   std::shared_ptr<GRM::Element> marker;
@@ -10566,8 +10614,8 @@ static void processScatter(const std::shared_ptr<GRM::Element> &element, const s
   auto x = static_cast<std::string>(element->getAttribute("x"));
   if (!element->hasAttribute("y")) throw NotFoundError("Scatter series is missing required attribute y-data.\n");
   auto y = static_cast<std::string>(element->getAttribute("y"));
-  x_vec = GRM::get<std::vector<double>>((*context)[x]);
-  y_vec = GRM::get<std::vector<double>>((*context)[y]);
+  x_vec = GRM::get_view((*context)[x]);
+  y_vec = GRM::get_view((*context)[y]);
   x_length = x_vec.size();
   y_length = y_vec.size();
   if (x_length != y_length) throw std::length_error("For scatter series x- and y-data must have the same size.\n");
@@ -10575,14 +10623,14 @@ static void processScatter(const std::shared_ptr<GRM::Element> &element, const s
   if (element->hasAttribute("z"))
     {
       auto z = static_cast<std::string>(element->getAttribute("z"));
-      z_vec = GRM::get<std::vector<double>>((*context)[z]);
+      z_vec = GRM::get_view((*context)[z]);
       z_length = z_vec.size();
       if (x_length != z_length) throw std::length_error("For scatter series x- and z-data must have the same size.\n");
     }
   if (element->hasAttribute("c"))
     {
       auto c = static_cast<std::string>(element->getAttribute("c"));
-      c_vec = GRM::get<std::vector<double>>((*context)[c]);
+      c_vec = GRM::get_view((*context)[c]);
       c_length = c_vec.size();
     }
   if (element->hasAttribute("orientation"))
@@ -10677,7 +10725,7 @@ static void processScatter(const std::shared_ptr<GRM::Element> &element, const s
         {
           if (del != del_values::update_without_default && del != del_values::update_with_default)
             {
-              marker = global_render->createPolymarker("x" + str, x_vec, "y" + str, y_vec);
+              marker = global_render->createPolymarker(x, std::nullopt, y, std::nullopt);
               marker->setAttribute("_child_id", child_id++);
               element->append(marker);
             }
@@ -10685,14 +10733,14 @@ static void processScatter(const std::shared_ptr<GRM::Element> &element, const s
             {
               marker = element->querySelectors("polymarker[_child_id=" + std::to_string(child_id++) + "]");
               if (marker != nullptr)
-                global_render->createPolymarker("x" + str, x_vec, "y" + str, y_vec, nullptr, 0, 0.0, 0, marker);
+                global_render->createPolymarker(x, std::nullopt, y, std::nullopt, nullptr, 0, 0.0, 0, marker);
             }
         }
       else
         {
           if (del != del_values::update_without_default && del != del_values::update_with_default)
             {
-              marker = global_render->createPolymarker("x" + str, y_vec, "y" + str, x_vec);
+              marker = global_render->createPolymarker(y, std::nullopt, x, std::nullopt);
               marker->setAttribute("_child_id", child_id++);
               element->append(marker);
             }
@@ -10700,7 +10748,7 @@ static void processScatter(const std::shared_ptr<GRM::Element> &element, const s
             {
               marker = element->querySelectors("polymarker[_child_id=" + std::to_string(child_id++) + "]");
               if (marker != nullptr)
-                global_render->createPolymarker("x" + str, y_vec, "y" + str, x_vec, nullptr, 0, 0.0, 0, marker);
+                global_render->createPolymarker(y, std::nullopt, x, std::nullopt, nullptr, 0, 0.0, 0, marker);
             }
         }
 
@@ -10716,13 +10764,12 @@ static void processScatter(const std::shared_ptr<GRM::Element> &element, const s
   else
     {
       auto id = static_cast<int>(global_root->getAttribute("_id"));
-      auto str = std::to_string(id);
 
       if (is_horizontal)
         {
           if (del != del_values::update_without_default && del != del_values::update_with_default)
             {
-              marker = global_render->createPolymarker("x" + str, x_vec, "y" + str, y_vec);
+              marker = global_render->createPolymarker(x, std::nullopt, y, std::nullopt);
               marker->setAttribute("_child_id", child_id++);
               element->append(marker);
             }
@@ -10730,14 +10777,14 @@ static void processScatter(const std::shared_ptr<GRM::Element> &element, const s
             {
               marker = element->querySelectors("polymarker[_child_id=" + std::to_string(child_id++) + "]");
               if (marker != nullptr)
-                global_render->createPolymarker("x" + str, x_vec, "y" + str, y_vec, nullptr, 0, 0.0, 0, marker);
+                global_render->createPolymarker(x, std::nullopt, y, std::nullopt, nullptr, 0, 0.0, 0, marker);
             }
         }
       else
         {
           if (del != del_values::update_without_default && del != del_values::update_with_default)
             {
-              marker = global_render->createPolymarker("x" + str, y_vec, "y" + str, x_vec);
+              marker = global_render->createPolymarker(y, std::nullopt, x, std::nullopt);
               marker->setAttribute("_child_id", child_id++);
               element->append(marker);
             }
@@ -10745,7 +10792,7 @@ static void processScatter(const std::shared_ptr<GRM::Element> &element, const s
             {
               marker = element->querySelectors("polymarker[_child_id=" + std::to_string(child_id++) + "]");
               if (marker != nullptr)
-                global_render->createPolymarker("x" + str, y_vec, "y" + str, x_vec, nullptr, 0, 0.0, 0, marker);
+                global_render->createPolymarker(y, std::nullopt, x, std::nullopt, nullptr, 0, 0.0, 0, marker);
             }
         }
       global_root->setAttribute("_id", ++id);
@@ -10754,7 +10801,10 @@ static void processScatter(const std::shared_ptr<GRM::Element> &element, const s
   // error_bar handling
   for (const auto &child : element->children())
     {
-      if (child->localName() == "error_bars") extendErrorBars(child, context, x_vec, y_vec);
+      if (child->localName() == "error_bars")
+        {
+          extendErrorBars(child, context, GRM::get_buffer((*context)[x]), GRM::get_buffer((*context)[y]));
+        }
     }
 }
 
@@ -11389,7 +11439,9 @@ static void processLine(const std::shared_ptr<GRM::Element> &element, const std:
    * \param[in] context The GRM::Context that contains the actual data
    */
   std::string orientation = PLOT_DEFAULT_ORIENTATION, line_spec = SERIES_DEFAULT_SPEC;
-  std::vector<double> x_vec, y_vec;
+  GRM::DoubleBuffer x_default;
+  GRM::DoubleView x_vec, y_vec;
+  std::string x_key;
   unsigned int x_length = 0, y_length = 0;
   del_values del = del_values::update_without_default;
   int child_id = 0;
@@ -11406,22 +11458,25 @@ static void processLine(const std::shared_ptr<GRM::Element> &element, const std:
     }
 
   if (!element->hasAttribute("y")) throw NotFoundError("Line series is missing required attribute y-data.\n");
-  auto y = static_cast<std::string>(element->getAttribute("y"));
-  y_vec = GRM::get<std::vector<double>>((*context)[y]);
+  auto y_key = static_cast<std::string>(element->getAttribute("y"));
+  y_vec = GRM::get_view((*context)[y_key]);
   y_length = y_vec.size();
 
   if (!element->hasAttribute("x"))
     {
+      std::vector<double> x_values(y_length);
       x_length = y_length;
       for (int i = 0; i < y_length; ++i) /* julia starts with 1, so GRM starts with 1 to be consistent */
         {
-          x_vec.push_back(i + 1);
+          x_values[i] = i + 1;
         }
+      x_default = GRM::DoubleBuffer(std::move(x_values));
+      x_vec = x_default;
     }
   else
     {
-      auto x = static_cast<std::string>(element->getAttribute("x"));
-      x_vec = GRM::get<std::vector<double>>((*context)[x]);
+      x_key = static_cast<std::string>(element->getAttribute("x"));
+      x_vec = GRM::get_view((*context)[x_key]);
       x_length = x_vec.size();
     }
   if (x_length != y_length) throw std::length_error("For line series x- and y-data must have the same size.\n");
@@ -11448,14 +11503,17 @@ static void processLine(const std::shared_ptr<GRM::Element> &element, const std:
       auto id = static_cast<int>(global_root->getAttribute("_id"));
       auto str = std::to_string(id);
 
-      std::vector<double> line_x = x_vec, line_y = y_vec;
-      if (orientation == "vertical")
+      /* the polyline references the data of the series, only generated x values must be stored separately */
+      auto line_x = x_key, line_y = y_key;
+      if (line_x.empty())
         {
-          line_x = y_vec, line_y = x_vec;
+          line_x = "x" + str;
+          (*context)[line_x] = x_default;
         }
+      if (orientation == "vertical") std::swap(line_x, line_y);
       if (del != del_values::update_without_default && del != del_values::update_with_default)
         {
-          line = global_render->createPolyline("x" + str, line_x, "y" + str, line_y);
+          line = global_render->createPolyline(line_x, std::nullopt, line_y, std::nullopt);
           line->setAttribute("_child_id", child_id++);
           element->append(line);
         }
@@ -11463,7 +11521,7 @@ static void processLine(const std::shared_ptr<GRM::Element> &element, const std:
         {
           line = element->querySelectors("polyline[_child_id=" + std::to_string(child_id++) + "]");
           if (line != nullptr)
-            global_render->createPolyline("x" + str, line_x, "y" + str, line_y, nullptr, 0, 0.0, 0, line);
+            global_render->createPolyline(line_x, std::nullopt, line_y, std::nullopt, nullptr, 0, 0.0, 0, line);
         }
 
       global_root->setAttribute("_id", ++id);
@@ -11476,14 +11534,16 @@ static void processLine(const std::shared_ptr<GRM::Element> &element, const std:
       auto id = static_cast<int>(global_root->getAttribute("_id"));
       auto str = std::to_string(id);
 
-      std::vector<double> marker_x = x_vec, marker_y = y_vec;
-      if (orientation == "vertical")
+      auto marker_x = x_key, marker_y = y_key;
+      if (marker_x.empty())
         {
-          marker_x = y_vec, marker_y = x_vec;
+          marker_x = "x" + str;
+          (*context)[marker_x] = x_default;
         }
+      if (orientation == "vertical") std::swap(marker_x, marker_y);
       if (del != del_values::update_without_default && del != del_values::update_with_default)
         {
-          marker = global_render->createPolymarker("x" + str, marker_x, "y" + str, marker_y);
+          marker = global_render->createPolymarker(marker_x, std::nullopt, marker_y, std::nullopt);
           marker->setAttribute("_child_id", child_id++);
           element->append(marker);
         }
@@ -11491,7 +11551,8 @@ static void processLine(const std::shared_ptr<GRM::Element> &element, const std:
         {
           marker = element->querySelectors("polymarker[_child_id=" + std::to_string(child_id++) + "]");
           if (marker != nullptr)
-            global_render->createPolymarker("x" + str, marker_x, "y" + str, marker_y, nullptr, 0, 0.0, 0, marker);
+            global_render->createPolymarker(marker_x, std::nullopt, marker_y, std::nullopt, nullptr, 0, 0.0, 0,
+                                            marker);
         }
 
       if (marker != nullptr)
@@ -11518,10 +11579,81 @@ static void processLine(const std::shared_ptr<GRM::Element> &element, const std:
   // error_bar handling
   for (const auto &child : element->children())
     {
-      if (child->localName() == "error_bars") extendErrorBars(child, context, x_vec, y_vec);
+      if (child->localName() == "error_bars")
+        {
+          extendErrorBars(child, context, x_key.empty() ? x_default : GRM::get_buffer((*context)[x_key]),
+                          GRM::get_buffer((*context)[y_key]));
+        }
     }
 }
 
+static std::string marginalHeatmapSumsComputation(const std::shared_ptr<GRM::Element> &element,
+                                                  const std::shared_ptr<GRM::Context> &context,
+                                                  std::vector<std::string> &keys,
+                                                  ManageDataPreparation::Compute &compute)
+{
+  /*!
+   * Determine the data and the function for computing the side plot values of a marginal heatmap of kind `all`. The
+   * computed values are the sums or maxima of all rows followed by those of all columns of the heatmap.
+   *
+   * \param[in] element The marginal_heatmap_plot GRM::Element
+   * \param[in] context The GRM::Context that contains the actual data
+   * \param[out] keys The context keys of the x, y and z data
+   * \param[out] compute The function computing the values from the data
+   * \returns The id of the values in the data preparation
+   */
+  std::string algorithm = PLOT_DEFAULT_MARGINAL_ALGORITHM;
+  auto plot_parent = element;
+
+  getPlotParent(plot_parent);
+  bool x_log = plot_parent->hasAttribute("x_log") && static_cast<int>(plot_parent->getAttribute("x_log"));
+  bool y_log = plot_parent->hasAttribute("y_log") && static_cast<int>(plot_parent->getAttribute("y_log"));
+  bool z_log = static_cast<int>(plot_parent->getAttribute("z_log"));
+  if (element->hasAttribute("algorithm")) algorithm = static_cast<std::string>(element->getAttribute("algorithm"));
+  auto x = static_cast<std::string>(element->getAttribute("x"));
+  auto y = static_cast<std::string>(element->getAttribute("y"));
+  auto z = static_cast<std::string>(element->getAttribute("z"));
+
+  keys = {x, y, z};
+  compute = [x_log, y_log, z_log, algorithm](const std::vector<GRM::DoubleView> &data) {
+    const auto &x_vec = data[0], &y_vec = data[1], &plot_vec = data[2];
+    unsigned int i, j, x_offset = 0, y_offset = 0;
+
+    /* NaN coordinates on logarithmic axes are skipped */
+    if (x_log) x_offset = std::count_if(x_vec.begin(), x_vec.end(), [](double value) { return grm_isnan(value); });
+    if (y_log) y_offset = std::count_if(y_vec.begin(), y_vec.end(), [](double value) { return grm_isnan(value); });
+    unsigned int num_bins_x = x_vec.size() - x_offset, num_bins_y = y_vec.size() - y_offset;
+    if (plot_vec.size() < x_vec.size() * y_vec.size())
+      throw std::length_error("For marginal heatmap z_length must be x_length * y_length.\n");
+
+    std::vector<double> bins(num_bins_y + num_bins_x, 0.0);
+    double *row_bins = bins.data(), *column_bins = bins.data() + num_bins_y;
+    bool sum = algorithm == "sum", max = algorithm == "max";
+    for (i = 0; i < num_bins_y; i++)
+      {
+        for (j = 0; j < num_bins_x; j++)
+          {
+            double value = plot_vec[(i + y_offset) * (num_bins_x + x_offset) + (j + x_offset)];
+            if (z_log) value = log10(value);
+            if (grm_isnan(value)) value = 0;
+            if (sum)
+              {
+                row_bins[i] += value;
+                column_bins[j] += value;
+              }
+            else if (max)
+              {
+                row_bins[i] = grm_max(row_bins[i], value);
+                column_bins[j] = grm_max(column_bins[j], value);
+              }
+          }
+      }
+    return bins;
+  };
+  return "marginal_heatmap_sums:" + x + ":" + y + ":" + z + ":" + std::to_string(x_log) + std::to_string(y_log) +
+         std::to_string(z_log) + ":" + algorithm;
+}
+
 static void processMarginalHeatmapPlot(const std::shared_ptr<GRM::Element> &element,
                                        const std::shared_ptr<GRM::Context> &context)
 {
@@ -11535,7 +11667,7 @@ static void processMarginalHeatmapPlot(const std::shared_ptr<GRM::Element> &elem
   double c_max;
   int flip, options;
   int x_ind = PLOT_DEFAULT_MARGINAL_INDEX, y_ind = PLOT_DEFAULT_MARGINAL_INDEX;
-  unsigned int i, j, k;
+  unsigned int i, k;
   std::string algorithm = PLOT_DEFAULT_MARGINAL_ALGORITHM, marginal_heatmap_kind = PLOT_DEFAULT_MARGINAL_KIND;
   std::vector<double> bins;
   unsigned int num_bins_x = 0, num_bins_y = 0;
@@ -11543,7 +11675,6 @@ static void processMarginalHeatmapPlot(const std::shared_ptr<GRM::Element> &elem
   auto plot_parent = element;
   del_values del = del_values::update_without_default;
   int child_id = 0;
-  bool z_log = false;
   int x_offset = 0, y_offset = 0;
 
   getPlotParent(plot_parent);
@@ -11556,8 +11687,6 @@ static void processMarginalHeatmapPlot(const std::shared_ptr<GRM::Element> &elem
         }
     }
 
-  z_log = static_cast<int>(plot_parent->getAttribute("z_log"));
-
   if (element->hasAttribute("x_ind"))
     {
       x_ind = static_cast<int>(element->getAttribute("x_ind"));
@@ -11652,7 +11781,7 @@ static void processMarginalHeatmapPlot(const std::shared_ptr<GRM::Element> &elem
 
   for (k = 0; k < 2; k++)
     {
-      double value, bin_max = 0;
+      double bin_max = 0;
       int bar_color_index = 989;
       double bar_color_rgb[3] = {-1};
       int edge_color_index = 1;
@@ -11674,48 +11803,22 @@ static void processMarginalHeatmapPlot(const std::shared_ptr<GRM::Element> &elem
         {
           unsigned int x_len = num_bins_x, y_len = num_bins_y;
 
-          bins = std::vector<double>((k == 0) ? num_bins_y : num_bins_x);
+          std::vector<std::string> keys;
+          ManageDataPreparation::Compute compute;
 
-          for (i = 0; i < ((k == 0) ? num_bins_y : num_bins_x); i++)
+          auto sums_id = marginalHeatmapSumsComputation(element, context, keys, compute);
+          const auto &sums = data_preparation.get(sums_id, context, keys, compute);
+          if (k == 0)
             {
-              bins[i] = 0;
+              bins = std::vector<double>(sums.begin(), sums.begin() + y_len);
             }
-          for (i = 0; i < y_len; i++)
+          else
             {
-              for (j = 0; j < x_len; j++)
-                {
-                  if (z_log)
-                    {
-                      value = (grm_isnan(log10(plot_vec[(i + y_offset) * (num_bins_x + x_offset) + (j + x_offset)])))
-                                  ? 0
-                                  : log10(plot_vec[(i + y_offset) * (num_bins_x + x_offset) + (j + x_offset)]);
-                    }
-                  else
-                    {
-                      value = (grm_isnan(plot_vec[(i + y_offset) * (num_bins_x + x_offset) + (j + x_offset)]))
-                                  ? 0
-                                  : plot_vec[(i + y_offset) * (num_bins_x + x_offset) + (j + x_offset)];
-                    }
-                  if (algorithm == "sum")
-                    {
-                      bins[(k == 0) ? i : j] += value;
-                    }
-                  else if (algorithm == "max")
-                    {
-                      bins[(k == 0) ? i : j] = grm_max(bins[(k == 0) ? i : j], value);
-                    }
-                }
-              if (k == 0)
-                {
-                  bin_max = grm_max(bin_max, bins[i]);
-                }
+              bins = std::vector<double>(sums.begin() + y_len, sums.end());
             }
-          if (k == 1)
+          for (i = 0; i < ((k == 0) ? y_len : x_len); i++)
             {
-              for (i = 0; i < x_len; i++)
-                {
-                  bin_max = grm_max(bin_max, bins[i]);
-                }
+              bin_max = grm_max(bin_max, bins[i]);
             }
           for (i = 0; i < ((k == 0) ? y_len : x_len); i++)
             {
@@ -12315,23 +12418,23 @@ static void processText(const std::shared_ptr<GRM::Element> &element, const std:
   double tbx[4], tby[4];
   int text_color_ind = 1, scientific_format = 0;
   bool text_fits = true;
-  auto x = static_cast<double>(element->getAttribute("x"));
-  auto y = static_cast<double>(element->getAttribute("y"));
-  auto str = static_cast<std::string>(element->getAttribute("text"));
-  auto available_width = static_cast<double>(element->getAttribute("width"));
-  auto available_height = static_cast<double>(element->getAttribute("height"));
-  auto space = static_cast<CoordinateSpace>(static_cast<int>(element->getAttribute("space")));
-  if (element->hasAttribute("text_color_ind"))
-    text_color_ind = static_cast<int>(element->getAttribute("text_color_ind"));
-  if (element->hasAttribute("scientific_format"))
-    scientific_format = static_cast<int>(element->getAttribute("scientific_format"));
+  auto x = static_cast<double>(element->getAttribute(GRM::Attr::x));
+  auto y = static_cast<double>(element->getAttribute(GRM::Attr::y));
+  auto str = static_cast<std::string>(element->getAttribute(GRM::Attr::text));
+  auto available_width = static_cast<double>(element->getAttribute(GRM::Attr::width));
+  auto available_height = static_cast<double>(element->getAttribute(GRM::Attr::height));
+  auto space = static_cast<CoordinateSpace>(static_cast<int>(element->getAttribute(GRM::Attr::space)));
+  if (element->hasAttribute(GRM::Attr::text_color_ind))
+    text_color_ind = static_cast<int>(element->getAttribute(GRM::Attr::text_color_ind));
+  if (element->hasAttribute(GRM::Attr::scientific_format))
+    scientific_format = static_cast<int>(element->getAttribute(GRM::Attr::scientific_format));
 
   applyMoveTransformation(element);
   if (space == CoordinateSpace::WC)
     {
       gr_wctondc(&x, &y);
     }
-  if (element->hasAttribute("width") && element->hasAttribute("height"))
+  if (element->hasAttribute(GRM::Attr::width) && element->hasAttribute(GRM::Attr::height))
     {
       gr_wctondc(&available_width, &available_height);
       gr_inqtext(x, y, &str[0], tbx, tby);
@@ -12471,26 +12574,28 @@ static void tickLabelAdjustment(const std::shared_ptr<GRM::Element> &tick_group,
 
   getPlotParent(plot_parent);
   gr_inqcharheight(&char_height);
-  auto text = static_cast<std::string>(tick_group->getAttribute("tick_label"));
-  auto width = static_cast<double>(tick_group->getAttribute("width"));
-  auto axis_type = static_cast<std::string>(tick_group->parentElement()->getAttribute("axis_type"));
-  auto value = static_cast<double>(tick_group->getAttribute("value"));
-  auto label_pos = static_cast<double>(tick_group->parentElement()->getAttribute("label_pos"));
-  auto pos = static_cast<double>(tick_group->parentElement()->getAttribute("pos"));
+  auto text = static_cast<std::string>(tick_group->getAttribute(GRM::Attr::tick_label));
+  auto width = static_cast<double>(tick_group->getAttribute(GRM::Attr::width));
+  auto axis_type = static_cast<std::string>(tick_group->parentElement()->getAttribute(GRM::Attr::axis_type));
+  auto value = static_cast<double>(tick_group->getAttribute(GRM::Attr::value));
+  auto label_pos = static_cast<double>(tick_group->parentElement()->getAttribute(GRM::Attr::label_pos));
+  auto pos = static_cast<double>(tick_group->parentElement()->getAttribute(GRM::Attr::pos));
   // todo: window should come from axis if axis has window defined on it
-  window[0] =
-      static_cast<double>(tick_group->parentElement()->parentElement()->parentElement()->getAttribute("window_x_min"));
-  window[1] =
-      static_cast<double>(tick_group->parentElement()->parentElement()->parentElement()->getAttribute("window_x_max"));
-  window[2] =
-      static_cast<double>(tick_group->parentElement()->parentElement()->parentElement()->getAttribute("window_y_min"));
-  window[3] =
-      static_cast<double>(tick_group->parentElement()->parentElement()->parentElement()->getAttribute("window_y_max"));
-
-  if (tick_group->parentElement()->hasAttribute("scale"))
-    scale = static_cast<int>(tick_group->parentElement()->getAttribute("scale"));
-  if (plot_parent->hasAttribute("x_flip")) x_flip = static_cast<int>(plot_parent->getAttribute("x_flip"));
-  if (plot_parent->hasAttribute("y_flip")) y_flip = static_cast<int>(plot_parent->getAttribute("y_flip"));
+  window[0] = static_cast<double>(
+      tick_group->parentElement()->parentElement()->parentElement()->getAttribute(GRM::Attr::window_x_min));
+  window[1] = static_cast<double>(
+      tick_group->parentElement()->parentElement()->parentElement()->getAttribute(GRM::Attr::window_x_max));
+  window[2] = static_cast<double>(
+      tick_group->parentElement()->parentElement()->parentElement()->getAttribute(GRM::Attr::window_y_min));
+  window[3] = static_cast<double>(
+      tick_group->parentElement()->parentElement()->parentElement()->getAttribute(GRM::Attr::window_y_max));
+
+  if (tick_group->parentElement()->hasAttribute(GRM::Attr::scale))
+    scale = static_cast<int>(tick_group->parentElement()->getAttribute(GRM::Attr::scale));
+  if (plot_parent->hasAttribute(GRM::Attr::x_flip))
+    x_flip = static_cast<int>(plot_parent->getAttribute(GRM::Attr::x_flip));
+  if (plot_parent->hasAttribute(GRM::Attr::y_flip))
+    y_flip = static_cast<int>(plot_parent->getAttribute(GRM::Attr::y_flip));
 
   gr_wctondc(&x_left, &null);
   gr_wctondc(&x_right, &null);
@@ -12522,8 +12627,8 @@ static void tickLabelAdjustment(const std::shared_ptr<GRM::Element> &tick_group,
           auto em_dash = std::string(minus);
           size_t start_pos = 0;
 
-          if (tick_group->parentElement()->hasAttribute("scientific_format"))
-            sc_format = static_cast<int>(tick_group->parentElement()->getAttribute("scientific_format"));
+          if (tick_group->parentElement()->hasAttribute(GRM::Attr::scientific_format))
+            sc_format = static_cast<int>(tick_group->parentElement()->getAttribute(GRM::Attr::scientific_format));
           gr_setscientificformat(sc_format);
 
           if (starts_with(text, em_dash))
@@ -12578,7 +12683,7 @@ static void tickLabelAdjustment(const std::shared_ptr<GRM::Element> &tick_group,
                         {
                           text_elem = global_render->createText(x, y, new_label + cur_start);
                           tick_group->append(text_elem);
-                          text_elem->setAttribute("_child_id", child_id++);
+                          text_elem->setAttribute(GRM::Attr::_child_id, child_id++);
                         }
                       else
                         {
@@ -12616,7 +12721,7 @@ static void tickLabelAdjustment(const std::shared_ptr<GRM::Element> &tick_group,
   if (del != del_values::update_without_default && del != del_values::update_with_default)
     {
       text_elem = global_render->createText(x, y, text, CoordinateSpace::WC);
-      text_elem->setAttribute("_child_id", child_id);
+      text_elem->setAttribute(GRM::Attr::_child_id, child_id);
       tick_group->append(text_elem);
     }
   else
@@ -12626,43 +12731,45 @@ static void tickLabelAdjustment(const std::shared_ptr<GRM::Element> &tick_group,
     }
   if (text_elem != nullptr && del != del_values::update_without_default)
     {
-      text_elem->setAttribute("text_color_ind", 1);
+      text_elem->setAttribute(GRM::Attr::text_color_ind, 1);
       // set text align if not set by user
-      if (!(tick_group->hasAttribute("text_align_vertical") && tick_group->hasAttribute("text_align_horizontal")))
+      if (!(tick_group->hasAttribute(GRM::Attr::text_align_vertical) &&
+            tick_group->hasAttribute(GRM::Attr::text_align_horizontal)))
         {
           if (axis_type == "x")
             {
-              text_elem->setAttribute("text_align_horizontal", GKS_K_TEXT_HALIGN_CENTER);
+              text_elem->setAttribute(GRM::Attr::text_align_horizontal, GKS_K_TEXT_HALIGN_CENTER);
               if (pos <= 0.5 * (window[2] + window[3]) ||
                   ((scale & GR_OPTION_FLIP_Y || y_flip) && pos > 0.5 * (window[2] + window[3])))
                 {
-                  text_elem->setAttribute("text_align_vertical", GKS_K_TEXT_VALIGN_TOP);
+                  text_elem->setAttribute(GRM::Attr::text_align_vertical, GKS_K_TEXT_VALIGN_TOP);
                 }
               else
                 {
-                  text_elem->setAttribute("text_align_vertical", GKS_K_TEXT_VALIGN_BOTTOM);
+                  text_elem->setAttribute(GRM::Attr::text_align_vertical, GKS_K_TEXT_VALIGN_BOTTOM);
                 }
             }
           else if (axis_type == "y")
             {
-              text_elem->setAttribute("text_align_vertical", GKS_K_TEXT_VALIGN_HALF);
+              text_elem->setAttribute(GRM::Attr::text_align_vertical, GKS_K_TEXT_VALIGN_HALF);
               if ((pos <= 0.5 * (window[0] + window[1]) && !(scale & GR_OPTION_FLIP_X || x_flip)) ||
                   ((scale & GR_OPTION_FLIP_X || x_flip) && pos > 0.5 * (window[0] + window[1]) &&
                    tick_group->parentElement()->parentElement()->localName() != "colorbar"))
                 {
-                  text_elem->setAttribute("text_align_horizontal", GKS_K_TEXT_HALIGN_RIGHT);
+                  text_elem->setAttribute(GRM::Attr::text_align_horizontal, GKS_K_TEXT_HALIGN_RIGHT);
                 }
               else
                 {
-                  text_elem->setAttribute("text_align_horizontal", GKS_K_TEXT_HALIGN_LEFT);
+                  text_elem->setAttribute(GRM::Attr::text_align_horizontal, GKS_K_TEXT_HALIGN_LEFT);
                 }
             }
         }
-      if (scientific_format == 2 || tick_group->parentElement()->hasAttribute("scientific_format"))
+      if (scientific_format == 2 || tick_group->parentElement()->hasAttribute(GRM::Attr::scientific_format))
         {
           if (scientific_format != 2)
-            scientific_format = static_cast<int>(tick_group->parentElement()->getAttribute("scientific_format"));
-          text_elem->setAttribute("scientific_format", scientific_format);
+            scientific_format =
+                static_cast<int>(tick_group->parentElement()->getAttribute(GRM::Attr::scientific_format));
+          text_elem->setAttribute(GRM::Attr::scientific_format, scientific_format);
           gr_setscientificformat(scientific_format);
         }
     }
@@ -12674,8 +12781,8 @@ static void applyTickModificationMap(const std::shared_ptr<GRM::Element> &tick_g
   std::shared_ptr<GRM::Element> text_elem = nullptr;
   bool tick_group_attr_changed = false, old_automatic_update = automatic_update;
 
-  auto value = static_cast<double>(tick_group->getAttribute("value"));
-  auto map_idx = static_cast<int>(tick_group->parentElement()->getAttribute("_axis_id"));
+  auto value = static_cast<double>(tick_group->getAttribute(GRM::Attr::value));
+  auto map_idx = static_cast<int>(tick_group->parentElement()->getAttribute(GRM::Attr::_axis_id));
   for (const auto &child : tick_group->children())
     {
       if (child->localName() == "text")
@@ -12699,11 +12806,11 @@ static void applyTickModificationMap(const std::shared_ptr<GRM::Element> &tick_g
                 {
                   tick_group->setAttribute(attr, val);
                   if (text_elem != nullptr && attr == "tick_label")
-                    text_elem->setAttribute("text", val);
+                    text_elem->setAttribute(GRM::Attr::text, val);
                   else if (text_elem == nullptr && attr == "tick_label")
                     tickLabelAdjustment(tick_group, child_id, del_values::recreate_own_children);
                   else if (str_equals_any(attr, "is_major", "value"))
-                    tick_group->setAttribute("_update_required", true);
+                    tick_group->setAttribute(GRM::Attr::_update_required, true);
                   tick_group_attr_changed = true;
                 }
               else if (str_equals_any(attr, "font", "font_precision", "scientific_format", "text", "text_color_ind",
@@ -12726,31 +12833,31 @@ static void processTickGroup(const std::shared_ptr<GRM::Element> &element, const
   std::shared_ptr<GRM::Element> tick_elem, text, grid_line;
   del_values del = del_values::update_without_default;
 
-  auto value = static_cast<double>(element->getAttribute("value"));
-  auto is_major = static_cast<int>(element->getAttribute("is_major"));
-  auto tick_label = static_cast<std::string>(element->getAttribute("tick_label"));
-  auto axis_type = static_cast<std::string>(element->parentElement()->getAttribute("axis_type"));
-  auto draw_grid = static_cast<int>(element->parentElement()->getAttribute("draw_grid"));
-  bool mirrored_axis = element->parentElement()->hasAttribute("mirrored_axis") &&
-                       static_cast<int>(element->parentElement()->getAttribute("mirrored_axis"));
+  auto value = static_cast<double>(element->getAttribute(GRM::Attr::value));
+  auto is_major = static_cast<int>(element->getAttribute(GRM::Attr::is_major));
+  auto tick_label = static_cast<std::string>(element->getAttribute(GRM::Attr::tick_label));
+  auto axis_type = static_cast<std::string>(element->parentElement()->getAttribute(GRM::Attr::axis_type));
+  auto draw_grid = static_cast<int>(element->parentElement()->getAttribute(GRM::Attr::draw_grid));
+  bool mirrored_axis = element->parentElement()->hasAttribute(GRM::Attr::mirrored_axis) &&
+                       static_cast<int>(element->parentElement()->getAttribute(GRM::Attr::mirrored_axis));
   // todo: window should come from axis if axis has window defined on it
-  window[0] =
-      static_cast<double>(element->parentElement()->parentElement()->parentElement()->getAttribute("window_x_min"));
-  window[1] =
-      static_cast<double>(element->parentElement()->parentElement()->parentElement()->getAttribute("window_x_max"));
-  window[2] =
-      static_cast<double>(element->parentElement()->parentElement()->parentElement()->getAttribute("window_y_min"));
-  window[3] =
-      static_cast<double>(element->parentElement()->parentElement()->parentElement()->getAttribute("window_y_max"));
-
-  del = del_values(static_cast<int>(element->getAttribute("_delete_children")));
+  window[0] = static_cast<double>(
+      element->parentElement()->parentElement()->parentElement()->getAttribute(GRM::Attr::window_x_min));
+  window[1] = static_cast<double>(
+      element->parentElement()->parentElement()->parentElement()->getAttribute(GRM::Attr::window_x_max));
+  window[2] = static_cast<double>(
+      element->parentElement()->parentElement()->parentElement()->getAttribute(GRM::Attr::window_y_min));
+  window[3] = static_cast<double>(
+      element->parentElement()->parentElement()->parentElement()->getAttribute(GRM::Attr::window_y_max));
+
+  del = del_values(static_cast<int>(element->getAttribute(GRM::Attr::_delete_children)));
   clearOldChildren(&del, element);
 
   // tick
   if (del != del_values::update_without_default && del != del_values::update_with_default)
     {
       tick_elem = global_render->createTick(is_major, value);
-      tick_elem->setAttribute("_child_id", child_id++);
+      tick_elem->setAttribute(GRM::Attr::_child_id, child_id++);
       element->append(tick_elem);
     }
   else
@@ -12766,7 +12873,7 @@ static void processTickGroup(const std::shared_ptr<GRM::Element> &element, const
         z_index = -4;
       if (axis_type == "y") z_index -= 2;
       if (element->parentElement()->parentElement()->localName() == "colorbar") z_index = 1;
-      tick_elem->setAttribute("z_index", z_index);
+      tick_elem->setAttribute(GRM::Attr::z_index, z_index);
     }
 
   // mirrored tick
@@ -12775,7 +12882,7 @@ static void processTickGroup(const std::shared_ptr<GRM::Element> &element, const
       if (del != del_values::update_without_default && del != del_values::update_with_default)
         {
           tick_elem = global_render->createTick(is_major, value);
-          tick_elem->setAttribute("_child_id", child_id++);
+          tick_elem->setAttribute(GRM::Attr::_child_id, child_id++);
           element->append(tick_elem);
         }
       else
@@ -12790,8 +12897,8 @@ static void processTickGroup(const std::shared_ptr<GRM::Element> &element, const
           else
             z_index = -5;
           if (axis_type == "y") z_index -= 2;
-          tick_elem->setAttribute("z_index", z_index);
-          tick_elem->setAttribute("is_mirrored", true);
+          tick_elem->setAttribute(GRM::Attr::z_index, z_index);
+          tick_elem->setAttribute(GRM::Attr::is_mirrored, true);
         }
     }
 
@@ -12801,7 +12908,7 @@ static void processTickGroup(const std::shared_ptr<GRM::Element> &element, const
       if (del != del_values::update_without_default && del != del_values::update_with_default)
         {
           grid_line = global_render->createGridLine(is_major, value);
-          grid_line->setAttribute("_child_id", child_id++);
+          grid_line->setAttribute(GRM::Attr::_child_id, child_id++);
           element->append(grid_line);
         }
       else
@@ -12816,7 +12923,7 @@ static void processTickGroup(const std::shared_ptr<GRM::Element> &element, const
           else
             z_index = -12;
           if (axis_type == "y") z_index -= 1;
-          grid_line->setAttribute("z_index", z_index);
+          grid_line->setAttribute(GRM::Attr::z_index, z_index);
         }
     }
 
@@ -12832,24 +12939,26 @@ static void processTick(const std::shared_ptr<GRM::Element> &element, const std:
   getPlotParent(plot_parent);
 
   auto coordinate_system = plot_parent->querySelectors("coordinate_system");
-  bool hide =
-      (coordinate_system->hasAttribute("hide")) ? static_cast<int>(coordinate_system->getAttribute("hide")) : false;
-  auto coordinate_system_type = static_cast<std::string>(coordinate_system->getAttribute("plot_type"));
-  auto axis_type = static_cast<std::string>(axis_elem->getAttribute("axis_type"));
-  auto min_val = static_cast<double>(axis_elem->getAttribute("min_value"));
-  auto max_val = static_cast<double>(axis_elem->getAttribute("max_value"));
-  auto org = static_cast<double>(axis_elem->getAttribute("org"));
-  auto pos = static_cast<double>(axis_elem->getAttribute("pos"));
-  auto tick = static_cast<double>(axis_elem->getAttribute("tick"));
-  auto major_count = static_cast<int>(axis_elem->getAttribute("major_count"));
-  auto tick_size = static_cast<double>(axis_elem->getAttribute("tick_size"));
-  if (element->parentElement()->hasAttribute("tick_size"))
-    tick_size = static_cast<double>(element->parentElement()->getAttribute("tick_size"));
-  auto tick_orientation = static_cast<int>(axis_elem->getAttribute("tick_orientation"));
-  auto value = static_cast<double>(element->getAttribute("value"));
-  auto is_major = static_cast<int>(element->getAttribute("is_major"));
-  auto label_pos = static_cast<double>(axis_elem->getAttribute("label_pos"));
-  bool mirrored_axis = element->hasAttribute("is_mirrored") && static_cast<int>(element->getAttribute("is_mirrored"));
+  bool hide = (coordinate_system->hasAttribute(GRM::Attr::hide))
+                  ? static_cast<int>(coordinate_system->getAttribute(GRM::Attr::hide))
+                  : false;
+  auto coordinate_system_type = static_cast<std::string>(coordinate_system->getAttribute(GRM::Attr::plot_type));
+  auto axis_type = static_cast<std::string>(axis_elem->getAttribute(GRM::Attr::axis_type));
+  auto min_val = static_cast<double>(axis_elem->getAttribute(GRM::Attr::min_value));
+  auto max_val = static_cast<double>(axis_elem->getAttribute(GRM::Attr::max_value));
+  auto org = static_cast<double>(axis_elem->getAttribute(GRM::Attr::org));
+  auto pos = static_cast<double>(axis_elem->getAttribute(GRM::Attr::pos));
+  auto tick = static_cast<double>(axis_elem->getAttribute(GRM::Attr::tick));
+  auto major_count = static_cast<int>(axis_elem->getAttribute(GRM::Attr::major_count));
+  auto tick_size = static_cast<double>(axis_elem->getAttribute(GRM::Attr::tick_size));
+  if (element->parentElement()->hasAttribute(GRM::Attr::tick_size))
+    tick_size = static_cast<double>(element->parentElement()->getAttribute(GRM::Attr::tick_size));
+  auto tick_orientation = static_cast<int>(axis_elem->getAttribute(GRM::Attr::tick_orientation));
+  auto value = static_cast<double>(element->getAttribute(GRM::Attr::value));
+  auto is_major = static_cast<int>(element->getAttribute(GRM::Attr::is_major));
+  auto label_pos = static_cast<double>(axis_elem->getAttribute(GRM::Attr::label_pos));
+  bool mirrored_axis =
+      element->hasAttribute(GRM::Attr::is_mirrored) && static_cast<int>(element->getAttribute(GRM::Attr::is_mirrored));
 
   tick_t t = {value, is_major};
   axis_t drawn_tick = {min_val, max_val, tick,      org,  pos, major_count, 1, &t, tick_size * tick_orientation,
@@ -13210,6 +13319,27 @@ void plotProcessWsWindowWsViewport(const std::shared_ptr<GRM::Element> &element,
           ws_viewport[3]));
 }
 
+static std::vector<double> dataRangeComputation(const std::vector<GRM::DoubleView> &data)
+{
+  /*!
+   * Compute the minimum and maximum of data, ignoring NaN values
+   *
+   * \param[in] data A single data buffer
+   * \returns The minimum and the maximum, or DBL_MAX and -DBL_MAX if there are no valid values
+   */
+  double min_component = DBL_MAX, max_component = -DBL_MAX;
+
+  for (const auto &value : data[0])
+    {
+      if (!std::isnan(value))
+        {
+          min_component = grm_min(value, min_component);
+          max_component = grm_max(value, max_component);
+        }
+    }
+  return {min_component, max_component};
+}
+
 static void plotCoordinateRanges(const std::shared_ptr<GRM::Element> &element,
                                  const std::shared_ptr<GRM::Context> &context)
 {
@@ -13218,7 +13348,7 @@ static void plotCoordinateRanges(const std::shared_ptr<GRM::Element> &element,
   unsigned int series_count = 0;
   std::vector<std::string> data_component_names = {"x", "y", "z", "c", ""};
   std::vector<std::string>::iterator current_component_name;
-  std::vector<double> current_component;
+  GRM::DoubleView current_component;
   std::shared_ptr<GRM::Element> central_region;
   unsigned int current_point_count = 0;
   struct
@@ -13299,7 +13429,7 @@ static void plotCoordinateRanges(const std::shared_ptr<GRM::Element> &element,
                           if (series->hasAttribute(*current_component_name))
                             {
                               auto key = static_cast<std::string>(series->getAttribute(*current_component_name));
-                              current_component = GRM::get<std::vector<double>>((*context)[key]);
+                              current_component = GRM::get_view((*context)[key]);
                               current_point_count = current_component.size();
                               if (style == "stacked")
                                 {
@@ -13324,14 +13454,10 @@ static void plotCoordinateRanges(const std::shared_ptr<GRM::Element> &element,
                                       current_min_component = 0.0;
                                       current_max_component = 0.0;
                                     }
-                                  for (i = 0; i < current_point_count; i++)
-                                    {
-                                      if (!std::isnan(current_component[i]))
-                                        {
-                                          current_min_component = grm_min(current_component[i], current_min_component);
-                                          current_max_component = grm_max(current_component[i], current_max_component);
-                                        }
-                                    }
+                                  const auto &range =
+                                      data_preparation.get("range:" + key, context, {key}, dataRangeComputation);
+                                  current_min_component = grm_min(range[0], current_min_component);
+                                  current_max_component = grm_max(range[1], current_max_component);
                                 }
                             }
                           /* TODO: Add more plot types which can omit `x` */
@@ -13341,8 +13467,7 @@ static void plotCoordinateRanges(const std::shared_ptr<GRM::Element> &element,
                               if (!series->hasAttribute("y"))
                                 throw NotFoundError("Series is missing required attribute y.\n");
                               auto key = static_cast<std::string>(series->getAttribute("y"));
-                              auto y_vec = GRM::get<std::vector<double>>((*context)[key]);
-                              y_length = y_vec.size();
+                              y_length = GRM::get_view((*context)[key]).size();
                               current_min_component = 0.0;
                               current_max_component = y_length - 1;
                             }
@@ -13397,7 +13522,7 @@ static void plotCoordinateRanges(const std::shared_ptr<GRM::Element> &element,
                                 {
                                   int index_sum = 0;
                                   auto key = static_cast<std::string>(series->getAttribute(*current_component_name));
-                                  current_component = GRM::get<std::vector<double>>((*context)[key]);
+                                  current_component = GRM::get_view((*context)[key]);
                                   current_point_count = current_component.size();
 
                                   current_max_component = 0;
@@ -14566,7 +14691,7 @@ static void processElement(const std::shared_ptr<GRM::Element> &element, const s
    */
 
   // Map used for processing all kinds of elements
-  bool update_required = static_cast<int>(element->getAttribute("_update_required"));
+  bool update_required = static_cast<int>(element->getAttribute(GRM::Attr::_update_required));
   static std::map<std::string,
                   std::function<void(const std::shared_ptr<GRM::Element>, const std::shared_ptr<GRM::Context>)>>
       elemStringToFunc{
@@ -14624,14 +14749,14 @@ static void processElement(const std::shared_ptr<GRM::Element> &element, const s
       /* check if figure is active; skip inactive elements */
       if (element->localName() == "figure")
         {
-          if (!static_cast<int>(element->getAttribute("active"))) return;
+          if (!static_cast<int>(element->getAttribute(GRM::Attr::active))) return;
           if (global_root->querySelectorsAll("draw_graphics").empty()) plotProcessWsWindowWsViewport(element, context);
         }
       if (element->localName() == "plot")
         {
           std::shared_ptr<GRM::Element> central_region_parent = element;
           processPlot(element, context);
-          if (static_cast<std::string>(element->getAttribute("kind")) == "marginal_heatmap")
+          if (static_cast<std::string>(element->getAttribute(GRM::Attr::kind)) == "marginal_heatmap")
             central_region_parent = element->children()[0]; // if the kind is marginal_heatmap plot can only has 1 child
                                                             // and this child is the marginal_heatmap_plot
 
@@ -14674,7 +14799,7 @@ static void processElement(const std::shared_ptr<GRM::Element> &element, const s
         }
       // TODO: something like series_contour shouldn't be in this list
       if (!automatic_update ||
-          ((static_cast<int>(global_root->getAttribute("_modified")) &&
+          ((static_cast<int>(global_root->getAttribute(GRM::Attr::_modified)) &&
             (str_equals_any(element->localName(), "axes_3d", "cellarray", "colorbar", "draw_arc", "draw_image",
                             "draw_rect", "fill_arc", "fill_area", "fill_rect", "grid", "grid_3d", "legend",
                             "nonuniform_polarcellarray", "nonuniformcellarray", "polarcellarray", "polyline",
@@ -14693,10 +14818,10 @@ static void processElement(const std::shared_ptr<GRM::Element> &element, const s
           automatic_update = false;
           /* The attributes of drawables (except for the z_index itself) are being processed when the z_queue is being
            * processed */
-          if (element->hasAttribute("viewport_x_min")) calculateViewport(element);
+          if (element->hasAttribute(GRM::Attr::viewport_x_min)) calculateViewport(element);
           if (isDrawable(element))
             {
-              if (element->hasAttribute("z_index")) processZIndex(element);
+              if (element->hasAttribute(GRM::Attr::z_index)) processZIndex(element);
             }
           else
             {
@@ -14715,8 +14840,8 @@ static void processElement(const std::shared_ptr<GRM::Element> &element, const s
             }
 
           // reset _update_required
-          element->setAttribute("_update_required", false);
-          element->setAttribute("_delete_children", 0);
+          element->setAttribute(GRM::Attr::_update_required, false);
+          element->setAttribute(GRM::Attr::_delete_children, 0);
           if (update_required)
             {
               for (const auto &child : element->children())
@@ -14724,15 +14849,15 @@ static void processElement(const std::shared_ptr<GRM::Element> &element, const s
                   if (!str_equals_any(element->localName(), "axes_text_group", "figure", "plot", "label",
                                       "labels_group", "root", "layout_grid_element"))
                     {
-                      child->setAttribute("_update_required", true);
+                      child->setAttribute(GRM::Attr::_update_required, true);
                       resetOldBoundingBoxes(child);
                     }
                 }
             }
           automatic_update = old_state;
         }
-      else if (automatic_update && static_cast<int>(global_root->getAttribute("_modified")) ||
-               element->parentElement()->parentElement()->hasAttribute("marginal_heatmap_side_plot"))
+      else if (automatic_update && static_cast<int>(global_root->getAttribute(GRM::Attr::_modified)) ||
+               element->parentElement()->parentElement()->hasAttribute(GRM::Attr::marginal_heatmap_side_plot))
         {
           bool old_state = automatic_update;
           automatic_update = false;
@@ -14745,6 +14870,102 @@ static void processElement(const std::shared_ptr<GRM::Element> &element, const s
 /* ~~~~~~~~~~~~~~~~~~~~~~~~~ render functions ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
  */
 
+static void prepareData(const std::shared_ptr<GRM::Element> &figure, const std::shared_ptr<GRM::Context> &context)
+{
+  /*!
+   * Compute the results derived from series data which are needed for processing the plots of a figure, like
+   * coordinate ranges, histogram bins and marginal heatmap values. The data is looked up here, the computations run
+   * concurrently in the data preparation afterwards. Results which are not prepared here are computed when needed.
+   *
+   * \param[in] figure The figure GRM::Element
+   * \param[in] context The GRM::Context that contains the actual data
+   */
+  static const std::string data_component_names[] = {"x", "y", "z", "c"};
+
+  data_preparation.begin();
+  for (const auto &plot : figure->querySelectorsAll("plot"))
+    {
+      std::vector<std::string> keys;
+      ManageDataPreparation::Compute compute;
+      const char *fmt;
+
+      /* coordinate ranges of the series, see `plotCoordinateRanges` */
+      auto kind = static_cast<std::string>(plot->getAttribute("kind"));
+      if (!plot->hasAttribute("original_x_lim") && !str_equals_any(kind, "pie", "polar_histogram") &&
+          string_map_at(fmt_map, static_cast<const char *>(kind.c_str()), static_cast<const char **>(&fmt)))
+        {
+          std::shared_ptr<GRM::Element> series_parent;
+          if (kind == "marginal_heatmap")
+            {
+              series_parent = plot;
+            }
+          else
+            {
+              for (const auto &child : plot->children())
+                {
+                  if (child->localName() == "central_region")
+                    {
+                      series_parent = child;
+                      break;
+                    }
+                }
+            }
+          for (const auto &component_name : data_component_names)
+            {
+              if (series_parent == nullptr || std::string(fmt).find(component_name) == std::string::npos) continue;
+              if (plot->hasAttribute(component_name + "_lim_min") && plot->hasAttribute(component_name + "_lim_max") &&
+                  !str_equals_any(kind, "heatmap", "marginal_heatmap", "polar_heatmap"))
+                continue;
+              for (const auto &series : series_parent->children())
+                {
+                  if (series->hasAttribute(component_name + "_range_min") &&
+                      series->hasAttribute(component_name + "_range_max"))
+                    continue;
+                  if (!series->hasAttribute(component_name)) continue;
+                  if (series->hasAttribute("style") &&
+                      static_cast<std::string>(series->getAttribute("style")) == "stacked")
+                    continue;
+                  auto key = static_cast<std::string>(series->getAttribute(component_name));
+                  data_preparation.request("range:" + key, context, {key}, dataRangeComputation);
+                }
+            }
+        }
+
+      if (kind == "hist")
+        {
+          for (const auto &series : plot->querySelectorsAll("series_hist"))
+            {
+              if (series->hasAttribute("bins")) continue;
+              try
+                {
+                  auto bins_id = histBinsComputation(series, context, keys, compute);
+                  data_preparation.request(bins_id, context, keys, compute);
+                }
+              catch (const std::exception &e)
+                {
+                  /* invalid series are reported when they are processed */
+                }
+            }
+        }
+      else if (kind == "marginal_heatmap")
+        {
+          for (const auto &marginal_heatmap : plot->querySelectorsAll("marginal_heatmap_plot"))
+            {
+              std::string marginal_heatmap_kind = PLOT_DEFAULT_MARGINAL_KIND;
+              if (marginal_heatmap->hasAttribute("marginal_heatmap_kind"))
+                {
+                  marginal_heatmap_kind =
+                      static_cast<std::string>(marginal_heatmap->getAttribute("marginal_heatmap_kind"));
+                }
+              if (marginal_heatmap_kind != "all") continue;
+              auto sums_id = marginalHeatmapSumsComputation(marginal_heatmap, context, keys, compute);
+              data_preparation.request(sums_id, context, keys, compute);
+            }
+        }
+    }
+  data_preparation.run();
+}
+
 static void renderHelper(const std::shared_ptr<GRM::Element> &element, const std::shared_ptr<GRM::Context> &context)
 {
   /*!
@@ -14844,12 +15065,14 @@ static void renderZQueue(const std::shared_ptr<GRM::Context> &context)
 {
   z_queue_is_being_rendered = true;
   bool bounding_boxes = (getenv("GRDISPLAY") && strcmp(getenv("GRDISPLAY"), "edit") == 0);
+  /* cached output is only valid for complete redraws of the workstation */
+  bool use_drawable_cache = redraw_ws && !bounding_boxes;
 
   gr_savestate();
-  for (; !z_queue.empty(); z_queue.pop())
+  std::sort(z_queue.begin(), z_queue.end(), CompareZIndex());
+  for (auto &drawable : z_queue)
     {
-      const auto &drawable = z_queue.top();
-      auto element = drawable->getElement();
+      const auto &element = drawable.getElement();
       if (!element->parentElement()) continue;
 
       if (bounding_boxes)
@@ -14859,16 +15082,20 @@ static void renderZQueue(const std::shared_ptr<GRM::Context> &context)
           bounding_id++;
         }
 
-      custom_color_index_manager.selectcontext(drawable->getGrContextId());
-      drawable->draw();
+      custom_color_index_manager.selectcontext(drawable.getGrContextId());
+      if (use_drawable_cache && cacheable_drawable_types.count(element->localName()))
+        drawable.draw(&drawable_cache);
+      else
+        drawable.draw();
 
       if (bounding_boxes)
         {
           gr_cancelbboxcallback();
         }
     }
+  if (use_drawable_cache) drawable_cache.discardDetached();
+  z_queue.clear();
   gr_context_id_manager.markAllIdsAsUnused();
-  parent_to_context = {};
   gr_unselectcontext();
   gr_restorestate();
   z_queue_is_being_rendered = false;
@@ -15218,6 +15445,7 @@ void GRM::Render::render()
       if (static_cast<int>(root->getAttribute("clear_ws"))) gr_clearws();
       root->setAttribute("_modified", true);
       finalizeGrid(active_figure);
+      prepareData(active_figure, this->context);
       renderHelper(root, this->context);
       renderZQueue(this->context);
       root->setAttribute("_modified", false); // reset the modified flag, cause all updates are made
@@ -15255,6 +15483,8 @@ void GRM::Render::process_tree()
 
 void GRM::Render::finalize()
 {
+  drawable_cache.clear();
+  data_preparation.clear();
   gr_context_id_manager.destroyGRContexts();
 }
 
@@ -15264,7 +15494,7 @@ std::shared_ptr<GRM::Render> GRM::Render::createRender()
    * This function can be used to create a Render object
    */
   global_render = std::shared_ptr<Render>(new Render());
-  global_render->ownerDocument()->setUpdateFct(&renderCaller, &updateFilter);
+  global_render->ownerDocument()->setUpdateFct(&renderCaller, &updateFilter, &updateFilterNeeded);
   global_render->ownerDocument()->setContextFct(&deleteContextAttribute, &updateContextAttribute);
   return global_render;
 }
@@ -17527,6 +17757,13 @@ static void setRanges(const std::shared_ptr<GRM::Element> &element, const std::s
     new_series->setAttribute("z_range_max", static_cast<double>(element->getAttribute("z_range_max")));
 }
 
+bool updateFilterNeeded(const std::string &attr)
+{
+  /* `updateFilter` ignores all changes while automatic updates are disabled and changes of internal attributes, so
+   * the old value does not need to be stringified for them */
+  return automatic_update && !starts_with(attr, "_");
+}
+
 void updateFilter(const std::shared_ptr<GRM::Element> &element, const std::string &attr, const std::string &value = "")
 {
   std::vector<std::string> bar{
@@ -18617,7 +18854,7 @@ void updateFilter(const std::shared_ptr<GRM::Element> &element, const std::strin
 
 void renderCaller()
 {
-  if (global_root && static_cast<int>(global_root->getAttribute("_modified")) && automatic_update)
+  if (automatic_update && global_root && static_cast<int>(global_root->getAttribute("_modified")))
     {
       global_render->process_tree();
     }
@@ -18,14 +18,6 @@
 
 /* ######################### internal implementation ################################################################ */
 
-/* ========================= macros ================================================================================= */
-
-/* ------------------------- general -------------------------------------------------------------------------------- */
-
-#ifndef DBL_DECIMAL_DIG
-#define DBL_DECIMAL_DIG 17
-#endif
-
 /* ========================= static variables ======================================================================= */
 
 /* ------------------------- json deserializer ---------------------------------------------------------------------- */
@@ -45,6 +37,11 @@ static err_t (*fromjson_datatype_to_func[])(fromjson_state_t *) = {NULL,
 static const char *const fromjson_datatype_to_string[] = {"unknown", "null",  "bool",  "number",
                                                           "string",  "array", "object"};
 
+/* powers of ten which are exactly representable as doubles */
+static const double fromjson_exact_powers_of_ten[] = {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,
+                                                      1e8,  1e9,  1e10, 1e11, 1e12, 1e13, 1e14, 1e15,
+                                                      1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
 
 /* ------------------------- json serializer ------------------------------------------------------------------------ */
 
@@ -52,6 +49,39 @@ static err_t (*tojson_datatype_to_func[128])(tojson_state_t *);
 static int tojson_static_variables_initialized = 0;
 static tojson_permanent_state_t tojson_permanent_state = {complete, 0};
 
+/* normalized 64 bit approximations of 10^-348, 10^-340, ..., 10^340, split into the upper and lower 32 bits */
+static const tojson_cached_power_t tojson_cached_powers_of_ten[] = {
+    {0xfa8fd5a0UL, 0x081c0288UL, -1220}, {0xbaaee17fUL, 0xa23ebf76UL, -1193}, {0x8b16fb20UL, 0x3055ac76UL, -1166},
+    {0xcf42894aUL, 0x5dce35eaUL, -1140}, {0x9a6bb0aaUL, 0x55653b2dUL, -1113}, {0xe61acf03UL, 0x3d1a45dfUL, -1087},
+    {0xab70fe17UL, 0xc79ac6caUL, -1060}, {0xff77b1fcUL, 0xbebcdc4fUL, -1034}, {0xbe5691efUL, 0x416bd60cUL, -1007},
+    {0x8dd01fadUL, 0x907ffc3cUL, -980}, {0xd3515c28UL, 0x31559a83UL, -954}, {0x9d71ac8fUL, 0xada6c9b5UL, -927},
+    {0xea9c2277UL, 0x23ee8bcbUL, -901}, {0xaecc4991UL, 0x4078536dUL, -874}, {0x823c1279UL, 0x5db6ce57UL, -847},
+    {0xc2109436UL, 0x4dfb5637UL, -821}, {0x9096ea6fUL, 0x3848984fUL, -794}, {0xd77485cbUL, 0x25823ac7UL, -768},
+    {0xa086cfcdUL, 0x97bf97f4UL, -741}, {0xef340a98UL, 0x172aace5UL, -715}, {0xb23867fbUL, 0x2a35b28eUL, -688},
+    {0x84c8d4dfUL, 0xd2c63f3bUL, -661}, {0xc5dd4427UL, 0x1ad3cdbaUL, -635}, {0x936b9fceUL, 0xbb25c996UL, -608},
+    {0xdbac6c24UL, 0x7d62a584UL, -582}, {0xa3ab6658UL, 0x0d5fdaf6UL, -555}, {0xf3e2f893UL, 0xdec3f126UL, -529},
+    {0xb5b5ada8UL, 0xaaff80b8UL, -502}, {0x87625f05UL, 0x6c7c4a8bUL, -475}, {0xc9bcff60UL, 0x34c13053UL, -449},
+    {0x964e858cUL, 0x91ba2655UL, -422}, {0xdff97724UL, 0x70297ebdUL, -396}, {0xa6dfbd9fUL, 0xb8e5b88fUL, -369},
+    {0xf8a95fcfUL, 0x88747d94UL, -343}, {0xb9447093UL, 0x8fa89bcfUL, -316}, {0x8a08f0f8UL, 0xbf0f156bUL, -289},
+    {0xcdb02555UL, 0x653131b6UL, -263}, {0x993fe2c6UL, 0xd07b7facUL, -236}, {0xe45c10c4UL, 0x2a2b3b06UL, -210},
+    {0xaa242499UL, 0x697392d3UL, -183}, {0xfd87b5f2UL, 0x8300ca0eUL, -157}, {0xbce50864UL, 0x92111aebUL, -130},
+    {0x8cbccc09UL, 0x6f5088ccUL, -103}, {0xd1b71758UL, 0xe219652cUL, -77}, {0x9c400000UL, 0x00000000UL, -50},
+    {0xe8d4a510UL, 0x00000000UL, -24}, {0xad78ebc5UL, 0xac620000UL, 3}, {0x813f3978UL, 0xf8940984UL, 30},
+    {0xc097ce7bUL, 0xc90715b3UL, 56}, {0x8f7e32ceUL, 0x7bea5c70UL, 83}, {0xd5d238a4UL, 0xabe98068UL, 109},
+    {0x9f4f2726UL, 0x179a2245UL, 136}, {0xed63a231UL, 0xd4c4fb27UL, 162}, {0xb0de6538UL, 0x8cc8ada8UL, 189},
+    {0x83c7088eUL, 0x1aab65dbUL, 216}, {0xc45d1df9UL, 0x42711d9aUL, 242}, {0x924d692cUL, 0xa61be758UL, 269},
+    {0xda01ee64UL, 0x1a708deaUL, 295}, {0xa26da399UL, 0x9aef774aUL, 322}, {0xf209787bUL, 0xb47d6b85UL, 348},
+    {0xb454e4a1UL, 0x79dd1877UL, 375}, {0x865b8692UL, 0x5b9bc5c2UL, 402}, {0xc83553c5UL, 0xc8965d3dUL, 428},
+    {0x952ab45cUL, 0xfa97a0b3UL, 455}, {0xde469fbdUL, 0x99a05fe3UL, 481}, {0xa59bc234UL, 0xdb398c25UL, 508},
+    {0xf6c69a72UL, 0xa3989f5cUL, 534}, {0xb7dcbf53UL, 0x54e9beceUL, 561}, {0x88fcf317UL, 0xf22241e2UL, 588},
+    {0xcc20ce9bUL, 0xd35c78a5UL, 614}, {0x98165af3UL, 0x7b2153dfUL, 641}, {0xe2a0b5dcUL, 0x971f303aUL, 667},
+    {0xa8d9d153UL, 0x5ce3b396UL, 694}, {0xfb9b7cd9UL, 0xa4a7443cUL, 720}, {0xbb764c4cUL, 0xa7a44410UL, 747},
+    {0x8bab8eefUL, 0xb6409c1aUL, 774}, {0xd01fef10UL, 0xa657842cUL, 800}, {0x9b10a4e5UL, 0xe9913129UL, 827},
+    {0xe7109bfbUL, 0xa19c0c9dUL, 853}, {0xac2820d9UL, 0x623bf429UL, 880}, {0x80444b5eUL, 0x7aa7cf85UL, 907},
+    {0xbf21e440UL, 0x03acdd2dUL, 933}, {0x8e679c2fUL, 0x5e44ff8fUL, 960}, {0xd433179dUL, 0x9c8cb841UL, 986},
+    {0x9e19db92UL, 0xb4e31ba9UL, 1013}, {0xeb96bf6eUL, 0xbadf77d9UL, 1039}, {0xaf87023bUL, 0x9bf0ee6bUL, 1066}
+};
+
 
 /* ========================= methods ================================================================================ */
 
@@ -383,6 +413,24 @@ err_t fromjson_parse_array(fromjson_state_t *state)
     }                                                                                                              \
   while (0)
 
+#define PARSE_NUMBERS(parse_suffix, c_type, array_format)                                                          \
+  do                                                                                                               \
+    {                                                                                                              \
+      c_type *values;                                                                                              \
+      CHECK_AND_ALLOCATE_MEMORY(c_type *, 1);                                                                      \
+      error = fromjson_parse_##parse_suffix##_array(state, &values, &array_length);                                \
+      if (error != ERROR_NONE)                                                                                     \
+        {                                                                                                          \
+          state->shared_state->json_ptr -= is_nested_array ? 2 : 1;                                                \
+          return error;                                                                                            \
+        }                                                                                                          \
+      *(c_type **)state->next_value_memory = values;                                                               \
+      state->value_buffer_pointer_level = 2;                                                                       \
+      state->next_value_memory = values;                                                                           \
+      snprintf(array_type + strlen(array_type), NEXT_VALUE_TYPE_SIZE, "%c(%zu)", array_format, array_length);      \
+    }                                                                                                              \
+  while (0)
+
   if (strchr("]", *(state->shared_state->json_ptr + 1)) == NULL)
     {
       char array_type[NEXT_VALUE_TYPE_SIZE];
@@ -401,30 +449,38 @@ err_t fromjson_parse_array(fromjson_state_t *state)
           err_t error = ERROR_NONE;
           size_t array_length = 0;
           state->shared_state->json_ptr += is_nested_array ? 2 : 1;
-          next_delim_ptr = state->shared_state->json_ptr;
-          while (*next_delim_ptr != ']' &&
-                 fromjson_find_next_delimiter(&next_delim_ptr, next_delim_ptr, array_length == 0, 1))
-            {
-              ++array_length;
-            }
-          if (*next_delim_ptr != ']')
-            {
-              state->shared_state->json_ptr -= is_nested_array ? 2 : 1;
-              return ERROR_PARSE_INCOMPLETE_STRING;
-            }
-          assert(array_length > 0);
           json_datatype = fromjson_check_type(state);
-          switch (json_datatype)
+          if (json_datatype == JSON_DATATYPE_NUMBER)
             {
-            case JSON_DATATYPE_NUMBER:
+              /* Numeric arrays are parsed in a single pass without counting the elements first */
               if (is_int_number(state->shared_state->json_ptr))
                 {
-                  PARSE_VALUES(int, int);
+                  PARSE_NUMBERS(int, int, 'I');
                 }
               else
                 {
-                  PARSE_VALUES(double, double);
+                  PARSE_NUMBERS(double, double, 'D');
                 }
+            }
+          else
+            {
+              next_delim_ptr = state->shared_state->json_ptr;
+              while (*next_delim_ptr != ']' &&
+                     fromjson_find_next_delimiter(&next_delim_ptr, next_delim_ptr, array_length == 0, 1))
+                {
+                  ++array_length;
+                }
+              if (*next_delim_ptr != ']')
+                {
+                  state->shared_state->json_ptr -= is_nested_array ? 2 : 1;
+                  return ERROR_PARSE_INCOMPLETE_STRING;
+                }
+              assert(array_length > 0);
+            }
+          switch (json_datatype)
+            {
+            case JSON_DATATYPE_NUMBER:
+              /* already parsed above */
               break;
             case JSON_DATATYPE_STRING:
               PARSE_VALUES(string, char *);
@@ -468,8 +524,67 @@ err_t fromjson_parse_array(fromjson_state_t *state)
   return ERROR_NONE;
 
 #undef PARSE_VALUES
+#undef PARSE_NUMBERS
 }
 
+#define DEFINE_PARSE_NUMBER_ARRAY(parse_suffix, c_type, parse_error)                                                   \
+  err_t fromjson_parse_##parse_suffix##_array(fromjson_state_t *state, c_type **values_ptr, size_t *array_length_ptr)  \
+  {                                                                                                                    \
+    /* Parse a numeric array (without the opening bracket) into a growing buffer. On success, the json pointer is      \
+     * left on the closing bracket and the buffer is owned by the caller. */                                           \
+    const char *json_ptr = state->shared_state->json_ptr;                                                              \
+    c_type *values = NULL, *new_values;                                                                                \
+    size_t array_length = 0, capacity = 0;                                                                             \
+    int was_successful;                                                                                                \
+                                                                                                                       \
+    for (;;)                                                                                                           \
+      {                                                                                                                \
+        if (array_length == capacity)                                                                                  \
+          {                                                                                                            \
+            capacity = (capacity > 0) ? 2 * capacity : 64;                                                             \
+            new_values = realloc(values, capacity * sizeof(c_type));                                                   \
+            if (new_values == NULL)                                                                                    \
+              {                                                                                                        \
+                debug_print_malloc_error();                                                                            \
+                free(values);                                                                                          \
+                return ERROR_MALLOC;                                                                                   \
+              }                                                                                                        \
+            values = new_values;                                                                                       \
+          }                                                                                                            \
+        values[array_length++] = fromjson_str_to_##parse_suffix(&json_ptr, &was_successful);                           \
+        if (!was_successful)                                                                                           \
+          {                                                                                                            \
+            free(values);                                                                                              \
+            return parse_error;                                                                                        \
+          }                                                                                                            \
+        if (*json_ptr != ',')                                                                                          \
+          {                                                                                                            \
+            break;                                                                                                     \
+          }                                                                                                            \
+        ++json_ptr;                                                                                                    \
+      }                                                                                                                \
+    if (*json_ptr != ']')                                                                                              \
+      {                                                                                                                \
+        free(values);                                                                                                  \
+        return (*json_ptr == '\0') ? ERROR_PARSE_INCOMPLETE_STRING : ERROR_PARSE_ARRAY;                                \
+      }                                                                                                                \
+    /* release the unused capacity */                                                                                  \
+    if ((new_values = realloc(values, array_length * sizeof(c_type))) != NULL)                                         \
+      {                                                                                                                \
+        values = new_values;                                                                                           \
+      }                                                                                                                \
+                                                                                                                       \
+    state->shared_state->json_ptr = (char *)json_ptr;                                                                  \
+    *values_ptr = values;                                                                                              \
+    *array_length_ptr = array_length;                                                                                  \
+    return ERROR_NONE;                                                                                                 \
+  }
+
+DEFINE_PARSE_NUMBER_ARRAY(int, int, ERROR_PARSE_INT)
+DEFINE_PARSE_NUMBER_ARRAY(double, double, ERROR_PARSE_DOUBLE)
+
+#undef DEFINE_PARSE_NUMBER_ARRAY
+
 err_t fromjson_parse_object(fromjson_state_t *state)
 {
   grm_args_t *args;
@@ -679,6 +794,241 @@ size_t fromjson_get_outer_array_length(const char *str)
   return outer_array_length;
 }
 
+int fromjson_decimal_to_double(uint64_t significand, int num_digits, int exponent, double *value)
+{
+  /*
+   * Convert `significand * 10^exponent` with a non-zero `significand` of at most 19 decimal digits to the nearest
+   * double. This is the `DiyFpStrtod` approximation of the double-conversion library, which shares its 64 bit
+   * helpers and cached powers of ten with the Grisu2 serializer: the significand is scaled by a power of ten with a
+   * known error bound (counted in eighths of an ulp), and the result is only returned if rounding it to 53 bits gives
+   * the same double for all values within this bound. Returns 0 if the rounding is ambiguous or if the result
+   * overflows or underflows to zero, these numbers are left to `strtod`.
+   */
+  const int denominator_log = 3, denominator = 1 << 3;
+  const uint64_t hidden_bit = ((uint64_t)1) << 52;
+  tojson_diy_fp_t input, power;
+  uint64_t error = 0, precision_bits_mask, precision_bits, half_way, bits;
+  int cached_index, adjustment_exponent, old_e, order_of_magnitude, significand_size, precision_digits_count, i;
+
+  /* the cached powers cover 10^-348 to 10^340 and the result is out of range outside of these bounds anyway */
+  if (exponent + num_digits > 309 || exponent + num_digits < -323)
+    {
+      return 0;
+    }
+
+  input.f = significand;
+  input.e = 0;
+  while (!(input.f & (((uint64_t)1) << 63)))
+    {
+      input.f <<= 1;
+      --input.e;
+    }
+
+  cached_index = (exponent + 348) >> 3;
+  adjustment_exponent = exponent - (cached_index * 8 - 348);
+  if (adjustment_exponent != 0)
+    {
+      /* multiply by the exactly representable power 10^adjustment_exponent first */
+      power.f = 1;
+      for (i = 0; i < adjustment_exponent; ++i)
+        {
+          power.f *= 10;
+        }
+      power.e = 0;
+      while (!(power.f & (((uint64_t)1) << 63)))
+        {
+          power.f <<= 1;
+          --power.e;
+        }
+      input = tojson_diy_fp_multiply(input, power);
+      if (19 - num_digits < adjustment_exponent)
+        {
+          /* the product does not fit into 64 bits and has been rounded */
+          error += denominator / 2;
+        }
+    }
+  power.f = (((uint64_t)tojson_cached_powers_of_ten[cached_index].f_upper) << 32) |
+            tojson_cached_powers_of_ten[cached_index].f_lower;
+  power.e = tojson_cached_powers_of_ten[cached_index].e;
+  input = tojson_diy_fp_multiply(input, power);
+  /* the cached power and the rounding of the product add half an ulp each, plus one eighth for the product of errors */
+  error += denominator / 2 + (error == 0 ? 0 : 1) + denominator / 2;
+
+  old_e = input.e;
+  while (!(input.f & (((uint64_t)1) << 63)))
+    {
+      input.f <<= 1;
+      --input.e;
+    }
+  error <<= old_e - input.e;
+
+  /* subnormal results have less than 53 significant bits */
+  order_of_magnitude = 64 + input.e;
+  if (order_of_magnitude >= -1074 + 53)
+    {
+      significand_size = 53;
+    }
+  else if (order_of_magnitude <= -1074)
+    {
+      return 0;
+    }
+  else
+    {
+      significand_size = order_of_magnitude + 1074;
+    }
+  precision_digits_count = 64 - significand_size;
+  if (precision_digits_count + denominator_log >= 64)
+    {
+      return 0;
+    }
+  precision_bits_mask = (((uint64_t)1) << precision_digits_count) - 1;
+  precision_bits = (input.f & precision_bits_mask) * denominator;
+  half_way = (((uint64_t)1) << (precision_digits_count - 1)) * denominator;
+  if (half_way - error < precision_bits && precision_bits < half_way + error)
+    {
+      return 0;
+    }
+
+  input.f >>= precision_digits_count;
+  input.e += precision_digits_count;
+  if (precision_bits >= half_way + error)
+    {
+      ++input.f;
+    }
+  if (input.f > (hidden_bit << 1) - 1)
+    {
+      input.f >>= 1;
+      ++input.e;
+    }
+  if (input.e >= 0x7ff - 1075)
+    {
+      return 0;
+    }
+  while (input.e > -1074 && !(input.f & hidden_bit))
+    {
+      input.f <<= 1;
+      --input.e;
+    }
+  if (input.e == -1074 && !(input.f & hidden_bit))
+    {
+      bits = input.f;
+    }
+  else
+    {
+      bits = (input.f & (hidden_bit - 1)) | (((uint64_t)(input.e + 1075)) << 52);
+    }
+  memcpy(value, &bits, sizeof(double));
+
+  return 1;
+}
+
+int fromjson_str_to_double_fast(const char **str, double *value)
+{
+  /*
+   * Convert numbers with at most 19 significant digits without `strtod`, independent of the locale. Numbers with at
+   * most 15 significant digits and a small decimal exponent take Clinger's fast path: the digits and the power of ten
+   * are exactly representable as doubles, so a single multiplication or division is correctly rounded. Other numbers,
+   * like the 16 and 17 digit output of `tojson_format_double`, are converted by `fromjson_decimal_to_double`. Returns 0
+   * for all numbers which cannot be converted this way and for invalid input, which are left to `strtod`.
+   */
+  const char *str_ptr = *str;
+  uint64_t significand = 0;
+  double result;
+  int is_negative = 0, has_digits = 0, num_significant_digits = 0, exponent = 0, explicit_exponent = 0;
+  int explicit_exponent_is_negative = 0;
+
+  if (*str_ptr == '-' || *str_ptr == '+')
+    {
+      is_negative = (*str_ptr == '-');
+      ++str_ptr;
+    }
+  for (; *str_ptr >= '0' && *str_ptr <= '9'; ++str_ptr)
+    {
+      has_digits = 1;
+      if (significand == 0 && *str_ptr == '0')
+        {
+          continue;
+        }
+      if (++num_significant_digits > 19)
+        {
+          return 0;
+        }
+      significand = 10 * significand + (*str_ptr - '0');
+    }
+  if (*str_ptr == '.')
+    {
+      for (++str_ptr; *str_ptr >= '0' && *str_ptr <= '9'; ++str_ptr)
+        {
+          has_digits = 1;
+          --exponent;
+          if (significand == 0 && *str_ptr == '0')
+            {
+              continue;
+            }
+          if (++num_significant_digits > 19)
+            {
+              return 0;
+            }
+          significand = 10 * significand + (*str_ptr - '0');
+        }
+    }
+  if (!has_digits)
+    {
+      return 0;
+    }
+  if (*str_ptr == 'e' || *str_ptr == 'E')
+    {
+      ++str_ptr;
+      if (*str_ptr == '-' || *str_ptr == '+')
+        {
+          explicit_exponent_is_negative = (*str_ptr == '-');
+          ++str_ptr;
+        }
+      if (*str_ptr < '0' || *str_ptr > '9')
+        {
+          return 0;
+        }
+      for (; *str_ptr >= '0' && *str_ptr <= '9'; ++str_ptr)
+        {
+          if (explicit_exponent > 1000)
+            {
+              return 0;
+            }
+          explicit_exponent = 10 * explicit_exponent + (*str_ptr - '0');
+        }
+      exponent += explicit_exponent_is_negative ? -explicit_exponent : explicit_exponent;
+    }
+  if (*str_ptr != ',' && *str_ptr != ']' && *str_ptr != '}')
+    {
+      return 0;
+    }
+
+  if (significand == 0)
+    {
+      result = 0.0;
+    }
+  else if (num_significant_digits <= 15 && exponent >= -22 && exponent <= 22)
+    {
+      result = (double)significand;
+      if (exponent >= 0)
+        {
+          result *= fromjson_exact_powers_of_ten[exponent];
+        }
+      else
+        {
+          result /= fromjson_exact_powers_of_ten[-exponent];
+        }
+    }
+  else if (!fromjson_decimal_to_double(significand, num_significant_digits, exponent, &result))
+    {
+      return 0;
+    }
+  *value = is_negative ? -result : result;
+  *str = str_ptr;
+
+  return 1;
+}
+
 double fromjson_str_to_double(const char **str, int *was_successful)
 {
   char *conversion_end = NULL;
@@ -686,6 +1036,15 @@ double fromjson_str_to_double(const char **str, int *was_successful)
   int success = 0;
   const char *next_delim_ptr = NULL;
 
+  if (*str != NULL && fromjson_str_to_double_fast(str, &conversion_result))
+    {
+      if (was_successful != NULL)
+        {
+          *was_successful = 1;
+        }
+      return conversion_result;
+    }
+
   errno = 0;
   if (*str != NULL)
     {
@@ -704,7 +1063,9 @@ double fromjson_str_to_double(const char **str, int *was_successful)
       fromjson_find_next_delimiter(&next_delim_ptr, *str, 1, 0);
       debug_print_error(("The parameter \"%.*s\" is not a valid number!\n", next_delim_ptr - *str, *str));
     }
-  else if (errno == ERANGE)
+  /* `strtod` may report a range error for subnormal results, too, which are valid numbers nevertheless */
+  else if (errno == ERANGE &&
+           (conversion_result == HUGE_VAL || conversion_result == -HUGE_VAL || conversion_result == 0.0))
     {
       fromjson_find_next_delimiter(&next_delim_ptr, *str, 1, 0);
       if (conversion_result == HUGE_VAL || conversion_result == -HUGE_VAL)
@@ -731,12 +1092,53 @@ double fromjson_str_to_double(const char **str, int *was_successful)
   return conversion_result;
 }
 
+int fromjson_str_to_int_fast(const char **str, int *value)
+{
+  /* Convert integers with at most 9 digits, which cannot overflow an `int`, without `strtol`. Returns 0 for all other
+   * numbers and for invalid input, which are left to `strtol`. */
+  const char *str_ptr = *str;
+  int is_negative = 0, num_digits = 0, result = 0;
+
+  if (*str_ptr == '-' || *str_ptr == '+')
+    {
+      is_negative = (*str_ptr == '-');
+      ++str_ptr;
+    }
+  for (; *str_ptr >= '0' && *str_ptr <= '9'; ++str_ptr)
+    {
+      if (++num_digits > 9)
+        {
+          return 0;
+        }
+      result = 10 * result + (*str_ptr - '0');
+    }
+  if (num_digits == 0 || (*str_ptr != ',' && *str_ptr != ']' && *str_ptr != '}'))
+    {
+      return 0;
+    }
+
+  *value = is_negative ? -result : result;
+  *str = str_ptr;
+
+  return 1;
+}
+
 int fromjson_str_to_int(const char **str, int *was_successful)
 {
   char *conversion_end = NULL;
   long conversion_result;
   int success = 0;
   const char *next_delim_ptr = NULL;
+  int int_value;
+
+  if (*str != NULL && fromjson_str_to_int_fast(str, &int_value))
+    {
+      if (was_successful != NULL)
+        {
+          *was_successful = 1;
+        }
+      return int_value;
+    }
 
   errno = 0;
   if (*str != NULL)
@@ -788,6 +1190,287 @@ int fromjson_str_to_int(const char **str, int *was_successful)
 
 /* ------------------------- json serializer ------------------------------------------------------------------------ */
 
+/*
+ * Doubles are written with the shortest digit string that reads back to the same value. The digits are generated by
+ * the Grisu2 algorithm of Florian Loitsch ("Printing Floating-Point Numbers Quickly and Accurately with Integers",
+ * PLDI 2010), which works on 64 bit integers only. Its output always round trips, but in rare cases it is one digit
+ * longer than the shortest possible output.
+ */
+
+tojson_diy_fp_t tojson_diy_fp_multiply(tojson_diy_fp_t x, tojson_diy_fp_t y)
+{
+  /* upper 64 bits of the 128 bit product, rounded */
+  const uint64_t mask = 0xffffffffUL;
+  uint64_t a = x.f >> 32, b = x.f & mask, c = y.f >> 32, d = y.f & mask;
+  uint64_t ac = a * c, bc = b * c, ad = a * d, bd = b * d;
+  uint64_t middle = (bd >> 32) + (ad & mask) + (bc & mask) + (((uint64_t)1) << 31);
+  tojson_diy_fp_t product;
+
+  product.f = ac + (ad >> 32) + (bc >> 32) + (middle >> 32);
+  product.e = x.e + y.e + 64;
+
+  return product;
+}
+
+void tojson_grisu_round(char *digits, int length, uint64_t delta, uint64_t rest, uint64_t ten_kappa, uint64_t distance)
+{
+  /* move the last digit towards the exact value as long as the result stays within the rounding interval */
+  while (rest < distance && delta - rest >= ten_kappa &&
+         (rest + ten_kappa < distance || distance - rest > rest + ten_kappa - distance))
+    {
+      --digits[length - 1];
+      rest += ten_kappa;
+    }
+}
+
+void tojson_grisu_generate_digits(tojson_diy_fp_t w, tojson_diy_fp_t upper, uint64_t delta, char *digits, int *length,
+                                  int *decimal_exponent)
+{
+  static const unsigned long powers_of_ten[] = {1UL,      10UL,      100UL,      1000UL,      10000UL,
+                                                100000UL, 1000000UL, 10000000UL, 100000000UL, 1000000000UL};
+  int shift = -upper.e;
+  uint64_t one = ((uint64_t)1) << shift;
+  uint64_t distance = upper.f - w.f;
+  unsigned long integral_part = (unsigned long)(upper.f >> shift);
+  uint64_t fractional_part = upper.f & (one - 1);
+  uint64_t unit = 1;
+  int kappa = 0;
+
+  while (kappa < 10 && integral_part >= powers_of_ten[kappa])
+    {
+      ++kappa;
+    }
+  *length = 0;
+
+  while (kappa > 0)
+    {
+      unsigned long digit = integral_part / powers_of_ten[kappa - 1];
+      uint64_t rest;
+
+      integral_part %= powers_of_ten[kappa - 1];
+      if (digit != 0 || *length != 0)
+        {
+          digits[(*length)++] = (char)('0' + digit);
+        }
+      --kappa;
+      rest = (((uint64_t)integral_part) << shift) + fractional_part;
+      if (rest <= delta)
+        {
+          *decimal_exponent += kappa;
+          tojson_grisu_round(digits, *length, delta, rest, ((uint64_t)powers_of_ten[kappa]) << shift, distance);
+          return;
+        }
+    }
+
+  while (1)
+    {
+      char digit;
+
+      fractional_part *= 10;
+      delta *= 10;
+      /* the distance is only needed for rounding, which is skipped once its scaled value would overflow */
+      unit = (kappa > -19) ? unit * 10 : 0;
+      digit = (char)(fractional_part >> shift);
+      if (digit != 0 || *length != 0)
+        {
+          digits[(*length)++] = (char)('0' + digit);
+        }
+      fractional_part &= one - 1;
+      --kappa;
+      if (fractional_part < delta)
+        {
+          *decimal_exponent += kappa;
+          tojson_grisu_round(digits, *length, delta, fractional_part, one, distance * unit);
+          return;
+        }
+    }
+}
+
+void tojson_grisu2(uint64_t bits, char *digits, int *length, int *decimal_exponent)
+{
+  /*
+   * Generate the decimal digits of the finite, positive double with the given bit pattern, so that the double equals
+   * `digits * 10^decimal_exponent`. `digits` must have room for 18 characters and is not terminated.
+   */
+  const uint64_t hidden_bit = ((uint64_t)1) << 52;
+  int biased_exponent = (int)((bits >> 52) & 0x7ff);
+  tojson_diy_fp_t v, w, upper, lower, cached_power;
+  double k_estimate;
+  int k, cached_index;
+
+  v.f = bits & (hidden_bit - 1);
+  if (biased_exponent != 0)
+    {
+      v.f += hidden_bit;
+      v.e = biased_exponent - 1075;
+    }
+  else
+    {
+      v.e = -1074;
+    }
+
+  /* boundaries of the interval of all numbers which round to `v`, with the normalized exponent of the upper one */
+  upper.f = (v.f << 1) + 1;
+  upper.e = v.e - 1;
+  while (!(upper.f & (hidden_bit << 1)))
+    {
+      upper.f <<= 1;
+      --upper.e;
+    }
+  upper.f <<= 10;
+  upper.e -= 10;
+  if (v.f == hidden_bit)
+    {
+      lower.f = (v.f << 2) - 1;
+      lower.e = v.e - 2;
+    }
+  else
+    {
+      lower.f = (v.f << 1) - 1;
+      lower.e = v.e - 1;
+    }
+  lower.f <<= lower.e - upper.e;
+  lower.e = upper.e;
+
+  w = v;
+  while (!(w.f & (((uint64_t)1) << 63)))
+    {
+      w.f <<= 1;
+      --w.e;
+    }
+
+  /* scale by a cached power of ten so that the binary exponent of the upper boundary ends up in [-60, -32] */
+  k_estimate = (-61 - upper.e) * 0.30102999566398114 + 347;
+  k = (int)k_estimate;
+  if (k_estimate - k > 0.0)
+    {
+      ++k;
+    }
+  cached_index = (k >> 3) + 1;
+  *decimal_exponent = 348 - (cached_index << 3);
+  cached_power.f = (((uint64_t)tojson_cached_powers_of_ten[cached_index].f_upper) << 32) |
+                   tojson_cached_powers_of_ten[cached_index].f_lower;
+  cached_power.e = tojson_cached_powers_of_ten[cached_index].e;
+
+  w = tojson_diy_fp_multiply(w, cached_power);
+  upper = tojson_diy_fp_multiply(upper, cached_power);
+  lower = tojson_diy_fp_multiply(lower, cached_power);
+  /* shrink the interval by the maximum error of the multiplications so that the output is guaranteed to round trip */
+  ++lower.f;
+  --upper.f;
+  tojson_grisu_generate_digits(w, upper, upper.f - lower.f, digits, length, decimal_exponent);
+}
+
+int tojson_format_double(char *buffer, double value)
+{
+  /*
+   * Write the shortest representation of `value` which reads back to the same double to `buffer` and return its
+   * length. The layout follows `%.17G` so that the output only differs from it in superfluous digits: "NAN" and "INF"
+   * are written in uppercase since "nan" would be read as null, and a trailing '.' marks integral values as doubles.
+   * At most `TOJSON_DOUBLE_MAX_LENGTH` characters are written, without a terminating null byte.
+   */
+  uint64_t bits;
+  char digits[18];
+  int length, decimal_exponent, exponent, i;
+  char *buffer_ptr = buffer;
+
+  memcpy(&bits, &value, sizeof(double));
+  if (bits >> 63)
+    {
+      *buffer_ptr++ = '-';
+      bits &= ~(((uint64_t)1) << 63);
+    }
+  if ((bits >> 52) == 0x7ff)
+    {
+      memcpy(buffer_ptr, (bits & ((((uint64_t)1) << 52) - 1)) ? "NAN" : "INF", 3);
+      return (int)(buffer_ptr - buffer) + 3;
+    }
+  if (bits == 0)
+    {
+      *buffer_ptr++ = '0';
+      *buffer_ptr++ = '.';
+      return (int)(buffer_ptr - buffer);
+    }
+
+  tojson_grisu2(bits, digits, &length, &decimal_exponent);
+  exponent = length + decimal_exponent - 1;
+  if (exponent >= -4 && exponent < 17)
+    {
+      if (exponent >= 0)
+        {
+          for (i = 0; i <= exponent; ++i)
+            {
+              *buffer_ptr++ = (i < length) ? digits[i] : '0';
+            }
+          *buffer_ptr++ = '.';
+          for (; i < length; ++i)
+            {
+              *buffer_ptr++ = digits[i];
+            }
+        }
+      else
+        {
+          *buffer_ptr++ = '0';
+          *buffer_ptr++ = '.';
+          for (i = -1; i > exponent; --i)
+            {
+              *buffer_ptr++ = '0';
+            }
+          memcpy(buffer_ptr, digits, length);
+          buffer_ptr += length;
+        }
+    }
+  else
+    {
+      *buffer_ptr++ = digits[0];
+      if (length > 1)
+        {
+          *buffer_ptr++ = '.';
+          memcpy(buffer_ptr, digits + 1, length - 1);
+          buffer_ptr += length - 1;
+        }
+      *buffer_ptr++ = 'E';
+      *buffer_ptr++ = (exponent < 0) ? '-' : '+';
+      if (exponent < 0)
+        {
+          exponent = -exponent;
+        }
+      if (exponent >= 100)
+        {
+          *buffer_ptr++ = (char)('0' + exponent / 100);
+        }
+      *buffer_ptr++ = (char)('0' + exponent / 10 % 10);
+      *buffer_ptr++ = (char)('0' + exponent % 10);
+    }
+
+  return (int)(buffer_ptr - buffer);
+}
+
+int tojson_format_int(char *buffer, int value)
+{
+  /* Write `value` in decimal to `buffer` without a terminating null byte and return the length. */
+  char reversed_digits[TOJSON_INT_MAX_LENGTH];
+  unsigned int magnitude = (value < 0) ? 0U - (unsigned int)value : (unsigned int)value;
+  int num_digits = 0, length = 0;
+
+  do
+    {
+      reversed_digits[num_digits++] = (char)('0' + magnitude % 10);
+      magnitude /= 10;
+    }
+  while (magnitude > 0);
+  if (value < 0)
+    {
+      buffer[length++] = '-';
+    }
+  while (num_digits > 0)
+    {
+      buffer[length++] = reversed_digits[--num_digits];
+    }
+
+  return length;
+}
+
 #define CHECK_PADDING(type)                                                             \
   do                                                                                    \
     {                                                                                   \
@@ -919,11 +1602,90 @@ int fromjson_str_to_int(const char **str, int *was_successful)
     return error;                                                                                         \
   }
 
+#define DEFINE_STRINGIFY_NUMBER_VALUE(name, type, max_length)                    \
+  err_t tojson_stringify_##name##_value(memwriter_t *memwriter, type value)      \
+  {                                                                              \
+    err_t error;                                                                 \
+    char *buffer_ptr;                                                            \
+    if ((error = memwriter_ensure_buf(memwriter, max_length + 1)) != ERROR_NONE) \
+      {                                                                          \
+        return error;                                                            \
+      }                                                                          \
+    buffer_ptr = memwriter_buf(memwriter) + memwriter_size(memwriter);           \
+    buffer_ptr += tojson_format_##name(buffer_ptr, value);                       \
+    *buffer_ptr = '\0';                                                          \
+    memwriter->size = buffer_ptr - memwriter_buf(memwriter);                     \
+    return ERROR_NONE;                                                           \
+  }
+
+/* Number arrays are formatted directly into the memwriter buffer, which is enlarged once per block of elements. */
+#define DEFINE_STRINGIFY_NUMBER_MULTI(name, type, max_length)                                                     \
+  err_t tojson_stringify_##name##_array(tojson_state_t *state)                                                    \
+  {                                                                                                               \
+    type *values;                                                                                                 \
+    unsigned int length, block_start, block_end, i;                                                               \
+    char *buffer_ptr;                                                                                             \
+    err_t error = ERROR_NONE;                                                                                     \
+    INIT_MULTI_VALUE(values, type);                                                                               \
+    if (state->additional_type_info != NULL)                                                                      \
+      {                                                                                                           \
+        if (!str_to_uint(state->additional_type_info, &length))                                                   \
+          {                                                                                                       \
+            debug_print_error(                                                                                    \
+                ("The given array length \"%s\" is no valid number; the array contents will be ignored.",         \
+                 state->additional_type_info));                                                                   \
+            length = 0;                                                                                           \
+          }                                                                                                       \
+      }                                                                                                           \
+    else                                                                                                          \
+      {                                                                                                           \
+        length = state->shared->array_length;                                                                     \
+      }                                                                                                           \
+    /* write array start */                                                                                       \
+    if ((error = memwriter_putc(state->memwriter, '[')) != ERROR_NONE)                                            \
+      {                                                                                                           \
+        return error;                                                                                             \
+      }                                                                                                           \
+    /* write array content */                                                                                     \
+    for (block_start = 0; block_start < length; block_start = block_end)                                          \
+      {                                                                                                           \
+        block_end = (length - block_start > TOJSON_NUMBER_ARRAY_BLOCK_SIZE)                                       \
+                        ? block_start + TOJSON_NUMBER_ARRAY_BLOCK_SIZE                                            \
+                        : length;                                                                                 \
+        /* one separator per value and the terminating null byte */                                               \
+        if ((error = memwriter_ensure_buf(state->memwriter, (block_end - block_start) * (max_length + 1) + 1)) != \
+            ERROR_NONE)                                                                                           \
+          {                                                                                                       \
+            return error;                                                                                         \
+          }                                                                                                       \
+        buffer_ptr = memwriter_buf(state->memwriter) + memwriter_size(state->memwriter);                          \
+        for (i = block_start; i < block_end; ++i)                                                                 \
+          {                                                                                                       \
+            if (i > 0)                                                                                            \
+              {                                                                                                   \
+                *buffer_ptr++ = ',';                                                                              \
+              }                                                                                                   \
+            buffer_ptr += tojson_format_##name(buffer_ptr, values[i]);                                            \
+          }                                                                                                       \
+        *buffer_ptr = '\0';                                                                                       \
+        state->memwriter->size = buffer_ptr - memwriter_buf(state->memwriter);                                    \
+      }                                                                                                           \
+    /* write array end */                                                                                         \
+    if ((error = memwriter_putc(state->memwriter, ']')) != ERROR_NONE)                                            \
+      {                                                                                                           \
+        return error;                                                                                             \
+      }                                                                                                           \
+    FIN_MULTI_VALUE(type);                                                                                        \
+    state->shared->wrote_output = 1;                                                                              \
+    return error;                                                                                                 \
+  }
+
 DEFINE_STRINGIFY_SINGLE(int, int, int)
-DEFINE_STRINGIFY_MULTI(int, int)
-DEFINE_STRINGIFY_VALUE(int, int, "%d")
+DEFINE_STRINGIFY_NUMBER_MULTI(int, int, TOJSON_INT_MAX_LENGTH)
+DEFINE_STRINGIFY_NUMBER_VALUE(int, int, TOJSON_INT_MAX_LENGTH)
 DEFINE_STRINGIFY_SINGLE(double, double, double)
-DEFINE_STRINGIFY_MULTI(double, double)
+DEFINE_STRINGIFY_NUMBER_MULTI(double, double, TOJSON_DOUBLE_MAX_LENGTH)
+DEFINE_STRINGIFY_NUMBER_VALUE(double, double, TOJSON_DOUBLE_MAX_LENGTH)
 DEFINE_STRINGIFY_SINGLE(char, char, int)
 DEFINE_STRINGIFY_VALUE(char, char, "%c")
 DEFINE_STRINGIFY_SINGLE(string, char *, char *)
@@ -935,40 +1697,10 @@ DEFINE_STRINGIFY_MULTI(args, grm_args_t *)
 
 #undef DEFINE_STRINGIFY_SINGLE
 #undef DEFINE_STRINGIFY_MULTI
+#undef DEFINE_STRINGIFY_NUMBER_MULTI
+#undef DEFINE_STRINGIFY_NUMBER_VALUE
 #undef DEFINE_STRINGIFY_VALUE
 
-#define STR(x) #x
-#define XSTR(x) STR(x)
-
-err_t tojson_stringify_double_value(memwriter_t *memwriter, double value)
-{
-  err_t error;
-  size_t string_start_index;
-  const char *unprocessed_string;
-
-  string_start_index = memwriter_size(memwriter);
-  /*
-     The %G format specifier is important here, as it returns "NAN" for missing values -
-     %g would return "nan" and be handled as JSON_DATATYPE_NULL in fromjson_check_type()
-   */
-  if ((error = memwriter_printf(memwriter, "%." XSTR(DBL_DECIMAL_DIG) "G", value)) != ERROR_NONE)
-    {
-      return error;
-    }
-  unprocessed_string = memwriter_buf(memwriter) + string_start_index;
-  if (strspn(unprocessed_string, "0123456789-") == memwriter_size(memwriter) - string_start_index)
-    {
-      if ((error = memwriter_putc(memwriter, '.')) != ERROR_NONE)
-        {
-          return error;
-        }
-    }
-  return ERROR_NONE;
-}
-
-#undef XSTR
-#undef STR
-
 err_t tojson_stringify_char_array(tojson_state_t *state)
 {
   char *chars;
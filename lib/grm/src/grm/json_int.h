@@ -8,6 +8,7 @@ extern "C" {
 /* ######################### includes ############################################################################### */
 
 #include <stdarg.h>
+#include <stdint.h>
 
 #include <grm/args.h>
 #include "grm/error.h"
@@ -29,6 +30,15 @@ extern const char *FROMJSON_VALID_DELIMITERS;
 
 #define NEXT_VALUE_TYPE_SIZE 80
 
+/* ------------------------- json serializer ------------------------------------------------------------------------ */
+
+/* longest output of `tojson_format_double`, e.g. "-0.00012345678901234567" or "-1.2345678901234567E-308" */
+#define TOJSON_DOUBLE_MAX_LENGTH 24
+/* longest output of `tojson_format_int`, e.g. "-2147483648" */
+#define TOJSON_INT_MAX_LENGTH 11
+/* number of array elements for which space in the output buffer is reserved at once */
+#define TOJSON_NUMBER_ARRAY_BLOCK_SIZE 1024
+
 
 /* ========================= datatypes ============================================================================== */
 
@@ -113,6 +123,19 @@ typedef struct
   unsigned int struct_nested_level;
 } tojson_permanent_state_t;
 
+typedef struct
+{
+  uint64_t f;
+  int e;
+} tojson_diy_fp_t;
+
+typedef struct
+{
+  unsigned long f_upper;
+  unsigned long f_lower;
+  int e;
+} tojson_cached_power_t;
+
 /* ========================= methods ================================================================================ */
 
 /* ------------------------- json deserializer ---------------------------------------------------------------------- */
@@ -128,6 +151,8 @@ err_t fromjson_parse_int(fromjson_state_t *state);
 err_t fromjson_parse_double(fromjson_state_t *state);
 err_t fromjson_parse_string(fromjson_state_t *state);
 err_t fromjson_parse_array(fromjson_state_t *state);
+err_t fromjson_parse_int_array(fromjson_state_t *state, int **values_ptr, size_t *array_length_ptr);
+err_t fromjson_parse_double_array(fromjson_state_t *state, double **values_ptr, size_t *array_length_ptr);
 err_t fromjson_parse_object(fromjson_state_t *state);
 
 fromjson_datatype_t fromjson_check_type(const fromjson_state_t *state);
@@ -136,7 +161,10 @@ int fromjson_is_escaped_delimiter(const char *delim_ptr, const char *str);
 int fromjson_find_next_delimiter(const char **delim_ptr, const char *src, int include_start,
                                  int exclude_nested_structures);
 size_t fromjson_get_outer_array_length(const char *str);
+int fromjson_decimal_to_double(uint64_t significand, int num_digits, int exponent, double *value);
+int fromjson_str_to_double_fast(const char **str, double *value);
 double fromjson_str_to_double(const char **str, int *was_successful);
+int fromjson_str_to_int_fast(const char **str, int *value);
 int fromjson_str_to_int(const char **str, int *was_successful);
 
 
@@ -147,6 +175,13 @@ int fromjson_str_to_int(const char **str, int *was_successful);
   err_t tojson_stringify_##name##_array(tojson_state_t *state); \
   err_t tojson_stringify_##name##_value(memwriter_t *memwriter, type value);
 
+tojson_diy_fp_t tojson_diy_fp_multiply(tojson_diy_fp_t x, tojson_diy_fp_t y);
+void tojson_grisu_round(char *digits, int length, uint64_t delta, uint64_t rest, uint64_t ten_kappa, uint64_t distance);
+void tojson_grisu_generate_digits(tojson_diy_fp_t w, tojson_diy_fp_t upper, uint64_t delta, char *digits, int *length,
+                                  int *decimal_exponent);
+void tojson_grisu2(uint64_t bits, char *digits, int *length, int *decimal_exponent);
+int tojson_format_double(char *buffer, double value);
+int tojson_format_int(char *buffer, int value);
 err_t tojson_read_array_length(tojson_state_t *state);
 err_t tojson_skip_bytes(tojson_state_t *state);
 DECLARE_STRINGIFY(int, int)
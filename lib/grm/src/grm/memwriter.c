@@ -170,28 +170,28 @@ err_t memwriter_printf(memwriter_t *memwriter, const char *format, ...)
 
 err_t memwriter_puts(memwriter_t *memwriter, const char *s)
 {
-  return memwriter_printf(memwriter, "%s", s);
+  return memwriter_puts_with_len(memwriter, (char *)s, strlen(s));
 }
 
 err_t memwriter_puts_with_len(memwriter_t *memwriter, char *s, size_t length)
 {
   err_t error = ERROR_NONE;
 
-  while (length > 0)
+  /* keep the buffer null terminated like `memwriter_printf` does */
+  if ((error = memwriter_ensure_buf(memwriter, length + 1)) != ERROR_NONE)
     {
-      if ((error = memwriter_putc(memwriter, *(s++))) != ERROR_NONE)
-        {
-          return error;
-        }
-      --length;
+      return error;
     }
+  memcpy(&memwriter->buf[memwriter->size], s, length);
+  memwriter->size += length;
+  memwriter->buf[memwriter->size] = '\0';
 
   return error;
 }
 
 err_t memwriter_putc(memwriter_t *memwriter, char c)
 {
-  return memwriter_printf(memwriter, "%c", c);
+  return memwriter_puts_with_len(memwriter, &c, 1);
 }
 
 err_t memwriter_memcpy(memwriter_t *memwriter, const void *source, size_t num)
@@ -6,6 +6,7 @@
 
 #include <ctype.h>
 #include <limits.h>
+#include <stdint.h>
 #include <string.h>
 #ifdef _WIN32
 #include <winsock2.h>
@@ -22,6 +23,7 @@
 #endif
 
 #include "args_int.h"
+#include "bson_int.h"
 #include "dynamic_args_array_int.h"
 #include "json_int.h"
 #include "net_int.h"
@@ -125,6 +127,8 @@ err_t receiver_init_for_custom(net_handle_t *handle, const char *name, unsigned
   handle->sender_receiver.receiver.recv = receiver_recv_for_custom;
   handle->sender_receiver.receiver.send = NULL;
   handle->finalize = receiver_finalize_for_custom;
+  handle->recv_format = NET_MESSAGE_FORMAT_JSON_ETB;
+  handle->send_frames = 0;
   handle->sender_receiver.receiver.memwriter = memwriter_new();
   if (handle->sender_receiver.receiver.memwriter == NULL)
     {
@@ -158,6 +162,8 @@ err_t receiver_init_for_socket(net_handle_t *handle, const char *hostname, unsig
   handle->sender_receiver.receiver.recv = receiver_recv_for_socket;
   handle->sender_receiver.receiver.send = sender_send_for_socket;
   handle->finalize = receiver_finalize_for_socket;
+  handle->recv_format = NET_MESSAGE_FORMAT_JSON_ETB;
+  handle->send_frames = is_env_variable_enabled(ENABLE_FRAMED_PROTOCOL_ENV_KEY);
 
 #ifdef _WIN32
   /* Initialize winsock */
@@ -310,20 +316,24 @@ err_t receiver_finalize_for_socket(net_handle_t *handle)
   return error;
 }
 
-err_t receiver_recv_for_socket(net_handle_t *handle)
+err_t receiver_recv_chunk_for_socket(net_handle_t *handle, size_t max_size, int wait_all)
 {
-  int search_start_index = 0;
-  char *end_ptr;
-  static char recv_buf[SOCKET_RECV_BUF_SIZE];
+  /*
+   * Receive up to `max_size` bytes (exactly `max_size` bytes if `wait_all` is set) directly into the memwriter buffer
+   * and keep the buffer null terminated.
+   */
+  memwriter_t *memwriter = handle->sender_receiver.receiver.memwriter;
   err_t error = ERROR_NONE;
 
-  while ((end_ptr = memchr(memwriter_buf(handle->sender_receiver.receiver.memwriter) + search_start_index, ETB,
-                           memwriter_size(handle->sender_receiver.receiver.memwriter) - search_start_index)) == NULL)
+  if ((error = memwriter_ensure_buf(memwriter, max_size + 1)) != ERROR_NONE)
     {
-      int bytes_received;
-      search_start_index = memwriter_size(handle->sender_receiver.receiver.memwriter);
-      bytes_received =
-          recv(handle->sender_receiver.receiver.comm.socket.client_socket, recv_buf, SOCKET_RECV_BUF_SIZE, 0);
+      return error;
+    }
+  while (max_size > 0)
+    {
+      int bytes_received =
+          recv(handle->sender_receiver.receiver.comm.socket.client_socket, memwriter_buf(memwriter) + memwriter->size,
+               (max_size > INT_MAX) ? INT_MAX : (int)max_size, wait_all ? NET_RECV_WAIT_ALL : 0);
       if (bytes_received < 0)
         {
           psocketerror("error while receiving data");
@@ -333,14 +343,119 @@ err_t receiver_recv_for_socket(net_handle_t *handle)
         {
           return ERROR_NETWORK_RECV_CONNECTION_SHUTDOWN;
         }
-      if ((error = memwriter_printf(handle->sender_receiver.receiver.memwriter, "%.*s", bytes_received, recv_buf)) !=
+      memwriter->size += bytes_received;
+      max_size -= bytes_received;
+      if (!wait_all)
+        {
+          break;
+        }
+    }
+  memwriter_buf(memwriter)[memwriter->size] = '\0';
+
+  return error;
+}
+
+err_t receiver_recv_frame_for_socket(net_handle_t *handle)
+{
+  memwriter_t *memwriter = handle->sender_receiver.receiver.memwriter;
+  const unsigned char *header;
+  uint64_t payload_size = 0;
+  int i;
+  err_t error = ERROR_NONE;
+
+  if (memwriter_size(memwriter) < NET_FRAME_HEADER_SIZE &&
+      (error = receiver_recv_chunk_for_socket(handle, NET_FRAME_HEADER_SIZE - memwriter_size(memwriter), 1)) !=
           ERROR_NONE)
+    {
+      return error;
+    }
+  header = (const unsigned char *)memwriter_buf(memwriter);
+  if (header[1] != NET_FRAME_PROTOCOL_VERSION ||
+      (header[2] != NET_MESSAGE_FORMAT_JSON && header[2] != NET_MESSAGE_FORMAT_BSON))
+    {
+      debug_print_error(("Received a frame of protocol version %d with payload format %d, which is not supported.\n",
+                         header[1], header[2]));
+      return ERROR_NETWORK_RECV;
+    }
+  for (i = NET_FRAME_HEADER_SIZE - 1; i >= 4; --i)
+    {
+      payload_size = (payload_size << 8) | header[i];
+    }
+  if (payload_size > (size_t)-1 - NET_FRAME_HEADER_SIZE - 1)
+    {
+      debug_print_error(("Received a frame of %lu bytes, which is too large.\n", (unsigned long)payload_size));
+      return ERROR_NETWORK_RECV;
+    }
+  handle->recv_format = (net_message_format_t)header[2];
+  handle->sender_receiver.receiver.message_size = NET_FRAME_HEADER_SIZE + (size_t)payload_size;
+
+  /* the payload is received in one piece into its final place, the buffer is enlarged at most once */
+  if (memwriter_size(memwriter) < handle->sender_receiver.receiver.message_size &&
+      (error = receiver_recv_chunk_for_socket(
+           handle, handle->sender_receiver.receiver.message_size - memwriter_size(memwriter), 1)) != ERROR_NONE)
+    {
+      return error;
+    }
+  if (handle->recv_format == NET_MESSAGE_FORMAT_JSON &&
+      (payload_size == 0 || memwriter_buf(memwriter)[handle->sender_receiver.receiver.message_size - 1] != '\0'))
+    {
+      debug_print_error(("Received a JSON frame without a terminating null byte.\n"));
+      return ERROR_NETWORK_RECV;
+    }
+  if (handle->recv_format == NET_MESSAGE_FORMAT_BSON)
+    {
+      /* a BSON document starts with its own little-endian 32-bit length and ends with a null byte */
+      const unsigned char *payload = (const unsigned char *)memwriter_buf(memwriter) + NET_FRAME_HEADER_SIZE;
+      uint32_t document_size = 0;
+      if (payload_size >= 5)
+        {
+          document_size = (uint32_t)payload[0] | ((uint32_t)payload[1] << 8) | ((uint32_t)payload[2] << 16) |
+                          ((uint32_t)payload[3] << 24);
+        }
+      if (payload_size < 5 || document_size != payload_size || payload[payload_size - 1] != '\0')
+        {
+          debug_print_error(("Received a BSON frame of %lu bytes which does not contain a single BSON document.\n",
+                             (unsigned long)payload_size));
+          return ERROR_NETWORK_RECV;
+        }
+    }
+
+  return error;
+}
+
+err_t receiver_recv_for_socket(net_handle_t *handle)
+{
+  memwriter_t *memwriter = handle->sender_receiver.receiver.memwriter;
+  size_t search_start_index = 0;
+  char *end_ptr;
+  err_t error = ERROR_NONE;
+
+  /*
+   * Receive whatever is available (up to one buffer size) at first, its first byte tells if the message is a frame.
+   * A frame header is parsed from the received data and only the rest of the payload is received afterwards.
+   */
+  if (memwriter_size(memwriter) == 0 &&
+      (error = receiver_recv_chunk_for_socket(handle, SOCKET_RECV_BUF_SIZE, 0)) != ERROR_NONE)
+    {
+      return error;
+    }
+  if (*memwriter_buf(memwriter) == NET_FRAME_MAGIC)
+    {
+      return receiver_recv_frame_for_socket(handle);
+    }
+
+  handle->recv_format = NET_MESSAGE_FORMAT_JSON_ETB;
+  while ((end_ptr = memchr(memwriter_buf(memwriter) + search_start_index, ETB,
+                           memwriter_size(memwriter) - search_start_index)) == NULL)
+    {
+      search_start_index = memwriter_size(memwriter);
+      if ((error = receiver_recv_chunk_for_socket(handle, SOCKET_RECV_BUF_SIZE, 0)) != ERROR_NONE)
         {
           return error;
         }
     }
   *end_ptr = '\0';
-  handle->sender_receiver.receiver.message_size = end_ptr - memwriter_buf(handle->sender_receiver.receiver.memwriter);
+  handle->sender_receiver.receiver.message_size = end_ptr - memwriter_buf(memwriter);
 
   return error;
 }
@@ -380,6 +495,8 @@ err_t sender_init_for_custom(net_handle_t *handle, const char *name, unsigned in
   handle->sender_receiver.sender.recv = NULL;
   handle->sender_receiver.sender.send = sender_send_for_custom;
   handle->finalize = sender_finalize_for_custom;
+  handle->recv_format = NET_MESSAGE_FORMAT_JSON_ETB;
+  handle->send_frames = 0;
   handle->sender_receiver.sender.memwriter = memwriter_new();
   if (handle->sender_receiver.sender.memwriter == NULL)
     {
@@ -419,6 +536,8 @@ err_t sender_init_for_socket(net_handle_t *handle, const char *hostname, unsigne
   handle->sender_receiver.sender.recv = receiver_recv_for_socket;
   handle->sender_receiver.sender.send = sender_send_for_socket;
   handle->finalize = sender_finalize_for_socket;
+  handle->recv_format = NET_MESSAGE_FORMAT_JSON_ETB;
+  handle->send_frames = is_env_variable_enabled(ENABLE_FRAMED_PROTOCOL_ENV_KEY);
 
 #ifdef _WIN32
   /* Initialize winsock */
@@ -585,34 +704,75 @@ err_t sender_finalize_for_socket(net_handle_t *handle)
   return error;
 }
 
-err_t sender_send_for_socket(net_handle_t *handle)
+err_t sender_send_bytes_for_socket(net_handle_t *handle, const char *buf, size_t size)
 {
-  const char *buf;
-  size_t buf_size;
-  int bytes_left;
+  while (size > 0)
+    {
+      int bytes_sent = send(handle->sender_receiver.sender.comm.socket.client_socket, buf,
+                            (size > INT_MAX) ? INT_MAX : (int)size, 0);
+      if (bytes_sent < 0)
+        {
+          psocketerror("could not send any data");
+          return ERROR_NETWORK_SEND;
+        }
+      buf += bytes_sent;
+      size -= bytes_sent;
+    }
+
+  return ERROR_NONE;
+}
+
+err_t sender_send_frame_for_socket(net_handle_t *handle, net_message_format_t format)
+{
+  /*
+   * The memwriter must contain `NET_FRAME_HEADER_SIZE` reserved bytes followed by the payload. The header is written
+   * to the reserved bytes, so that the whole frame can be sent at once.
+   */
+  memwriter_t *memwriter = handle->sender_receiver.sender.memwriter;
+  unsigned char *header = (unsigned char *)memwriter_buf(memwriter);
+  uint64_t payload_size = memwriter_size(memwriter) - NET_FRAME_HEADER_SIZE;
+  int i;
   err_t error = ERROR_NONE;
 
-  if ((error = memwriter_putc(handle->sender_receiver.sender.memwriter, ETB)) != ERROR_NONE)
+  header[0] = NET_FRAME_MAGIC;
+  header[1] = NET_FRAME_PROTOCOL_VERSION;
+  header[2] = (unsigned char)format;
+  header[3] = 0;
+  for (i = 4; i < NET_FRAME_HEADER_SIZE; ++i)
     {
-      return error;
+      header[i] = (unsigned char)(payload_size & 0xff);
+      payload_size >>= 8;
     }
+  error = sender_send_bytes_for_socket(handle, memwriter_buf(memwriter), memwriter_size(memwriter));
+  memwriter_clear(memwriter);
 
-  buf = memwriter_buf(handle->sender_receiver.sender.memwriter);
-  buf_size = memwriter_size(handle->sender_receiver.sender.memwriter);
+  return error;
+}
+
+err_t sender_send_for_socket(net_handle_t *handle)
+{
+  memwriter_t *memwriter = handle->sender_receiver.sender.memwriter;
+  err_t error = ERROR_NONE;
 
-  bytes_left = buf_size;
-  while (bytes_left)
+  if (handle->send_frames)
     {
-      int bytes_sent = send(handle->sender_receiver.sender.comm.socket.client_socket, buf, bytes_left, 0);
-      if (bytes_sent < 0)
+      /* JSON is written in several steps, so the space for the header is made afterwards */
+      if ((error = memwriter_putc(memwriter, '\0')) != ERROR_NONE ||
+          (error = memwriter_ensure_buf(memwriter, NET_FRAME_HEADER_SIZE)) != ERROR_NONE)
         {
-          psocketerror("could not send any data");
-          return ERROR_NETWORK_SEND;
+          return error;
         }
-      bytes_left -= bytes_sent;
+      memmove(memwriter_buf(memwriter) + NET_FRAME_HEADER_SIZE, memwriter_buf(memwriter), memwriter_size(memwriter));
+      memwriter->size += NET_FRAME_HEADER_SIZE;
+      return sender_send_frame_for_socket(handle, NET_MESSAGE_FORMAT_JSON);
     }
 
-  memwriter_clear(handle->sender_receiver.sender.memwriter);
+  if ((error = memwriter_putc(memwriter, ETB)) != ERROR_NONE)
+    {
+      return error;
+    }
+  error = sender_send_bytes_for_socket(handle, memwriter_buf(memwriter), memwriter_size(memwriter));
+  memwriter_clear(memwriter);
 
   return error;
 }
@@ -706,6 +866,7 @@ grm_args_t *grm_recv(const void *p, grm_args_t *args)
 {
   net_handle_t *handle = (net_handle_t *)p;
   int created_args = 0;
+  err_t error;
 
   if (handle->sender_receiver.receiver.recv == NULL)
     {
@@ -727,13 +888,28 @@ grm_args_t *grm_recv(const void *p, grm_args_t *args)
     {
       goto error_cleanup;
     }
-  if (fromjson_read(args, memwriter_buf(handle->sender_receiver.receiver.memwriter)) != ERROR_NONE)
+  /* payloads of frames are parsed in place */
+  switch (handle->recv_format)
+    {
+    case NET_MESSAGE_FORMAT_JSON:
+      error = fromjson_read(args, memwriter_buf(handle->sender_receiver.receiver.memwriter) + NET_FRAME_HEADER_SIZE);
+      break;
+    case NET_MESSAGE_FORMAT_BSON:
+      error = frombson_read(args, memwriter_buf(handle->sender_receiver.receiver.memwriter) + NET_FRAME_HEADER_SIZE);
+      break;
+    default:
+      error = fromjson_read(args, memwriter_buf(handle->sender_receiver.receiver.memwriter));
+      break;
+    }
+  if (error != ERROR_NONE)
     {
       goto error_cleanup;
     }
 
+  /* only JSON strings are followed by an `ETB` */
   if (memwriter_erase(handle->sender_receiver.receiver.memwriter, 0,
-                      handle->sender_receiver.receiver.message_size + 1) != ERROR_NONE)
+                      handle->sender_receiver.receiver.message_size +
+                          (handle->recv_format == NET_MESSAGE_FORMAT_JSON_ETB ? 1 : 0)) != ERROR_NONE)
     {
       goto error_cleanup;
     }
@@ -1054,6 +1230,25 @@ int grm_send_args(const void *p, const grm_args_t *args)
   net_handle_t *handle = (net_handle_t *)p;
   err_t error;
 
+  /* frames carry args as BSON which stores arrays as raw bytes, unless a JSON message is still being written */
+  if (handle->send_frames && memwriter_size(handle->sender_receiver.sender.memwriter) == 0)
+    {
+      char reserved_header[NET_FRAME_HEADER_SIZE] = {0};
+
+      error = memwriter_puts_with_len(handle->sender_receiver.sender.memwriter, reserved_header, NET_FRAME_HEADER_SIZE);
+      if (error == ERROR_NONE)
+        {
+          error = tobson_write_args(handle->sender_receiver.sender.memwriter, args);
+        }
+      if (error == ERROR_NONE)
+        {
+          error = sender_send_frame_for_socket(handle, NET_MESSAGE_FORMAT_BSON);
+        }
+      memwriter_clear(handle->sender_receiver.sender.memwriter);
+
+      return error == ERROR_NONE;
+    }
+
   error = tojson_write_args(handle->sender_receiver.sender.memwriter, args);
   if (error == ERROR_NONE && tojson_is_complete() && handle->sender_receiver.sender.send != NULL)
     {
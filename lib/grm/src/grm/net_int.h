@@ -20,17 +20,41 @@ extern "C" {
 
 #define SOCKET_RECV_BUF_SIZE (MEMWRITER_INITIAL_SIZE - 1)
 
+/*
+ * Messages on sockets are either JSON strings terminated by `ETB` or frames. A frame starts with a header of
+ * `NET_FRAME_HEADER_SIZE` bytes: `NET_FRAME_MAGIC`, the protocol version, the payload format (see
+ * `net_message_format_t`), a reserved zero byte and the payload size as 64 bit little endian number. JSON payloads of
+ * frames include their terminating null byte. JSON strings never start with `NET_FRAME_MAGIC`.
+ */
+#define NET_FRAME_MAGIC '\001'
+#define NET_FRAME_PROTOCOL_VERSION 1
+#define NET_FRAME_HEADER_SIZE 12
+
+#ifdef MSG_WAITALL
+#define NET_RECV_WAIT_ALL MSG_WAITALL
+#else
+#define NET_RECV_WAIT_ALL 0
+#endif
+
 
 /* ------------------------- sender --------------------------------------------------------------------------------- */
 
 #define SEND_REF_FORMAT_MAX_LENGTH 100
 #define PORT_MAX_STRING_LENGTH 80
+#define ENABLE_FRAMED_PROTOCOL_ENV_KEY "GRM_FRAMED_PROTOCOL"
 
 
 /* ========================= datatypes ============================================================================== */
 
 /* ------------------------- receiver / sender ---------------------------------------------------------------------- */
 
+typedef enum
+{
+  NET_MESSAGE_FORMAT_JSON_ETB,
+  NET_MESSAGE_FORMAT_JSON = 'j',
+  NET_MESSAGE_FORMAT_BSON = 'b'
+} net_message_format_t;
+
 struct _net_handle_t;
 typedef struct _net_handle_t net_handle_t;
 
@@ -98,6 +122,10 @@ struct _net_handle_t
     } sender;
   } sender_receiver;
   finalize_callback_t finalize;
+  /* format of the last received message */
+  net_message_format_t recv_format;
+  /* send frames instead of JSON strings terminated by `ETB`, only supported on sockets */
+  int send_frames;
 };
 
 /* ========================= methods ================================================================================ */
@@ -109,6 +137,8 @@ static err_t receiver_init_for_custom(net_handle_t *handle, const char *name, un
                                       const char *(*custom_recv)(const char *, unsigned int));
 static err_t receiver_finalize_for_socket(net_handle_t *handle);
 static err_t receiver_finalize_for_custom(net_handle_t *handle);
+static err_t receiver_recv_chunk_for_socket(net_handle_t *handle, size_t max_size, int wait_all);
+static err_t receiver_recv_frame_for_socket(net_handle_t *handle);
 static err_t receiver_recv_for_socket(net_handle_t *handle);
 static err_t receiver_recv_for_custom(net_handle_t *handle);
 
@@ -120,6 +150,8 @@ static err_t sender_init_for_custom(net_handle_t *handle, const char *name, unsi
                                     int (*custom_send)(const char *, unsigned int, const char *));
 static err_t sender_finalize_for_socket(net_handle_t *handle);
 static err_t sender_finalize_for_custom(net_handle_t *handle);
+static err_t sender_send_bytes_for_socket(net_handle_t *handle, const char *buf, size_t size);
+static err_t sender_send_frame_for_socket(net_handle_t *handle, net_message_format_t format);
 static err_t sender_send_for_socket(net_handle_t *handle);
 static err_t sender_send_for_custom(net_handle_t *handle);
 
@@ -7,6 +7,8 @@
 
 #include <algorithm>
 #include <array>
+#include <cstdint>
+#include <cstring>
 #include <fstream>
 #include <functional>
 #include <memory>
@@ -1517,6 +1519,30 @@ err_t plot_get_args_in_hierarchy(grm_args_t *args, const char **hierarchy_name_s
 
 /* ~~~~~~~~~~~~~~~~~~~~~~~~~ plotting ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
 
+/*!
+ * \brief Share a double array of an argument container with the GRM context instead of copying it.
+ *
+ * The argument is kept alive by its reference count until the last buffer which references the array is destroyed,
+ * so the buffer stays valid even if the argument is removed from `args` or replaced by a newer value.
+ *
+ * \param[in] args The argument container which holds the array.
+ * \param[in] key The key of the array.
+ * \return A buffer referencing the array or an empty buffer if `key` does not hold a double array.
+ */
+static GRM::DoubleBuffer get_double_buffer_from_args(const grm_args_t *args, const char *key)
+{
+  arg_t *arg;
+  double *values;
+  unsigned int length;
+
+  arg = args_at(args, key);
+  if (arg == nullptr || !arg_first_value(arg, "D", &values, &length)) return {};
+
+  arg_increase_reference_count(arg);
+  return {std::shared_ptr<const double[]>(values, [arg](const double *) { arg_decrease_reference_count(arg); }),
+          length};
+}
+
 err_t plot_line(grm_args_t *subplot_args)
 {
   grm_args_t **current_series;
@@ -1545,14 +1571,12 @@ err_t plot_line(grm_args_t *subplot_args)
 
       if (y_length > 0)
         {
-          std::vector<double> y_vec(y, y + y_length);
-          (*context)["y" + str] = y_vec;
+          (*context)["y" + str] = get_double_buffer_from_args(*current_series, "y");
           subGroup->setAttribute("y", "y" + str);
         }
       if (grm_args_first_value(*current_series, "x", "D", &x, &x_length))
         {
-          std::vector<double> x_vec(x, x + x_length);
-          (*context)["x" + str] = x_vec;
+          (*context)["x" + str] = get_double_buffer_from_args(*current_series, "x");
           subGroup->setAttribute("x", "x" + str);
         }
 
@@ -1719,18 +1743,13 @@ err_t plot_scatter(grm_args_t *subplot_args)
       std::string str = std::to_string(id);
       auto context = global_render->getContext();
 
-      std::vector<double> x_vec(x, x + x_length);
-      std::vector<double> y_vec(y, y + y_length);
-
-      (*context)["x" + str] = x_vec;
+      (*context)["x" + str] = get_double_buffer_from_args(*current_series, "x");
       subGroup->setAttribute("x", "x" + str);
-      (*context)["y" + str] = y_vec;
+      (*context)["y" + str] = get_double_buffer_from_args(*current_series, "y");
       subGroup->setAttribute("y", "y" + str);
       if (grm_args_first_value(*current_series, "z", "D", &z, &z_length))
         {
-          std::vector<double> z_vec(z, z + z_length);
-
-          (*context)["z" + str] = z_vec;
+          (*context)["z" + str] = get_double_buffer_from_args(*current_series, "z");
           subGroup->setAttribute("z", "z" + str);
         }
       if (grm_args_values(*current_series, "marker_type", "i", &marker_type))
@@ -4644,6 +4663,16 @@ char *dump_context_str(dump_encoding_t dump_encoding, const std::unordered_set<s
                             write_callback(memwriter, format_stream.str().c_str(), pair_ref.get().second.size(),
                                            pair_ref.get().second.data());
                           },
+                          [&memwriter, &context_keys_to_discard, &write_callback](
+                              std::reference_wrapper<std::pair<const std::string, GRM::DoubleBuffer>> pair_ref) {
+                            if (context_keys_to_discard->find(pair_ref.get().first) != context_keys_to_discard->end())
+                              return;
+                            std::stringstream format_stream;
+                            format_stream << pair_ref.get().first << ":nD";
+                            /* the writer only reads the data */
+                            write_callback(memwriter, format_stream.str().c_str(), pair_ref.get().second.size(),
+                                           const_cast<double *>(pair_ref.get().second.data()));
+                          },
                           [&memwriter, &context_keys_to_discard, &write_callback](
                               std::reference_wrapper<std::pair<const std::string, std::vector<int>>> pair_ref) {
                             if (context_keys_to_discard->find(pair_ref.get().first) != context_keys_to_discard->end())
@@ -6081,6 +6110,490 @@ char *grm_dump_graphics_tree_str(void)
   return graphics_tree_with_context_cstr;
 }
 
+} /* end of extern "C" */
+
+namespace internal
+{
+/*
+ * The binary graphics tree format consists of a fixed header, the serialized tree, a table of all context vectors and
+ * the raw vector data. Every vector starts at an offset which is a multiple of 8 bytes, so the file can be mapped into
+ * memory and the vectors can be read in place. All numbers are stored in the byte order of the writing machine, the
+ * `byte_order` field is used to reject files from machines with a different byte order.
+ */
+constexpr char binary_graphics_tree_magic[8] = {'G', 'R', 'M', 'T', 'R', 'E', 'E', '\0'};
+constexpr uint32_t binary_graphics_tree_byte_order = 0x01020304;
+constexpr uint32_t binary_graphics_tree_version = 1;
+
+struct BinaryGraphicsTreeHeader
+{
+  char magic[8];
+  uint32_t byte_order;
+  uint32_t version;
+  uint64_t tree_size;
+  uint64_t context_table_size;
+};
+
+enum class BinaryNodeType : uint8_t
+{
+  ELEMENT = 1,
+  COMMENT = 2
+};
+
+static uint64_t align_binary_offset(uint64_t offset)
+{
+  return (offset + 7) & ~static_cast<uint64_t>(7);
+}
+
+/*!
+ * \brief Append the binary representation of numbers and strings to a byte buffer.
+ */
+class BinaryWriter
+{
+public:
+  template <typename T> void write(T value) { buffer_.append(reinterpret_cast<const char *>(&value), sizeof(T)); }
+
+  void writeString(const std::string &str)
+  {
+    write<uint32_t>(static_cast<uint32_t>(str.size()));
+    buffer_.append(str);
+  }
+
+  const std::string &buffer() const { return buffer_; }
+
+private:
+  std::string buffer_;
+};
+
+/*!
+ * \brief Read numbers and strings from a byte range, throwing `std::runtime_error` if the range is exceeded.
+ */
+class BinaryReader
+{
+public:
+  BinaryReader(const char *data, uint64_t size) : data_(data), size_(size) {}
+
+  template <typename T> T read()
+  {
+    T value;
+    require(sizeof(T));
+    memcpy(&value, data_ + pos_, sizeof(T));
+    pos_ += sizeof(T);
+    return value;
+  }
+
+  std::string readString()
+  {
+    auto length = read<uint32_t>();
+    require(length);
+    std::string str(data_ + pos_, length);
+    pos_ += length;
+    return str;
+  }
+
+  bool atEnd() const { return pos_ == size_; }
+
+private:
+  void require(uint64_t n) const
+  {
+    if (n > size_ - pos_) throw std::runtime_error("Truncated binary graphics tree");
+  }
+
+  const char *data_;
+  uint64_t size_;
+  uint64_t pos_ = 0;
+};
+
+/*!
+ * \brief The contents of a binary graphics tree file, read into memory owned by this object.
+ *
+ * The file is not memory-mapped, so it may be overwritten or truncated while lazily loaded context vectors still
+ * refer to it. They keep a shared pointer to this object, which is released as soon as the last of them has been
+ * loaded or discarded.
+ */
+class BinaryGraphicsTreeFile
+{
+public:
+  explicit BinaryGraphicsTreeFile(FILE *file)
+  {
+    /* `uint64_t` storage keeps vectors at the same alignment as in the file */
+    size_t capacity = 1 << 16, n;
+    buffer_.resize(capacity / sizeof(uint64_t));
+    while ((n = fread(reinterpret_cast<char *>(buffer_.data()) + size_, 1, capacity - size_, file)) > 0)
+      {
+        size_ += n;
+        if (size_ == capacity)
+          {
+            capacity *= 2;
+            buffer_.resize(capacity / sizeof(uint64_t));
+          }
+      }
+  }
+
+  BinaryGraphicsTreeFile(const BinaryGraphicsTreeFile &) = delete;
+  BinaryGraphicsTreeFile &operator=(const BinaryGraphicsTreeFile &) = delete;
+
+  const char *data() const { return reinterpret_cast<const char *>(buffer_.data()); }
+  uint64_t size() const { return size_; }
+
+private:
+  std::vector<uint64_t> buffer_;
+  uint64_t size_ = 0;
+};
+
+static void writeBinaryNode(BinaryWriter &writer, const std::shared_ptr<const GRM::Node> &node,
+                            RestoreBackupAttributeFilter &attribute_filter)
+{
+  if (node->nodeType() == GRM::Node::Type::COMMENT_NODE)
+    {
+      writer.write(BinaryNodeType::COMMENT);
+      writer.writeString(std::dynamic_pointer_cast<const GRM::Comment>(node)->data());
+      return;
+    }
+  auto element = std::dynamic_pointer_cast<const GRM::Element>(node);
+  if (!element) return;
+
+  /*
+   * Write the name first, then all public and finally all internal attributes, each sorted by the name they are
+   * written with. Restored backup attributes are renamed, so sorting by the original names would not give the same
+   * file for a reloaded tree.
+   */
+  auto attribute_names = element->getAttributeNames();
+  std::vector<std::pair<std::string, GRM::Value>> attributes;
+  std::map<std::string, GRM::Value> internal_attributes;
+  if (element->hasAttribute("name")) attributes.emplace_back("name", element->getAttribute("name"));
+  for (const auto &attribute_name : attribute_names)
+    {
+      std::optional<std::string> new_attribute_name;
+      if (attribute_name == "name" || !attribute_filter(attribute_name, *element, new_attribute_name)) continue;
+      /* undefined values have no representation in the file, the reader rejects unknown types */
+      auto value = element->getAttribute(attribute_name);
+      if (value.isUndefined()) continue;
+      const std::string &name = new_attribute_name ? *new_attribute_name : attribute_name;
+      if (starts_with(name, "_"))
+        {
+          internal_attributes[name] = value;
+        }
+      else
+        {
+          attributes.emplace_back(name, value);
+        }
+    }
+  std::sort(attributes.begin() + (element->hasAttribute("name") ? 1 : 0), attributes.end(),
+            [](const auto &a, const auto &b) { return a.first < b.first; });
+  attributes.insert(attributes.end(), internal_attributes.begin(), internal_attributes.end());
+
+  writer.write(BinaryNodeType::ELEMENT);
+  writer.writeString(element->localName());
+  writer.write<uint32_t>(static_cast<uint32_t>(attributes.size()));
+  for (const auto &attribute : attributes)
+    {
+      writer.writeString(attribute.first);
+      writer.write(static_cast<uint8_t>(attribute.second.type()));
+      switch (attribute.second.type())
+        {
+        case GRM::Value::Type::INT:
+          writer.write<int32_t>(static_cast<int>(attribute.second));
+          break;
+        case GRM::Value::Type::DOUBLE:
+          writer.write<double>(static_cast<double>(attribute.second));
+          break;
+        case GRM::Value::Type::STRING:
+          writer.writeString(static_cast<std::string>(attribute.second));
+          break;
+        default:
+          break;
+        }
+    }
+  auto child_nodes = element->childNodes();
+  writer.write<uint32_t>(static_cast<uint32_t>(child_nodes.size()));
+  for (const auto &child_node : child_nodes)
+    {
+      writeBinaryNode(writer, child_node, attribute_filter);
+    }
+}
+
+static std::shared_ptr<GRM::Node> readBinaryNode(BinaryReader &reader, const std::shared_ptr<GRM::Element> &parent)
+{
+  auto node_type = reader.read<BinaryNodeType>();
+  if (node_type == BinaryNodeType::COMMENT)
+    {
+      auto comment = global_render->createComment(reader.readString());
+      if (parent) parent->appendChild(comment);
+      return comment;
+    }
+  if (node_type != BinaryNodeType::ELEMENT) throw std::runtime_error("Invalid node type in binary graphics tree");
+
+  std::shared_ptr<GRM::Element> element;
+  auto local_name = reader.readString();
+  if (local_name == "root")
+    {
+      global_root = global_render->createElement("root");
+      global_render->replaceChildren(global_root);
+      element = global_root;
+    }
+  else
+    {
+      element = global_render->createElement(local_name);
+    }
+
+  auto attribute_count = reader.read<uint32_t>();
+  for (uint32_t i = 0; i < attribute_count; i++)
+    {
+      auto attribute_name = reader.readString();
+      switch (static_cast<GRM::Value::Type>(reader.read<uint8_t>()))
+        {
+        case GRM::Value::Type::INT:
+          element->setAttribute(attribute_name, static_cast<int>(reader.read<int32_t>()));
+          break;
+        case GRM::Value::Type::DOUBLE:
+          element->setAttribute(attribute_name, reader.read<double>());
+          break;
+        case GRM::Value::Type::STRING:
+          element->setAttribute(attribute_name, reader.readString());
+          break;
+        default:
+          throw std::runtime_error("Invalid attribute type in binary graphics tree");
+        }
+    }
+  if (element->hasAttribute("active") && static_cast<int>(element->getAttribute("active")) == 1)
+    {
+      global_render->setActiveFigure(element);
+    }
+  if (parent) parent->appendChild(element);
+
+  auto child_count = reader.read<uint32_t>();
+  for (uint32_t i = 0; i < child_count; i++)
+    {
+      readBinaryNode(reader, element);
+    }
+  return element;
+}
+
+/*!
+ * \brief Register all vectors of the context table as lazily loaded context entries.
+ */
+static void readBinaryContextTable(BinaryReader &reader, const std::shared_ptr<BinaryGraphicsTreeFile> &file,
+                                   GRM::Context &context)
+{
+  while (!reader.atEnd())
+    {
+      auto key = reader.readString();
+      auto format = reader.read<char>();
+      auto count = reader.read<uint64_t>();
+      auto offset = reader.read<uint64_t>();
+      auto size = reader.read<uint64_t>();
+      if (offset % 8 != 0 || offset > file->size() || size > file->size() - offset)
+        {
+          throw std::runtime_error("Invalid vector offset in binary graphics tree");
+        }
+      switch (format)
+        {
+        case 'i':
+          if (size != count * sizeof(int)) throw std::runtime_error("Invalid vector size in binary graphics tree");
+          context.setLazy(key, GRM::Context::IntLoader([file, offset, count]() {
+                            auto values = reinterpret_cast<const int *>(file->data() + offset);
+                            return std::vector<int>(values, values + count);
+                          }));
+          break;
+        case 'd':
+          if (size != count * sizeof(double)) throw std::runtime_error("Invalid vector size in binary graphics tree");
+          context.setLazy(key, GRM::Context::DoubleLoader([file, offset, count]() {
+                            auto values = reinterpret_cast<const double *>(file->data() + offset);
+                            return std::vector<double>(values, values + count);
+                          }));
+          break;
+        case 's':
+          context.setLazy(key, GRM::Context::StringLoader([file, offset, count, size]() {
+                            std::vector<std::string> values;
+                            const char *str = file->data() + offset, *end = str + size;
+                            values.reserve(count);
+                            for (uint64_t i = 0; i < count && str < end; i++)
+                              {
+                                size_t length = strnlen(str, end - str);
+                                values.emplace_back(str, length);
+                                str += length + 1;
+                              }
+                            return values;
+                          }));
+          break;
+        default:
+          throw std::runtime_error("Invalid vector type in binary graphics tree");
+        }
+    }
+}
+} // namespace internal
+
+extern "C" {
+
+/*!
+ * \brief Dump the graphics tree and the context into a binary file.
+ *
+ * In contrast to `grm_dump_graphics_tree`, context vectors are not text-encoded but written as raw data blobs which
+ * can be loaded lazily by `grm_load_graphics_tree_binary`. The file must be opened in binary mode.
+ *
+ * \param[in] f The file object to write to.
+ * \return 1 on success, 0 on failure.
+ */
+int grm_dump_graphics_tree_binary(FILE *f)
+{
+  internal::RestoreBackupAttributeFilter restore_backup_attribute_filter;
+  internal::BinaryWriter tree_writer, table_writer;
+  std::vector<std::pair<const void *, uint64_t>> blobs;
+  std::vector<std::string> string_blobs;
+  std::vector<size_t> string_blob_indices;
+
+  if (global_root == nullptr) return 0;
+
+  internal::writeBinaryNode(tree_writer, global_root, restore_backup_attribute_filter);
+
+  const auto &context_keys_to_discard = restore_backup_attribute_filter.context_keys_to_discard();
+  std::vector<std::tuple<std::string, char, uint64_t>> entries;
+  auto context = global_render->getContext();
+  for (auto item : *context)
+    {
+      std::visit(GRM::overloaded{
+                     [&](std::reference_wrapper<std::pair<const std::string, std::vector<double>>> pair_ref) {
+                       if (context_keys_to_discard.count(pair_ref.get().first)) return;
+                       entries.emplace_back(pair_ref.get().first, 'd', pair_ref.get().second.size());
+                       blobs.emplace_back(pair_ref.get().second.data(), pair_ref.get().second.size() * sizeof(double));
+                     },
+                     [&](std::reference_wrapper<std::pair<const std::string, GRM::DoubleBuffer>> pair_ref) {
+                       if (context_keys_to_discard.count(pair_ref.get().first)) return;
+                       entries.emplace_back(pair_ref.get().first, 'd', pair_ref.get().second.size());
+                       blobs.emplace_back(pair_ref.get().second.data(), pair_ref.get().second.size() * sizeof(double));
+                     },
+                     [&](std::reference_wrapper<std::pair<const std::string, std::vector<int>>> pair_ref) {
+                       if (context_keys_to_discard.count(pair_ref.get().first)) return;
+                       entries.emplace_back(pair_ref.get().first, 'i', pair_ref.get().second.size());
+                       blobs.emplace_back(pair_ref.get().second.data(), pair_ref.get().second.size() * sizeof(int));
+                     },
+                     [&](std::reference_wrapper<std::pair<const std::string, std::vector<std::string>>> pair_ref) {
+                       if (context_keys_to_discard.count(pair_ref.get().first)) return;
+                       std::string joined;
+                       for (const auto &str : pair_ref.get().second)
+                         {
+                           joined.append(str);
+                           joined.push_back('\0');
+                         }
+                       entries.emplace_back(pair_ref.get().first, 's', pair_ref.get().second.size());
+                       string_blobs.push_back(std::move(joined));
+                       string_blob_indices.push_back(blobs.size());
+                       blobs.emplace_back(nullptr, 0);
+                     }},
+                 item);
+    }
+  /*
+   * String blobs are resolved only now, `string_blobs` does not move anymore. They are tracked by index since empty
+   * vectors have no data pointer either.
+   */
+  for (size_t i = 0; i < string_blobs.size(); i++)
+    {
+      blobs[string_blob_indices[i]] = {string_blobs[i].data(), string_blobs[i].size()};
+    }
+
+  uint64_t table_size = 0;
+  for (const auto &entry : entries)
+    {
+      table_size += sizeof(uint32_t) + std::get<0>(entry).size() + sizeof(char) + 3 * sizeof(uint64_t);
+    }
+  uint64_t offset = internal::align_binary_offset(sizeof(internal::BinaryGraphicsTreeHeader) +
+                                                  tree_writer.buffer().size() + table_size);
+  std::vector<uint64_t> offsets;
+  for (size_t i = 0; i < entries.size(); i++)
+    {
+      table_writer.writeString(std::get<0>(entries[i]));
+      table_writer.write(std::get<1>(entries[i]));
+      table_writer.write<uint64_t>(std::get<2>(entries[i]));
+      table_writer.write<uint64_t>(offset);
+      table_writer.write<uint64_t>(blobs[i].second);
+      offsets.push_back(offset);
+      offset = internal::align_binary_offset(offset + blobs[i].second);
+    }
+
+  internal::BinaryGraphicsTreeHeader header;
+  memcpy(header.magic, internal::binary_graphics_tree_magic, sizeof(header.magic));
+  header.byte_order = internal::binary_graphics_tree_byte_order;
+  header.version = internal::binary_graphics_tree_version;
+  header.tree_size = tree_writer.buffer().size();
+  header.context_table_size = table_writer.buffer().size();
+
+  static const char padding[8] = {0};
+  uint64_t position = sizeof(header) + tree_writer.buffer().size() + table_writer.buffer().size();
+  bool ok = fwrite(&header, sizeof(header), 1, f) == 1 &&
+            fwrite(tree_writer.buffer().data(), 1, tree_writer.buffer().size(), f) == tree_writer.buffer().size() &&
+            fwrite(table_writer.buffer().data(), 1, table_writer.buffer().size(), f) == table_writer.buffer().size();
+  for (size_t i = 0; ok && i < blobs.size(); i++)
+    {
+      ok = fwrite(padding, 1, offsets[i] - position, f) == offsets[i] - position &&
+           fwrite(blobs[i].first, 1, blobs[i].second, f) == blobs[i].second;
+      position = offsets[i] + blobs[i].second;
+    }
+  return ok;
+}
+
+/*!
+ * \brief Load a graphics tree from a binary file written by `grm_dump_graphics_tree_binary`.
+ *
+ * The file is read into memory completely. The tree is created immediately, but the context vectors are only decoded
+ * when they are accessed for the first time. The file object can be closed, and the file overwritten, after this
+ * function returns.
+ *
+ * \param[in] file The file object to read from. It must be opened in binary mode and positioned at its start.
+ * \return 1 on success, 0 on failure.
+ */
+int grm_load_graphics_tree_binary(FILE *file)
+{
+  if (plot_init_static_variables() != ERROR_NONE)
+    {
+      return 0;
+    }
+
+  gr_setscale(0);
+
+  bool auto_update;
+  global_render->getAutoUpdate(&auto_update);
+  global_render->setAutoUpdate(false);
+
+  int success = 1;
+  try
+    {
+      auto binary_file = std::make_shared<internal::BinaryGraphicsTreeFile>(file);
+      internal::BinaryGraphicsTreeHeader header;
+      if (binary_file->size() < sizeof(header)) throw std::runtime_error("Not a binary graphics tree");
+      memcpy(&header, binary_file->data(), sizeof(header));
+      if (memcmp(header.magic, internal::binary_graphics_tree_magic, sizeof(header.magic)) != 0 ||
+          header.byte_order != internal::binary_graphics_tree_byte_order)
+        {
+          throw std::runtime_error("Not a binary graphics tree or written on a machine with a different byte order");
+        }
+      if (header.version != internal::binary_graphics_tree_version)
+        {
+          throw std::runtime_error("Unsupported binary graphics tree version");
+        }
+      if (header.tree_size > binary_file->size() - sizeof(header) ||
+          header.context_table_size > binary_file->size() - sizeof(header) - header.tree_size)
+        {
+          throw std::runtime_error("Truncated binary graphics tree");
+        }
+
+      internal::BinaryReader tree_reader(binary_file->data() + sizeof(header), header.tree_size);
+      internal::readBinaryNode(tree_reader, nullptr);
+      internal::BinaryReader table_reader(binary_file->data() + sizeof(header) + header.tree_size,
+                                          header.context_table_size);
+      internal::readBinaryContextTable(table_reader, binary_file, *global_render->getContext());
+    }
+  catch (const std::exception &e)
+    {
+      logger((stderr, "Failed to load the binary graphics tree: %s\n", e.what()));
+      success = 0;
+    }
+
+  edit_figure = global_render->getActiveFigure();
+  global_render->setAutoUpdate(auto_update);
+
+  return success;
+}
+
 int grm_merge(const grm_args_t *args)
 {
   return grm_merge_extended(args, 0, nullptr);
@@ -0,0 +1,91 @@
+#ifdef __unix__
+#define _POSIX_C_SOURCE 1
+#endif
+
+#include <stdio.h>
+#include <string.h>
+
+#include "test.h"
+
+#include <grm/args_int.h>
+
+
+#define NUM_KEYS 100
+
+static void check_keys(const grm_args_t *args, int first_key, int last_key, int removed_key)
+{
+  grm_args_iterator_t *it;
+  arg_t *arg;
+  char key[16];
+  int i, value;
+
+  /* iteration follows the order of insertion */
+  it = grm_args_iter(args);
+  for (i = first_key; i <= last_key; ++i)
+    {
+      if (i == removed_key) continue;
+      sprintf(key, "key_%d", i);
+      assert((arg = it->next(it)) != NULL);
+      assert(strcmp(arg->key, key) == 0);
+    }
+  assert(it->next(it) == NULL);
+  args_iterator_delete(it);
+
+  for (i = first_key; i <= last_key; ++i)
+    {
+      sprintf(key, "key_%d", i);
+      if (i == removed_key)
+        {
+          assert(!grm_args_contains(args, key));
+        }
+      else
+        {
+          assert(grm_args_values(args, key, "i", &value));
+          assert(value == i);
+        }
+    }
+  assert(!grm_args_contains(args, "key_missing"));
+}
+
+void test(void)
+{
+  grm_args_t *args, *copied_args;
+  char key[16];
+  int i, value;
+
+  args = grm_args_new();
+  for (i = 0; i < NUM_KEYS; ++i)
+    {
+      sprintf(key, "key_%d", i);
+      grm_args_push(args, key, "i", -1);
+      grm_args_push(args, key, "i", i);
+    }
+  assert(args_count(args) == NUM_KEYS);
+  check_keys(args, 0, NUM_KEYS - 1, -1);
+
+  grm_args_remove(args, "key_42");
+  assert(args_count(args) == NUM_KEYS - 1);
+  check_keys(args, 0, NUM_KEYS - 1, 42);
+
+  copied_args = args_copy(args);
+  check_keys(copied_args, 0, NUM_KEYS - 1, 42);
+
+  /* merging replaces the values of existing keys and appends new keys */
+  grm_args_push(copied_args, "key_0", "i", 1000);
+  grm_args_push(copied_args, "key_new", "i", 2000);
+  assert(args_merge(args, copied_args, NULL) == ERROR_NONE);
+  grm_args_delete(copied_args);
+  assert(args_count(args) == NUM_KEYS);
+  assert(grm_args_values(args, "key_0", "i", &value) && value == 1000);
+  assert(grm_args_values(args, "key_new", "i", &value) && value == 2000);
+
+  args_clear(args, NULL);
+  assert(args_count(args) == 0);
+  assert(!grm_args_contains(args, "key_0"));
+  grm_args_push(args, "key_0", "i", 0);
+  check_keys(args, 0, 0, -1);
+
+  grm_args_delete(args);
+}
+
+DEFINE_TEST_MAIN
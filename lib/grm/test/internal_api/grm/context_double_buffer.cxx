@@ -0,0 +1,76 @@
+#include <memory>
+#include <string>
+#include <variant>
+#include <vector>
+
+#include <grm/dom_render/context.hxx>
+#include "test.h"
+
+
+static double data[] = {1.0, 2.0, 3.0, 4.0};
+static int num_releases = 0;
+
+static GRM::DoubleBuffer shared_data()
+{
+  return {std::shared_ptr<const double[]>(data, [](const double *) { ++num_releases; }), 4};
+}
+
+static void test_iteration_keeps_buffers()
+{
+  GRM::Context context;
+  int num_visited_buffers = 0;
+
+  context["x"] = shared_data();
+  context["y"] = std::vector<double>{5.0, 6.0};
+  context["z"] = std::vector<int>{7};
+  for (auto item : context)
+    {
+      if (auto pair_ref =
+              std::get_if<std::reference_wrapper<std::pair<const std::string, GRM::DoubleBuffer>>>(&item))
+        {
+          assert(pair_ref->get().first == "x");
+          assert(pair_ref->get().second.data() == data);
+          ++num_visited_buffers;
+        }
+    }
+  assert(num_visited_buffers == 1);
+  /* neither the iteration nor a view converts the buffer into a vector */
+  assert(GRM::get_view(context["x"]).data() == data);
+  assert(GRM::get_buffer(context["x"]).data() == data);
+  assert(num_releases == 0);
+}
+
+static void test_vector_conversion()
+{
+  GRM::Context context;
+
+  num_releases = 0;
+  context["x"] = shared_data();
+  auto &x_vec = GRM::get<std::vector<double>>(context["x"]);
+  assert(x_vec.data() != data && x_vec.size() == 4 && x_vec[3] == 4.0);
+  assert(num_releases == 1);
+  assert(GRM::get_view(context["x"]).data() == x_vec.data());
+}
+
+static void test_buffers_of_vectors_own_their_data()
+{
+  GRM::Context context;
+
+  context["x"] = std::vector<double>{1.0, 2.0};
+  auto view = GRM::get_view(context["x"]);
+  auto buffer = GRM::get_buffer(context["x"]);
+  assert(view.data() == GRM::get<std::vector<double>>(context["x"]).data());
+  assert(buffer.data() != view.data());
+
+  context["x"] = std::vector<double>{3.0};
+  assert(buffer.size() == 2 && buffer[0] == 1.0 && buffer[1] == 2.0);
+}
+
+static void test()
+{
+  test_iteration_keeps_buffers();
+  test_vector_conversion();
+  test_buffers_of_vectors_own_their_data();
+}
+
+DEFINE_TEST_MAIN
@@ -0,0 +1,123 @@
+#include <cstdlib>
+#include <memory>
+#include <vector>
+
+#include <grm/dom_render/ManageDrawableCache.hxx>
+#include <grm/dom_render/graphics_tree/Document.hxx>
+#include <grm/dom_render/graphics_tree/Element.hxx>
+#include <grm/dom_render/context.hxx>
+#include "gr.h"
+#include "test.h"
+
+
+static ManageDrawableCache cache;
+static std::shared_ptr<GRM::Context> context;
+
+/* renders the drawable like the renderer does: from the same initial state, replayed if possible */
+static bool render(const std::shared_ptr<GRM::Element> &element, bool with_colorrep = false)
+{
+  gr_setlinewidth(1.0);
+  gr_setlinecolorind(1);
+  if (cache.replay(element, context)) return true;
+
+  cache.beginCapture(element, context);
+  auto &x = GRM::get<std::vector<double>>((*context)[static_cast<std::string>(element->getAttribute("x"))]);
+  auto &y = GRM::get<std::vector<double>>((*context)[static_cast<std::string>(element->getAttribute("y"))]);
+  gr_setlinewidth(static_cast<double>(element->getAttribute("line_width")));
+  gr_setlinecolorind(2);
+  if (with_colorrep) gr_setcolorrep(2, 0.5, 0.5, 0.5);
+  gr_polyline(static_cast<int>(x.size()), x.data(), y.data());
+  cache.endCapture(element, context);
+  return false;
+}
+
+static void test_replay_and_invalidation(const std::shared_ptr<GRM::Element> &grandparent,
+                                         const std::shared_ptr<GRM::Element> &parent,
+                                         const std::shared_ptr<GRM::Element> &drawable)
+{
+  assert(!render(drawable));
+  assert(render(drawable));
+
+  /* the drawable, its parent and the transformations of all ancestors are part of the cache key */
+  drawable->setAttribute("line_width", 3.0);
+  assert(!render(drawable));
+  assert(render(drawable));
+  parent->setAttribute("line_color_ind", 3);
+  assert(!render(drawable));
+  assert(render(drawable));
+  grandparent->setAttribute("x_shift_wc", 0.1);
+  assert(!render(drawable));
+  assert(render(drawable));
+  /* other attributes of more distant ancestors are not */
+  grandparent->setAttribute("name", "grandparent");
+  assert(render(drawable));
+
+  /* so are the context keys referenced by the drawable or its parent */
+  (*context)["y"] = std::vector<double>{0.5, 0.0, 0.5};
+  assert(!render(drawable));
+  assert(render(drawable));
+  (*context)["parent_data"] = std::vector<double>{2.0};
+  assert(!render(drawable));
+  assert(render(drawable));
+  /* and handing out data for modification counts as a change */
+  GRM::get<std::vector<double>>((*context)["x"])[0] = 0.1;
+  assert(!render(drawable));
+  assert(render(drawable));
+  (*context)["unrelated"] = std::vector<double>{1.0};
+  assert(render(drawable));
+
+  /* a capture is only replayed from the state it was recorded in */
+  gr_setlinewidth(5.0);
+  assert(!cache.replay(drawable, context));
+}
+
+static void test_discarded_captures(const std::shared_ptr<GRM::Element> &parent,
+                                    const std::shared_ptr<GRM::Element> &drawable)
+{
+  /* output with unsupported records is not captured and not captured again while the drawable is unchanged */
+  drawable->setAttribute("line_width", 4.0);
+  assert(!render(drawable, true));
+  assert(!render(drawable, true));
+  assert(!render(drawable));
+  drawable->setAttribute("line_width", 2.0);
+  assert(!render(drawable));
+  assert(render(drawable));
+
+  /* detached drawables are dropped from the cache */
+  parent->removeChild(drawable);
+  cache.discardDetached();
+  parent->appendChild(drawable);
+  assert(!render(drawable));
+  assert(render(drawable));
+}
+
+static void test()
+{
+  setenv("GKS_WSTYPE", "100", 1);
+  context = std::make_shared<GRM::Context>();
+  (*context)["x"] = std::vector<double>{0.0, 0.5, 1.0};
+  (*context)["y"] = std::vector<double>{0.0, 1.0, 0.0};
+  (*context)["parent_data"] = std::vector<double>{1.0};
+
+  auto document = GRM::createDocument();
+  auto root = document->createElement("root");
+  document->appendChild(root);
+  auto grandparent = document->createElement("plot");
+  root->appendChild(grandparent);
+  auto parent = document->createElement("series_line");
+  grandparent->appendChild(parent);
+  parent->setAttribute("data", "parent_data");
+  auto drawable = document->createElement("polyline");
+  parent->appendChild(drawable);
+  drawable->setAttribute("x", "x");
+  drawable->setAttribute("y", "y");
+  drawable->setAttribute("line_width", 2.0);
+
+  test_replay_and_invalidation(grandparent, parent, drawable);
+  test_discarded_captures(parent, drawable);
+
+  cache.clear();
+  gr_emergencyclosegks();
+}
+
+DEFINE_TEST_MAIN
@@ -0,0 +1,217 @@
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "gks.h"
+#include "gkscore.h"
+
+#include "test.h"
+
+
+#define WKID 1
+#define WSTYPE_PS 62
+#define WSTYPE_SVG 382
+#define NUM_POINTS 1000
+
+enum output_mode
+{
+  DRAW,
+  CAPTURE,
+  REPLAY
+};
+
+static double x[NUM_POINTS], y[NUM_POINTS];
+
+static void set_initial_state(void)
+{
+  gks_set_window(1, 0.0, 1.0, -1.0, 1.0);
+  gks_set_viewport(1, 0.1, 0.9, 0.1, 0.9);
+  gks_select_xform(1);
+  gks_set_pline_color_index(1);
+  gks_set_pline_linewidth(1.0);
+  gks_set_pmark_type(1);
+  gks_set_pmark_size(1.0);
+  gks_set_fill_int_style(1);
+  gks_set_fill_color_index(1);
+}
+
+static void draw(void)
+{
+  double fill_x[] = {0.2, 0.5, 0.8}, fill_y[] = {-0.5, 0.5, -0.5};
+  int colors[] = {1, 2, 3, 4, 5, 6};
+
+  gks_set_pline_color_index(2);
+  gks_set_pline_linewidth(2.0);
+  gks_polyline(NUM_POINTS, x, y);
+  gks_set_pmark_type(-1);
+  gks_set_pmark_size(2.0);
+  gks_polymarker(NUM_POINTS / 10, x, y);
+  gks_set_fill_color_index(4);
+  gks_fillarea(3, fill_x, fill_y);
+  gks_cellarray(0.0, 1.0, 0.3, 0.7, 3, 2, 1, 1, 3, 2, colors);
+}
+
+static void write_output(const char *path, int wstype, gks_capture_t *capture, enum output_mode mode)
+{
+  gks_open_ws(WKID, (char *)path, wstype);
+  gks_activate_ws(WKID);
+  set_initial_state();
+  switch (mode)
+    {
+    case DRAW:
+      draw();
+      break;
+    case CAPTURE:
+      gks_begin_capture(capture, 1 << 20);
+      draw();
+      assert(gks_end_capture());
+      break;
+    case REPLAY:
+      assert(gks_replay_capture(capture));
+      break;
+    }
+  gks_deactivate_ws(WKID);
+  gks_close_ws(WKID);
+}
+
+static char *read_output(const char *path, long *size)
+{
+  FILE *f = fopen(path, "rb");
+  char *content, *pos, *line_end;
+
+  assert(f != NULL);
+  fseek(f, 0, SEEK_END);
+  *size = ftell(f);
+  fseek(f, 0, SEEK_SET);
+  content = malloc(*size + 1);
+  assert(content != NULL);
+  assert(fread(content, 1, *size, f) == (size_t)*size);
+  content[*size] = '\0';
+  fclose(f);
+  remove(path);
+
+  /* the PostScript header contains the creation date, so it is left out */
+  pos = strstr(content, "CreationDate:");
+  if (pos != NULL)
+    {
+      line_end = strchr(pos, '\n');
+      assert(line_end != NULL);
+      memmove(pos, line_end, content + *size + 1 - line_end);
+      *size -= line_end - pos;
+    }
+  /* the SVG plugin numbers clip paths with a per-process counter (two digits followed by the rectangle index) */
+  for (pos = strstr(content, "clip"); pos != NULL; pos = strstr(pos + 4, "clip"))
+    {
+      if (pos[4] >= '0' && pos[4] <= '9' && pos[5] >= '0' && pos[5] <= '9')
+        {
+          pos[4] = pos[5] = '0';
+        }
+    }
+  return content;
+}
+
+static void test_replay_output(int wstype, const char *extension)
+{
+  gks_capture_t capture;
+  char path[3][64];
+  char *content[3];
+  long size[3];
+  int i;
+
+  for (i = 0; i < 3; ++i)
+    {
+      sprintf(path[i], "gks_capture_replay_%d.%s", i, extension);
+    }
+  write_output(path[0], wstype, NULL, DRAW);
+  write_output(path[1], wstype, &capture, CAPTURE);
+  write_output(path[2], wstype, &capture, REPLAY);
+  gks_discard_capture(&capture);
+
+  for (i = 0; i < 3; ++i)
+    {
+      content[i] = read_output(path[i], &size[i]);
+    }
+  printf("%s output: %ld bytes\n", extension, size[0]);
+  /* neither capturing nor replaying the output changes it */
+  assert(size[0] > 0 && size[0] == size[1] && size[0] == size[2]);
+  assert(memcmp(content[0], content[1], size[0]) == 0);
+  assert(memcmp(content[0], content[2], size[0]) == 0);
+  for (i = 0; i < 3; ++i)
+    {
+      free(content[i]);
+    }
+}
+
+static void test_discarded_captures(void)
+{
+  gks_capture_t capture;
+  int size;
+
+  gks_open_ws(WKID, "gks_capture_replay.ps", WSTYPE_PS);
+  gks_activate_ws(WKID);
+
+  /* a capture may use up to `max_size` bytes */
+  set_initial_state();
+  gks_begin_capture(&capture, 1 << 20);
+  draw();
+  assert(gks_end_capture());
+  size = capture.nbytes;
+  gks_discard_capture(&capture);
+
+  set_initial_state();
+  gks_begin_capture(&capture, size);
+  draw();
+  assert(gks_end_capture() && capture.nbytes == size);
+  gks_discard_capture(&capture);
+
+  set_initial_state();
+  gks_begin_capture(&capture, size - 1);
+  draw();
+  assert(!gks_end_capture());
+  assert(capture.buffer == NULL && capture.nbytes == 0);
+  assert(!gks_replay_capture(&capture));
+
+  /* color representations are workstation state which is not captured */
+  set_initial_state();
+  gks_begin_capture(&capture, 1 << 20);
+  gks_polyline(NUM_POINTS, x, y);
+  gks_set_color_rep(WKID, 2, 0.5, 0.5, 0.5);
+  gks_polyline(NUM_POINTS, x, y);
+  assert(!gks_end_capture());
+  assert(capture.buffer == NULL);
+  assert(!gks_replay_capture(&capture));
+
+  /* a capture is only replayed in the state it was recorded in */
+  set_initial_state();
+  gks_begin_capture(&capture, 1 << 20);
+  draw();
+  assert(gks_end_capture());
+  set_initial_state();
+  gks_set_pline_linewidth(3.0);
+  assert(!gks_replay_capture(&capture));
+  set_initial_state();
+  assert(gks_replay_capture(&capture));
+  gks_discard_capture(&capture);
+
+  gks_deactivate_ws(WKID);
+  gks_close_ws(WKID);
+  remove("gks_capture_replay.ps");
+}
+
+static void test(void)
+{
+  int i;
+
+  for (i = 0; i < NUM_POINTS; ++i)
+    {
+      x[i] = (double)i / (NUM_POINTS - 1);
+      y[i] = (i % 7) / 7.0 - 0.5;
+    }
+  gks_open_gks(6);
+  test_replay_output(WSTYPE_PS, "ps");
+  test_replay_output(WSTYPE_SVG, "svg");
+  test_discarded_captures();
+  gks_close_gks();
+}
+
+DEFINE_TEST_MAIN
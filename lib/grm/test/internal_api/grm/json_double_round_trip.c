@@ -0,0 +1,185 @@
+#include <assert.h>
+#include <float.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "grm/json_int.h"
+
+#include "test.h"
+
+
+#define NUM_RANDOM_VALUES 500000
+
+static uint64_t random_state = 0x853c49e6748fea9bUL;
+
+static uint64_t random_bits(void)
+{
+  /* xorshift64* */
+  random_state ^= random_state >> 12;
+  random_state ^= random_state << 25;
+  random_state ^= random_state >> 27;
+  return random_state * 0x2545f4914f6cdd1dUL;
+}
+
+static int same_bits(double a, double b)
+{
+  return memcmp(&a, &b, sizeof(double)) == 0;
+}
+
+/*
+ * Write `value` like the JSON serializer does and read it back with the fast path of the parser. Returns 1 if the fast
+ * path converted the number and 0 if it was left to `strtod`. The value must be read back bit-exactly in both cases.
+ */
+static int round_trip(double value)
+{
+  char buffer[TOJSON_DOUBLE_MAX_LENGTH + 2];
+  const char *str;
+  double parsed_value = 0.0;
+  int length, was_successful, converted;
+
+  length = tojson_format_double(buffer, value);
+  assert(length > 0 && length <= TOJSON_DOUBLE_MAX_LENGTH);
+  buffer[length] = ',';
+  buffer[length + 1] = '\0';
+
+  str = buffer;
+  converted = fromjson_str_to_double_fast(&str, &parsed_value);
+  if (converted)
+    {
+      if (!same_bits(parsed_value, value))
+        {
+          fprintf(stderr, "\"%s\" was read as %.17g instead of %.17g\n", buffer, parsed_value, value);
+        }
+      assert(same_bits(parsed_value, value));
+      assert(str == buffer + length);
+    }
+  str = buffer;
+  parsed_value = fromjson_str_to_double(&str, &was_successful);
+  assert(was_successful && same_bits(parsed_value, value));
+
+  return converted;
+}
+
+static void test_special_values(void)
+{
+  static const double values[] = {0.0,     -0.0,          1.0,          -1.0,    0.1,     1.0 / 3.0, 2.0 / 3.0,
+                                  1e-7,    123456789.0,   9007199254740992.0,   9007199254740993.0,
+                                  1e22,    1e23,          5e-324,       DBL_MIN, DBL_MAX, -DBL_MAX,
+                                  2.2250738585072009e-308, 4.9406564584124654e-324, 1.7976931348623157e308,
+                                  0.30000000000000004, 9.5367431640625e-07, 4.35679732e-21};
+  int i;
+
+  for (i = 0; i < (int)(sizeof(values) / sizeof(values[0])); ++i)
+    {
+      round_trip(values[i]);
+    }
+}
+
+static void test_powers_of_ten(void)
+{
+  char buffer[32];
+  double value;
+  int exponent;
+
+  for (exponent = -307; exponent <= 308; ++exponent)
+    {
+      sprintf(buffer, "1e%d", exponent);
+      value = strtod(buffer, NULL);
+      round_trip(value);
+      round_trip(value * 3.0);
+    }
+}
+
+static void test_random_bit_patterns(void)
+{
+  uint64_t bits;
+  double value;
+  int i, num_converted = 0, num_finite = 0;
+
+  for (i = 0; i < NUM_RANDOM_VALUES; ++i)
+    {
+      bits = random_bits();
+      memcpy(&value, &bits, sizeof(double));
+      if (value != value || value - value != 0.0)
+        {
+          continue;
+        }
+      ++num_finite;
+      num_converted += round_trip(value);
+    }
+  printf("random bit patterns: %d of %d read without strtod\n", num_converted, num_finite);
+  /* only values whose rounding is too close to call and tiny subnormals are left to `strtod` */
+  assert(num_converted > num_finite - num_finite / 100);
+}
+
+static void test_random_data(void)
+{
+  double value;
+  int i, num_converted = 0;
+
+  for (i = 0; i < NUM_RANDOM_VALUES; ++i)
+    {
+      value = (double)(random_bits() >> 11) / 9007199254740992.0;
+      switch (i % 4)
+        {
+        case 0:
+          break;
+        case 1:
+          value = (value - 0.5) * 2000.0;
+          break;
+        case 2:
+          value *= 1e-5;
+          break;
+        default:
+          value = (double)(random_bits() % 100000) / 100.0;
+          break;
+        }
+      num_converted += round_trip(value);
+    }
+  printf("random data: %d of %d read without strtod\n", num_converted, NUM_RANDOM_VALUES);
+  assert(num_converted > NUM_RANDOM_VALUES - NUM_RANDOM_VALUES / 100);
+}
+
+static void test_random_digit_strings(void)
+{
+  /* numbers which are not written by the serializer must be read like `strtod` does, too */
+  char buffer[64];
+  const char *str;
+  double value, expected_value;
+  int i, j, num_digits, exponent, length;
+
+  for (i = 0; i < NUM_RANDOM_VALUES; ++i)
+    {
+      num_digits = 1 + (int)(random_bits() % 19);
+      exponent = (int)(random_bits() % 660) - 340;
+      length = 0;
+      for (j = 0; j < num_digits; ++j)
+        {
+          buffer[length++] = (char)('0' + random_bits() % 10);
+        }
+      length += sprintf(buffer + length, "e%d,", exponent);
+      expected_value = strtod(buffer, NULL);
+      str = buffer;
+      if (fromjson_str_to_double_fast(&str, &value))
+        {
+          if (!same_bits(value, expected_value))
+            {
+              fprintf(stderr, "\"%s\" was read as %.17g instead of %.17g\n", buffer, value, expected_value);
+            }
+          assert(same_bits(value, expected_value));
+          assert(str == buffer + length - 1);
+        }
+    }
+}
+
+static void test(void)
+{
+  test_special_values();
+  test_powers_of_ten();
+  test_random_bit_patterns();
+  test_random_data();
+  test_random_digit_strings();
+}
+
+DEFINE_TEST_MAIN
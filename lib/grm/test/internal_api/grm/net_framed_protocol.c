@@ -0,0 +1,260 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <assert.h>
+#include <netdb.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+#include <grm.h>
+#include "grm/bson_int.h"
+#include "grm/memwriter_int.h"
+#include "grm/net_int.h"
+
+#include "test.h"
+
+
+#define NUM_VALUES 1000
+
+static double values[NUM_VALUES];
+
+static void sleep_ms(long ms)
+{
+  struct timespec ts;
+
+  ts.tv_sec = ms / 1000;
+  ts.tv_nsec = (ms % 1000) * 1000000L;
+  nanosleep(&ts, NULL);
+}
+
+static int connect_to_receiver(unsigned int port)
+{
+  char port_str[16];
+  struct addrinfo hints, *addr_info;
+  int client_socket = -1, retry;
+
+  sprintf(port_str, "%u", port);
+  memset(&hints, 0, sizeof(hints));
+  hints.ai_family = AF_INET;
+  hints.ai_socktype = SOCK_STREAM;
+  assert(getaddrinfo("127.0.0.1", port_str, &hints, &addr_info) == 0);
+  for (retry = 0; retry < 100; ++retry)
+    {
+      client_socket = socket(addr_info->ai_family, addr_info->ai_socktype, addr_info->ai_protocol);
+      assert(client_socket >= 0);
+      if (connect(client_socket, addr_info->ai_addr, addr_info->ai_addrlen) == 0) break;
+      close(client_socket);
+      client_socket = -1;
+      sleep_ms(50);
+    }
+  freeaddrinfo(addr_info);
+  assert(client_socket >= 0);
+
+  return client_socket;
+}
+
+static void send_all(int client_socket, const char *buf, size_t size)
+{
+  ssize_t bytes_sent;
+
+  while (size > 0)
+    {
+      bytes_sent = send(client_socket, buf, size, 0);
+      assert(bytes_sent > 0);
+      buf += bytes_sent;
+      size -= bytes_sent;
+    }
+}
+
+/* Append a frame header for a payload of `payload_size` bytes in the given format */
+static void put_frame_header(memwriter_t *memwriter, net_message_format_t format, size_t payload_size)
+{
+  int i;
+
+  memwriter_putc(memwriter, NET_FRAME_MAGIC);
+  memwriter_putc(memwriter, NET_FRAME_PROTOCOL_VERSION);
+  memwriter_putc(memwriter, (char)format);
+  memwriter_putc(memwriter, '\0');
+  for (i = 0; i < 8; ++i)
+    {
+      memwriter_putc(memwriter, (char)(i < (int)sizeof(size_t) ? (payload_size >> (8 * i)) & 0xff : 0));
+    }
+}
+
+static void put_json_frame(memwriter_t *memwriter, const char *json)
+{
+  put_frame_header(memwriter, NET_MESSAGE_FORMAT_JSON, strlen(json) + 1);
+  memwriter_puts_with_len(memwriter, (char *)json, strlen(json) + 1);
+}
+
+static void put_bson_frame(memwriter_t *memwriter, const grm_args_t *args)
+{
+  memwriter_t *bson_memwriter = memwriter_new();
+
+  assert(bson_memwriter != NULL);
+  assert(tobson_write_args(bson_memwriter, args) == ERROR_NONE);
+  put_frame_header(memwriter, NET_MESSAGE_FORMAT_BSON, memwriter_size(bson_memwriter));
+  memwriter_puts_with_len(memwriter, memwriter_buf(bson_memwriter), memwriter_size(bson_memwriter));
+  memwriter_delete(bson_memwriter);
+}
+
+/*
+ * Send hand-made messages: a JSON string terminated by `ETB`, a JSON frame, a BSON frame whose header arrives in two
+ * pieces, a JSON string and a BSON frame in the same chunk, two JSON frames and a JSON string in the same chunk and
+ * finally a BSON frame with a wrong document length.
+ */
+static void send_raw_messages(unsigned int port)
+{
+  int client_socket = connect_to_receiver(port);
+  memwriter_t *memwriter = memwriter_new();
+  grm_args_t *args = grm_args_new();
+
+  assert(memwriter != NULL && args != NULL);
+  grm_args_push(args, "values", "nD", NUM_VALUES, values);
+  grm_args_push(args, "kind", "s", "line");
+
+  memwriter_printf(memwriter, "{\"id\": 1}%c", ETB);
+  put_json_frame(memwriter, "{\"id\": 2}");
+  send_all(client_socket, memwriter_buf(memwriter), memwriter_size(memwriter));
+  memwriter_erase(memwriter, 0, memwriter_size(memwriter));
+
+  put_bson_frame(memwriter, args);
+  send_all(client_socket, memwriter_buf(memwriter), 5);
+  sleep_ms(100);
+  send_all(client_socket, memwriter_buf(memwriter) + 5, memwriter_size(memwriter) - 5);
+  memwriter_erase(memwriter, 0, memwriter_size(memwriter));
+
+  memwriter_printf(memwriter, "{\"id\": 4}%c", ETB);
+  put_bson_frame(memwriter, args);
+  send_all(client_socket, memwriter_buf(memwriter), memwriter_size(memwriter));
+  memwriter_erase(memwriter, 0, memwriter_size(memwriter));
+
+  put_json_frame(memwriter, "{\"id\": 5}");
+  put_json_frame(memwriter, "{\"id\": 6}");
+  memwriter_printf(memwriter, "{\"id\": 7}%c", ETB);
+  send_all(client_socket, memwriter_buf(memwriter), memwriter_size(memwriter));
+  memwriter_erase(memwriter, 0, memwriter_size(memwriter));
+
+  put_bson_frame(memwriter, args);
+  memwriter_buf(memwriter)[NET_FRAME_HEADER_SIZE] ^= 1;
+  send_all(client_socket, memwriter_buf(memwriter), memwriter_size(memwriter));
+
+  grm_args_delete(args);
+  memwriter_delete(memwriter);
+  close(client_socket);
+}
+
+static void assert_id(grm_args_t *args, int expected_id)
+{
+  int id;
+
+  assert(args != NULL);
+  assert(grm_args_values(args, "id", "i", &id));
+  assert(id == expected_id);
+  grm_args_delete(args);
+}
+
+static void assert_values(grm_args_t *args)
+{
+  double *received_values;
+  unsigned int length;
+  const char *kind;
+
+  assert(args != NULL);
+  assert(grm_args_first_value(args, "values", "D", &received_values, &length));
+  assert(length == NUM_VALUES);
+  assert(memcmp(received_values, values, sizeof(values)) == 0);
+  assert(grm_args_values(args, "kind", "s", &kind));
+  assert(strcmp(kind, "line") == 0);
+  grm_args_delete(args);
+}
+
+static void test_recv_mixed_stream(unsigned int port)
+{
+  void *handle;
+  pid_t pid;
+  int status;
+
+  pid = fork();
+  assert(pid >= 0);
+  if (pid == 0)
+    {
+      send_raw_messages(port);
+      exit(0);
+    }
+
+  handle = grm_open(GRM_RECEIVER, "127.0.0.1", port, NULL, NULL);
+  assert(handle != NULL);
+  assert_id(grm_recv(handle, NULL), 1);
+  assert_id(grm_recv(handle, NULL), 2);
+  assert_values(grm_recv(handle, NULL));
+  assert_id(grm_recv(handle, NULL), 4);
+  assert_values(grm_recv(handle, NULL));
+  assert_id(grm_recv(handle, NULL), 5);
+  assert_id(grm_recv(handle, NULL), 6);
+  assert_id(grm_recv(handle, NULL), 7);
+  assert(grm_recv(handle, NULL) == NULL);
+  grm_close(handle);
+
+  assert(waitpid(pid, &status, 0) == pid && WIFEXITED(status) && WEXITSTATUS(status) == 0);
+}
+
+/*
+ * Send `values` with the framed protocol enabled and expect them back unchanged in the reply. The receiver does not
+ * enable frames, so it answers with JSON strings terminated by `ETB`.
+ */
+static void test_send_framed_round_trip(unsigned int port)
+{
+  void *handle;
+  grm_args_t *args;
+  pid_t pid;
+  int status;
+
+  pid = fork();
+  assert(pid >= 0);
+  if (pid == 0)
+    {
+      setenv(ENABLE_FRAMED_PROTOCOL_ENV_KEY, "1", 1);
+      handle = grm_open(GRM_SENDER, "127.0.0.1", port, NULL, NULL);
+      assert(handle != NULL);
+      args = grm_args_new();
+      grm_args_push(args, "values", "nD", NUM_VALUES, values);
+      grm_args_push(args, "kind", "s", "line");
+      assert(grm_send_args(handle, args));
+      grm_args_delete(args);
+      assert(grm_send(handle, "o(id:i)", 5));
+      assert_id(grm_recv(handle, NULL), 6);
+      assert_values(grm_recv(handle, NULL));
+      grm_close(handle);
+      exit(0);
+    }
+
+  handle = grm_open(GRM_RECEIVER, "127.0.0.1", port, NULL, NULL);
+  assert(handle != NULL);
+  args = grm_recv(handle, NULL);
+  assert(args != NULL);
+  assert(grm_send(handle, "o(id:i)", 6));
+  assert(grm_send_args(handle, args));
+  assert_values(args);
+  assert_id(grm_recv(handle, NULL), 5);
+  grm_close(handle);
+
+  assert(waitpid(pid, &status, 0) == pid && WIFEXITED(status) && WEXITSTATUS(status) == 0);
+}
+
+static void test(void)
+{
+  unsigned int port = 20000 + getpid() % 10000;
+  int i;
+
+  for (i = 0; i < NUM_VALUES; ++i)
+    {
+      values[i] = (i - NUM_VALUES / 2) * 0.1 + 1.0 / 3.0;
+    }
+  test_recv_mixed_stream(port);
+  test_send_framed_round_trip(port + 1);
+}
+
+DEFINE_TEST_MAIN
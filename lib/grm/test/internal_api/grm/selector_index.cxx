@@ -0,0 +1,171 @@
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <grm/dom_render/graphics_tree/Document.hxx>
+#include <grm/dom_render/graphics_tree/Element.hxx>
+#include "test.h"
+
+
+/* selectors with a required local name or an indexed attribute value are answered from the document index */
+static const std::vector<std::string> indexed_selectors = {
+    "polyline",
+    "series_line",
+    "[name=\"a\"]",
+    "series_line[name=\"b\"]",
+    "[_child_id=\"1\"]",
+    "polyline[_child_id=\"2\"]",
+    "series_line polyline",
+    "plot > series_line[name=\"a\"]",
+};
+
+/* a selector list of different local names has no required local name, so appending a second selector which does
+ * not match anything forces a traversal of the tree without changing the result */
+static std::string traversed(const std::string &selectors)
+{
+  return selectors + ", unmatched";
+}
+
+template <typename T> static void check_queries(const std::shared_ptr<T> &node)
+{
+  for (const auto &selectors : indexed_selectors)
+    {
+      auto found_elements = node->querySelectorsAll(selectors);
+      /* both the elements and their (tree) order must match */
+      assert(found_elements == node->querySelectorsAll(traversed(selectors)));
+      assert(node->querySelectors(selectors) == (found_elements.empty() ? nullptr : found_elements.front()));
+      assert(node->querySelectors(selectors) == node->querySelectors(traversed(selectors)));
+    }
+}
+
+static void check_all_queries(const std::shared_ptr<GRM::Document> &document)
+{
+  check_queries(document);
+  for (const auto &plot : document->querySelectorsAll(traversed("plot")))
+    {
+      check_queries(plot);
+    }
+  for (const auto &series : document->querySelectorsAll(traversed("series_line")))
+    {
+      check_queries(series);
+    }
+}
+
+static std::shared_ptr<GRM::Element> create_series(const std::shared_ptr<GRM::Document> &document,
+                                                   const std::string &name)
+{
+  auto series = document->createElement("series_line");
+  series->setAttribute("name", name);
+  for (int i = 0; i < 3; ++i)
+    {
+      auto polyline = document->createElement("polyline");
+      polyline->setAttribute("_child_id", i);
+      series->appendChild(polyline);
+    }
+  return series;
+}
+
+static void test_tree_changes(const std::shared_ptr<GRM::Document> &document,
+                              const std::shared_ptr<GRM::Element> &plot1, const std::shared_ptr<GRM::Element> &plot2)
+{
+  check_all_queries(document);
+  assert(document->querySelectorsAll("polyline").size() == 12);
+  assert(document->querySelectorsAll("[name=\"a\"]").size() == 2);
+
+  /* moving an element changes the tree order of the results */
+  auto series = plot1->querySelectors("series_line");
+  plot2->appendChild(series);
+  check_all_queries(document);
+  assert(document->querySelectors("series_line[name=\"a\"]") == plot2->querySelectors("series_line[name=\"a\"]"));
+  plot1->insertBefore(series, plot1->firstChild());
+  check_all_queries(document);
+  assert(document->querySelectors("series_line[name=\"a\"]") == series);
+
+  /* elements which are not part of the tree any more are still in the index of their document, but not found */
+  plot2->removeChild(plot2->firstChild());
+  check_all_queries(document);
+  assert(document->querySelectorsAll("polyline").size() == 9);
+  assert(document->querySelectorsAll("[name=\"a\"]").size() == 1);
+
+  /* adopted elements move to the index of the new document */
+  auto other_document = GRM::createDocument();
+  auto other_root = other_document->createElement("root");
+  other_document->appendChild(other_root);
+  auto adopted_series = create_series(other_document, "a");
+  other_root->appendChild(adopted_series);
+  plot2->appendChild(adopted_series);
+  check_all_queries(document);
+  check_queries(other_document);
+  assert(document->querySelectorsAll("polyline").size() == 12);
+  assert(document->querySelectorsAll("[name=\"a\"]").size() == 2);
+  assert(other_document->querySelectorsAll("polyline").empty());
+  assert(other_document->querySelectors("[name=\"a\"]") == nullptr);
+
+  /* so do clones, which belong to the document of the cloned element */
+  plot1->appendChild(adopted_series->cloneNode(true));
+  check_all_queries(document);
+  assert(document->querySelectorsAll("polyline").size() == 15);
+}
+
+static void test_attribute_changes(const std::shared_ptr<GRM::Document> &document)
+{
+  auto series = document->querySelectorsAll("series_line");
+  auto polylines = document->querySelectorsAll("polyline");
+
+  series.back()->setAttribute("name", "b");
+  check_all_queries(document);
+  series.front()->removeAttribute("name");
+  check_all_queries(document);
+  series.front()->setAttribute("name", "a");
+  check_all_queries(document);
+  assert(document->querySelectors("[name=\"a\"]") == series.front());
+
+  /* indexed attribute values are compared by their string representation */
+  polylines[0]->setAttribute("_child_id", "1");
+  polylines[1]->setAttribute("_child_id", 2);
+  polylines[2]->setAttribute("_child_id", 1.0);
+  check_all_queries(document);
+  polylines[4]->removeAttribute("_child_id");
+  check_all_queries(document);
+  assert(document->querySelectors("[_child_id=\"1\"]") == polylines[0]);
+}
+
+static void test_parsed_selector_cache(const std::shared_ptr<GRM::Document> &document)
+{
+  /* parsed selectors are shared between all queries with the same string, also across documents and after the
+   * cache was flushed because of too many different selector strings */
+  auto found_elements = document->querySelectorsAll("series_line polyline");
+  for (int i = 0; i < 2000; ++i)
+    {
+      document->querySelectorsAll("[_child_id=\"" + std::to_string(i) + "\"]");
+    }
+  check_all_queries(document);
+  assert(document->querySelectorsAll("series_line polyline") == found_elements);
+
+  auto other_document = GRM::createDocument();
+  assert(other_document->querySelectorsAll("series_line polyline").empty());
+  check_queries(other_document);
+}
+
+static void test()
+{
+  auto document = GRM::createDocument();
+  auto root = document->createElement("root");
+  document->appendChild(root);
+  auto figure = document->createElement("figure");
+  root->appendChild(figure);
+  auto plot1 = document->createElement("plot");
+  auto plot2 = document->createElement("plot");
+  figure->appendChild(plot1);
+  figure->appendChild(plot2);
+  plot1->appendChild(create_series(document, "a"));
+  plot1->appendChild(create_series(document, "b"));
+  plot2->appendChild(create_series(document, "a"));
+  plot2->appendChild(create_series(document, "c"));
+
+  test_tree_changes(document, plot1, plot2);
+  test_attribute_changes(document);
+  test_parsed_selector_cache(document);
+}
+
+DEFINE_TEST_MAIN
@@ -0,0 +1,140 @@
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <grm/dom_render/graphics_tree/Document.hxx>
+#include <grm/dom_render/graphics_tree/Element.hxx>
+#include "test.h"
+
+
+static int render_count = 0;
+static std::vector<std::string> updates;
+static bool throw_on_update = false;
+
+static void render()
+{
+  ++render_count;
+}
+
+static void update(const std::shared_ptr<GRM::Element> &element, const std::string &attribute,
+                   const std::string &old_value)
+{
+  if (throw_on_update)
+    {
+      throw_on_update = false;
+      throw std::runtime_error("update failed");
+    }
+  updates.push_back(attribute + "=" + old_value);
+}
+
+static void reset_counters()
+{
+  render_count = 0;
+  updates.clear();
+}
+
+static void test_batched_changes(const std::shared_ptr<GRM::Document> &document,
+                                 const std::shared_ptr<GRM::Element> &element)
+{
+  reset_counters();
+  {
+    GRM::Document::UpdateTransaction transaction(document);
+    element->setAttribute("x_log", 1);
+    element->setAttribute("x_log", 0);
+    element->setAttribute("y_log", 1);
+    element->setAttribute("y_log", 0);
+    element->setAttribute("y_log", 1);
+    element->setAttribute("kind", "scatter");
+    assert(render_count == 0 && updates.empty());
+  }
+  /* `x_log` got its old value back, `y_log` is reported once with the value before the transaction */
+  std::cout << "batched: " << render_count << " render(s), " << updates.size() << " update(s)" << std::endl;
+  assert(render_count == 1);
+  assert((updates == std::vector<std::string>{"y_log=0", "kind=line"}));
+}
+
+static void test_nested_commit(const std::shared_ptr<GRM::Document> &document,
+                               const std::shared_ptr<GRM::Element> &element)
+{
+  reset_counters();
+  GRM::Document::UpdateTransaction outer_transaction(document);
+  {
+    GRM::Document::UpdateTransaction inner_transaction(document);
+    element->setAttribute("kind", "line");
+    inner_transaction.commit();
+    assert(render_count == 0 && updates.empty());
+  }
+  element->setAttribute("y_log", 0);
+  outer_transaction.commit();
+  assert(render_count == 1);
+  assert((updates == std::vector<std::string>{"kind=scatter", "y_log=1"}));
+  outer_transaction.commit();
+  assert(render_count == 1);
+}
+
+static void test_failed_commit(const std::shared_ptr<GRM::Document> &document,
+                               const std::shared_ptr<GRM::Element> &element)
+{
+  bool thrown = false;
+
+  reset_counters();
+  {
+    GRM::Document::UpdateTransaction transaction(document);
+    element->setAttribute("x_log", 1);
+    element->setAttribute("y_log", 1);
+    throw_on_update = true;
+    try
+      {
+        transaction.commit();
+      }
+    catch (const std::runtime_error &)
+      {
+        thrown = true;
+      }
+  }
+  assert(thrown);
+  assert(render_count == 0 && updates.empty());
+
+  /* the updates of the failed commit are passed on by the next transaction, together with its own ones */
+  {
+    GRM::Document::UpdateTransaction transaction(document);
+    element->setAttribute("kind", "scatter");
+  }
+  assert(render_count == 1);
+  assert((updates == std::vector<std::string>{"x_log=0", "y_log=0", "kind=line"}));
+
+  /* the destructor does not throw but keeps the updates as well */
+  reset_counters();
+  {
+    GRM::Document::UpdateTransaction transaction(document);
+    element->setAttribute("x_log", 0);
+    throw_on_update = true;
+  }
+  assert(render_count == 0 && updates.empty());
+  document->beginUpdate();
+  document->endUpdate();
+  assert(render_count == 1);
+  assert((updates == std::vector<std::string>{"x_log=1"}));
+}
+
+static void test()
+{
+  auto document = GRM::createDocument();
+  auto root = document->createElement("root");
+  document->appendChild(root);
+  auto element = document->createElement("plot");
+  root->appendChild(element);
+  element->setAttribute("x_log", 0);
+  element->setAttribute("y_log", 0);
+  element->setAttribute("kind", "line");
+  document->setUpdateFct(render, update);
+
+  test_batched_changes(document, element);
+  test_nested_commit(document, element);
+  test_failed_commit(document, element);
+
+  document->setUpdateFct(nullptr, nullptr);
+}
+
+DEFINE_TEST_MAIN
@@ -0,0 +1,195 @@
+#ifdef __unix__
+#define _XOPEN_SOURCE 500
+#endif
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "grm.h"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+
+#define BINARY_FILENAME "graphics_tree_binary.grm"
+
+
+static char *read_file(const char *filename, size_t *size)
+{
+  FILE *file;
+  char *buffer = NULL;
+  long file_size;
+
+  file = fopen(filename, "rb");
+  if (file == NULL)
+    {
+      return NULL;
+    }
+  if (fseek(file, 0, SEEK_END) == 0 && (file_size = ftell(file)) > 0 && fseek(file, 0, SEEK_SET) == 0)
+    {
+      buffer = malloc(file_size);
+      if (buffer != NULL && fread(buffer, 1, file_size, file) != (size_t)file_size)
+        {
+          free(buffer);
+          buffer = NULL;
+        }
+      *size = file_size;
+    }
+  fclose(file);
+
+  return buffer;
+}
+
+static int dump_to_file(const char *filename)
+{
+  FILE *file;
+  int success;
+
+  file = fopen(filename, "wb");
+  if (file == NULL)
+    {
+      return 0;
+    }
+  success = grm_dump_graphics_tree_binary(file);
+  return fclose(file) == 0 && success;
+}
+
+static int load_from_file(const char *filename)
+{
+  FILE *file;
+  int success;
+
+  file = fopen(filename, "rb");
+  if (file == NULL)
+    {
+      return 0;
+    }
+  success = grm_load_graphics_tree_binary(file);
+  fclose(file);
+
+  return success;
+}
+
+static int test_dump_and_load(void)
+{
+  char *tree = NULL, *loaded_tree = NULL, *dump = NULL, *loaded_dump = NULL;
+  size_t dump_size = 0, loaded_dump_size = 0;
+  int success;
+
+  printf("dumping binary graphics tree...\n");
+  success = dump_to_file(BINARY_FILENAME) && (dump = read_file(BINARY_FILENAME, &dump_size)) != NULL;
+  grm_clear();
+
+  /* Overwrite the file right after loading it, before any lazily loaded context vector has been accessed */
+  printf("loading binary graphics tree and overwriting its file...\n");
+  success = success && load_from_file(BINARY_FILENAME) && dump_to_file(BINARY_FILENAME) &&
+            (loaded_dump = read_file(BINARY_FILENAME, &loaded_dump_size)) != NULL;
+  if (success && (loaded_dump_size != dump_size || memcmp(dump, loaded_dump, dump_size) != 0))
+    {
+      printf("the binary dump of the loaded graphics tree and context differs from the original one\n");
+      success = 0;
+    }
+
+  printf("reloading binary graphics tree...\n");
+  if (success)
+    {
+      tree = grm_dump_graphics_tree_str();
+      grm_clear();
+      success = load_from_file(BINARY_FILENAME);
+    }
+  if (success)
+    {
+      loaded_tree = grm_dump_graphics_tree_str();
+      if (strcmp(tree, loaded_tree) != 0)
+        {
+          printf("the reloaded graphics tree differs from the loaded one\n");
+          success = 0;
+        }
+    }
+
+  if (success)
+    {
+      printf("rendering loaded graphics tree...\n");
+      grm_render();
+    }
+  else
+    {
+      printf("failed to dump or load the binary graphics tree\n");
+    }
+
+  free(tree);
+  free(loaded_tree);
+  free(dump);
+  free(loaded_dump);
+  remove(BINARY_FILENAME);
+
+  return success;
+}
+
+static int test_graphics_tree_binary(void)
+{
+  double x[1000], y[1000];
+  int n = sizeof(x) / sizeof(x[0]);
+  grm_args_t *args;
+  int i, success;
+
+  printf("filling argument container...\n");
+
+  for (i = 0; i < n; ++i)
+    {
+      x[i] = i * 2 * M_PI / n;
+      y[i] = sin(i * 2 * M_PI / n);
+    }
+
+  args = grm_args_new();
+  grm_args_push(args, "x", "nD", n, x);
+  grm_args_push(args, "y", "nD", n, y);
+  grm_args_push(args, "title", "s", "Binary graphics tree");
+  printf("plotting data...\n");
+  success = grm_plot(args);
+  grm_args_delete(args);
+
+  return success && test_dump_and_load();
+}
+
+static int test_empty_vectors(void)
+{
+  double x[] = {0.0, 1.0}, y[] = {1.0, 2.0};
+  const char *labels[] = {""};
+  grm_args_t *args;
+  int success;
+
+  /* Empty context vectors have no data pointer, they must be written as empty blobs nevertheless */
+  printf("plotting data with empty context vectors...\n");
+  args = grm_args_new();
+  grm_args_push(args, "x", "nD", 2, x);
+  grm_args_push(args, "y", "nD", 2, y);
+  grm_args_push(args, "int_limits_high", "nD", 0, x);
+  grm_args_push(args, "int_limits_low", "nD", 0, x);
+  success = grm_plot(args);
+  grm_args_delete(args);
+  success = success && test_dump_and_load();
+  grm_clear();
+
+  printf("plotting data with an empty string context vector...\n");
+  args = grm_args_new();
+  grm_args_push(args, "kind", "s", "barplot");
+  grm_args_push(args, "y", "nD", 2, y);
+  grm_args_push(args, "y_labels", "nS", 0, labels);
+  success = success && grm_plot(args);
+  grm_args_delete(args);
+
+  return success && test_dump_and_load();
+}
+
+int main(void)
+{
+  int success = test_graphics_tree_binary();
+  grm_clear();
+  success = test_empty_vectors() && success;
+  grm_finalize();
+
+  return success ? 0 : 1;
+}